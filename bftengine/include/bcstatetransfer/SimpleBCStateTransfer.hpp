@@ -183,6 +183,9 @@ struct Config {
   bool enableSourceBlocksPreFetch = true;
   bool enableSourceSelectorPrimaryAwareness = true;
   bool enableStoreRvbDataDuringCheckpointing = true;
+  // Digest the reserved pages descriptor with a Merkle tree, which is updated incrementally on checkpoints. Changes the
+  // checkpoint digests, so it must be set identically on all replicas.
+  bool enableResPagesDigestTree = false;
 };
 
 inline std::ostream &operator<<(std::ostream &os, const Config &c) {
@@ -216,7 +219,8 @@ inline std::ostream &operator<<(std::ostream &os, const Config &c) {
               c.enableReservedPages,
               c.enableSourceBlocksPreFetch,
               c.enableSourceSelectorPrimaryAwareness,
-              c.enableStoreRvbDataDuringCheckpointing);
+              c.enableStoreRvbDataDuringCheckpointing,
+              c.enableResPagesDigestTree);
   return os;
 }
 // creates an instance of the state transfer module.
@@ -59,6 +59,14 @@ class IStateTransfer : public IReservedPages {
 
   virtual void createCheckpointOfCurrentState(uint64_t checkpointNumber) = 0;
 
+  // Reserved pages saved by the calling thread between beginReservedPagesWriteBack() and endReservedPagesWriteBack()
+  // may be written lazily, until flushReservedPages() is called. Pages saved otherwise are written through. Scopes may
+  // be nested.
+  virtual void beginReservedPagesWriteBack() {}
+  virtual void endReservedPagesWriteBack() {}
+  // Once this returns, all pages saved so far survive a restart.
+  virtual void flushReservedPages() {}
+
   virtual void markCheckpointAsStable(uint64_t checkpointNumber) = 0;
 
   virtual void getDigestOfCheckpoint(uint64_t checkpointNumber,
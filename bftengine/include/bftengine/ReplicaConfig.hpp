@@ -102,6 +102,11 @@ class ReplicaConfig : public concord::serialize::SerializableFactory<ReplicaConf
                "Number of threads to be used by the PreProcessor to execute "
                "client requests. If equals to 0, a default of "
                "min(thread::hardware_concurrency(), numOfClients) is used ");
+  CONFIG_PARAM(preExecResultsCacheSizeBytes,
+               uint64_t,
+               32 * 1024 * 1024,
+               "Total size of pre-execution results kept in memory to be reused by retried requests with the same "
+               "content and conflict detection block id. If equals to 0, the cache is disabled");
 
   CONFIG_PARAM(batchingPolicy, uint32_t, BATCH_SELF_ADJUSTED, "BFT consensus batching policy for requests");
   CONFIG_PARAM(batchFlushPeriod, uint32_t, 1000, "BFT consensus batching flush period");
@@ -280,6 +285,23 @@ class ReplicaConfig : public concord::serialize::SerializableFactory<ReplicaConf
                "Port to be used to communicate with the diagnostic server using"
                "the concord-ctl script");
 
+  CONFIG_PARAM(clientRepliesCacheSizeBytes,
+               uint64_t,
+               64 * 1024 * 1024,
+               "Total size of the latest client replies kept in memory to answer retransmissions without reading "
+               "the reserved pages. 0 disables the cache");
+  CONFIG_PARAM(numOfReadOnlyReplicaReadThreads,
+               uint16_t,
+               0,
+               "Number of threads a read-only replica uses to execute read-only client requests, each over a "
+               "consistent snapshot of the state. The requests handler must support concurrent read-only execution. If "
+               "equals to 0, a read-only replica serves reconfiguration requests only");
+  CONFIG_PARAM(numOfStateSnapshotShards,
+               std::uint32_t,
+               64u,
+               "Number of shards of consecutive public keys the public state hash of a DB checkpoint is split into. "
+               "Each shard of a state snapshot can be streamed and verified on its own");
+
   // Parameter to enable/disable waiting for transaction data to be persisted.
   // Not predefined configuration parameters
   // Example of usage:
@@ -404,6 +426,10 @@ class ReplicaConfig : public concord::serialize::SerializableFactory<ReplicaConf
     serialize(outStream, enablePreProcessorMemoryPool);
     serialize(outStream, diagnosticsServerPort);
     serialize(outStream, useUnifiedCertificates);
+    serialize(outStream, clientRepliesCacheSizeBytes);
+    serialize(outStream, preExecResultsCacheSizeBytes);
+    serialize(outStream, numOfReadOnlyReplicaReadThreads);
+    serialize(outStream, numOfStateSnapshotShards);
   }
   void deserializeDataMembers(std::istream& inStream) {
     deserialize(inStream, isReadOnly);
@@ -503,6 +529,10 @@ class ReplicaConfig : public concord::serialize::SerializableFactory<ReplicaConf
     deserialize(inStream, enablePreProcessorMemoryPool);
     deserialize(inStream, diagnosticsServerPort);
     deserialize(inStream, useUnifiedCertificates);
+    deserialize(inStream, clientRepliesCacheSizeBytes);
+    deserialize(inStream, preExecResultsCacheSizeBytes);
+    deserialize(inStream, numOfReadOnlyReplicaReadThreads);
+    deserialize(inStream, numOfStateSnapshotShards);
   }
 
  private:
@@ -595,7 +625,11 @@ inline std::ostream& operator<<(std::ostream& os, const ReplicaConfig& rc) {
               rc.operatorEnabled_,
               rc.enablePreProcessorMemoryPool,
               rc.diagnosticsServerPort,
-              rc.useUnifiedCertificates);
+              rc.useUnifiedCertificates,
+              rc.clientRepliesCacheSizeBytes,
+              rc.preExecResultsCacheSizeBytes,
+              rc.numOfReadOnlyReplicaReadThreads,
+              rc.numOfStateSnapshotShards);
   os << ", ";
   for (auto& [param, value] : rc.config_params_) os << param << ": " << value << "\n";
   return os;
@@ -444,6 +444,7 @@ void BCStateTran::stopRunning() {
   if (postProcessingQ_) {
     postProcessingQ_->stop();
   }
+  psd_->flushPendingResPages();
   {
     DataStoreTransaction::Guard g(psd_->beginTransaction());
     stReset(g.txn(), true, false, false);
@@ -494,22 +495,23 @@ DataStore::CheckpointDesc BCStateTran::createCheckpointDesc(uint64_t checkpointN
 
 // Associate any pending reserved pages with the current checkpoint.
 // Return the digest of all the reserved pages descriptor.
-//
-// This has the side effect of mutating buffer_.
 Digest BCStateTran::checkpointReservedPages(uint64_t checkpointNumber, DataStoreTransaction *txn) {
   set<uint32_t> pages = txn->getNumbersOfPendingResPages();
   auto numberOfPagesInCheckpoint = pages.size();
   LOG_INFO(logger_,
            "Associating pending pages with checkpoint: " << KVLOG(numberOfPagesInCheckpoint, checkpointNumber));
-  std::unique_ptr<char[]> buffer(new char[config_.sizeOfReservedPage]);
-  for (uint32_t p : pages) {
-    Digest d;
-    txn->getPendingResPage(p, buffer.get(), config_.sizeOfReservedPage);
-    computeDigestOfPage(p, checkpointNumber, buffer.get(), config_.sizeOfReservedPage, d);
-    txn->associatePendingResPageWithCheckpoint(p, checkpointNumber, d);
+  const std::vector<uint32_t> pageIds(pages.begin(), pages.end());
+  std::vector<Digest> pageDigests;
+  computeDigestsOfPendingPages(checkpointNumber, pageIds, txn, pageDigests);
+  for (size_t i = 0; i < pageIds.size(); ++i) {
+    txn->associatePendingResPageWithCheckpoint(pageIds[i], checkpointNumber, pageDigests[i]);
   }
 
   ConcordAssertEQ(txn->numOfAllPendingResPage(), 0);
+  if (config_.enableResPagesDigestTree) {
+    return updateResPagesDigestTree(checkpointNumber, pageIds, pageDigests, txn);
+  }
+
   DataStore::ResPagesDescriptor *allPagesDesc = txn->getResPagesDescriptor(checkpointNumber);
   ConcordAssertEQ(allPagesDesc->numOfPages, numberOfReservedPages_);
 
@@ -522,6 +524,84 @@ Digest BCStateTran::checkpointReservedPages(uint64_t checkpointNumber, DataStore
   return digestOfResPagesDescriptor;
 }
 
+// Equivalent to computeDigestOfPage() of every page. The pages are copied, a window at a time, into inputs of equal
+// size, which are hashed in SIMD lanes by DigestUtil::computeBatch, split among the threads of resPagesDigestPool_.
+void BCStateTran::computeDigestsOfPendingPages(uint64_t checkpointNumber,
+                                               const std::vector<uint32_t> &pageIds,
+                                               DataStoreTransaction *txn,
+                                               std::vector<Digest> &outDigests) {
+  ConcordAssertGT(checkpointNumber, 0);
+  outDigests.resize(pageIds.size());
+  if (pageIds.empty()) return;
+
+  // [pageId][checkpointNumber][page]
+  const size_t inputSize = sizeof(uint32_t) + sizeof(uint64_t) + config_.sizeOfReservedPage;
+  const size_t windowSize = std::min(pageIds.size(), kMaxPagesInDigestWindow);
+  std::unique_ptr<char[]> inputs(new char[windowSize * inputSize]);
+  std::vector<const char *> inputPtrs(windowSize);
+  const std::vector<size_t> inputSizes(windowSize, inputSize);
+
+  for (size_t first = 0; first < pageIds.size(); first += windowSize) {
+    const size_t count = std::min(windowSize, pageIds.size() - first);
+    for (size_t i = 0; i < count; ++i) {
+      const uint32_t pageId = pageIds[first + i];
+      char *input = inputs.get() + i * inputSize;
+      memcpy(input, &pageId, sizeof(pageId));
+      memcpy(input + sizeof(pageId), &checkpointNumber, sizeof(checkpointNumber));
+      txn->getPendingResPage(pageId, input + sizeof(pageId) + sizeof(checkpointNumber), config_.sizeOfReservedPage);
+      inputPtrs[i] = input;
+    }
+
+    if (count <= kPagesPerDigestTask) {
+      DigestUtil::computeBatch(inputPtrs.data(), inputSizes.data(), count, &outDigests[first]);
+      continue;
+    }
+    if (!resPagesDigestPool_) resPagesDigestPool_ = std::make_unique<concord::util::ThreadPool>();
+    std::vector<std::future<void>> tasks;
+    for (size_t begin = 0; begin < count; begin += kPagesPerDigestTask) {
+      const size_t n = std::min(kPagesPerDigestTask, count - begin);
+      tasks.push_back(resPagesDigestPool_->async([&inputPtrs, &inputSizes, &outDigests, first, begin, n]() {
+        DigestUtil::computeBatch(&inputPtrs[begin], &inputSizes[begin], n, &outDigests[first + begin]);
+      }));
+    }
+    for (auto &task : tasks) task.get();
+  }
+}
+
+// Only the pages associated with this checkpoint changed since the previous one, so when resPagesDigestTree_ describes
+// the previous checkpoint, only their paths are recomputed. Otherwise (first checkpoint since startup, or the pages
+// were replaced by state transfer) the tree is built from the full descriptor.
+Digest BCStateTran::updateResPagesDigestTree(uint64_t checkpointNumber,
+                                             const std::vector<uint32_t> &pageIds,
+                                             const std::vector<Digest> &pageDigests,
+                                             DataStoreTransaction *txn) {
+  const uint64_t lastStoredCheckpoint = txn->getLastStoredCheckpoint();
+  if (resPagesDigestTree_ && resPagesDigestTreeCheckpoint_ > 0 &&
+      resPagesDigestTreeCheckpoint_ == lastStoredCheckpoint) {
+    for (size_t i = 0; i < pageIds.size(); ++i) {
+      resPagesDigestTree_->update(pageIds[i], checkpointNumber, pageDigests[i]);
+    }
+  } else {
+    LOG_INFO(logger_, "Building reserved pages digest tree: " << KVLOG(checkpointNumber, lastStoredCheckpoint));
+    DataStore::ResPagesDescriptor *allPagesDesc = txn->getResPagesDescriptor(checkpointNumber);
+    ConcordAssertEQ(allPagesDesc->numOfPages, numberOfReservedPages_);
+    resPagesDigestTree_ = std::make_unique<ResPagesDigestTree>(allPagesDesc);
+    txn->free(allPagesDesc);
+  }
+  resPagesDigestTreeCheckpoint_ = checkpointNumber;
+  const Digest digestOfResPagesDescriptor = resPagesDigestTree_->digest();
+
+  if (config_.pedanticChecks) {
+    DataStore::ResPagesDescriptor *allPagesDesc = txn->getResPagesDescriptor(checkpointNumber);
+    ConcordAssertEQ(ResPagesDigestTree::compute(allPagesDesc), digestOfResPagesDescriptor);
+    txn->free(allPagesDesc);
+  }
+  LOG_INFO(logger_,
+           "Reserved pages digest tree updated: " << KVLOG(
+               checkpointNumber, pageIds.size(), numberOfReservedPages_, digestOfResPagesDescriptor));
+  return digestOfResPagesDescriptor;
+}
+
 void BCStateTran::deleteOldCheckpoints(uint64_t checkpointNumber, DataStoreTransaction *txn) {
   uint64_t minRelevantCheckpoint = 0;
   if (checkpointNumber >= maxNumOfStoredCheckpoints_)
@@ -578,6 +658,13 @@ void BCStateTran::createCheckpointOfCurrentState(uint64_t checkpointNumber) {
   LOG_INFO(logger_, "Done creating (and persisting) checkpoint of current state!" << KVLOG(checkpointNumber));
 }
 
+void BCStateTran::beginReservedPagesWriteBack() { psd_->beginPendingResPagesWriteBack(); }
+
+void BCStateTran::endReservedPagesWriteBack() { psd_->endPendingResPagesWriteBack(); }
+
+// Pending pages which were not yet associated with a checkpoint are written in one batch
+void BCStateTran::flushReservedPages() { psd_->flushPendingResPages(); }
+
 void BCStateTran::markCheckpointAsStable(uint64_t checkpointNumber) {
   ConcordAssert(running_);
   ConcordAssert(!isFetching());
@@ -2590,7 +2677,7 @@ bool BCStateTran::checkVirtualBlockOfResPages(const Digest &expectedDigestOfResP
   }
 
   Digest computedDigest;
-  computeDigestOfPagesDescriptor(pagesDesc, computedDigest);
+  computeDigestOfPagesDescriptor(pagesDesc, computedDigest, config_.enableResPagesDigestTree);
   LOG_INFO(logger_, pagesDesc->toString(computedDigest.toString()));
   psd_->free(pagesDesc);
 
@@ -3555,7 +3642,8 @@ void BCStateTran::checkStoredCheckpoints(uint64_t firstStoredCheckpoint, uint64_
         ConcordAssertEQ(allPagesDesc->numOfPages, numberOfReservedPages_);
         {
           Digest computedDigestOfResPagesDescriptor;
-          computeDigestOfPagesDescriptor(allPagesDesc, computedDigestOfResPagesDescriptor);
+          computeDigestOfPagesDescriptor(
+              allPagesDesc, computedDigestOfResPagesDescriptor, config_.enableResPagesDigestTree);
           LOG_INFO(logger_, allPagesDesc->toString(computedDigestOfResPagesDescriptor.toString()));
           ConcordAssertEQ(computedDigestOfResPagesDescriptor, desc.digestOfResPagesDescriptor);
         }
@@ -3593,7 +3681,13 @@ void BCStateTran::computeDigestOfPage(
   c.writeDigest(reinterpret_cast<char *>(&outDigest));
 }
 
-void BCStateTran::computeDigestOfPagesDescriptor(const DataStore::ResPagesDescriptor *pagesDesc, Digest &outDigest) {
+void BCStateTran::computeDigestOfPagesDescriptor(const DataStore::ResPagesDescriptor *pagesDesc,
+                                                 Digest &outDigest,
+                                                 bool useDigestTree) {
+  if (useDigestTree) {
+    outDigest = ResPagesDigestTree::compute(pagesDesc);
+    return;
+  }
   DigestUtil::Context c;
   c.update(reinterpret_cast<const char *>(pagesDesc), pagesDesc->size());
   c.writeDigest(reinterpret_cast<char *>(&outDigest));
@@ -23,6 +23,7 @@
 #include <array>
 #include <cstdint>
 #include <optional>
+#include <vector>
 
 #include "Logger.hpp"
 #include "SimpleBCStateTransfer.hpp"
@@ -41,6 +42,8 @@
 #include "Timers.hpp"
 #include "TimeUtils.hpp"
 #include "SimpleMemoryPool.hpp"
+#include "thread_pool.hpp"
+#include "ResPagesDigestTree.hpp"
 #include "messages/MessageBase.hpp"
 
 using std::set;
@@ -90,6 +93,10 @@ class BCStateTran : public IStateTransfer {
 
   void createCheckpointOfCurrentState(uint64_t checkpointNumber) override;
 
+  void beginReservedPagesWriteBack() override;
+  void endReservedPagesWriteBack() override;
+  void flushReservedPages() override;
+
   void markCheckpointAsStable(uint64_t checkpointNumber) override;
 
   void getDigestOfCheckpoint(uint64_t checkpointNumber,
@@ -227,6 +234,13 @@ class BCStateTran : public IStateTransfer {
 
   std::unique_ptr<char[]> buffer_;  // general use buffer
 
+  // Reserved pages digests of a checkpoint (see checkpointReservedPages)
+  static constexpr size_t kMaxPagesInDigestWindow = 1024;
+  static constexpr size_t kPagesPerDigestTask = 64;
+  std::unique_ptr<concord::util::ThreadPool> resPagesDigestPool_;  // created on first use
+  std::unique_ptr<ResPagesDigestTree> resPagesDigestTree_;
+  uint64_t resPagesDigestTreeCheckpoint_ = 0;  // the checkpoint resPagesDigestTree_ describes
+
   // random generator
   std::random_device randomDevice_;
   std::mt19937 randomGen_;
@@ -416,6 +430,14 @@ class BCStateTran : public IStateTransfer {
   DataStore::CheckpointDesc createCheckpointDesc(uint64_t checkpointNumber, const Digest& digestOfResPagesDescriptor);
 
   Digest checkpointReservedPages(uint64_t checkpointNumber, DataStoreTransaction* txn);
+  void computeDigestsOfPendingPages(uint64_t checkpointNumber,
+                                    const std::vector<uint32_t>& pageIds,
+                                    DataStoreTransaction* txn,
+                                    std::vector<Digest>& outDigests);
+  Digest updateResPagesDigestTree(uint64_t checkpointNumber,
+                                  const std::vector<uint32_t>& pageIds,
+                                  const std::vector<Digest>& pageDigests,
+                                  DataStoreTransaction* txn);
 
   void deleteOldCheckpoints(uint64_t checkpointNumber, DataStoreTransaction* txn);
   void srcInitialize();
@@ -440,7 +462,10 @@ class BCStateTran : public IStateTransfer {
   static void computeDigestOfPage(
       const uint32_t pageId, const uint64_t checkpointNumber, const char* page, uint32_t pageSize, Digest& outDigest);
 
-  static void computeDigestOfPagesDescriptor(const DataStore::ResPagesDescriptor* pagesDesc, Digest& outDigest);
+  // useDigestTree selects the Merkle digest of ResPagesDigestTree over the flat digest of the whole descriptor
+  static void computeDigestOfPagesDescriptor(const DataStore::ResPagesDescriptor* pagesDesc,
+                                             Digest& outDigest,
+                                             bool useDigestTree = false);
 
   static void computeDigestOfBlock(const uint64_t blockNum,
                                    const char* block,
@@ -339,13 +339,68 @@ void DBDataStore::loadPendingPages() {
   }
 }
 
+thread_local uint32_t DBDataStore::writeBackScopes_ = 0;
+
+/**
+ * Within a write-back scope and outside of a transaction, the page is only marked dirty; it reaches the DB on the next
+ * flushPendingResPages() or when it is associated with a checkpoint, whichever comes first.
+ */
 void DBDataStore::setPendingResPage(uint32_t inPageId, const char* inPage, uint32_t inPageLen) {
   LOG_DEBUG(logger(), "page: " << inPageId);
-  std::ostringstream oss;
-  Serializable::serialize(oss, inPageLen);
-  Serializable::serialize(oss, inPage, inPageLen);
-  put(pendingPageKey(inPageId), oss.str());
   inmem_->setPendingResPage(inPageId, inPage, inPageLen);
+  if (txn_) {
+    setPendingResPageTxn(inPageId, txn_);
+    return;
+  }
+  if (writeBackScopes_ == 0) {
+    ITransaction::Guard g(dbc_->beginTransaction());
+    setPendingResPageTxn(inPageId, g.txn());
+    return;
+  }
+  std::lock_guard<std::mutex> lock(dirtyPendingPages_->lock);
+  dirtyPendingPages_->pageIds.insert(inPageId);
+}
+
+/**
+ * Pending page serialized form: [PageLen][Page], where the page is the in-memory copy, padded to the reserved page size.
+ */
+void DBDataStore::setPendingResPageTxn(uint32_t inPageId, ITransaction* txn) {
+  const auto& pendingPages = inmem_->getPendingPagesMap();
+  auto page = pendingPages.find(inPageId);
+  ConcordAssert(page != pendingPages.end());
+  const uint32_t pageLen = inmem_->getSizeOfReservedPage();
+  std::ostringstream oss;
+  Serializable::serialize(oss, pageLen);
+  Serializable::serialize(oss, page->second, pageLen);
+  txn->put(pendingPageKey(inPageId), oss.str());
+  {
+    std::lock_guard<std::mutex> lock(dirtyPendingPages_->lock);
+    dirtyPendingPages_->pageIds.erase(inPageId);
+  }
+}
+
+void DBDataStore::flushPendingResPagesTxn(const std::set<uint32_t>& pageIds, ITransaction* txn) {
+  for (auto pid : pageIds) {
+    // associated with a checkpoint or deleted since it was set
+    if (!inmem_->hasPendingResPage(pid)) continue;
+    setPendingResPageTxn(pid, txn);
+  }
+}
+
+void DBDataStore::flushPendingResPages() {
+  std::set<uint32_t> pageIds;
+  {
+    std::lock_guard<std::mutex> lock(dirtyPendingPages_->lock);
+    pageIds.swap(dirtyPendingPages_->pageIds);
+  }
+  if (pageIds.empty()) return;
+  LOG_DEBUG(logger(), "flushing pending pages: " << pageIds.size());
+  if (txn_) {
+    flushPendingResPagesTxn(pageIds, txn_);
+  } else {
+    ITransaction::Guard g(dbc_->beginTransaction());
+    flushPendingResPagesTxn(pageIds, g.txn());
+  }
 }
 
 void DBDataStore::associatePendingResPageWithCheckpoint(uint32_t inPageId,
@@ -374,6 +429,8 @@ void DBDataStore::associatePendingResPageWithCheckpointTxn(uint32_t inPageId,
 
   setResPageTxn(inPageId, inCheckpoint, inPageDigest, page->second, txn);
   txn->del(pendingPageKey(inPageId));
+  std::lock_guard<std::mutex> lock(dirtyPendingPages_->lock);
+  dirtyPendingPages_->pageIds.erase(inPageId);
 }
 void DBDataStore::deleteAllPendingPagesTxn(ITransaction* txn) {
   std::set<uint32_t> pageIds = getNumbersOfPendingResPages();
@@ -387,6 +444,8 @@ void DBDataStore::deleteAllPendingPages() {
     deleteAllPendingPagesTxn(g.txn());
   }
   inmem_->deleteAllPendingPages();
+  std::lock_guard<std::mutex> lock(dirtyPendingPages_->lock);
+  dirtyPendingPages_->pageIds.clear();
 }
 
 void DBDataStore::deleteCoveredResPageInSmallerCheckpointsTxn(uint64_t minChkp, ITransaction* txn) {
@@ -16,6 +16,7 @@
 #include <map>
 #include <set>
 #include <memory>
+#include <mutex>
 
 #include "string.hpp"
 #include "Logger.hpp"
@@ -35,6 +36,11 @@ using concord::storage::ObjectId;
  *  This class is used in one of two modes:
  *  1. When ITransaction is not set - works directly through IDBClient instance;
  *  2. When ITransaction is set - is invoked via DBDataStoreTransaction.
+ *
+ *  Pending reserved pages set outside of a transaction, by a thread within a write-back scope, are kept in memory and
+ *  only marked dirty. Repeated writes to the same page are coalesced, and the dirty pages are written in a single DB
+ *  transaction by flushPendingResPages() or together with the checkpoint they are associated with. Pending pages set
+ *  outside of such a scope are written through.
  */
 class DBDataStore : public DataStore {
  public:
@@ -70,6 +76,12 @@ class DBDataStore : public DataStore {
   void setLastRequiredBlock(uint64_t) override;
   void setFVal(uint16_t) override;
   void deleteAllPendingPages() override;
+  void beginPendingResPagesWriteBack() override { ++writeBackScopes_; }
+  void endPendingResPagesWriteBack() override {
+    ConcordAssertGT(writeBackScopes_, 0);
+    --writeBackScopes_;
+  }
+  void flushPendingResPages() override;
   void deleteCheckpointBeingFetched() override;
   void deleteDescOfSmallerCheckpoints(uint64_t) override;
   void deleteCoveredResPageInSmallerCheckpoints(uint64_t) override;
@@ -163,6 +175,8 @@ class DBDataStore : public DataStore {
   void setResPageTxn(uint32_t, uint64_t, const Digest&, const char*, ITransaction*);
   void associatePendingResPageWithCheckpointTxn(uint32_t, uint64_t, const Digest&, ITransaction*);
   void deleteAllPendingPagesTxn(ITransaction*);
+  void setPendingResPageTxn(uint32_t, ITransaction*);
+  void flushPendingResPagesTxn(const std::set<uint32_t>&, ITransaction*);
   void deleteCoveredResPageInSmallerCheckpointsTxn(uint64_t, ITransaction*);
   void deleteDescOfSmallerCheckpointsTxn(uint64_t, ITransaction*);
   void deleteAllDesc();
@@ -243,6 +257,14 @@ class DBDataStore : public DataStore {
 
  protected:
   std::shared_ptr<InMemoryDataStore> inmem_;  // one copy among instances
+  // Pending pages which are newer in memory than in the DB, shared among the transaction copies.
+  struct DirtyPendingPages {
+    std::mutex lock;
+    std::set<uint32_t> pageIds;
+  };
+  std::shared_ptr<DirtyPendingPages> dirtyPendingPages_ = std::make_shared<DirtyPendingPages>();
+  // The number of write-back scopes the calling thread is in
+  static thread_local uint32_t writeBackScopes_;
   ITransaction* txn_ = nullptr;
   IDBClient::ptr dbc_;
   std::shared_ptr<concord::storage::ISTKeyManipulator> keymanip_;
@@ -108,6 +108,12 @@ class DataStore : public std::enable_shared_from_this<DataStore> {
   virtual uint32_t numOfAllPendingResPage() = 0;
   virtual set<uint32_t> getNumbersOfPendingResPages() = 0;
   virtual void deleteAllPendingPages() = 0;
+  // Pending pages set by the calling thread between these calls may be kept in memory only, until
+  // flushPendingResPages() is called. Pending pages set otherwise are written through.
+  virtual void beginPendingResPagesWriteBack() = 0;
+  virtual void endPendingResPagesWriteBack() = 0;
+  // Once this returns, all pending pages survive a restart.
+  virtual void flushPendingResPages() = 0;
 
   virtual void associatePendingResPageWithCheckpoint(uint32_t inPageId,
                                                      uint64_t inCheckpoint,
@@ -216,6 +222,9 @@ class DataStoreTransaction : public DataStore, public ITransaction {
   void setFVal(uint16_t fVal) override { ds_->setFVal(fVal); }
   void free(ResPagesDescriptor* des) override { ds_->free(des); }
   void deleteAllPendingPages() override { ds_->deleteAllPendingPages(); }
+  void beginPendingResPagesWriteBack() override { ds_->beginPendingResPagesWriteBack(); }
+  void endPendingResPagesWriteBack() override { ds_->endPendingResPagesWriteBack(); }
+  void flushPendingResPages() override { ds_->flushPendingResPages(); }
   void deleteCheckpointBeingFetched() override { ds_->deleteCheckpointBeingFetched(); }
   void deleteDescOfSmallerCheckpoints(uint64_t chpt) override { ds_->deleteDescOfSmallerCheckpoints(chpt); }
 
@@ -112,6 +112,9 @@ class InMemoryDataStore : public DataStore {
   uint32_t numOfAllPendingResPage() override;
   set<uint32_t> getNumbersOfPendingResPages() override;
   void deleteAllPendingPages() override;
+  void beginPendingResPagesWriteBack() override {}
+  void endPendingResPagesWriteBack() override {}
+  void flushPendingResPages() override {}
 
   void associatePendingResPageWithCheckpoint(uint32_t inPageId,
                                              uint64_t inCheckpoint,
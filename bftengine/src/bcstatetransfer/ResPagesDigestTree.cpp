@@ -0,0 +1,110 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").  You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include <algorithm>
+#include <cstring>
+
+#include "ResPagesDigestTree.hpp"
+
+using concord::util::digest::DigestUtil;
+
+namespace bftEngine::bcst::impl {
+
+namespace {
+
+constexpr size_t kLeafInputSize = sizeof(uint32_t) + sizeof(uint64_t) + sizeof(Digest);
+constexpr size_t kNodeInputSize = 2 * sizeof(Digest);
+
+void writeLeafInput(char* out, uint32_t pageId, uint64_t relevantCheckpoint, const Digest& pageDigest) {
+  memcpy(out, &pageId, sizeof(pageId));
+  memcpy(out + sizeof(pageId), &relevantCheckpoint, sizeof(relevantCheckpoint));
+  memcpy(out + sizeof(pageId) + sizeof(relevantCheckpoint), pageDigest.get(), sizeof(Digest));
+}
+
+}  // namespace
+
+ResPagesDigestTree::ResPagesDigestTree(const DataStore::ResPagesDescriptor* desc) : numOfPages_{desc->numOfPages} {
+  ConcordAssertGT(numOfPages_, 0);
+  while (width_ < numOfPages_) width_ *= 2;
+  nodes_.resize(2 * width_);
+
+  // All the leaves are independent inputs of the same size, hash them as a single batch
+  std::vector<char> inputs(numOfPages_ * kLeafInputSize);
+  std::vector<const char*> inputPtrs(numOfPages_);
+  const std::vector<size_t> inputSizes(numOfPages_, kLeafInputSize);
+  for (uint32_t i = 0; i < numOfPages_; ++i) {
+    inputPtrs[i] = inputs.data() + i * kLeafInputSize;
+    writeLeafInput(inputs.data() + i * kLeafInputSize, i, desc->d[i].relevantCheckpoint, desc->d[i].pageDigest);
+  }
+  DigestUtil::computeBatch(inputPtrs.data(), inputSizes.data(), numOfPages_, &nodes_[width_]);
+
+  dirtyLeaves_.resize(numOfPages_);
+  for (uint32_t i = 0; i < numOfPages_; ++i) dirtyLeaves_[i] = width_ + i;
+}
+
+void ResPagesDigestTree::update(uint32_t pageId, uint64_t relevantCheckpoint, const Digest& pageDigest) {
+  ConcordAssertLT(pageId, numOfPages_);
+  char input[kLeafInputSize];
+  writeLeafInput(input, pageId, relevantCheckpoint, pageDigest);
+  DigestUtil::compute(input, kLeafInputSize, nodes_[width_ + pageId].getForUpdate(), sizeof(Digest));
+  dirtyLeaves_.push_back(width_ + pageId);
+}
+
+std::vector<size_t> ResPagesDigestTree::computeLevel(const std::vector<size_t>& nodes) {
+  std::vector<char> inputs(nodes.size() * kNodeInputSize);
+  std::vector<const char*> inputPtrs(nodes.size());
+  const std::vector<size_t> inputSizes(nodes.size(), kNodeInputSize);
+  std::vector<Digest> digests(nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    inputPtrs[i] = inputs.data() + i * kNodeInputSize;
+    memcpy(inputs.data() + i * kNodeInputSize, nodes_[2 * nodes[i]].get(), sizeof(Digest));
+    memcpy(inputs.data() + i * kNodeInputSize + sizeof(Digest), nodes_[2 * nodes[i] + 1].get(), sizeof(Digest));
+  }
+  DigestUtil::computeBatch(inputPtrs.data(), inputSizes.data(), nodes.size(), digests.data());
+
+  std::vector<size_t> parents;
+  parents.reserve(nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    nodes_[nodes[i]] = digests[i];
+    if (parents.empty() || parents.back() != nodes[i] / 2) parents.push_back(nodes[i] / 2);
+  }
+  return parents;
+}
+
+Digest ResPagesDigestTree::digest() {
+  if (!dirtyLeaves_.empty()) {
+    std::sort(dirtyLeaves_.begin(), dirtyLeaves_.end());
+    std::vector<size_t> level;
+    level.reserve(dirtyLeaves_.size());
+    for (auto leaf : dirtyLeaves_) {
+      if (level.empty() || level.back() != leaf / 2) level.push_back(leaf / 2);
+    }
+    dirtyLeaves_.clear();
+    // A single page has no inner nodes: the root is the leaf itself
+    if (width_ > 1) {
+      while (level.front() > 0) level = computeLevel(level);
+    }
+  }
+
+  const Digest& root = nodes_[1];
+  DigestUtil::Context c;
+  c.update(reinterpret_cast<const char*>(&numOfPages_), sizeof(numOfPages_));
+  c.update(root.get(), sizeof(Digest));
+  Digest out;
+  c.writeDigest(out.getForUpdate());
+  return out;
+}
+
+Digest ResPagesDigestTree::compute(const DataStore::ResPagesDescriptor* desc) {
+  return ResPagesDigestTree(desc).digest();
+}
+
+}  // namespace bftEngine::bcst::impl
@@ -0,0 +1,58 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").  You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "DataStore.hpp"
+
+namespace bftEngine::bcst::impl {
+
+/**
+ * Merkle tree over the entries of a reserved pages descriptor.
+ *
+ * Leaf i is the digest of [i][relevantCheckpoint][pageDigest] of page i, and an inner node is the digest of its two
+ * children. The leaves are padded up to a power of two with zero digests; an inner node which covers padding only is a
+ * zero digest as well. The digest of the whole descriptor is the digest of [numOfPages][root].
+ *
+ * When only a few pages change between checkpoints, update() followed by digest() recomputes only the paths from the
+ * changed leaves to the root, instead of hashing the whole descriptor again.
+ */
+class ResPagesDigestTree {
+ public:
+  explicit ResPagesDigestTree(const DataStore::ResPagesDescriptor* desc);
+
+  // Sets the description of a single page; the digest is recomputed lazily.
+  void update(uint32_t pageId, uint64_t relevantCheckpoint, const Digest& pageDigest);
+  Digest digest();
+
+  uint32_t numOfPages() const { return numOfPages_; }
+
+  // Equal to ResPagesDigestTree(desc).digest()
+  static Digest compute(const DataStore::ResPagesDescriptor* desc);
+
+ private:
+  // Computes the nodes with the given (sorted, unique) indices on one level from their children, and returns the
+  // indices of their parents
+  std::vector<size_t> computeLevel(const std::vector<size_t>& nodes);
+
+  const uint32_t numOfPages_;
+  // Number of leaves, a power of two
+  size_t width_ = 1;
+  // Heap layout: the root is at 1, the children of n at 2n and 2n + 1, and leaf i at width_ + i
+  std::vector<Digest> nodes_;
+  // Leaves which were updated since the last call to digest()
+  std::vector<size_t> dirtyLeaves_;
+};
+
+}  // namespace bftEngine::bcst::impl
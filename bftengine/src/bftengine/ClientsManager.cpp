@@ -20,82 +20,155 @@
 #include "PersistentStorageImp.hpp"
 #include "ReplicasInfo.hpp"
 
+#include <algorithm>
 #include <chrono>
 using namespace std::chrono;
 using namespace concord::serialize;
 namespace bftEngine::impl {
 
+/*************************** Class ClientsManager::ReqIdSlots ***************************/
+
+void ClientsManager::ReqIdSlots::init(size_t capacity) {
+  capacity_ = std::max<size_t>(capacity, 1);
+  slots_.reset(new std::atomic<ReqId>[capacity_]);
+  clear();
+}
+
+void ClientsManager::ReqIdSlots::add(ReqId reqSeqNum) {
+  if (reqSeqNum != kEmptySlot) {
+    for (size_t i = 0; i < capacity_; ++i) {
+      if (slots_[i].load(std::memory_order_relaxed) == kEmptySlot) {
+        slots_[i].store(reqSeqNum, std::memory_order_release);
+        return;
+      }
+    }
+  }
+  overflow_.fetch_add(1, std::memory_order_release);
+}
+
+void ClientsManager::ReqIdSlots::remove(ReqId reqSeqNum) {
+  if (reqSeqNum != kEmptySlot) {
+    for (size_t i = 0; i < capacity_; ++i) {
+      if (slots_[i].load(std::memory_order_relaxed) == reqSeqNum) {
+        slots_[i].store(kEmptySlot, std::memory_order_release);
+        return;
+      }
+    }
+  }
+  ConcordAssertGT(overflow_.load(std::memory_order_relaxed), 0);
+  overflow_.fetch_sub(1, std::memory_order_release);
+}
+
+void ClientsManager::ReqIdSlots::clear() {
+  for (size_t i = 0; i < capacity_; ++i) slots_[i].store(kEmptySlot, std::memory_order_release);
+  overflow_.store(0, std::memory_order_release);
+}
+
+ClientsManager::ReqIdSlots::Lookup ClientsManager::ReqIdSlots::find(ReqId reqSeqNum) const {
+  if (reqSeqNum != kEmptySlot) {
+    for (size_t i = 0; i < capacity_; ++i) {
+      if (slots_[i].load(std::memory_order_acquire) == reqSeqNum) return Lookup::FOUND;
+    }
+  }
+  return overflow_.load(std::memory_order_acquire) ? Lookup::UNKNOWN : Lookup::NOT_FOUND;
+}
+
 /*************************** Class ClientsManager::RequestsInfo ***************************/
 
+void ClientsManager::RequestsInfo::init(std::mutex* mutex, size_t capacity) {
+  mutex_ = mutex;
+  requests_.reserve(capacity);
+  ids_.init(capacity);
+}
+
+ClientsManager::RequestsInfo::Requests::iterator ClientsManager::RequestsInfo::lookup(ReqId reqSeqNum) {
+  auto it = std::lower_bound(
+      requests_.begin(), requests_.end(), reqSeqNum, [](const auto& req, ReqId id) { return req.first < id; });
+  return (it != requests_.end() && it->first == reqSeqNum) ? it : requests_.end();
+}
+
+ClientsManager::RequestsInfo::Requests::const_iterator ClientsManager::RequestsInfo::lookup(ReqId reqSeqNum) const {
+  auto it = std::lower_bound(
+      requests_.cbegin(), requests_.cend(), reqSeqNum, [](const auto& req, ReqId id) { return req.first < id; });
+  return (it != requests_.cend() && it->first == reqSeqNum) ? it : requests_.cend();
+}
+
 void ClientsManager::RequestsInfo::emplaceSafe(NodeIdType clientId, ReqId reqSeqNum, const std::string& cid) {
-  const lock_guard<mutex> lock(requestsMapMutex_);
-  if (requestsMap_.find(reqSeqNum) != requestsMap_.end()) {
+  const lock_guard<mutex> lock(*mutex_);
+  auto it = std::lower_bound(
+      requests_.begin(), requests_.end(), reqSeqNum, [](const auto& req, ReqId id) { return req.first < id; });
+  if (it != requests_.end() && it->first == reqSeqNum) {
     LOG_WARN(CL_MNGR, "The request already exists - skip adding" << KVLOG(clientId, reqSeqNum));
     return;
   }
-  requestsMap_.emplace(reqSeqNum, RequestInfo{getMonotonicTime(), cid});
-  LOG_DEBUG(CL_MNGR, "Added request" << KVLOG(clientId, reqSeqNum, requestsMap_.size()));
+  requests_.emplace(it, reqSeqNum, RequestInfo{getMonotonicTime(), cid});
+  ids_.add(reqSeqNum);
+  LOG_DEBUG(CL_MNGR, "Added request" << KVLOG(clientId, reqSeqNum, requests_.size()));
 }
 
-bool ClientsManager::RequestsInfo::findSafe(ReqId reqSeqNum) {
-  const lock_guard<mutex> lock(requestsMapMutex_);
-  return (requestsMap_.find(reqSeqNum) != requestsMap_.end());
+bool ClientsManager::RequestsInfo::findSafe(ReqId reqSeqNum) const {
+  switch (ids_.find(reqSeqNum)) {
+    case ReqIdSlots::Lookup::FOUND:
+      return true;
+    case ReqIdSlots::Lookup::NOT_FOUND:
+      return false;
+    case ReqIdSlots::Lookup::UNKNOWN:
+      break;
+  }
+  const lock_guard<mutex> lock(*mutex_);
+  return find(reqSeqNum);
 }
 
 bool ClientsManager::RequestsInfo::removeRequestsOutOfBatchBoundsSafe(NodeIdType clientId, ReqId reqSequenceNum) {
-  ReqId maxReqId{0};
-  const lock_guard<mutex> lock(requestsMapMutex_);
-  if (requestsMap_.find(reqSequenceNum) != requestsMap_.end()) return false;
-  for (const auto& reqInfo : requestsMap_)
-    if (reqInfo.first > maxReqId) maxReqId = reqInfo.first;
-
-  if (requestsMap_.size() == maxNumOfRequestsInBatch && maxReqId > reqSequenceNum) {
+  const lock_guard<mutex> lock(*mutex_);
+  if (find(reqSequenceNum)) return false;
+  if (requests_.size() == maxNumOfRequestsInBatch && requests_.back().first > reqSequenceNum) {
     // If we don't have room for the sequence number, and we see that the highest sequence number is greater
     // than the given one, it means that the highest sequence number is out of the boundaries and can be safely removed
-    requestsMap_.erase(maxReqId);
+    ids_.remove(requests_.back().first);
+    requests_.pop_back();
     return true;
   }
   return false;
 }
 
 void ClientsManager::RequestsInfo::removeOldPendingReqsSafe(NodeIdType clientId, ReqId reqSeqNum) {
-  const lock_guard<mutex> lock(requestsMapMutex_);
-  for (auto it = requestsMap_.begin(); it != requestsMap_.end();) {
-    if (it->first <= reqSeqNum) {
-      it = requestsMap_.erase(it);
-      LOG_INFO(CL_MNGR, "Remove old pending request" << KVLOG(clientId, reqSeqNum));
-    } else
-      it++;
+  const lock_guard<mutex> lock(*mutex_);
+  auto it = requests_.begin();
+  for (; it != requests_.end() && it->first <= reqSeqNum; ++it) {
+    ids_.remove(it->first);
+    LOG_INFO(CL_MNGR, "Remove old pending request" << KVLOG(clientId, reqSeqNum));
   }
+  requests_.erase(requests_.begin(), it);
 }
 
 void ClientsManager::RequestsInfo::removePendingForExecutionRequestSafe(NodeIdType clientId, ReqId reqSeqNum) {
-  const lock_guard<mutex> lock(requestsMapMutex_);
-  const auto& reqIt = requestsMap_.find(reqSeqNum);
-  if (reqIt != requestsMap_.end()) {
-    requestsMap_.erase(reqIt);
-    LOG_DEBUG(CL_MNGR, "Removed request" << KVLOG(clientId, reqSeqNum, requestsMap_.size()));
+  const lock_guard<mutex> lock(*mutex_);
+  const auto reqIt = lookup(reqSeqNum);
+  if (reqIt != requests_.end()) {
+    requests_.erase(reqIt);
+    ids_.remove(reqSeqNum);
+    LOG_DEBUG(CL_MNGR, "Removed request" << KVLOG(clientId, reqSeqNum, requests_.size()));
   }
 }
 
 void ClientsManager::RequestsInfo::clearSafe() {
-  const std::lock_guard<std::mutex> lock(requestsMapMutex_);
-  requestsMap_.clear();
+  const std::lock_guard<std::mutex> lock(*mutex_);
+  requests_.clear();
+  ids_.clear();
 }
 
-bool ClientsManager::RequestsInfo::find(ReqId reqSeqNum) const {
-  return (requestsMap_.find(reqSeqNum) != requestsMap_.end());
-}
+bool ClientsManager::RequestsInfo::find(ReqId reqSeqNum) const { return lookup(reqSeqNum) != requests_.cend(); }
 
 bool ClientsManager::RequestsInfo::isPending(ReqId reqSeqNum) const {
-  const auto& reqIt = requestsMap_.find(reqSeqNum);
-  if (reqIt != requestsMap_.end() && !reqIt->second.committed) return true;
+  const auto reqIt = lookup(reqSeqNum);
+  if (reqIt != requests_.cend() && !reqIt->second.committed) return true;
   return false;
 }
 
 void ClientsManager::RequestsInfo::markRequestAsCommitted(NodeIdType clientId, ReqId reqSeqNum) {
-  const auto& reqIt = requestsMap_.find(reqSeqNum);
-  if (reqIt != requestsMap_.end()) {
+  const auto reqIt = lookup(reqSeqNum);
+  if (reqIt != requests_.end()) {
     reqIt->second.committed = true;
     LOG_DEBUG(CL_MNGR, "Marked committed" << KVLOG(clientId, reqSeqNum));
     return;
@@ -105,7 +178,7 @@ void ClientsManager::RequestsInfo::markRequestAsCommitted(NodeIdType clientId, R
 
 void ClientsManager::RequestsInfo::infoOfEarliestPendingRequest(Time& earliestTime,
                                                                 RequestInfo& earliestPendingReqInfo) const {
-  for (const auto& req : requestsMap_) {
+  for (const auto& req : requests_) {
     // Don't take into account already committed requests
     if ((req.second.time != MinTime) && (earliestTime > req.second.time) && (!req.second.committed)) {
       earliestPendingReqInfo = req.second;
@@ -117,7 +190,7 @@ void ClientsManager::RequestsInfo::infoOfEarliestPendingRequest(Time& earliestTi
 void ClientsManager::RequestsInfo::logAllPendingRequestsExceedingThreshold(const int64_t threshold,
                                                                            const Time& currTime,
                                                                            int& numExceeding) const {
-  for (const auto& req : requestsMap_) {
+  for (const auto& req : requests_) {
     // Don't take into account already committed requests
     if ((req.second.time != MinTime) && (!req.second.committed)) {
       const auto delayed = duration_cast<milliseconds>(currTime - req.second.time).count();
@@ -131,48 +204,73 @@ void ClientsManager::RequestsInfo::logAllPendingRequestsExceedingThreshold(const
 
 /*************************** Class ClientsManager::RepliesInfo ***************************/
 
+void ClientsManager::RepliesInfo::init(std::mutex* mutex, size_t capacity) {
+  mutex_ = mutex;
+  replies_.reserve(capacity);
+  ids_.init(capacity);
+}
+
+ClientsManager::RepliesInfo::Replies::const_iterator ClientsManager::RepliesInfo::lookup(ReqId reqSeqNum) const {
+  auto it = std::lower_bound(
+      replies_.cbegin(), replies_.cend(), reqSeqNum, [](const auto& reply, ReqId id) { return reply.first < id; });
+  return (it != replies_.cend() && it->first == reqSeqNum) ? it : replies_.cend();
+}
+
 void ClientsManager::RepliesInfo::deleteOldestReplyIfNeededSafe(NodeIdType clientId, uint16_t maxNumOfReqsPerClient) {
   Time earliestTime = MaxTime;
   ReqId earliestReplyId = 0;
-  const lock_guard<mutex> lock(repliesMapMutex_);
-  if (repliesMap_.size() < maxNumOfReqsPerClient) return;
-  if (repliesMap_.size() > maxNumOfReqsPerClient)
+  const lock_guard<mutex> lock(*mutex_);
+  if (replies_.size() < maxNumOfReqsPerClient) return;
+  if (replies_.size() > maxNumOfReqsPerClient)
     LOG_FATAL(CL_MNGR,
               "More than maxNumOfReqsPerClient_ items in repliesInfo"
-                  << KVLOG(repliesMap_.size(), maxNumOfReqsPerClient, clientId));
-  for (auto& reply : repliesMap_) {
-    if (earliestTime > reply.second) {
-      earliestReplyId = reply.first;
-      earliestTime = reply.second;
+                  << KVLOG(replies_.size(), maxNumOfReqsPerClient, clientId));
+  if (replies_.empty()) return;
+  auto earliest = replies_.cend();
+  for (auto it = replies_.cbegin(); it != replies_.cend(); ++it) {
+    if (earliestTime > it->second) {
+      earliest = it;
+      earliestTime = it->second;
     }
   }
-  if (earliestReplyId) {
-    repliesMap_.erase(earliestReplyId);
-  } else if (!repliesMap_.empty()) {
-    // Delete reply arrived through ST
-    auto const& reply = repliesMap_.cbegin();
-    earliestReplyId = reply->first;
-    earliestTime = reply->second;
-    repliesMap_.erase(reply);
-  }
+  // If no reply has a time, delete the one with the lowest sequence number (replies which arrived through ST)
+  if (earliest == replies_.cend()) earliest = replies_.cbegin();
+  earliestReplyId = earliest->first;
+  earliestTime = earliest->second;
+  replies_.erase(earliest);
+  ids_.remove(earliestReplyId);
   LOG_DEBUG(CL_MNGR,
             "Deleted reply message" << KVLOG(
-                clientId, earliestReplyId, earliestTime.time_since_epoch().count(), repliesMap_.size()));
+                clientId, earliestReplyId, earliestTime.time_since_epoch().count(), replies_.size()));
 }
 
 bool ClientsManager::RepliesInfo::insertOrAssignSafe(ReqId reqSeqNum, Time time) {
-  const lock_guard<mutex> lock(repliesMapMutex_);
-  return repliesMap_.insert_or_assign(reqSeqNum, time).second;
+  const lock_guard<mutex> lock(*mutex_);
+  auto it = std::lower_bound(
+      replies_.begin(), replies_.end(), reqSeqNum, [](const auto& reply, ReqId id) { return reply.first < id; });
+  if (it != replies_.end() && it->first == reqSeqNum) {
+    it->second = time;
+    return false;
+  }
+  replies_.emplace(it, reqSeqNum, time);
+  ids_.add(reqSeqNum);
+  return true;
 }
 
-bool ClientsManager::RepliesInfo::findSafe(ReqId reqSeqNum) {
-  const lock_guard<mutex> lock(repliesMapMutex_);
-  return (repliesMap_.find(reqSeqNum) != repliesMap_.end());
+bool ClientsManager::RepliesInfo::findSafe(ReqId reqSeqNum) const {
+  switch (ids_.find(reqSeqNum)) {
+    case ReqIdSlots::Lookup::FOUND:
+      return true;
+    case ReqIdSlots::Lookup::NOT_FOUND:
+      return false;
+    case ReqIdSlots::Lookup::UNKNOWN:
+      break;
+  }
+  const lock_guard<mutex> lock(*mutex_);
+  return find(reqSeqNum);
 }
 
-bool ClientsManager::RepliesInfo::find(ReqId reqSeqNum) const {
-  return (repliesMap_.find(reqSeqNum) != repliesMap_.end());
-}
+bool ClientsManager::RepliesInfo::find(ReqId reqSeqNum) const { return lookup(reqSeqNum) != replies_.cend(); }
 
 /*************************** Class ClientsManager ***************************/
 
@@ -205,30 +303,34 @@ ClientsManager::ClientsManager(const std::set<NodeIdType>& proxyClients,
       maxReplySize_(ReplicaConfig::instance().getmaxReplyMessageSize()),
       maxNumOfReqsPerClient_(
           ReplicaConfig::instance().clientBatchingEnabled ? ReplicaConfig::instance().clientBatchingMaxMsgsNbr : 1),
+      maxCachedRepliesSize_(ReplicaConfig::instance().clientRepliesCacheSizeBytes),
       metrics_(metrics),
       metric_reply_inconsistency_detected_{metrics_.RegisterCounter("totalReplyInconsistenciesDetected")},
-      metric_removed_due_to_out_of_boundaries_{metrics_.RegisterCounter("totalRemovedDueToOutOfBoundaries")} {
+      metric_removed_due_to_out_of_boundaries_{metrics_.RegisterCounter("totalRemovedDueToOutOfBoundaries")},
+      metric_reply_cache_hits_{metrics_.RegisterCounter("totalReplyCacheHits")},
+      metric_reply_cache_misses_{metrics_.RegisterCounter("totalReplyCacheMisses")} {
   reservedPagesPerClient_ = reservedPagesPerClient(sizeOfReservedPage(), maxReplySize_);
+  std::set<NodeIdType> clientIds;
   for (NodeIdType i = 0; i < ReplicaConfig::instance().numReplicas + ReplicaConfig::instance().numRoReplicas; i++) {
-    clientIds_.insert(i);
-  }
-  clientIds_.insert(proxyClients_.begin(), proxyClients_.end());
-  clientIds_.insert(externalClients_.begin(), externalClients_.end());
-  clientIds_.insert(clientServices_.begin(), clientServices_.end());
-  clientIds_.insert(internalClients_.begin(), internalClients_.end());
-  ConcordAssert(clientIds_.size() >= 1);
-  uint32_t rpage = 0;
-  for (const auto cid : clientIds_) {
-    clientIdsToReservedPages_.emplace(cid, rpage);
-    rpage++;
-  }
-  // For the benefit of code accessing clientsInfo_, pre-fill clientsInfo_ with a blank entry for each client to reduce
-  // ambiguity between invalid client IDs and valid client IDs for which nothing stored in clientsInfo_ has been loaded
-  // so far.
-  for (const auto& client_id : clientIds_) {
-    clientsInfo_.emplace(client_id, ClientInfo());
-    clientsInfo_[client_id].requestsInfo = make_shared<RequestsInfo>();
-    clientsInfo_[client_id].repliesInfo = make_shared<RepliesInfo>();
+    clientIds.insert(i);
+  }
+  clientIds.insert(proxyClients_.begin(), proxyClients_.end());
+  clientIds.insert(externalClients_.begin(), externalClients_.end());
+  clientIds.insert(clientServices_.begin(), clientServices_.end());
+  clientIds.insert(internalClients_.begin(), internalClients_.end());
+  ConcordAssert(clientIds.size() >= 1);
+  // The slot of a client is its index in the sorted client IDs, which is also its index in the reserved pages
+  clientIds_.assign(clientIds.begin(), clientIds.end());
+  clientIdToSlot_.assign(static_cast<size_t>(clientIds_.back()) + 1, kInvalidClientSlot);
+  clientsInfo_ = std::vector<ClientInfo>(clientIds_.size());
+  for (uint32_t slot = 0; slot < clientIds_.size(); ++slot) {
+    const auto clientId = clientIds_[slot];
+    clientIdToSlot_[clientId] = slot;
+    auto& info = clientsInfo_[slot];
+    auto* lock = &clientLocks_[slot % kClientLockStripes];
+    info.requestsInfo.init(lock, maxNumOfReqsPerClient_);
+    info.repliesInfo.init(lock, maxNumOfReqsPerClient_);
+    info.internal = internalClients_.find(clientId) != internalClients_.end();
   }
 
   LOG_INFO(
@@ -236,7 +338,17 @@ ClientsManager::ClientsManager(const std::set<NodeIdType>& proxyClients,
       "proxy clients: " << concord::util::toString(proxyClients_, " ")
                         << "external clients: " << concord::util::toString(externalClients_, " ")
                         << "internal clients: " << concord::util::toString(internalClients_, " ")
-                        << KVLOG(sizeOfReservedPage(), reservedPagesPerClient_, maxReplySize_, maxNumOfReqsPerClient_));
+                        << KVLOG(sizeOfReservedPage(),
+                                 reservedPagesPerClient_,
+                                 maxReplySize_,
+                                 maxNumOfReqsPerClient_,
+                                 maxCachedRepliesSize_));
+}
+
+uint32_t ClientsManager::checkedClientSlot(NodeIdType clientId) const {
+  const auto slot = clientSlot(clientId);
+  if (slot == kInvalidClientSlot) throw std::out_of_range("Invalid client ID: " + std::to_string(clientId));
+  return slot;
 }
 
 uint32_t ClientsManager::reservedPagesPerClient(const uint32_t& sizeOfReservedPage, const uint32_t& maxReplySize) {
@@ -249,15 +361,21 @@ uint32_t ClientsManager::reservedPagesPerClient(const uint32_t& sizeOfReservedPa
 }
 
 // Per client:
+// * drop the cached reply, the reserved pages may have been replaced (e.g. by state transfer)
 // * load public key
 // * load page of the reply header
 // * fill clientInfo
 // * remove pending request if loaded reply is newer
 void ClientsManager::loadInfoFromReservedPages() {
+  {
+    const std::lock_guard<std::mutex> lock(cachedRepliesLock_);
+    while (!cachedReplySlots_.empty()) dropCachedReply(cachedReplySlots_.front());
+    for (auto& info : clientsInfo_) info.savedReplyVersion++;
+  }
   for (auto const& clientId : clientIds_) {
-    if (internalClients_.find(clientId) != internalClients_.end()) continue;
+    auto& info = clientInfo(clientId);
+    if (info.internal) continue;
     if (loadReservedPage(getKeyPageId(clientId), sizeOfReservedPage(), scratchPage_.data())) {
-      auto& info = clientsInfo_[clientId];
       std::istringstream iss(scratchPage_);
       concord::serialize::Serializable::deserialize(iss, info.pubKey);
       ConcordAssertGT(info.pubKey.first.length(), 0);
@@ -271,26 +389,26 @@ void ClientsManager::loadInfoFromReservedPages() {
     ConcordAssert(replyHeader->replyLength >= 0);
     ConcordAssert(replyHeader->replyLength + sizeof(ClientReplyMsgHeader) <= maxReplySize_);
 
-    clientsInfo_[clientId].repliesInfo->deleteOldestReplyIfNeededSafe(clientId, maxNumOfReqsPerClient_);
-    const auto& res = clientsInfo_[clientId].repliesInfo->insertOrAssignSafe(replyHeader->reqSeqNum, MinTime);
+    info.repliesInfo.deleteOldestReplyIfNeededSafe(clientId, maxNumOfReqsPerClient_);
+    const auto& res = info.repliesInfo.insertOrAssignSafe(replyHeader->reqSeqNum, MinTime);
     LOG_INFO(CL_MNGR, "Added/updated reply message" << KVLOG(clientId, replyHeader->reqSeqNum, res));
-    clientsInfo_[clientId].requestsInfo->removeOldPendingReqsSafe(clientId, replyHeader->reqSeqNum);
+    info.requestsInfo.removeOldPendingReqsSafe(clientId, replyHeader->reqSeqNum);
   }
 }
 
 bool ClientsManager::hasReply(NodeIdType clientId, ReqId reqSeqNum) {
-  try {
-    const bool found = clientsInfo_.at(clientId).repliesInfo->findSafe(reqSeqNum);
-    if (found) LOG_DEBUG(CL_MNGR, "Reply found for" << KVLOG(clientId, reqSeqNum));
-    return found;
-  } catch (const std::out_of_range& e) {
+  const auto slot = clientSlot(clientId);
+  if (slot == kInvalidClientSlot) {
     LOG_DEBUG(CL_MNGR, "No info found for client" << KVLOG(clientId, reqSeqNum));
     return false;
   }
+  const bool found = clientsInfo_[slot].repliesInfo.findSafe(reqSeqNum);
+  if (found) LOG_DEBUG(CL_MNGR, "Reply found for" << KVLOG(clientId, reqSeqNum));
+  return found;
 }
 
 void ClientsManager::deleteOldestReply(NodeIdType clientId) {
-  clientsInfo_[clientId].repliesInfo->deleteOldestReplyIfNeededSafe(clientId, maxNumOfReqsPerClient_);
+  clientInfo(clientId).repliesInfo.deleteOldestReplyIfNeededSafe(clientId, maxNumOfReqsPerClient_);
 }
 
 // Reference the ClientInfo of the corresponding client:
@@ -306,8 +424,9 @@ std::unique_ptr<ClientReplyMsg> ClientsManager::allocateNewReplyMsgAndWriteToSto
                                                                                      uint32_t replyLength,
                                                                                      uint32_t rsiLength,
                                                                                      uint32_t executionResult) {
-  clientsInfo_[clientId].repliesInfo->deleteOldestReplyIfNeededSafe(clientId, maxNumOfReqsPerClient_);
-  clientsInfo_[clientId].repliesInfo->insertOrAssignSafe(requestSeqNum, getMonotonicTime());
+  auto& info = clientInfo(clientId);
+  info.repliesInfo.deleteOldestReplyIfNeededSafe(clientId, maxNumOfReqsPerClient_);
+  info.repliesInfo.insertOrAssignSafe(requestSeqNum, getMonotonicTime());
   LOG_DEBUG(CL_MNGR, KVLOG(clientId, requestSeqNum));
   auto r = std::make_unique<ClientReplyMsg>(myId_, requestSeqNum, reply, replyLength - rsiLength, executionResult);
 
@@ -328,6 +447,12 @@ std::unique_ptr<ClientReplyMsg> ClientsManager::allocateNewReplyMsgAndWriteToSto
   }
 
   LOG_DEBUG(CL_MNGR, KVLOG(clientId, requestSeqNum, numOfPages, sizeLastPage));
+  const auto slot = checkedClientSlot(clientId);
+  {
+    const std::lock_guard<std::mutex> lock(cachedRepliesLock_);
+    dropCachedReply(slot);
+    clientsInfo_[slot].savedReplyVersion++;
+  }
   // write reply message to reserved pages
   const uint32_t firstPageId = getReplyFirstPageId(clientId);
   for (uint32_t i = 0; i < numOfPages; i++) {
@@ -335,6 +460,11 @@ std::unique_ptr<ClientReplyMsg> ClientsManager::allocateNewReplyMsgAndWriteToSto
     const uint32_t sizePage = ((i < numOfPages - 1) ? sizeOfReservedPage() : sizeLastPage);
     saveReservedPage(firstPageId + i, sizePage, ptrPage);
   }
+  {
+    const std::lock_guard<std::mutex> lock(cachedRepliesLock_);
+    clientsInfo_[slot].savedReplyVersion++;
+    cacheReply(slot, r->body(), commonMsgSize);
+  }
   // now save the RSI in the rsiManager, if this ClientsManager has one.
   if (rsiManager_) {
     rsiManager_->setRsiForClient(clientId, requestSeqNum, std::string(reply + commonMsgSize, rsiLength));
@@ -348,15 +478,30 @@ std::unique_ptr<ClientReplyMsg> ClientsManager::allocateNewReplyMsgAndWriteToSto
   return r;
 }
 
+// * copy the cached reply to a new ClientReplyMsg, if there is one. Otherwise:
 // * load client reserve page to scratchPage
 // * cast to ClientReplyMsgHeader and validate.
 // * calculate: reply msg size, num of pages, size of last page.
 // * allocate new ClientReplyMsg.
-// * copy reply from reserved pages to ClientReplyMsg.
-// * set primary id.
-std::unique_ptr<ClientReplyMsg> ClientsManager::allocateReplyFromSavedOne(NodeIdType clientId,
-                                                                          ReqId requestSeqNum,
-                                                                          uint16_t currentPrimaryId) {
+// * copy reply from reserved pages to ClientReplyMsg, and cache it.
+std::unique_ptr<ClientReplyMsg> ClientsManager::loadSavedReply(NodeIdType clientId, ReqId requestSeqNum) {
+  const auto slot = checkedClientSlot(clientId);
+  uint64_t savedReplyVersion = 0;
+  {
+    const std::lock_guard<std::mutex> lock(cachedRepliesLock_);
+    savedReplyVersion = clientsInfo_[slot].savedReplyVersion;
+    const auto& cachedReply = clientsInfo_[slot].cachedReply;
+    if (!cachedReply.empty()) {
+      metric_reply_cache_hits_++;
+      const auto* replyHeader = reinterpret_cast<const ClientReplyMsgHeader*>(cachedReply.data());
+      auto r = std::make_unique<ClientReplyMsg>(myId_, replyHeader->replyLength, replyHeader->result);
+      memcpy(r->body(), cachedReply.data(), cachedReply.size());
+      LOG_DEBUG(CL_MNGR, "Reply found in cache" << KVLOG(clientId, requestSeqNum));
+      return r;
+    }
+  }
+  metric_reply_cache_misses_++;
+
   const uint32_t firstPageId = getReplyFirstPageId(clientId);
   LOG_DEBUG(CL_MNGR, KVLOG(clientId, requestSeqNum, firstPageId));
   loadReservedPage(firstPageId, sizeOfReservedPage(), scratchPage_.data());
@@ -383,6 +528,20 @@ std::unique_ptr<ClientReplyMsg> ClientsManager::allocateReplyFromSavedOne(NodeId
     const uint32_t sizePage = ((i < numOfPages - 1) ? sizeOfReservedPage() : sizeLastPage);
     loadReservedPage(firstPageId + i, sizePage, ptrPage);
   }
+  {
+    const std::lock_guard<std::mutex> lock(cachedRepliesLock_);
+    if (clientsInfo_[slot].savedReplyVersion == savedReplyVersion) cacheReply(slot, r->body(), replyMsgSize);
+  }
+  return r;
+}
+
+// * load the saved reply.
+// * add the RSI data.
+// * set primary id.
+std::unique_ptr<ClientReplyMsg> ClientsManager::allocateReplyFromSavedOne(NodeIdType clientId,
+                                                                          ReqId requestSeqNum,
+                                                                          uint16_t currentPrimaryId) {
+  auto r = loadSavedReply(clientId, requestSeqNum);
 
   // Load the RSI data from persistent storage, if an RSI manager is in use.
   if (rsiManager_) {
@@ -416,11 +575,29 @@ std::unique_ptr<ClientReplyMsg> ClientsManager::allocateReplyFromSavedOne(NodeId
   return r;
 }
 
+void ClientsManager::cacheReply(uint32_t slot, const char* reply, uint32_t size) {
+  dropCachedReply(slot);
+  if (size > maxCachedRepliesSize_) return;
+  while (cachedRepliesSize_ + size > maxCachedRepliesSize_) dropCachedReply(cachedReplySlots_.front());
+  auto& info = clientsInfo_[slot];
+  info.cachedReply.assign(reply, size);
+  info.cachedReplyIt = cachedReplySlots_.insert(cachedReplySlots_.end(), slot);
+  cachedRepliesSize_ += size;
+}
+
+void ClientsManager::dropCachedReply(uint32_t slot) {
+  auto& info = clientsInfo_[slot];
+  if (info.cachedReply.empty()) return;
+  cachedRepliesSize_ -= info.cachedReply.size();
+  cachedReplySlots_.erase(info.cachedReplyIt);
+  std::string().swap(info.cachedReply);
+}
+
 void ClientsManager::setClientPublicKey(NodeIdType clientId,
                                         const std::string& key,
                                         concord::util::crypto::KeyFormat fmt) {
   LOG_INFO(CL_MNGR, "key: " << key << " fmt: " << (uint16_t)fmt << " client: " << clientId);
-  ClientInfo& info = clientsInfo_[clientId];
+  ClientInfo& info = clientInfo(clientId);
   info.pubKey = std::make_pair(key, fmt);
   std::string page(sizeOfReservedPage(), 0);
   std::ostringstream oss(page);
@@ -429,58 +606,59 @@ void ClientsManager::setClientPublicKey(NodeIdType clientId,
 }
 
 bool ClientsManager::isClientRequestInProcess(NodeIdType clientId, ReqId reqSeqNum) {
-  try {
-    const bool found = clientsInfo_.at(clientId).requestsInfo->findSafe(reqSeqNum);
-    if (found) LOG_DEBUG(CL_MNGR, "The request is executing right now" << KVLOG(clientId, reqSeqNum));
-    return found;
-  } catch (const std::out_of_range& e) {
+  const auto slot = clientSlot(clientId);
+  if (slot == kInvalidClientSlot) {
     LOG_DEBUG(CL_MNGR, "No info found for client" << KVLOG(clientId, reqSeqNum));
     return false;
   }
+  const bool found = clientsInfo_[slot].requestsInfo.findSafe(reqSeqNum);
+  if (found) LOG_DEBUG(CL_MNGR, "The request is executing right now" << KVLOG(clientId, reqSeqNum));
+  return found;
 }
 
 bool ClientsManager::isPending(NodeIdType clientId, ReqId reqSeqNum) const {
-  try {
-    return clientsInfo_.at(clientId).requestsInfo->isPending(reqSeqNum);
-  } catch (const std::out_of_range& e) {
+  const auto slot = clientSlot(clientId);
+  if (slot == kInvalidClientSlot) {
     LOG_DEBUG(CL_MNGR, "No info found for client" << KVLOG(clientId, reqSeqNum));
     return false;
   }
+  return clientsInfo_[slot].requestsInfo.isPending(reqSeqNum);
 }
 
 // Check that:
 // * max number of pending requests not reached for that client.
 // * request seq number is bigger than the last reply seq number.
 bool ClientsManager::canBecomePending(NodeIdType clientId, ReqId reqSeqNum) const {
-  try {
-    ReqId requestsNum = clientsInfo_.at(clientId).requestsInfo->size();
-    if (requestsNum == maxNumOfReqsPerClient_) {
-      LOG_DEBUG(CL_MNGR,
-                "Maximum number of requests per client reached" << KVLOG(maxNumOfReqsPerClient_, clientId, reqSeqNum));
-      return false;
-    }
-    if (clientsInfo_.at(clientId).requestsInfo->find(reqSeqNum)) {
-      LOG_DEBUG(CL_MNGR, "The request is executing right now" << KVLOG(clientId, reqSeqNum));
-      return false;
-    }
-    if (clientsInfo_.at(clientId).repliesInfo->find(reqSeqNum)) {
-      LOG_DEBUG(CL_MNGR, "The request has been already executed" << KVLOG(clientId, reqSeqNum));
-      return false;
-    }
-    LOG_DEBUG(CL_MNGR, "The request can become pending" << KVLOG(clientId, reqSeqNum, requestsNum));
-    return true;
-  } catch (const std::out_of_range& e) {
+  const auto slot = clientSlot(clientId);
+  if (slot == kInvalidClientSlot) {
     LOG_DEBUG(CL_MNGR, "No info found for client" << KVLOG(clientId, reqSeqNum));
     return false;
   }
+  const auto& info = clientsInfo_[slot];
+  ReqId requestsNum = info.requestsInfo.size();
+  if (requestsNum == maxNumOfReqsPerClient_) {
+    LOG_DEBUG(CL_MNGR,
+              "Maximum number of requests per client reached" << KVLOG(maxNumOfReqsPerClient_, clientId, reqSeqNum));
+    return false;
+  }
+  if (info.requestsInfo.find(reqSeqNum)) {
+    LOG_DEBUG(CL_MNGR, "The request is executing right now" << KVLOG(clientId, reqSeqNum));
+    return false;
+  }
+  if (info.repliesInfo.find(reqSeqNum)) {
+    LOG_DEBUG(CL_MNGR, "The request has been already executed" << KVLOG(clientId, reqSeqNum));
+    return false;
+  }
+  LOG_DEBUG(CL_MNGR, "The request can become pending" << KVLOG(clientId, reqSeqNum, requestsNum));
+  return true;
 }
 
 void ClientsManager::addPendingRequest(NodeIdType clientId, ReqId reqSeqNum, const std::string& cid) {
-  clientsInfo_[clientId].requestsInfo->emplaceSafe(clientId, reqSeqNum, cid);
+  clientInfo(clientId).requestsInfo.emplaceSafe(clientId, reqSeqNum, cid);
 }
 
 void ClientsManager::markRequestAsCommitted(NodeIdType clientId, ReqId reqSeqNum) {
-  clientsInfo_[clientId].requestsInfo->markRequestAsCommitted(clientId, reqSeqNum);
+  clientInfo(clientId).requestsInfo.markRequestAsCommitted(clientId, reqSeqNum);
 }
 
 /*
@@ -492,17 +670,17 @@ void ClientsManager::markRequestAsCommitted(NodeIdType clientId, ReqId reqSeqNum
  * that we shouldn't have more than maxNumOfRequestsInBatch. Thus, we can safely remove them from the client manager.
  */
 void ClientsManager::removeRequestsOutOfBatchBounds(NodeIdType clientId, ReqId reqSequenceNum) {
-  if (clientsInfo_[clientId].requestsInfo->removeRequestsOutOfBatchBoundsSafe(clientId, reqSequenceNum))
+  if (clientInfo(clientId).requestsInfo.removeRequestsOutOfBatchBoundsSafe(clientId, reqSequenceNum))
     metric_removed_due_to_out_of_boundaries_++;
 }
 
 void ClientsManager::removePendingForExecutionRequest(NodeIdType clientId, ReqId reqSeqNum) {
   if (!isValidClient(clientId)) return;
-  clientsInfo_[clientId].requestsInfo->removePendingForExecutionRequestSafe(clientId, reqSeqNum);
+  clientInfo(clientId).requestsInfo.removePendingForExecutionRequestSafe(clientId, reqSeqNum);
 }
 
 void ClientsManager::clearAllPendingRequests() {
-  for (auto& clientInfo : clientsInfo_) clientInfo.second.requestsInfo->clearSafe();
+  for (auto& info : clientsInfo_) info.requestsInfo.clearSafe();
   LOG_DEBUG(CL_MNGR, "Cleared pending requests for all clients");
 }
 
@@ -510,8 +688,8 @@ void ClientsManager::clearAllPendingRequests() {
 Time ClientsManager::infoOfEarliestPendingRequest(std::string& cid) const {
   Time earliestTime = MaxTime;
   RequestInfo earliestPendingReqInfo{MaxTime, std::string()};
-  for (const auto& clientInfo : clientsInfo_)
-    clientInfo.second.requestsInfo->infoOfEarliestPendingRequest(earliestTime, earliestPendingReqInfo);
+  for (const auto& info : clientsInfo_)
+    info.requestsInfo.infoOfEarliestPendingRequest(earliestTime, earliestPendingReqInfo);
   cid = earliestPendingReqInfo.cid;
   if (earliestPendingReqInfo.time != MaxTime) LOG_DEBUG(CL_MNGR, "Earliest pending request: " << KVLOG(cid));
   return earliestPendingReqInfo.time;
@@ -520,15 +698,16 @@ Time ClientsManager::infoOfEarliestPendingRequest(std::string& cid) const {
 // Iterate over all clients and log the ones that have not been committed for more than threshold milliseconds.
 void ClientsManager::logAllPendingRequestsExceedingThreshold(const int64_t threshold, const Time& currTime) const {
   int numExceeding = 0;
-  for (const auto& clientInfo : clientsInfo_)
-    clientInfo.second.requestsInfo->logAllPendingRequestsExceedingThreshold(threshold, currTime, numExceeding);
+  for (const auto& info : clientsInfo_)
+    info.requestsInfo.logAllPendingRequestsExceedingThreshold(threshold, currTime, numExceeding);
   if (numExceeding) {
     LOG_INFO(CL_MNGR, "Total Client request with more than " << threshold << "ms delay: " << numExceeding);
   }
 }
 
 bool ClientsManager::isInternal(NodeIdType clientId) const {
-  return internalClients_.find(clientId) != internalClients_.end();
+  const auto slot = clientSlot(clientId);
+  return slot != kInvalidClientSlot && clientsInfo_[slot].internal;
 }
 
 }  // namespace bftEngine::impl
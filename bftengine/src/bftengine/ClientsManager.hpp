@@ -19,12 +19,16 @@
 #include "bftengine/IKeyExchanger.hpp"
 #include "PersistentStorage.hpp"
 #include "ReplicaSpecificInfoManager.hpp"
+#include <array>
+#include <atomic>
+#include <limits>
+#include <list>
 #include <mutex>
 #include <map>
 #include <set>
-#include <unordered_map>
 #include <memory>
 #include <queue>
+#include <vector>
 
 namespace bftEngine {
 class IStateTransfer;
@@ -36,7 +40,9 @@ class ClientRequestMsg;
 // Keeps track of Client IDs, public keys, and pending requests and replies. Supports saving and loading client public
 // keys and pending reply messages to the reserved pages mechanism.
 //
-// Not thread-safe.
+// Clients are kept in dense arrays indexed by a client slot, which is also the index of the client's reserved pages.
+// hasReply() and isClientRequestInProcess() may be called concurrently with the other methods, which are not
+// thread-safe.
 class ClientsManager : public ResPagesClient<ClientsManager>, public IPendingRequest, public IClientPublicKeyStore {
  public:
   // As preconditions to this constructor:
@@ -86,7 +92,7 @@ class ClientsManager : public ResPagesClient<ClientsManager>, public IPendingReq
   // not make sense (too high) - this will prevent some potential attacks)
   bool hasReply(NodeIdType clientId, ReqId reqSeqNum);
 
-  bool isValidClient(NodeIdType clientId) const { return clientIds_.find(clientId) != clientIds_.end(); }
+  bool isValidClient(NodeIdType clientId) const { return clientSlot(clientId) != kInvalidClientSlot; }
 
   // First, if this ClientsManager has a number of reply records for the given clientId equalling or exceeding the
   // maximum client batch size configured at the time of this ClientManager's construction (or 1 if client batching was
@@ -109,9 +115,11 @@ class ClientsManager : public ResPagesClient<ClientsManager>, public IPendingReq
                                                                        uint32_t executionResult = 0);
 
   // Loads a client reply message from the reserved pages, and allocates and returns a ClientReplyMsg containing the
-  // loaded message. Returns a null pointer if the configuration recorded at the time of this ClientManager's
-  // construction enabled client batching with a maximum batch size greater than 1 and the message loaded from the
-  // reserved pages has a sequence number not matching requestSeqNum. Behavior is undefined for all of the following
+  // loaded message. The latest reply of each client is also kept in memory, within the clientRepliesCacheSizeBytes
+  // budget, so a retransmission is usually answered without reading the reserved pages. Returns a null pointer if the
+  // configuration recorded at the time of this ClientManager's construction enabled client batching with a maximum
+  // batch size greater than 1 and the message loaded from the reserved pages has a sequence number not matching
+  // requestSeqNum. Behavior is undefined for all of the following
   // cases:
   // - clientId does not belong to a valid client.
   // - The reserved pages do not contain client reply message data of the expected format for clientId.
@@ -198,12 +206,21 @@ class ClientsManager : public ResPagesClient<ClientsManager>, public IPendingReq
   bool isInternal(NodeIdType clientId) const;
 
  protected:
+  static constexpr uint32_t kInvalidClientSlot = std::numeric_limits<uint32_t>::max();
+  // Number of locks shared by the clients; the lock of a client is picked by its slot
+  static constexpr size_t kClientLockStripes = 64;
+
   uint32_t getReplyFirstPageId(NodeIdType clientId) const { return getKeyPageId(clientId) + 1; }
 
-  uint32_t getKeyPageId(NodeIdType clientId) const {
-    return clientIdsToReservedPages_.at(clientId) * reservedPagesPerClient_;
+  uint32_t getKeyPageId(NodeIdType clientId) const { return checkedClientSlot(clientId) * reservedPagesPerClient_; }
+
+  uint32_t clientSlot(NodeIdType clientId) const {
+    return clientId < clientIdToSlot_.size() ? clientIdToSlot_[clientId] : kInvalidClientSlot;
   }
 
+  // Throws std::out_of_range if clientId does not belong to a valid client.
+  uint32_t checkedClientSlot(NodeIdType clientId) const;
+
   const ReplicaId myId_;
 
   std::string scratchPage_;
@@ -219,16 +236,41 @@ class ClientsManager : public ResPagesClient<ClientsManager>, public IPendingReq
     bool committed = false;
   };
 
+  // The sequence numbers of one client's requests or replies, readable without the client's lock. Up to capacity
+  // sequence numbers are kept in atomic slots which a reader scans. Any sequence number beyond that is only counted,
+  // and a reader which misses the slots while the count is not zero has to fall back to a locked lookup.
+  // Modified only under the client's lock.
+  class ReqIdSlots {
+   public:
+    enum class Lookup { FOUND, NOT_FOUND, UNKNOWN };
+
+    void init(size_t capacity);
+    // The caller keeps track of the ids: add() only ids which are not there yet, remove() only ids which are.
+    void add(ReqId reqSeqNum);
+    void remove(ReqId reqSeqNum);
+    void clear();
+    Lookup find(ReqId reqSeqNum) const;
+
+   private:
+    static constexpr ReqId kEmptySlot = std::numeric_limits<ReqId>::max();
+
+    size_t capacity_ = 0;
+    std::unique_ptr<std::atomic<ReqId>[]> slots_;
+    std::atomic<uint32_t> overflow_{0};
+  };
+
   class RequestsInfo {
    public:
+    void init(std::mutex* mutex, size_t capacity);
+
     void emplaceSafe(NodeIdType clientId, ReqId reqSeqNum, const std::string& cid);
     bool removeRequestsOutOfBatchBoundsSafe(NodeIdType clientId, ReqId reqSequenceNum);
-    bool findSafe(ReqId reqSeqNum);
+    bool findSafe(ReqId reqSeqNum) const;
     void clearSafe();
     void removeOldPendingReqsSafe(NodeIdType clientId, ReqId reqSeqNum);
     void removePendingForExecutionRequestSafe(NodeIdType clientId, ReqId reqSeqNum);
 
-    size_t size() const { return requestsMap_.size(); }
+    size_t size() const { return requests_.size(); }
     bool find(ReqId reqSeqNum) const;
     bool isPending(ReqId reqSeqNum) const;
     void markRequestAsCommitted(NodeIdType clientId, ReqId reqSeqNum);
@@ -237,42 +279,85 @@ class ClientsManager : public ResPagesClient<ClientsManager>, public IPendingReq
                                                  const Time& currTime,
                                                  int& numExceeding) const;
 
-   public:
-    std::mutex requestsMapMutex_;
-    std::map<ReqId, RequestInfo> requestsMap_;
+   private:
+    using Requests = std::vector<std::pair<ReqId, RequestInfo>>;
+    Requests::iterator lookup(ReqId reqSeqNum);
+    Requests::const_iterator lookup(ReqId reqSeqNum) const;
+
+    std::mutex* mutex_ = nullptr;
+    // Sorted by sequence number. A client has only a few requests in process, so a flat vector beats a tree here.
+    Requests requests_;
+    ReqIdSlots ids_;
   };
 
   class RepliesInfo {
    public:
+    void init(std::mutex* mutex, size_t capacity);
+
     void deleteOldestReplyIfNeededSafe(NodeIdType clientId, uint16_t maxNumOfReqsPerClient);
     bool insertOrAssignSafe(ReqId reqSeqNum, Time time);
-    bool findSafe(ReqId reqSeqNum);
+    bool findSafe(ReqId reqSeqNum) const;
 
     bool find(ReqId reqSeqNum) const;
 
-   public:
-    std::mutex repliesMapMutex_;
-    std::map<ReqId, Time> repliesMap_;
+   private:
+    using Replies = std::vector<std::pair<ReqId, Time>>;
+    Replies::const_iterator lookup(ReqId reqSeqNum) const;
+
+    std::mutex* mutex_ = nullptr;
+    // Sorted by sequence number, at most maxNumOfReqsPerClient_ entries
+    Replies replies_;
+    ReqIdSlots ids_;
   };
 
   struct ClientInfo {
-    std::shared_ptr<RequestsInfo> requestsInfo;
-    std::shared_ptr<RepliesInfo> repliesInfo;
+    RequestsInfo requestsInfo;
+    RepliesInfo repliesInfo;
     std::pair<std::string, concord::util::crypto::KeyFormat> pubKey;
+    bool internal = false;
+    // A copy of the reply in the reserved pages of the client, exactly as saved there. Empty if not cached.
+    // Guarded by cachedRepliesLock_.
+    std::string cachedReply;
+    std::list<uint32_t>::iterator cachedReplyIt;
+    // Changed whenever the reply in the reserved pages may change, so that a reply loaded from the reserved pages
+    // concurrently is not cached over a newer one
+    uint64_t savedReplyVersion = 0;
   };
 
+  // Loads the reply saved for the client, from the cache if it is there. No RSI and no primary ID.
+  std::unique_ptr<ClientReplyMsg> loadSavedReply(NodeIdType clientId, ReqId requestSeqNum);
+
+  // Replaces the cached reply of the client, evicting the oldest cached replies if the cache is full. Called with
+  // cachedRepliesLock_ held, as is dropCachedReply().
+  void cacheReply(uint32_t slot, const char* reply, uint32_t size);
+  void dropCachedReply(uint32_t slot);
+
+  ClientInfo& clientInfo(NodeIdType clientId) { return clientsInfo_[checkedClientSlot(clientId)]; }
+  const ClientInfo& clientInfo(NodeIdType clientId) const { return clientsInfo_[checkedClientSlot(clientId)]; }
+
   std::set<NodeIdType> proxyClients_;
   std::set<NodeIdType> externalClients_;
   std::set<NodeIdType> clientServices_;
   std::set<NodeIdType> internalClients_;
-  std::set<NodeIdType> clientIds_;
-  std::map<NodeIdType, uint32_t> clientIdsToReservedPages_;
-  std::unordered_map<NodeIdType, ClientInfo> clientsInfo_;
+  // Sorted; the slot of a client is its index here
+  std::vector<NodeIdType> clientIds_;
+  // Client ID -> slot, kInvalidClientSlot for IDs which are not clients
+  std::vector<uint32_t> clientIdToSlot_;
+  // Indexed by slot
+  std::vector<ClientInfo> clientsInfo_;
+  std::array<std::mutex, kClientLockStripes> clientLocks_;
   const uint32_t maxReplySize_;
   const uint16_t maxNumOfReqsPerClient_;
+  const uint64_t maxCachedRepliesSize_;
+  std::mutex cachedRepliesLock_;
+  // Slots of the clients with a cached reply, in the order the replies were cached
+  std::list<uint32_t> cachedReplySlots_;
+  uint64_t cachedRepliesSize_ = 0;
   concordMetrics::Component& metrics_;
   concordMetrics::CounterHandle metric_reply_inconsistency_detected_;
   concordMetrics::CounterHandle metric_removed_due_to_out_of_boundaries_;
+  concordMetrics::CounterHandle metric_reply_cache_hits_;
+  concordMetrics::CounterHandle metric_reply_cache_misses_;
   std::unique_ptr<RsiDataManager> rsiManager_;
 };  // namespace impl
 
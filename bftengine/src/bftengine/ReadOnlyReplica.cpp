@@ -44,7 +44,9 @@ ReadOnlyReplica::ReadOnlyReplica(const ReplicaConfig &config,
       ro_metrics_{metrics_.RegisterCounter("receivedCheckpointMsgs"),
                   metrics_.RegisterCounter("sentAskForCheckpointMsgs"),
                   metrics_.RegisterCounter("receivedInvalidMsgs"),
-                  metrics_.RegisterGauge("lastExecutedSeqNum", lastExecutedSeqNum)},
+                  metrics_.RegisterGauge("lastExecutedSeqNum", lastExecutedSeqNum),
+                  metrics_.RegisterCounter("receivedReadOnlyRequests"),
+                  metrics_.RegisterCounter("droppedReadOnlyRequests")},
       metadataStorage_{metadataStorage} {
   LOG_INFO(GL, "Initialising ReadOnly Replica");
   repsInfo = new ReplicasInfo(config, dynamicCollectorForPartialProofs, dynamicCollectorForExecutionProofs);
@@ -73,6 +75,14 @@ ReadOnlyReplica::ReadOnlyReplica(const ReplicaConfig &config,
 }
 
 void ReadOnlyReplica::start() {
+  // The pool must exist before the communication starts delivering client requests
+  if (config_.numOfReadOnlyReplicaReadThreads > 0) {
+    using concord::util::WorkStealingExecutor;
+    readPool_ = std::make_unique<WorkStealingExecutor>(
+        WorkStealingExecutor::Config{"readOnlyReplicaReadPool", config_.numOfReadOnlyReplicaReadThreads});
+    if (aggregator_) readPool_->setAggregator(aggregator_);
+    LOG_INFO(GL, "Serving read-only requests" << KVLOG(config_.numOfReadOnlyReplicaReadThreads));
+  }
   ReplicaForStateTransfer::start();
   askForCheckpointMsgTimer_ = timers_.add(std::chrono::seconds(5),  // TODO [TK] config
                                           Timers::Timer::RECURRING,
@@ -84,6 +94,7 @@ void ReadOnlyReplica::start() {
 
 void ReadOnlyReplica::stop() {
   timers_.cancel(askForCheckpointMsgTimer_);
+  if (readPool_) readPool_->stop();
   ReplicaForStateTransfer::stop();
 }
 
@@ -198,18 +209,43 @@ void ReadOnlyReplica::onMessage<ClientRequestMsg>(ClientRequestMsg *m) {
   span.setTag("cid", m->getCid());
   span.setTag("seq_num", reqSeqNum);
 
-  // A read only replica can handle only reconfiguration requests. Those requests are signed by the operator and
-  // the validation is done in the reconfiguration engine. Thus, we don't need to check the client validity as in
-  // the committers
+  // Reconfiguration requests are signed by the operator and the validation is done in the reconfiguration engine.
+  // Thus, we don't need to check the client validity as in the committers
 
   if (reconfig_flag) {
     LOG_INFO(GL, "ro replica has received a reconfiguration request");
-    executeReadOnlyRequest(span, m);
+    executeReadOnlyRequest(span, *m);
+    delete m;
+    return;
+  }
+
+  // Other read-only requests are served only if a read pool is configured
+  if (!readPool_ || !m->isReadOnly()) {
+    delete m;
+    return;
+  }
+  if (!repsInfo->isIdOfClientProxy(clientId) && !repsInfo->isIdOfExternalClient(clientId)) {
+    onReportAboutInvalidMessage(m, "ClientRequestMsg is invalid. invalidClient: 1");
+    delete m;
+    return;
+  }
+  ro_metrics_.received_read_only_requests_++;
+  // The committers bound their deferred read-only requests by the same size
+  if (readPool_->numOfPendingTasks() >= config_.postExecutionQueuesSize * readPool_->numOfThreads()) {
+    ro_metrics_.dropped_read_only_requests_++;
+    LOG_DEBUG(GL, "Too many pending read-only requests, dropping. " << KVLOG(clientId, reqSeqNum));
     delete m;
     return;
   }
+  executeReadOnlyRequestAsync(std::move(span), std::unique_ptr<ClientRequestMsg>{m});
+}
 
-  delete m;
+void ReadOnlyReplica::executeReadOnlyRequestAsync(concordUtils::SpanWrapper &&span,
+                                                  std::unique_ptr<ClientRequestMsg> m) {
+  readPool_->submit([this, span = std::move(span), m = std::move(m)]() mutable {
+    SCOPED_MDC_CID(m->getCid());
+    executeReadOnlyRequest(span, *m);
+  });
 }
 
 void ReadOnlyReplica::executeReadOnlyRequest(concordUtils::SpanWrapper &parent_span, const ClientRequestMsg &request) {
@@ -222,8 +258,10 @@ void ReadOnlyReplica::executeReadOnlyRequest(concordUtils::SpanWrapper &parent_s
 
   int executionResult = 0;
   bftEngine::IRequestsHandler::ExecutionRequestsQueue accumulatedRequests;
+  // May run on a thread of the read pool, hence the atomic copy of the last executed sequence number
+  const SeqNum executedSeqNum = last_executed_seq_num_;
   accumulatedRequests.push_back(bftEngine::IRequestsHandler::ExecutionRequest{clientId,
-                                                                              static_cast<uint64_t>(lastExecutedSeqNum),
+                                                                              static_cast<uint64_t>(executedSeqNum),
                                                                               request.getCid(),
                                                                               request.flags(),
                                                                               request.requestLength(),
@@ -242,7 +280,7 @@ void ReadOnlyReplica::executeReadOnlyRequest(concordUtils::SpanWrapper &parent_s
   const uint32_t actualReplicaSpecificInfoLength = single_request.outReplicaSpecificInfoSize;
   LOG_DEBUG(GL,
             "Executed read only request. " << KVLOG(clientId,
-                                                    lastExecutedSeqNum,
+                                                    executedSeqNum,
                                                     request.requestLength(),
                                                     reply.maxReplyLength(),
                                                     actualReplyLength,
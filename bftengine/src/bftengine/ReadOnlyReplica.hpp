@@ -14,6 +14,9 @@
 #include "ReplicaForStateTransfer.hpp"
 #include "Timers.hpp"
 #include "CheckpointInfo.hpp"
+#include "WorkStealingExecutor.hpp"
+
+#include <memory>
 
 namespace bftEngine::impl {
 
@@ -55,6 +58,7 @@ class ReadOnlyReplica : public ReplicaForStateTransfer {
   void onMessage(T*);
 
   void executeReadOnlyRequest(concordUtils::SpanWrapper& parent_span, const ClientRequestMsg& m);
+  void executeReadOnlyRequestAsync(concordUtils::SpanWrapper&& span, std::unique_ptr<ClientRequestMsg> m);
   void persistCheckpointDescriptor(const SeqNum&, const CheckpointInfo<false>&);
 
  protected:
@@ -65,10 +69,16 @@ class ReadOnlyReplica : public ReplicaForStateTransfer {
     concordMetrics::CounterHandle sent_ask_for_checkpoint_msg_;
     concordMetrics::CounterHandle received_invalid_msg_;
     concordMetrics::GaugeHandle last_executed_seq_num_;
+    concordMetrics::CounterHandle received_read_only_requests_;
+    concordMetrics::CounterHandle dropped_read_only_requests_;
   } ro_metrics_;
 
   std::unique_ptr<MetadataStorage> metadataStorage_;
-  std::atomic<SeqNum> last_executed_seq_num_;
+  std::atomic<SeqNum> last_executed_seq_num_{0};
+
+  // Executes read-only client requests off the dispatcher thread and replies directly. Null if the replica only serves
+  // reconfiguration requests.
+  std::unique_ptr<concord::util::WorkStealingExecutor> readPool_;
 
  private:
   // This function serves as an ReplicaStatusHandlers alternative for ReadOnlyReplica. The reason to use this function
@@ -74,6 +74,21 @@ using namespace concord::diagnostics;
 
 namespace bftEngine::impl {
 
+namespace {
+// Reserved pages saved by the current thread while in scope are written lazily and flushed before the sequence number
+// is finalized
+class ReservedPagesWriteBack {
+ public:
+  ReservedPagesWriteBack(IStateTransfer &stateTransfer) : stateTransfer_{stateTransfer} {
+    stateTransfer_.beginReservedPagesWriteBack();
+  }
+  ~ReservedPagesWriteBack() { stateTransfer_.endReservedPagesWriteBack(); }
+
+ private:
+  IStateTransfer &stateTransfer_;
+};
+}  // namespace
+
 void ReplicaImp::registerMsgHandlers() {
   msgHandlers_->registerMsgHandler(MsgCode::Checkpoint,
                                    bind(&ReplicaImp::messageHandler<CheckpointMsg>, this, _1),
@@ -4569,6 +4584,8 @@ void ReplicaImp::start() {
   LOG_INFO(GL, "Running ReplicaImp");
   sigManager_->SetAggregator(aggregator_);
   KeyExchangeManager::instance().setAggregator(aggregator_);
+  internalThreadPool.setAggregator(aggregator_);
+  postExecThread_.setAggregator(aggregator_);
   ReplicaForStateTransfer::start();
 
   if (config_.timeServiceEnabled) {
@@ -4978,6 +4995,7 @@ void ReplicaImp::executeSpecialRequests(PrePrepareMsg *ppMsg,
 void ReplicaImp::executeRequests(PrePrepareMsg *ppMsg, Bitmap &requestSet, Timestamp time) {
   //   TimeRecorder scoped_timer(*histograms_.executeRequestsAndSendResponses);
   //  SCOPED_MDC("pp_msg_cid", ppMsg->getCid());
+  ReservedPagesWriteBack writeBack{*stateTransfer};
   auto pAccumulatedRequests =
       make_unique<IRequestsHandler::ExecutionRequestsQueue>();  // new IRequestsHandler::ExecutionRequestsQueue;
   size_t reqIdx = 0;
@@ -5068,18 +5086,21 @@ void ReplicaImp::finishExecutePrePrepareMsg(PrePrepareMsg *ppMsg,
                                             IRequestsHandler::ExecutionRequestsQueue *pAccumulatedRequests) {
   activeExecutions_ = 0;
 
-  if (pAccumulatedRequests != nullptr) {
-    sendResponses(ppMsg, *pAccumulatedRequests);
-    delete pAccumulatedRequests;
-  }
-  LOG_INFO(CNSUS, "Finished execution of request seqNum:" << ppMsg->seqNumber());
-  uint64_t checkpointNum{};
-  if ((lastExecutedSeqNum + 1) % checkpointWindowSize == 0) {
-    checkpointNum = (lastExecutedSeqNum + 1) / checkpointWindowSize;
-    stateTransfer->createCheckpointOfCurrentState(
-        checkpointNum);  // TODO(GG): should make sure that this operation is idempotent, even if it was partially
-                         // executed (because of the recovery)
-    checkpoint_times_.start(lastExecutedSeqNum);
+  {
+    ReservedPagesWriteBack writeBack{*stateTransfer};
+    if (pAccumulatedRequests != nullptr) {
+      sendResponses(ppMsg, *pAccumulatedRequests);
+      delete pAccumulatedRequests;
+    }
+    LOG_INFO(CNSUS, "Finished execution of request seqNum:" << ppMsg->seqNumber());
+    uint64_t checkpointNum{};
+    if ((lastExecutedSeqNum + 1) % checkpointWindowSize == 0) {
+      checkpointNum = (lastExecutedSeqNum + 1) / checkpointWindowSize;
+      stateTransfer->createCheckpointOfCurrentState(
+          checkpointNum);  // TODO(GG): should make sure that this operation is idempotent, even if it was partially
+                           // executed (because of the recovery)
+      checkpoint_times_.start(lastExecutedSeqNum);
+    }
   }
 
   finalizeExecution();
@@ -5113,6 +5134,9 @@ void ReplicaImp::finalizeExecution() {
 
   LOG_DEBUG(CNSUS, "Finalized execution. " << KVLOG(lastExecutedSeqNum + 1, getCurrentView(), lastStableSeqNum));
 
+  // The reserved pages saved while executing (e.g. client replies) must be durable before the sequence number is, as
+  // they are not saved again if the sequence number is not re-executed after a restart
+  stateTransfer->flushReservedPages();
   if (ps_) {
     ps_->beginWriteTran();
     ps_->setLastExecutedSeqNum(lastExecutedSeqNum + 1);
@@ -5335,6 +5359,7 @@ void ReplicaImp::executeRequestsInPrePrepareMsg(concordUtils::SpanWrapper &paren
   if (bftEngine::ControlStateManager::instance().getPruningProcessStatus()) {
     return;
   }
+  std::optional<ReservedPagesWriteBack> writeBack{std::in_place, *stateTransfer};
   auto span = concordUtils::startChildSpan("bft_execute_requests_in_preprepare", parent_span);
   if (!isCollectingState()) ConcordAssert(currentViewIsActive());
 
@@ -5435,6 +5460,11 @@ void ReplicaImp::executeRequestsInPrePrepareMsg(concordUtils::SpanWrapper &paren
 
   LOG_DEBUG(CNSUS, "Finalized execution. " << KVLOG(lastExecutedSeqNum + 1, getCurrentView(), lastStableSeqNum));
 
+  // Pages saved from here on are written through
+  writeBack.reset();
+  // The reserved pages saved while executing (e.g. client replies) must be durable before the sequence number is, as
+  // they are not saved again if the sequence number is not re-executed after a restart
+  stateTransfer->flushReservedPages();
   if (ps_) {
     ps_->beginWriteTran();
     ps_->setLastExecutedSeqNum(lastExecutedSeqNum + 1);
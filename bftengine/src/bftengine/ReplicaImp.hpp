@@ -12,6 +12,7 @@
 #pragma once
 
 #include <string>
+#include <queue>
 #include <utility>
 
 #include "ReplicaForStateTransfer.hpp"
@@ -84,7 +85,7 @@ class ReplicaImp : public InternalReplicaApi, public ReplicaForStateTransfer {
   bool restarted_ = false;
 
   // thread pool of this replica
-  concord::util::SimpleThreadPool internalThreadPool;  // TODO(GG): !!!! rename
+  concord::util::SimpleThreadPool internalThreadPool{"internalThreadPool"};  // TODO(GG): !!!! rename
 
   // retransmissions manager (can be disabled)
   RetransmissionsManager* retransmissionsManager = nullptr;
@@ -160,7 +161,7 @@ class ReplicaImp : public InternalReplicaApi, public ReplicaForStateTransfer {
   bool isSendCheckpointIfNeeded_ = false;
   bool isStartCollectingState_ = false;
   bool startedExecution = false;
-  concord::util::SimpleThreadPool postExecThread_;
+  concord::util::SimpleThreadPool postExecThread_{"postExecThread"};
 
   // bounded log used to store information about SeqNums in the range (lastStableSeqNum,lastStableSeqNum +
   // kWorkWindowSize]
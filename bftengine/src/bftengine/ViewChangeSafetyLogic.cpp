@@ -14,6 +14,8 @@
 #include "assertUtils.hpp"
 #include "Logger.hpp"
 #include "CryptoManager.hpp"
+#include "ReplicaConfig.hpp"
+#include "RequestThreadPool.hpp"
 #include <set>
 #include <unordered_map>
 
@@ -123,6 +125,12 @@ static bool checkSlowPathCertificates(std::set<SlowElem, SlowElemCompare>& slowP
   return true;
 }
 
+static std::string certificateKey(const Digest& d, const char* sig, uint16_t sigLen) {
+  std::string key(d.content(), DIGEST_SIZE);
+  key.append(sig, sigLen);
+  return key;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // ViewChangeSafetyLogic
 ///////////////////////////////////////////////////////////////////////////////
@@ -177,6 +185,9 @@ void ViewChangeSafetyLogic::computeRestrictions(ViewChangeMsg** const inViewChan
   const SeqNum lowerBound = inLBStableForView + 1;
   const SeqNum upperBound = inLBStableForView + kWorkWindowSize;
 
+  // results below the lower bound will not be needed again
+  dropCertificatesBelow(lowerBound);
+
   SeqNum lastRestcitionNum = 0;
 
   // TODO(GG): optimize the restricted range (e.g., add lastPrepared to each VC - the max of all VC msgs can be used as
@@ -280,8 +291,7 @@ bool ViewChangeSafetyLogic::computeRestrictionsForSeqNum(SeqNum s,
     Digest d;
     Digest::calcCombination(slow.prePrepreDigest(), slow.certificateView(), slow.seqNum(), d);
 
-    bool valid = CryptoManager::instance().thresholdVerifierForSlowPathCommit(s)->verify(
-        d.content(), DIGEST_SIZE, slow.certificateSig(), slow.certificateSigLength());
+    bool valid = isValidCertificate(s, d, slow.certificateSig(), slow.certificateSigLength());
 
     if (valid) {
       selectedSlow = slow;
@@ -370,5 +380,55 @@ bool ViewChangeSafetyLogic::computeRestrictionsForSeqNum(SeqNum s,
   }
 }
 
+void ViewChangeSafetyLogic::prefetchCertificates(const ViewChangeMsg* vc) const {
+  if (vc->numberOfElements() == 0) return;
+
+  // Bounds the memory that replicas which keep sending new messages can make us use. The certificates which don't fit
+  // get verified by computeRestrictions.
+  const size_t maxCertificates = static_cast<size_t>(N) * kWorkWindowSize;
+  static auto& threadPool = RequestThreadPool::getThreadPool(RequestThreadPool::PoolLevel::STARTING);
+
+  ViewChangeMsg::ElementsIterator iter(vc);
+  ViewChangeMsg::Element* elem = nullptr;
+  while (iter.getAndGoToNext(elem)) {
+    if (!elem->hasPreparedCertificate) continue;
+    if (numOfVerifiedCertificates >= maxCertificates) {
+      LOG_WARN(VC_LOG, "Too many prepared certificates to verify in advance" << KVLOG(numOfVerifiedCertificates));
+      return;
+    }
+
+    SlowElem slow{elem};
+    Digest d;
+    Digest::calcCombination(slow.prePrepreDigest(), slow.certificateView(), slow.seqNum(), d);
+    auto& certificates = verifiedCertificates[slow.seqNum()];
+    std::string key = certificateKey(d, slow.certificateSig(), slow.certificateSigLength());
+    if (certificates.count(key) > 0) continue;  // carried by another message too
+
+    auto verifier = CryptoManager::instance().thresholdVerifierForSlowPathCommit(slow.seqNum());
+    std::string sig(slow.certificateSig(), slow.certificateSigLength());
+    auto verify = [verifier, d, sig = std::move(sig)]() {
+      return verifier->verify(d.content(), DIGEST_SIZE, sig.data(), static_cast<int>(sig.size()));
+    };
+    auto result = threadPool.asyncWithPriority(concord::util::WorkStealingExecutor::Priority::HIGH, std::move(verify));
+    certificates.emplace(std::move(key), result.share());
+    numOfVerifiedCertificates++;
+  }
+}
+
+bool ViewChangeSafetyLogic::isValidCertificate(SeqNum s, const Digest& d, const char* sig, uint16_t sigLen) const {
+  auto it = verifiedCertificates.find(s);
+  if (it != verifiedCertificates.end()) {
+    auto result = it->second.find(certificateKey(d, sig, sigLen));
+    if (result != it->second.end()) return result->second.get();
+  }
+  return CryptoManager::instance().thresholdVerifierForSlowPathCommit(s)->verify(d.content(), DIGEST_SIZE, sig, sigLen);
+}
+
+void ViewChangeSafetyLogic::dropCertificatesBelow(SeqNum s) const {
+  auto end = verifiedCertificates.lower_bound(s);
+  for (auto it = verifiedCertificates.begin(); it != end; it++) numOfVerifiedCertificates -= it->second.size();
+  verifiedCertificates.erase(verifiedCertificates.begin(), end);
+}
+
 }  // namespace impl
 }  // namespace bftEngine
@@ -12,6 +12,10 @@
 #pragma once
 
 #include "messages/ViewChangeMsg.hpp"
+#include <future>
+#include <map>
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include "threshsign/IThresholdVerifier.h"
 
@@ -44,12 +48,26 @@ class ViewChangeSafetyLogic {
   // - Otherwise, its first (outMaxRestrictedSeqNum-outMinRestrictedSeqNum+1) elements are valid : they represents the
   // restrictions between outMinRestrictedSeqNum and outMaxRestrictedSeqNum
 
+  // Starts verifying the prepared certificates carried by vc on a thread pool, so that computeRestrictions only has to
+  // wait for the results instead of verifying the certificates of all the messages serially. A certificate carried by
+  // several messages is verified once. Should be called when vc is accepted; vc can be deleted right after the call.
+  void prefetchCertificates(const ViewChangeMsg* vc) const;
+
+  size_t numOfCachedCertificates() const { return numOfVerifiedCertificates; }
+
  protected:
   bool computeRestrictionsForSeqNum(SeqNum s,
                                     vector<ViewChangeMsg::ElementsIterator*>& VCIterators,
                                     const SeqNum upperBound,
                                     Digest& outRestrictedDigest) const;
 
+  // Returns the result of a prepared certificate verification started by prefetchCertificates, or verifies the
+  // certificate if it wasn't prefetched. d is the combined digest signed by the certificate.
+  bool isValidCertificate(SeqNum s, const Digest& d, const char* sig, uint16_t sigLen) const;
+
+  // Drops the results of the certificates of sequence numbers below s
+  void dropCertificatesBelow(SeqNum s) const;
+
   const uint16_t N;  // number of replicas
   const uint16_t F;
   const uint16_t C;
@@ -57,6 +75,11 @@ class ViewChangeSafetyLogic {
   std::shared_ptr<IThresholdVerifier> preparedCertVerifier;
 
   const Digest nullDigest;
+
+  // Verification results of prepared certificates, by sequence number and by combined digest + signature. Only
+  // accessed by the thread which adds the ViewChangeMsg messages and computes the restrictions.
+  mutable std::map<SeqNum, std::unordered_map<std::string, std::shared_future<bool>>> verifiedCertificates;
+  mutable size_t numOfVerifiedCertificates = 0;
 };
 
 }  // namespace impl
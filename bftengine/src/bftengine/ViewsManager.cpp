@@ -320,6 +320,9 @@ bool ViewsManager::add(ViewChangeMsg* m) {
   delete viewChangeMessages[id];  // delete previous
   viewChangeMessages[id] = m;
 
+  // verify the certificates of the message while waiting for the other messages of the view change
+  viewChangeSafetyLogic->prefetchCertificates(m);
+
   return true;
 }
 
@@ -577,6 +580,7 @@ ViewChangeMsg* ViewsManager::exitFromCurrentView(SeqNum currentLastStable,
 
   // store my new VC
   viewChangeMessages[myId] = myNewVC;
+  viewChangeSafetyLogic->prefetchCertificates(myNewVC);
 
   return myNewVC;
 }
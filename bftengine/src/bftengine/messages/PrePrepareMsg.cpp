@@ -9,6 +9,7 @@
 // these subcomponents is subject to the terms and conditions of the subcomponent's license, as noted in the LICENSE
 // file.
 
+#include <algorithm>
 #include <utility>
 #include <bftengine/ClientMsgs.hpp>
 #include "OpenTracing.hpp"
@@ -35,8 +36,13 @@ static Digest nullDigest(0x18);
 const Digest& PrePrepareMsg::digestOfNullPrePrepareMsg() { return nullDigest; }
 
 void PrePrepareMsg::calculateDigestOfRequests(Digest& digest) const {
+  // Unsigned requests are hashed in batches of this size, so that every task fills the lanes of the batch digest engine.
+  static constexpr size_t kRequestsPerDigestTask = 16;
+
   std::vector<std::pair<char*, size_t>> sigOrDigestOfRequest(b()->numberOfRequests, std::make_pair(nullptr, 0));
-  auto digestBuffer = std::make_unique<char[]>(b()->numberOfRequests * sizeof(Digest));
+  std::vector<const char*> unsignedRequests;
+  std::vector<size_t> unsignedRequestsLengths;
+  std::vector<size_t> unsignedRequestsIds;
 
   std::vector<std::future<void>> tasks;
   auto it = RequestsIterator(this);
@@ -56,18 +62,28 @@ void PrePrepareMsg::calculateDigestOfRequests(Digest& digest) const {
         sigOrDigestOfRequest[local_id].first = sig;
         sigOrDigestOfRequest[local_id].second = req.requestSignatureLength();
       } else {
-        tasks.push_back(threadPool.async(
-            [&sigOrDigestOfRequest, &digestBuffer, local_id](auto* request, auto requestLength) {
-              DigestUtil::compute(
-                  request, requestLength, digestBuffer.get() + local_id * sizeof(Digest), sizeof(Digest));
-              sigOrDigestOfRequest[local_id].first = digestBuffer.get() + local_id * sizeof(Digest);
-              sigOrDigestOfRequest[local_id].second = sizeof(Digest);
-            },
-            req.body(),
-            req.size()));
+        unsignedRequests.push_back(req.body());
+        unsignedRequestsLengths.push_back(req.size());
+        unsignedRequestsIds.push_back(local_id);
       }
       local_id++;
     }
+
+    std::vector<Digest> digests(unsignedRequests.size());
+    for (size_t first = 0; first < unsignedRequests.size(); first += kRequestsPerDigestTask) {
+      const auto count = std::min(kRequestsPerDigestTask, unsignedRequests.size() - first);
+      tasks.push_back(threadPool.async(
+          [&unsignedRequests, &unsignedRequestsLengths, &digests](auto first, auto count) {
+            DigestUtil::computeBatch(
+                &unsignedRequests[first], &unsignedRequestsLengths[first], count, &digests[first]);
+          },
+          first,
+          count));
+    }
+    for (size_t i = 0; i < unsignedRequestsIds.size(); ++i) {
+      sigOrDigestOfRequest[unsignedRequestsIds[i]].first = digests[i].content();
+      sigOrDigestOfRequest[unsignedRequestsIds[i]].second = sizeof(Digest);
+    }
     for (const auto& t : tasks) {
       t.wait();
     }
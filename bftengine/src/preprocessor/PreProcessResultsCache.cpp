@@ -0,0 +1,94 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").  You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "PreProcessResultsCache.hpp"
+
+#include <cstring>
+
+namespace preprocessor {
+
+using namespace std;
+using concord::util::SHA3_256;
+
+PreProcessResultsCache::Digest PreProcessResultsCache::requestDigest(const char *request,
+                                                                     uint32_t requestLen,
+                                                                     const string &signature,
+                                                                     uint32_t primaryResult) {
+  SHA3_256 hash;
+  hash.init();
+  // Length-prefix the variable-sized parts, so that different splits of the same bytes never collide
+  hash.update(&requestLen, sizeof(requestLen));
+  hash.update(request, requestLen);
+  const auto signatureLen = static_cast<uint32_t>(signature.size());
+  hash.update(&signatureLen, sizeof(signatureLen));
+  hash.update(signature.data(), signatureLen);
+  hash.update(&primaryResult, sizeof(primaryResult));
+  return hash.finish();
+}
+
+size_t PreProcessResultsCache::KeyHash::operator()(const Key &key) const {
+  // The request digest is uniformly distributed already
+  size_t h;
+  memcpy(&h, key.requestDigest.data(), sizeof(h));
+  return h ^ (key.reqSeqNum * 0x9e3779b97f4a7c15ULL) ^ (key.blockId << 16) ^ key.clientId;
+}
+
+uint32_t PreProcessResultsCache::find(const Key &key, char *resultBuf, uint32_t resultBufLen) {
+  if (!enabled()) return 0;
+  lock_guard<mutex> lock(lock_);
+  const auto it = index_.find(key);
+  if (it == index_.end()) return 0;
+  const auto &result = it->second->result;
+  if (result.size() > resultBufLen) return 0;
+  entries_.splice(entries_.begin(), entries_, it->second);
+  memcpy(resultBuf, result.data(), result.size());
+  return result.size();
+}
+
+void PreProcessResultsCache::add(const Key &key, const char *result, uint32_t resultLen) {
+  if (!enabled() || !resultLen || sizeof(Entry) + resultLen > maxSizeBytes_) return;
+  string value(result, resultLen);
+  lock_guard<mutex> lock(lock_);
+  const auto it = index_.find(key);
+  if (it != index_.end()) {
+    // Pre-execution is deterministic, but keep the latest result anyway
+    sizeInBytes_ -= entrySize(it->second->result);
+    it->second->result = move(value);
+    sizeInBytes_ += entrySize(it->second->result);
+    entries_.splice(entries_.begin(), entries_, it->second);
+  } else {
+    entries_.push_front(Entry{key, move(value)});
+    index_.emplace(key, entries_.begin());
+    sizeInBytes_ += entrySize(entries_.front().result);
+  }
+  evict();
+}
+
+void PreProcessResultsCache::evict() {
+  while (sizeInBytes_ > maxSizeBytes_) {
+    const auto &lru = entries_.back();
+    sizeInBytes_ -= entrySize(lru.result);
+    index_.erase(lru.key);
+    entries_.pop_back();
+  }
+}
+
+size_t PreProcessResultsCache::numOfEntries() const {
+  lock_guard<mutex> lock(lock_);
+  return entries_.size();
+}
+
+uint64_t PreProcessResultsCache::sizeInBytes() const {
+  lock_guard<mutex> lock(lock_);
+  return sizeInBytes_;
+}
+
+}  // namespace preprocessor
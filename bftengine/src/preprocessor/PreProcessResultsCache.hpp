@@ -0,0 +1,88 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").  You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#pragma once
+
+#include "PrimitiveTypes.hpp"
+#include "sha_hash.hpp"
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace preprocessor {
+
+// A bounded LRU cache of successful pre-execution results.
+//
+// A result is reused only by a request with the same client, sequence number, content (request, signature and primary
+// result) and conflict detection block id. Such a request reads the same state as the one that produced the result, and
+// the conflict detection on post-execution validates its read set against the same block, so reusing the result is
+// indistinguishable from executing it again. This spares the application the pre-execution of retried requests and of
+// requests re-sent by the primary.
+//
+// The class is thread-safe.
+class PreProcessResultsCache {
+ public:
+  using Digest = concord::util::SHA3_256::Digest;
+
+  struct Key {
+    uint16_t clientId = 0;
+    bftEngine::impl::ReqId reqSeqNum = 0;
+    uint64_t blockId = 0;
+    Digest requestDigest{};
+
+    bool operator==(const Key& other) const {
+      return clientId == other.clientId && reqSeqNum == other.reqSeqNum && blockId == other.blockId &&
+             requestDigest == other.requestDigest;
+    }
+  };
+
+  // maxSizeBytes = 0 disables the cache
+  explicit PreProcessResultsCache(uint64_t maxSizeBytes) : maxSizeBytes_{maxSizeBytes} {}
+
+  bool enabled() const { return maxSizeBytes_ > 0; }
+
+  static Digest requestDigest(const char* request,
+                              uint32_t requestLen,
+                              const std::string& signature,
+                              uint32_t primaryResult);
+
+  // Copies the result cached under the key to resultBuf and returns its length, or returns 0 if there is none
+  uint32_t find(const Key& key, char* resultBuf, uint32_t resultBufLen);
+  void add(const Key& key, const char* result, uint32_t resultLen);
+
+  size_t numOfEntries() const;
+  uint64_t sizeInBytes() const;
+
+ private:
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+  struct Entry {
+    Key key;
+    std::string result;
+  };
+  using Entries = std::list<Entry>;
+
+  static uint64_t entrySize(const std::string& result) { return sizeof(Entry) + result.size(); }
+  void evict();
+
+  const uint64_t maxSizeBytes_;
+  mutable std::mutex lock_;
+  // The most recently used entry is at the front
+  Entries entries_;
+  std::unordered_map<Key, Entries::iterator, KeyHash> index_;
+  uint64_t sizeInBytes_ = 0;
+};
+
+}  // namespace preprocessor
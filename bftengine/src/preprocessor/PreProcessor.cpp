@@ -229,6 +229,7 @@ void RequestsBatch::sendCancelBatchedPreProcessingMsgToNonPrimaries(const Client
   uint32_t overallPreProcessReqMsgsSize = 0;
   uint32_t reqRetryId = 0;
   PreProcessReqMsgsList reqsBatch;
+  reqsBatch.reserve(clientMsgs.size());
   for (auto &clientMsg : clientMsgs) {
     const auto &reqEntry = requestsMap_[offset];
     reqRetryId = (reqEntry->reqRetryId)++;
@@ -291,6 +292,7 @@ void PreProcessor::setAggregator(std::shared_ptr<concordMetrics::Aggregator> agg
     for (const auto &elem : preProcessors_) {
       elem->metricsComponent_.SetAggregator(aggregator);
       elem->memoryPool_.setAggregator(aggregator);
+      elem->threadPool_.setAggregator(aggregator);
     }
   }
 }
@@ -341,7 +343,9 @@ PreProcessor::PreProcessor(shared_ptr<MsgsCommunicator> &msgsCommunicator,
                            metricsComponent_.RegisterCounter("preProcReqRetried"),
                            metricsComponent_.RegisterAtomicGauge("preProcessingTimeAvg", 0),
                            metricsComponent_.RegisterAtomicGauge("launchAsyncPreProcessJobTimeAvg", 0),
-                           metricsComponent_.RegisterAtomicGauge("PreProcInFlyRequestsNum", 0)},
+                           metricsComponent_.RegisterAtomicGauge("PreProcInFlyRequestsNum", 0),
+                           metricsComponent_.RegisterAtomicCounter("preProcResultsCacheHits"),
+                           metricsComponent_.RegisterAtomicCounter("preProcResultsCacheMisses")},
       metric_pre_exe_duration_{metricsComponent_, "metric_pre_exe_duration_", 10000, true},
       totalPreProcessingTime_(true),
       launchAsyncJobTimeAvg_(true),
@@ -351,7 +355,8 @@ PreProcessor::PreProcessor(shared_ptr<MsgsCommunicator> &msgsCommunicator,
       launchAsyncPreProcessJobRecorder_{histograms_.launchAsyncPreProcessJob},
       pm_{pm},
       batchedPreProcessEnabled_(myReplica_.getReplicaConfig().batchedPreProcessEnabled),
-      memoryPoolEnabled_(myReplica_.getReplicaConfig().enablePreProcessorMemoryPool) {
+      memoryPoolEnabled_(myReplica_.getReplicaConfig().enablePreProcessorMemoryPool),
+      preProcessResultsCache_(myReplica_.getReplicaConfig().preExecResultsCacheSizeBytes) {
   clientMaxBatchSize_ = clientBatchingEnabled_ ? myReplica.getReplicaConfig().clientBatchingMaxMsgsNbr : 1,
   registerMsgHandlers();
   metricsComponent_.Register();
@@ -793,6 +798,7 @@ void PreProcessor::onMessage<ClientBatchRequestMsg>(ClientBatchRequestMsg *msg)
   }
   uint16_t offset = 0;
   PreProcessReqMsgsList preProcessReqMsgList;
+  preProcessReqMsgList.reserve(clientMsgs.size());
   uint32_t overallPreProcessReqMsgsSize = 0;
   uint32_t numOfReqsToSkip = 0;
   for (auto &clientMsg : clientMsgs) {
@@ -907,7 +913,7 @@ void PreProcessor::onMessage<PreProcessBatchRequestMsg>(PreProcessBatchRequestMs
                 << KVLOG(reqType, senderId, clientId, batchCid, batchMsg->numOfMessagesInBatch()));
   if (!checkPreProcessBatchReqMsgCorrectness(batchMsg)) return;
 
-  PreProcessReqMsgsList &preProcessReqMsgs = batchMsg->getPreProcessRequestMsgs();
+  const auto preProcessReqMsgs = batchMsg->getPreProcessRequestMsgs();
   const auto batchSize = preProcessReqMsgs.size();
 
   const auto &batchEntry = ongoingReqBatches_[clientId];
@@ -918,7 +924,7 @@ void PreProcessor::onMessage<PreProcessBatchRequestMsg>(PreProcessBatchRequestMs
   }
   if (!batchEntry->isBatchInProcess()) {
     uint32_t numOfReqsToSkip = 0;
-    for (auto &singleMsg : preProcessReqMsgs) {
+    for (const auto &singleMsg : preProcessReqMsgs) {
       const auto reqSeqNum = singleMsg->reqSeqNum();
       const auto reqCid = singleMsg->getCid();
       LOG_INFO(logger(),
@@ -1120,7 +1126,7 @@ bool PreProcessor::checkPreProcessReplyPrerequisites(
 }
 
 bool PreProcessor::checkPreProcessBatchReplyMsgCorrectness(const PreProcessBatchReplyMsgSharedPtr &batchReply) {
-  const auto &preProcessReplyMsgs = batchReply->getPreProcessReplyMsgs();
+  const auto preProcessReplyMsgs = batchReply->getPreProcessReplyMsgs();
   NodeIdType senderId = batchReply->senderId();
   const string batchCid = batchReply->getCid();
   bool valid = true;
@@ -1151,7 +1157,7 @@ void PreProcessor::onMessage<PreProcessBatchReplyMsg>(PreProcessBatchReplyMsg *m
   const auto &batchCid = msg->getCid();
   const NodeIdType &senderId = batchMsg->senderId();
   const NodeIdType &clientId = batchMsg->clientId();
-  PreProcessReplyMsgsList &preProcessReplyMsgs = batchMsg->getPreProcessReplyMsgs();
+  const auto preProcessReplyMsgs = batchMsg->getPreProcessReplyMsgs();
   const auto batchSize = preProcessReplyMsgs.size();
   LOG_DEBUG(logger(), "Received PreProcessBatchReplyMsg" << KVLOG(batchCid, senderId, clientId, batchSize));
   const auto &batchEntry = ongoingReqBatches_[clientId];
@@ -1166,7 +1172,7 @@ void PreProcessor::onMessage<PreProcessBatchReplyMsg>(PreProcessBatchReplyMsg *m
 
   if (!checkPreProcessBatchReplyMsgCorrectness(batchMsg)) return;
 
-  for (auto &singleReplyMsg : preProcessReplyMsgs) {
+  for (const auto &singleReplyMsg : preProcessReplyMsgs) {
     const auto &reqSeqNum = singleReplyMsg->reqSeqNum();
     const auto &reqCid = singleReplyMsg->getCid();
     LOG_DEBUG(logger(),
@@ -1745,9 +1751,34 @@ OperationResult PreProcessor::launchReqPreProcessing(const string &batchCid,
       preProcessResultBuffer,
       reqSeqNum,
       preProcessReqMsg->result()};
+  // A request which is too advanced for conflict detection (blockId == 0) has nothing to tie its result to
+  const bool useResultsCache = preProcessResultsCache_.enabled() && blockId != 0;
+  PreProcessResultsCache::Key cacheKey;
+  if (useResultsCache) {
+    cacheKey = PreProcessResultsCache::Key{clientId,
+                                           reqSeqNum,
+                                           blockId,
+                                           PreProcessResultsCache::requestDigest(preProcessReqMsg->requestBuf(),
+                                                                                 preProcessReqMsg->requestLength(),
+                                                                                 request.signature,
+                                                                                 preProcessReqMsg->result())};
+    const auto cachedResultLen = preProcessResultsCache_.find(cacheKey, preProcessResultBuffer, maxPreExecResultSize_);
+    if (cachedResultLen) {
+      preProcessorMetrics_.preProcResultsCacheHits++;
+      memcpy(preProcessResultBuffer + cachedResultLen, reinterpret_cast<char *>(&blockId), sizeof(uint64_t));
+      resultLen = cachedResultLen + sizeof(uint64_t);
+      LOG_INFO(logger(),
+               "Pre-execution result has been reused from the cache"
+                   << KVLOG(clientId, batchCid, reqSeqNum, reqCid, reqOffsetInBatch, blockId, resultLen));
+      return OperationResult::SUCCESS;
+    }
+    preProcessorMetrics_.preProcResultsCacheMisses++;
+  }
   requestsHandler_.preExecute(request, std::nullopt, reqCid, span);
   auto preProcessResult = static_cast<OperationResult>(request.outExecutionStatus);
   resultLen = request.outActualReplySize;
+  if (useResultsCache && preProcessResult == OperationResult::SUCCESS)
+    preProcessResultsCache_.add(cacheKey, preProcessResultBuffer, resultLen);
   if (preProcessResult != OperationResult::SUCCESS) {
     LOG_ERROR(logger(),
               "Pre-execution failed" << KVLOG(
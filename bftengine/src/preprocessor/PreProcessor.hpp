@@ -21,6 +21,7 @@
 #include "IRequestHandler.hpp"
 #include "Replica.hpp"
 #include "RequestProcessingState.hpp"
+#include "PreProcessResultsCache.hpp"
 #include "sliver.hpp"
 #include "SigManager.hpp"
 #include "Metrics.hpp"
@@ -333,7 +334,7 @@ class PreProcessor {
   const uint16_t numOfClientProxies_;
   const bool clientBatchingEnabled_;
   inline static uint16_t clientMaxBatchSize_ = 0;
-  concord::util::SimpleThreadPool threadPool_;
+  concord::util::SimpleThreadPool threadPool_{"preProcessorThreadPool"};
   // One-time allocated buffers (one per client) for the pre-execution results storage
   PreProcessResultBuffers preProcessResultBuffers_;
   OngoingReqBatchesMap ongoingReqBatches_;  // clientId -> RequestsBatch
@@ -356,6 +357,8 @@ class PreProcessor {
     concordMetrics::AtomicGaugeHandle preProcessingTimeAvg;
     concordMetrics::AtomicGaugeHandle launchAsyncPreProcessJobTimeAvg;
     concordMetrics::AtomicGaugeHandle preProcInFlyRequestsNum;
+    concordMetrics::AtomicCounterHandle preProcResultsCacheHits;
+    concordMetrics::AtomicCounterHandle preProcResultsCacheMisses;
   } preProcessorMetrics_;
 
   PerfMetric<std::string> metric_pre_exe_duration_;
@@ -372,6 +375,8 @@ class PreProcessor {
   std::shared_ptr<concord::performance::PerformanceManager> pm_ = nullptr;
   bool batchedPreProcessEnabled_;
   bool memoryPoolEnabled_;
+  // Results of pre-executed requests, reused when the same request is pre-executed again for the same block
+  PreProcessResultsCache preProcessResultsCache_;
 };
 
 //**************** Class AsyncPreProcessJob ****************//
@@ -66,6 +66,45 @@ void PreProcessBatchReplyMsg::validate(const ReplicasInfo& repInfo) const {
     LOG_WARN(logger(), "Too many messages in the batch" << KVLOG(numOfMessagesInBatch, msgBody()->senderId, getCid()));
     throw std::runtime_error(__PRETTY_FUNCTION__);
   }
+
+  if (!checkElements()) {
+    LOG_WARN(logger(), "One or more PreProcessReplyMsg in the list is invalid");
+    throw std::runtime_error(__PRETTY_FUNCTION__);
+  }
+}
+
+bool PreProcessBatchReplyMsg::checkElements() const {
+  // The elements get accessed in place, so each of them should be well-formed and fit into the message
+  const char* dataPosition = body() + sizeof(Header) + msgBody()->cidLength;
+  const char* msgEnd = body() + size();
+  const auto& senderId = msgBody()->senderId;
+  const auto expectedSigLen = SigManager::instance()->getSigLength(senderId);
+  for (auto i = 0u; i < msgBody()->numOfMessagesInBatch; i++) {
+    if (dataPosition > msgEnd || static_cast<size_t>(msgEnd - dataPosition) < sizeof(PreProcessReplyMsg::Header)) {
+      LOG_WARN(logger(), "The batch is too short" << KVLOG(i, msgBody()->numOfMessagesInBatch, size()));
+      return false;
+    }
+    const auto& singleMsgHeader = *(const PreProcessReplyMsg::Header*)dataPosition;
+    const auto singleMsgSize = PreProcessReplyMsg::serializedSize(singleMsgHeader);
+    if ((singleMsgHeader.header.msgType != MsgCode::PreProcessReply) || (singleMsgHeader.senderId != senderId) ||
+        (singleMsgHeader.clientId != msgBody()->clientId) || (singleMsgHeader.replyLength != expectedSigLen) ||
+        (singleMsgSize > static_cast<size_t>(msgEnd - dataPosition))) {
+      LOG_WARN(logger(),
+               KVLOG(singleMsgHeader.header.msgType,
+                     singleMsgHeader.senderId,
+                     senderId,
+                     singleMsgHeader.clientId,
+                     msgBody()->clientId,
+                     size(),
+                     singleMsgSize,
+                     expectedSigLen,
+                     singleMsgHeader.replyLength,
+                     singleMsgHeader.cidLength));
+      return false;
+    }
+    dataPosition += singleMsgSize;
+  }
+  return true;
 }
 
 void PreProcessBatchReplyMsg::setParams(
@@ -79,38 +118,25 @@ void PreProcessBatchReplyMsg::setParams(
 
 std::string PreProcessBatchReplyMsg::getCid() const { return string(body() + sizeof(Header), msgBody()->cidLength); }
 
-PreProcessReplyMsgsList& PreProcessBatchReplyMsg::getPreProcessReplyMsgs() {
-  if (!preProcessReplyMsgsList_.empty()) return preProcessReplyMsgsList_;
-
+PreProcessReplyMsgsList PreProcessBatchReplyMsg::getPreProcessReplyMsgs() {
   const auto& numOfMessagesInBatch = msgBody()->numOfMessagesInBatch;
-  const string& batchCid = getCid();
   const auto& clientId = msgBody()->clientId;
   const auto& senderId = msgBody()->senderId;
-  const auto sigLen = SigManager::instance()->getSigLength(msgBody()->senderId);
-  char* dataPosition = body() + sizeof(Header) + msgBody()->cidLength;
-  for (uint32_t i = 0; i < numOfMessagesInBatch; i++) {
-    const auto& singleMsgHeader = *(PreProcessReplyMsg::Header*)dataPosition;
-    const auto& reqSeqNum = singleMsgHeader.reqSeqNum;
-    const char* sigPosition = dataPosition + sizeof(PreProcessReplyMsg::Header);
-    const char* cidPosition = sigPosition + sigLen;
-    const string cid(cidPosition, singleMsgHeader.cidLength);
-    auto preProcessReplyMsg =
-        make_unique<preprocessor::PreProcessReplyMsg>(senderId,
-                                                      clientId,
-                                                      singleMsgHeader.reqOffsetInBatch,
-                                                      reqSeqNum,
-                                                      singleMsgHeader.reqRetryId,
-                                                      (const uint8_t*)&singleMsgHeader.resultsHash,
-                                                      sigPosition,
-                                                      cid,
-                                                      singleMsgHeader.status,
-                                                      singleMsgHeader.preProcessResult,
-                                                      singleMsgHeader.viewNum);
-    preProcessReplyMsgsList_.push_back(move(preProcessReplyMsg));
-    dataPosition += sizeof(PreProcessReplyMsg::Header) + sigLen + singleMsgHeader.cidLength;
+  if (preProcessReplyMsgs_.empty()) {
+    char* dataPosition = body() + sizeof(Header) + msgBody()->cidLength;
+    for (uint32_t i = 0; i < numOfMessagesInBatch; i++) {
+      const auto singleMsgSize = PreProcessReplyMsg::serializedSize(*(PreProcessReplyMsg::Header*)dataPosition);
+      preProcessReplyMsgs_.emplace_back(senderId, dataPosition, singleMsgSize);
+      dataPosition += singleMsgSize;
+    }
   }
-  LOG_DEBUG(logger(), KVLOG(batchCid, clientId, senderId, numOfMessagesInBatch, preProcessReplyMsgsList_.size()));
-  return preProcessReplyMsgsList_;
+  // Aliasing pointers: the elements live as long as any of them, or the batch itself, is in use
+  const auto batch = shared_from_this();
+  PreProcessReplyMsgsList preProcessReplyMsgsList;
+  preProcessReplyMsgsList.reserve(preProcessReplyMsgs_.size());
+  for (auto& msg : preProcessReplyMsgs_) preProcessReplyMsgsList.emplace_back(batch, &msg);
+  LOG_DEBUG(logger(), KVLOG(getCid(), clientId, senderId, numOfMessagesInBatch, preProcessReplyMsgsList.size()));
+  return preProcessReplyMsgsList;
 }
 
 }  // namespace preprocessor
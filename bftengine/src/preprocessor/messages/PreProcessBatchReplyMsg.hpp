@@ -13,13 +13,14 @@
 
 #include "PreProcessReplyMsg.hpp"
 #include "../PreProcessorRecorder.hpp"
-#include <list>
+#include <deque>
+#include <vector>
 
 namespace preprocessor {
 
-using PreProcessReplyMsgsList = std::list<PreProcessReplyMsgSharedPtr>;
+using PreProcessReplyMsgsList = std::vector<PreProcessReplyMsgSharedPtr>;
 
-class PreProcessBatchReplyMsg : public MessageBase {
+class PreProcessBatchReplyMsg : public MessageBase, public std::enable_shared_from_this<PreProcessBatchReplyMsg> {
  public:
   PreProcessBatchReplyMsg(uint16_t clientId,
                           NodeIdType senderId,
@@ -34,7 +35,9 @@ class PreProcessBatchReplyMsg : public MessageBase {
   uint16_t clientId() const { return msgBody()->clientId; }
   uint32_t numOfMessagesInBatch() const { return msgBody()->numOfMessagesInBatch; }
   ViewNum viewNum() const { return msgBody()->viewNum; }
-  PreProcessReplyMsgsList& getPreProcessReplyMsgs();
+  // Returns the batch elements as views of this message's body: nothing gets copied, and the returned messages share
+  // the ownership of this one. Should be called on a validated message owned by a shared pointer.
+  PreProcessReplyMsgsList getPreProcessReplyMsgs();
   void validate(const ReplicasInfo&) const override;
 
  protected:
@@ -60,11 +63,12 @@ class PreProcessBatchReplyMsg : public MessageBase {
   }
   void setParams(
       NodeIdType senderId, uint16_t clientId, uint32_t numOfMessagesInBatch, uint32_t repliesSize, ViewNum viewNum);
+  bool checkElements() const;
   Header* msgBody() const { return ((Header*)msgBody_); }
 
  private:
   std::string cid_;
-  PreProcessReplyMsgsList preProcessReplyMsgsList_;
+  std::deque<PreProcessReplyMsg> preProcessReplyMsgs_;
 };
 
 using PreProcessBatchReplyMsgSharedPtr = std::shared_ptr<PreProcessBatchReplyMsg>;
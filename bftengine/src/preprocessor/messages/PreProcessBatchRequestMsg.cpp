@@ -60,32 +60,40 @@ void PreProcessBatchRequestMsg::validate(const ReplicasInfo& repInfo) const {
 }
 
 bool PreProcessBatchRequestMsg::checkElements() const {
-  const auto totalMsgSize = size();
   const auto& numOfMessagesInBatch = msgBody()->numOfMessagesInBatch;
   if (!numOfMessagesInBatch || (numOfMessagesInBatch > MAX_BATCH_SIZE)) {
     LOG_WARN(logger(), KVLOG(numOfMessagesInBatch));
     return false;
   }
-  char* dataPosition = body() + sizeof(Header) + msgBody()->cidLength;
+  // The elements get accessed in place, so each of them should be well-formed and fit into the message
+  const char* dataPosition = body() + sizeof(Header) + msgBody()->cidLength;
+  const char* msgEnd = body() + size();
   const auto& sigManager = SigManager::instance();
   const auto& isClientTransactionSigningEnabled = sigManager->isClientTransactionSigningEnabled();
   for (auto i = 0u; i < numOfMessagesInBatch; i++) {
-    const auto& singleMsgHeader = *(PreProcessRequestMsg::Header*)dataPosition;
+    if (dataPosition > msgEnd || static_cast<size_t>(msgEnd - dataPosition) < sizeof(PreProcessRequestMsg::Header)) {
+      LOG_WARN(logger(), "The batch is too short" << KVLOG(i, numOfMessagesInBatch, size()));
+      return false;
+    }
+    const auto& singleMsgHeader = *(const PreProcessRequestMsg::Header*)dataPosition;
     auto clientId = singleMsgHeader.clientId;
     auto expectedSigLen = (isClientTransactionSigningEnabled ? sigManager->getSigLength(clientId) : 0);
-    if ((expectedSigLen != singleMsgHeader.reqSignatureLength) || (totalMsgSize < singleMsgHeader.requestLength) ||
-        (totalMsgSize < singleMsgHeader.cidLength)) {
+    const auto singleMsgSize = PreProcessRequestMsg::serializedSize(singleMsgHeader);
+    if ((clientId != msgBody()->clientId) || (expectedSigLen != singleMsgHeader.reqSignatureLength) ||
+        (singleMsgHeader.header.spanContextSize != singleMsgHeader.spanContextSize) ||
+        (singleMsgSize > static_cast<size_t>(msgEnd - dataPosition))) {
       LOG_WARN(logger(),
                KVLOG(clientId,
-                     totalMsgSize,
+                     msgBody()->clientId,
+                     size(),
+                     singleMsgSize,
                      expectedSigLen,
                      singleMsgHeader.reqSignatureLength,
                      singleMsgHeader.requestLength,
                      singleMsgHeader.cidLength));
       return false;
     }
-    dataPosition += sizeof(PreProcessRequestMsg::Header) + singleMsgHeader.spanContextSize +
-                    singleMsgHeader.requestLength + singleMsgHeader.cidLength + singleMsgHeader.reqSignatureLength;
+    dataPosition += singleMsgSize;
   }
   return true;
 }
@@ -107,43 +115,25 @@ void PreProcessBatchRequestMsg::setParams(uint16_t clientId,
 
 string PreProcessBatchRequestMsg::getCid() const { return string(body() + sizeof(Header), msgBody()->cidLength); }
 
-PreProcessReqMsgsList& PreProcessBatchRequestMsg::getPreProcessRequestMsgs() {
-  if (!preProcessReqMsgsList_.empty()) return preProcessReqMsgsList_;
-
+PreProcessReqMsgsList PreProcessBatchRequestMsg::getPreProcessRequestMsgs() {
   const auto& numOfMessagesInBatch = msgBody()->numOfMessagesInBatch;
-  const string& batchCid = getCid();
   const auto& clientId = msgBody()->clientId;
   const auto& senderId = msgBody()->senderId;
-  char* dataPosition = body() + sizeof(Header) + msgBody()->cidLength;
-  for (uint32_t i = 0; i < numOfMessagesInBatch; i++) {
-    const auto& singleMsgHeader = *(PreProcessRequestMsg::Header*)dataPosition;
-    const char* spanDataPosition = dataPosition + sizeof(PreProcessRequestMsg::Header);
-    const char* requestDataPosition = spanDataPosition + singleMsgHeader.spanContextSize;
-    const char* cidPosition = requestDataPosition + singleMsgHeader.requestLength;
-    const char* requestSignaturePosition =
-        (singleMsgHeader.reqSignatureLength > 0) ? (cidPosition + singleMsgHeader.cidLength) : nullptr;
-    const concordUtils::SpanContext spanContext(string(spanDataPosition, singleMsgHeader.spanContextSize));
-    const string cid(cidPosition, singleMsgHeader.cidLength);
-    auto preProcessReqMsg = make_unique<preprocessor::PreProcessRequestMsg>(singleMsgHeader.reqType,
-                                                                            senderId,
-                                                                            clientId,
-                                                                            singleMsgHeader.reqOffsetInBatch,
-                                                                            singleMsgHeader.reqSeqNum,
-                                                                            singleMsgHeader.reqRetryId,
-                                                                            singleMsgHeader.requestLength,
-                                                                            requestDataPosition,
-                                                                            cid,
-                                                                            requestSignaturePosition,
-                                                                            singleMsgHeader.reqSignatureLength,
-                                                                            singleMsgHeader.primaryBlockId,
-                                                                            singleMsgHeader.viewNum,
-                                                                            spanContext);
-    preProcessReqMsgsList_.push_back(move(preProcessReqMsg));
-    dataPosition += sizeof(PreProcessRequestMsg::Header) + singleMsgHeader.spanContextSize +
-                    singleMsgHeader.requestLength + singleMsgHeader.cidLength + singleMsgHeader.reqSignatureLength;
+  if (preProcessReqMsgs_.empty()) {
+    char* dataPosition = body() + sizeof(Header) + msgBody()->cidLength;
+    for (uint32_t i = 0; i < numOfMessagesInBatch; i++) {
+      const auto singleMsgSize = PreProcessRequestMsg::serializedSize(*(PreProcessRequestMsg::Header*)dataPosition);
+      preProcessReqMsgs_.emplace_back(senderId, dataPosition, singleMsgSize);
+      dataPosition += singleMsgSize;
+    }
   }
-  LOG_DEBUG(logger(), KVLOG(batchCid, clientId, senderId, preProcessReqMsgsList_.size(), numOfMessagesInBatch));
-  return preProcessReqMsgsList_;
+  // Aliasing pointers: the elements live as long as any of them, or the batch itself, is in use
+  const auto batch = shared_from_this();
+  PreProcessReqMsgsList preProcessReqMsgsList;
+  preProcessReqMsgsList.reserve(preProcessReqMsgs_.size());
+  for (auto& msg : preProcessReqMsgs_) preProcessReqMsgsList.emplace_back(batch, &msg);
+  LOG_DEBUG(logger(), KVLOG(getCid(), clientId, senderId, preProcessReqMsgsList.size(), numOfMessagesInBatch));
+  return preProcessReqMsgsList;
 }
 
 }  // namespace preprocessor
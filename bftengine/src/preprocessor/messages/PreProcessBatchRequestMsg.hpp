@@ -12,13 +12,14 @@
 #pragma once
 
 #include "PreProcessRequestMsg.hpp"
-#include <list>
+#include <deque>
+#include <vector>
 
 namespace preprocessor {
 
-using PreProcessReqMsgsList = std::list<preprocessor::PreProcessRequestMsgSharedPtr>;
+using PreProcessReqMsgsList = std::vector<preprocessor::PreProcessRequestMsgSharedPtr>;
 
-class PreProcessBatchRequestMsg : public MessageBase {
+class PreProcessBatchRequestMsg : public MessageBase, public std::enable_shared_from_this<PreProcessBatchRequestMsg> {
  public:
   PreProcessBatchRequestMsg(RequestType reqType,
                             NodeIdType clientId,
@@ -35,7 +36,9 @@ class PreProcessBatchRequestMsg : public MessageBase {
   uint32_t numOfMessagesInBatch() const { return msgBody()->numOfMessagesInBatch; }
   const RequestType reqType() const { return msgBody()->reqType; }
   const ViewNum viewNum() const { return msgBody()->viewNum; }
-  PreProcessReqMsgsList& getPreProcessRequestMsgs();
+  // Returns the batch elements as views of this message's body: nothing gets copied, and the returned messages share
+  // the ownership of this one. Should be called on a validated message owned by a shared pointer.
+  PreProcessReqMsgsList getPreProcessRequestMsgs();
   void validate(const ReplicasInfo&) const override;
 
  protected:
@@ -71,7 +74,7 @@ class PreProcessBatchRequestMsg : public MessageBase {
  private:
   bool checkElements() const;
   std::string cid_;
-  PreProcessReqMsgsList preProcessReqMsgsList_;
+  std::deque<PreProcessRequestMsg> preProcessReqMsgs_;
 };
 
 using PreProcessBatchReqMsgSharedPtr = std::shared_ptr<PreProcessBatchRequestMsg>;
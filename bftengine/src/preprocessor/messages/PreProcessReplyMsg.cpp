@@ -40,23 +40,6 @@ PreProcessReplyMsg::PreProcessReplyMsg(NodeIdType senderId,
   setupMsgBody(preProcessResultBuf, preProcessResultBufLen, reqCid);
 }
 
-// Used by PreProcessBatchReplyMsg while retrieving PreProcessReplyMsgs from the batch
-PreProcessReplyMsg::PreProcessReplyMsg(NodeIdType senderId,
-                                       uint16_t clientId,
-                                       uint16_t reqOffsetInBatch,
-                                       uint64_t reqSeqNum,
-                                       uint64_t reqRetryId,
-                                       const uint8_t* resultsHash,
-                                       const char* signature,
-                                       const std::string& reqCid,
-                                       ReplyStatus status,
-                                       OperationResult preProcessResult,
-                                       ViewNum viewNum)
-    : MessageBase(senderId, MsgCode::PreProcessReply, 0, maxReplyMsgSize_) {
-  setParams(senderId, clientId, reqOffsetInBatch, reqSeqNum, reqRetryId, status, preProcessResult, viewNum);
-  setupMsgBody(resultsHash, signature, reqCid);
-}
-
 void PreProcessReplyMsg::validate(const ReplicasInfo& repInfo) const {
   const uint64_t headerSize = sizeof(Header);
   if (size() < headerSize || size() < headerSize + msgBody()->replyLength) throw runtime_error(__PRETTY_FUNCTION__);
@@ -159,14 +142,6 @@ void PreProcessReplyMsg::setupMsgBody(const char* preProcessResultBuf,
   setLeftMsgParams(reqCid, sigSize);
 }
 
-// Used by PreProcessBatchReplyMsg while retrieving PreProcessReplyMsgs from the batch
-void PreProcessReplyMsg::setupMsgBody(const uint8_t* resultsHash, const char* signature, const string& reqCid) {
-  memcpy(msgBody()->resultsHash, resultsHash, SHA3_256::SIZE_IN_BYTES);
-  const uint16_t sigLen = SigManager::instance()->getMySigLength();
-  memcpy(body() + sizeof(Header), signature, sigLen);
-  setLeftMsgParams(reqCid, sigLen);
-}
-
 std::string PreProcessReplyMsg::getCid() const {
   return std::string(body() + msgSize_ - msgBody()->cidLength, msgBody()->cidLength);
 }
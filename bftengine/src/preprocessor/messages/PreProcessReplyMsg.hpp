@@ -34,20 +34,12 @@ class PreProcessReplyMsg : public MessageBase {
                      bftEngine::OperationResult preProcessResult,
                      ViewNum viewNum);
 
-  PreProcessReplyMsg(NodeIdType senderId,
-                     uint16_t clientId,
-                     uint16_t reqOffsetInBatch,
-                     uint64_t reqSeqNum,
-                     uint64_t reqRetryId,
-                     const uint8_t* resultsHash,
-                     const char* signature,
-                     const std::string& reqCid,
-                     ReplyStatus status,
-                     bftEngine::OperationResult preProcessResult,
-                     ViewNum viewNum);
-
   BFTENGINE_GEN_CONSTRUCT_FROM_BASE_MESSAGE(PreProcessReplyMsg)
 
+  // A view of a message serialized in a buffer owned by someone else, e.g. of an element of a batch message
+  PreProcessReplyMsg(NodeIdType senderId, char* body, MsgSize size)
+      : MessageBase(senderId, reinterpret_cast<MessageBase::Header*>(body), size, false) {}
+
   void validate(const bftEngine::impl::ReplicasInfo&) const override;
   const uint16_t clientId() const { return msgBody()->clientId; }
   const uint16_t reqOffsetInBatch() const { return msgBody()->reqOffsetInBatch; }
@@ -84,6 +76,11 @@ class PreProcessReplyMsg : public MessageBase {
 // The pre-executed results' hash signature resides in the message body
 #pragma pack(pop)
 
+  // The size of a serialized message with the given header
+  static uint64_t serializedSize(const Header& header) {
+    return sizeof(Header) + uint64_t{header.replyLength} + header.cidLength;
+  }
+
  protected:
   template <typename MessageT>
   friend size_t bftEngine::impl::sizeOfHeader();
@@ -102,7 +99,6 @@ class PreProcessReplyMsg : public MessageBase {
                  bftEngine::OperationResult preProcessResult,
                  ViewNum viewNum);
   void setupMsgBody(const char* preProcessResultBuf, uint32_t preProcessResultBufLen, const std::string& reqCid);
-  void setupMsgBody(const uint8_t* resultsHash, const char* signature, const std::string& reqCid);
   void setLeftMsgParams(const std::string& cid, uint16_t sigSize);
 
   Header* msgBody() const { return ((Header*)msgBody_); }
@@ -40,6 +40,10 @@ class PreProcessRequestMsg : public MessageBase {
 
   BFTENGINE_GEN_CONSTRUCT_FROM_BASE_MESSAGE(PreProcessRequestMsg)
 
+  // A view of a message serialized in a buffer owned by someone else, e.g. of an element of a batch message
+  PreProcessRequestMsg(NodeIdType senderId, char* body, MsgSize size)
+      : MessageBase(senderId, reinterpret_cast<MessageBase::Header*>(body), size, false) {}
+
   void validate(const bftEngine::impl::ReplicasInfo&) const override;
   char* requestBuf() const { return body() + sizeof(Header) + spanContextSize(); }
   const RequestType reqType() const { return msgBody()->reqType; }
@@ -80,6 +84,12 @@ class PreProcessRequestMsg : public MessageBase {
   };
 #pragma pack(pop)
 
+  // The size of a serialized message with the given header
+  static uint64_t serializedSize(const Header& header) {
+    return sizeof(Header) + uint64_t{header.spanContextSize} + header.requestLength + header.cidLength +
+           header.reqSignatureLength;
+  }
+
  protected:
   template <typename MessageT>
   friend size_t bftEngine::impl::sizeOfHeader();
@@ -0,0 +1,122 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").  You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "gtest/gtest.h"
+
+#include "PreProcessResultsCache.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std;
+using preprocessor::PreProcessResultsCache;
+
+const string request = "request";
+const string signature = "signature";
+
+PreProcessResultsCache::Key key(uint16_t clientId, uint64_t reqSeqNum, uint64_t blockId, const string& req = request) {
+  return PreProcessResultsCache::Key{
+      clientId, reqSeqNum, blockId, PreProcessResultsCache::requestDigest(req.data(), req.size(), signature, 0)};
+}
+
+string find(PreProcessResultsCache& cache, const PreProcessResultsCache::Key& k) {
+  char buf[1024];
+  const auto len = cache.find(k, buf, sizeof(buf));
+  return string(buf, len);
+}
+
+TEST(PreProcessResultsCache, reuses_result_of_the_same_request_and_block_only) {
+  PreProcessResultsCache cache{1024 * 1024};
+  cache.add(key(1, 10, 100), "result", 6);
+  ASSERT_EQ(find(cache, key(1, 10, 100)), "result");
+
+  ASSERT_EQ(find(cache, key(2, 10, 100)), "");
+  ASSERT_EQ(find(cache, key(1, 11, 100)), "");
+  ASSERT_EQ(find(cache, key(1, 10, 101)), "");
+  ASSERT_EQ(find(cache, key(1, 10, 100, "other request")), "");
+  const auto otherSignature = PreProcessResultsCache::Key{
+      1, 10, 100, PreProcessResultsCache::requestDigest(request.data(), request.size(), "other", 0)};
+  ASSERT_EQ(find(cache, otherSignature), "");
+  const auto otherPrimaryResult = PreProcessResultsCache::Key{
+      1, 10, 100, PreProcessResultsCache::requestDigest(request.data(), request.size(), signature, 1)};
+  ASSERT_EQ(find(cache, otherPrimaryResult), "");
+  // Same bytes, split differently between the request and the signature
+  ASSERT_NE(PreProcessResultsCache::requestDigest("ab", 2, "c", 0),
+            PreProcessResultsCache::requestDigest("a", 1, "bc", 0));
+
+  cache.add(key(1, 10, 100), "new result", 10);
+  ASSERT_EQ(find(cache, key(1, 10, 100)), "new result");
+  ASSERT_EQ(cache.numOfEntries(), 1);
+}
+
+TEST(PreProcessResultsCache, result_larger_than_the_buffer_is_not_returned) {
+  PreProcessResultsCache cache{1024 * 1024};
+  cache.add(key(1, 1, 1), "result", 6);
+  char buf[5];
+  ASSERT_EQ(cache.find(key(1, 1, 1), buf, sizeof(buf)), 0);
+}
+
+TEST(PreProcessResultsCache, evicts_least_recently_used_results) {
+  const string result(1000, 'r');
+  // Room for 3 results
+  PreProcessResultsCache cache{3 * (result.size() + 200)};
+  cache.add(key(1, 1, 1), result.data(), result.size());
+  cache.add(key(2, 1, 1), result.data(), result.size());
+  cache.add(key(3, 1, 1), result.data(), result.size());
+  ASSERT_EQ(cache.numOfEntries(), 3);
+
+  // Client 1 becomes the most recently used, so client 2 is evicted
+  ASSERT_EQ(find(cache, key(1, 1, 1)), result);
+  cache.add(key(4, 1, 1), result.data(), result.size());
+  ASSERT_EQ(cache.numOfEntries(), 3);
+  ASSERT_EQ(find(cache, key(2, 1, 1)), "");
+  ASSERT_EQ(find(cache, key(1, 1, 1)), result);
+  ASSERT_EQ(find(cache, key(3, 1, 1)), result);
+  ASSERT_EQ(find(cache, key(4, 1, 1)), result);
+  ASSERT_LE(cache.sizeInBytes(), 3 * (result.size() + 200));
+
+  // A result which can never fit is not cached
+  const string huge(10000, 'h');
+  cache.add(key(5, 1, 1), huge.data(), huge.size());
+  ASSERT_EQ(find(cache, key(5, 1, 1)), "");
+  ASSERT_EQ(cache.numOfEntries(), 3);
+}
+
+TEST(PreProcessResultsCache, disabled_cache_is_empty) {
+  PreProcessResultsCache cache{0};
+  ASSERT_FALSE(cache.enabled());
+  cache.add(key(1, 1, 1), "result", 6);
+  ASSERT_EQ(find(cache, key(1, 1, 1)), "");
+  ASSERT_EQ(cache.numOfEntries(), 0);
+}
+
+TEST(PreProcessResultsCache, concurrent_access) {
+  PreProcessResultsCache cache{64 * 1024};
+  vector<thread> threads;
+  for (uint16_t clientId = 0; clientId < 8; ++clientId) {
+    threads.emplace_back([&cache, clientId]() {
+      for (uint64_t reqSeqNum = 1; reqSeqNum <= 1000; ++reqSeqNum) {
+        const auto value = to_string(clientId) + "/" + to_string(reqSeqNum);
+        cache.add(key(clientId, reqSeqNum, 1), value.data(), value.size());
+        const auto found = find(cache, key(clientId, reqSeqNum, 1));
+        // Possibly evicted by the other threads already
+        if (!found.empty()) ASSERT_EQ(found, value);
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  ASSERT_LE(cache.sizeInBytes(), 64 * 1024);
+}
+
+}  // namespace
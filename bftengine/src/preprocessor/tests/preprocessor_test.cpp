@@ -685,6 +685,59 @@ TEST(requestPreprocessingState_test, validatePreProcessBatchRequestMsg) {
   }
 }
 
+TEST(requestPreprocessingState_test, preProcessBatchRequestMsgElementsAreViewsOfTheBatch) {
+  bftEngine::impl::ReplicasInfo repInfo(replicaConfig, false, false);
+  PreProcessReqMsgsList batch;
+  uint overallReqSize = 0;
+  const auto numOfMsgs = 3;
+  const auto senderId = 2;
+  memset(buf, '7', bufLen);
+  for (uint i = 0; i < numOfMsgs; i++) {
+    auto preProcessReqMsg = make_shared<PreProcessRequestMsg>(REQ_TYPE_PRE_PROCESS,
+                                                              senderId,
+                                                              clientId,
+                                                              i,
+                                                              reqSeqNum + i,
+                                                              i,
+                                                              bufLen - i,
+                                                              buf,
+                                                              cid + to_string(i + 1),
+                                                              nullptr,
+                                                              0,
+                                                              GlobalData::current_block_id,
+                                                              viewNum,
+                                                              span,
+                                                              i);
+    batch.push_back(preProcessReqMsg);
+    overallReqSize += preProcessReqMsg->size();
+  }
+  auto preProcessBatchReqMsg = make_shared<PreProcessBatchRequestMsg>(
+      REQ_TYPE_PRE_PROCESS, clientId, senderId, batch, cid, overallReqSize, viewNum);
+  preProcessBatchReqMsg->validate(repInfo);
+  auto msgs = preProcessBatchReqMsg->getPreProcessRequestMsgs();
+  ConcordAssertEQ(msgs.size(), numOfMsgs);
+  const char* batchBegin = preProcessBatchReqMsg->body();
+  const char* batchEnd = batchBegin + preProcessBatchReqMsg->size();
+  // The elements point into the batch and keep it alive
+  preProcessBatchReqMsg.reset();
+  for (uint i = 0; i < numOfMsgs; i++) {
+    const auto& msg = msgs[i];
+    ConcordAssert(msg->body() > batchBegin && msg->body() < batchEnd);
+    msg->validate(repInfo);
+    ConcordAssertEQ(msg->size(), batch[i]->size());
+    ConcordAssertEQ(memcmp(msg->body(), batch[i]->body(), msg->size()), 0);
+    ConcordAssertEQ(msg->requestLength(), bufLen - i);
+    ConcordAssertEQ(memcmp(msg->requestBuf(), buf, bufLen - i), 0);
+    ConcordAssertEQ(msg->result(), i);
+  }
+
+  // An element which does not fit into the batch
+  reinterpret_cast<PreProcessRequestMsg::Header*>(batch.back()->body())->requestLength++;
+  auto invalidBatchReqMsg = make_shared<PreProcessBatchRequestMsg>(
+      REQ_TYPE_PRE_PROCESS, clientId, senderId, batch, cid, overallReqSize, viewNum);
+  EXPECT_THROW(invalidBatchReqMsg->validate(repInfo), std::runtime_error);
+}
+
 TEST(requestPreprocessingState_test, validatePreProcessBatchReplyMsg) {
   bftEngine::impl::ReplicasInfo repInfo(replicaConfig, false, false);
 
@@ -729,6 +782,64 @@ TEST(requestPreprocessingState_test, validatePreProcessBatchReplyMsg) {
   }
 }
 
+TEST(requestPreprocessingState_test, preProcessBatchReplyMsgElementsAreViewsOfTheBatch) {
+  bftEngine::impl::ReplicasInfo repInfo(replicaConfig, false, false);
+  PreProcessReplyMsgsList batch;
+  uint overallRepliesSize = 0;
+  const auto numOfMsgs = 3;
+  const auto senderId = 2;
+  SigManager::instance(sigManager[senderId].get());
+  for (uint i = 0; i < numOfMsgs; i++) {
+    auto preProcessReplyMsg = make_shared<PreProcessReplyMsg>(senderId,
+                                                              clientId,
+                                                              i,
+                                                              reqSeqNum + i,
+                                                              i,
+                                                              buf,
+                                                              bufLen - i,
+                                                              cid + to_string(i + 1),
+                                                              (i == 1 ? STATUS_REJECT : STATUS_GOOD),
+                                                              OperationResult::SUCCESS,
+                                                              viewNum);
+    batch.push_back(preProcessReplyMsg);
+    overallRepliesSize += preProcessReplyMsg->size();
+  }
+  auto preProcessBatchReplyMsg =
+      make_shared<PreProcessBatchReplyMsg>(clientId, senderId, batch, cid, overallRepliesSize, viewNum);
+  preProcessBatchReplyMsg->validate(repInfo);
+  auto msgs = preProcessBatchReplyMsg->getPreProcessReplyMsgs();
+  ConcordAssertEQ(msgs.size(), numOfMsgs);
+  const char* batchBegin = preProcessBatchReplyMsg->body();
+  const char* batchEnd = batchBegin + preProcessBatchReplyMsg->size();
+  // The elements point into the batch and keep it alive
+  preProcessBatchReplyMsg.reset();
+  SigManager::instance(sigManager[repInfo.myId()].get());
+  for (uint i = 0; i < numOfMsgs; i++) {
+    const auto& msg = msgs[i];
+    ConcordAssert(msg->body() > batchBegin && msg->body() < batchEnd);
+    msg->validate(repInfo);
+    ConcordAssertEQ(msg->size(), batch[i]->size());
+    ConcordAssertEQ(memcmp(msg->body(), batch[i]->body(), msg->size()), 0);
+    ConcordAssertEQ(msg->status(), batch[i]->status());
+    ConcordAssert(msg->getResultHashSignature() == batch[i]->getResultHashSignature());
+  }
+
+  // An element which does not fit into the batch
+  SigManager::instance(sigManager[senderId].get());
+  reinterpret_cast<PreProcessReplyMsg::Header*>(batch.back()->body())->cidLength++;
+  auto tooShortBatchReplyMsg =
+      make_shared<PreProcessBatchReplyMsg>(clientId, senderId, batch, cid, overallRepliesSize, viewNum);
+  EXPECT_THROW(tooShortBatchReplyMsg->validate(repInfo), std::runtime_error);
+  reinterpret_cast<PreProcessReplyMsg::Header*>(batch.back()->body())->cidLength--;
+
+  // An element sent on behalf of another replica
+  reinterpret_cast<PreProcessReplyMsg::Header*>(batch.front()->body())->senderId = senderId + 1;
+  auto otherSenderBatchReplyMsg =
+      make_shared<PreProcessBatchReplyMsg>(clientId, senderId, batch, cid, overallRepliesSize, viewNum);
+  EXPECT_THROW(otherSenderBatchReplyMsg->validate(repInfo), std::runtime_error);
+  SigManager::instance(sigManager[repInfo.myId()].get());
+}
+
 TEST(requestPreprocessingState_test, requestTimedOut) {
   setUpConfiguration_7();
 
@@ -342,7 +342,8 @@ SimpleStateTran::SimpleStateTran(
       true,                                 // enableReservedPages
       true,                                 // enableSourceBlocksPreFetch
       true,                                 // enableSourceSelectorPrimaryAwareness
-      true                                  // enableStoreRvbDataDuringCheckpointing
+      true,                                 // enableStoreRvbDataDuringCheckpointing
+      false                                 // enableResPagesDigestTree
   };
 
   auto comparator = concord::storage::memorydb::KeyComparator();
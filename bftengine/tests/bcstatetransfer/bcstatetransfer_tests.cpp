@@ -139,7 +139,8 @@ Config targetConfig() {
       true,               // enableReservedPages
       true,               // enableSourceBlocksPreFetch
       true,               // enableSourceSelectorPrimaryAwareness
-      true                // enableStoreRvbDataDuringCheckpointing
+      true,               // enableStoreRvbDataDuringCheckpointing
+      false               // enableResPagesDigestTree
   };
 }
 
@@ -1861,6 +1862,67 @@ TEST_F(BcStTest, bkpCheckCheckPruningPersistency) {
   testConfig_.productDbDeleteOnEnd = true;
 }
 
+// Check that a backup replica loads the last version of reserved pages which were saved several times between
+// checkpoints, once they are flushed
+TEST_F(BcStTest, bkpCheckPendingResPagesPersistency) {
+  ASSERT_NFF(initialize());
+  ASSERT_NFF(cmnStartRunning());
+  const uint32_t pageSize = targetConfig_.sizeOfReservedPage;
+  const uint32_t numPages = 2;
+  std::vector<char> page(pageSize);
+  stateTransfer_->beginReservedPagesWriteBack();
+  for (uint32_t pageId = 0; pageId < numPages; ++pageId) {
+    for (char c : {'a', 'b', 'c'}) {
+      std::fill(page.begin(), page.end(), static_cast<char>(c + pageId));
+      stateTransfer_->saveReservedPage(pageId, pageSize, page.data());
+    }
+  }
+  stateTransfer_->endReservedPagesWriteBack();
+  stateTransfer_->flushReservedPages();
+  ASSERT_EQ(datastore_->numOfAllPendingResPage(), numPages);
+  ASSERT_NFF(dstRestart(false, FetchingState::NotFetching));
+  for (uint32_t pageId = 0; pageId < numPages; ++pageId) {
+    ASSERT_TRUE(stateTransfer_->loadReservedPage(pageId, pageSize, page.data()));
+    ASSERT_EQ(page, std::vector<char>(pageSize, static_cast<char>('c' + pageId)));
+  }
+  testConfig_.productDbDeleteOnEnd = true;
+}
+
+// Pending pages set outside of a write-back scope (e.g. by the epoch manager or the key store) are durable without a
+// flush, while the ones set within a scope reach the DB only when flushed
+TEST(DBDataStoreTest, pendingResPagesWriteThrough) {
+  const uint32_t pageSize = 4096;
+  concord::storage::IDBClient::ptr dbc = std::make_shared<concord::storage::memorydb::Client>();
+  dbc->init();
+  const auto keyManip = std::make_shared<concord::storage::v1DirectKeyValue::STKeyManipulator>();
+  DBDataStore store(dbc, pageSize, keyManip, true);
+  store.setAsInitialized();
+  store.setNumberOfReservedPages(2);
+
+  const std::vector<char> throughPage(pageSize, 't');
+  store.setPendingResPage(0, throughPage.data(), pageSize);
+  const std::vector<char> backPage(pageSize, 'b');
+  store.beginPendingResPagesWriteBack();
+  store.setPendingResPage(1, backPage.data(), pageSize);
+  store.endPendingResPagesWriteBack();
+
+  // Reopen the storage without flushing, as after a crash
+  std::vector<char> page(pageSize);
+  {
+    DBDataStore reopened(dbc, pageSize, keyManip, true);
+    ASSERT_TRUE(reopened.hasPendingResPage(0));
+    reopened.getPendingResPage(0, page.data(), pageSize);
+    ASSERT_EQ(page, throughPage);
+    ASSERT_FALSE(reopened.hasPendingResPage(1));
+  }
+
+  store.flushPendingResPages();
+  DBDataStore reopened(dbc, pageSize, keyManip, true);
+  ASSERT_TRUE(reopened.hasPendingResPage(1));
+  reopened.getPendingResPage(1, page.data(), pageSize);
+  ASSERT_EQ(page, backPage);
+}
+
 // Check inter-versions compatibility: period to version 1.6 there is no RVT data in checkpoint.
 // We would like to check that replica is able to reconstruct the whole RVT from storage, when no data is found in
 // Checkpoint
@@ -0,0 +1,137 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the
+// LICENSE file.
+
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "ResPagesDigestTree.hpp"
+
+namespace {
+
+using bftEngine::bcst::impl::DataStore;
+using bftEngine::bcst::impl::ResPagesDigestTree;
+using concord::util::digest::Digest;
+using concord::util::digest::DigestUtil;
+
+struct DescDeleter {
+  void operator()(DataStore::ResPagesDescriptor* desc) const { std::free(desc); }
+};
+using DescPtr = std::unique_ptr<DataStore::ResPagesDescriptor, DescDeleter>;
+
+DescPtr makeDescriptor(uint32_t numOfPages) {
+  const auto size = DataStore::ResPagesDescriptor::size(numOfPages);
+  auto desc = static_cast<DataStore::ResPagesDescriptor*>(std::calloc(1, size));
+  desc->numOfPages = numOfPages;
+  return DescPtr{desc};
+}
+
+Digest randomDigest(std::mt19937& gen) {
+  Digest d;
+  for (size_t i = 0; i < sizeof(Digest); ++i) d.getForUpdate()[i] = static_cast<char>(gen());
+  return d;
+}
+
+void setPage(DataStore::ResPagesDescriptor* desc, uint32_t pageId, uint64_t checkpoint, const Digest& digest) {
+  desc->d[pageId].pageId = pageId;
+  desc->d[pageId].relevantCheckpoint = checkpoint;
+  desc->d[pageId].pageDigest = digest;
+}
+
+Digest hash(const std::string& input) {
+  Digest d;
+  DigestUtil::compute(input.data(), input.size(), d.getForUpdate(), sizeof(Digest));
+  return d;
+}
+
+template <typename T>
+std::string bytes(const T& v) {
+  return std::string(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+// A straightforward recursive definition of the tree digest
+Digest referenceNode(const DataStore::ResPagesDescriptor* desc, uint64_t width, uint64_t first) {
+  if (first >= desc->numOfPages) return Digest{};
+  if (width == 1) {
+    const auto pageId = static_cast<uint32_t>(first);
+    const auto& page = desc->d[pageId];
+    return hash(bytes(pageId) + bytes(page.relevantCheckpoint) + std::string(page.pageDigest.get(), sizeof(Digest)));
+  }
+  const auto left = referenceNode(desc, width / 2, first);
+  const auto right = referenceNode(desc, width / 2, first + width / 2);
+  return hash(std::string(left.get(), sizeof(Digest)) + std::string(right.get(), sizeof(Digest)));
+}
+
+Digest referenceDigest(const DataStore::ResPagesDescriptor* desc) {
+  uint64_t width = 1;
+  while (width < desc->numOfPages) width *= 2;
+  const auto root = referenceNode(desc, width, 0);
+  return hash(bytes(desc->numOfPages) + std::string(root.get(), sizeof(Digest)));
+}
+
+TEST(res_pages_digest_tree, matches_reference) {
+  std::mt19937 gen{42};
+  for (uint32_t numOfPages : {1u, 2u, 3u, 7u, 8u, 100u, 1025u}) {
+    auto desc = makeDescriptor(numOfPages);
+    ASSERT_EQ(ResPagesDigestTree::compute(desc.get()), referenceDigest(desc.get())) << numOfPages;
+    for (uint32_t i = 0; i < numOfPages; i += 2) setPage(desc.get(), i, gen() % 10 + 1, randomDigest(gen));
+    ASSERT_EQ(ResPagesDigestTree::compute(desc.get()), referenceDigest(desc.get())) << numOfPages;
+  }
+}
+
+TEST(res_pages_digest_tree, incremental_updates) {
+  std::mt19937 gen{7};
+  const uint32_t numOfPages = 1000;
+  auto desc = makeDescriptor(numOfPages);
+  ResPagesDigestTree tree{desc.get()};
+  ASSERT_EQ(tree.digest(), ResPagesDigestTree::compute(desc.get()));
+
+  for (uint64_t checkpoint = 1; checkpoint <= 20; ++checkpoint) {
+    const auto numOfUpdates = gen() % 50;
+    for (uint32_t i = 0; i < numOfUpdates; ++i) {
+      const auto pageId = static_cast<uint32_t>(gen() % numOfPages);
+      const auto digest = randomDigest(gen);
+      setPage(desc.get(), pageId, checkpoint, digest);
+      tree.update(pageId, checkpoint, digest);
+    }
+    ASSERT_EQ(tree.digest(), ResPagesDigestTree::compute(desc.get())) << checkpoint;
+  }
+  // nothing changed
+  ASSERT_EQ(tree.digest(), ResPagesDigestTree::compute(desc.get()));
+}
+
+TEST(res_pages_digest_tree, any_page_change_changes_the_digest) {
+  const uint32_t numOfPages = 17;
+  auto desc = makeDescriptor(numOfPages);
+  ResPagesDigestTree tree{desc.get()};
+  auto prev = tree.digest();
+  for (uint32_t pageId = 0; pageId < numOfPages; ++pageId) {
+    tree.update(pageId, 1, Digest{});
+    const auto next = tree.digest();
+    ASSERT_NE(prev, next) << pageId;
+    prev = next;
+  }
+  // Same leaves, different number of pages
+  ASSERT_NE(ResPagesDigestTree::compute(makeDescriptor(numOfPages).get()),
+            ResPagesDigestTree::compute(makeDescriptor(numOfPages + 1).get()));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -17,6 +17,9 @@
 #include "messages/ClientReplyMsg.hpp"
 #include "ReservedPagesMock.hpp"
 
+#include <atomic>
+#include <thread>
+
 using bftEngine::impl::ClientsManager;
 using bftEngine::impl::NodeIdType;
 using bftEngine::impl::ReplicasInfo;
@@ -878,6 +881,39 @@ TEST(ClientsManager, allocateReplyFromSavedOneCorrectlyHandlesCasesWithClientBat
          "matching the reply that should have been in the reserved pages in the case where client batching is enabled.";
 }
 
+TEST(ClientsManager, allocateReplyFromSavedOneServesCachedReplies) {
+  resetMockReservedPages();
+  ReplicaConfig::instance().setclientBatchingEnabled(false);
+  string reply_3 = "reply 3 to client 1";
+  string reply_4 = "reply 4 to client 1";
+
+  unique_ptr<ClientsManager> cm(new ClientsManager({8}, {1, 2}, {}, {4}, metrics));
+  cm->allocateNewReplyMsgAndWriteToStorage(1, 3, 9, reply_3.data(), reply_3.length(), kRSILengthForTesting);
+  auto res_pages_with_reply_3 = getMockReservedPages();
+
+  // The latest reply is answered from memory, without the reserved pages
+  resetMockReservedPages();
+  unique_ptr<ClientReplyMsg> message = cm->allocateReplyFromSavedOne(1, 3, 12);
+  ASSERT_TRUE(message) << "ClientsManager::allocateReplyFromSavedOne failed to return the cached reply.";
+  EXPECT_EQ(message->reqSeqNum(), 3);
+  EXPECT_EQ(message->currentPrimaryId(), 12);
+  EXPECT_EQ(string(message->replyBuf(), message->replyLength()), reply_3);
+
+  cm->allocateNewReplyMsgAndWriteToStorage(1, 4, 9, reply_4.data(), reply_4.length(), kRSILengthForTesting);
+  message = cm->allocateReplyFromSavedOne(1, 4, 12);
+  ASSERT_TRUE(message);
+  EXPECT_EQ(string(message->replyBuf(), message->replyLength()), reply_4)
+      << "ClientsManager::allocateReplyFromSavedOne returned a stale cached reply after a newer one was saved.";
+
+  // Reserved pages replaced under the ClientsManager, e.g. by state transfer, are reloaded and so is the reply
+  setMockReservedPages(res_pages_with_reply_3);
+  cm->loadInfoFromReservedPages();
+  message = cm->allocateReplyFromSavedOne(1, 3, 12);
+  ASSERT_TRUE(message);
+  EXPECT_EQ(string(message->replyBuf(), message->replyLength()), reply_3)
+      << "ClientsManager::allocateReplyFromSavedOne returned a cached reply not matching the reloaded reserved pages.";
+}
+
 TEST(ClientsManager, isClientRequestInProcess) {
   resetMockReservedPages();
 
@@ -912,6 +948,40 @@ TEST(ClientsManager, isClientRequestInProcess) {
          "ClientsManager.";
 }
 
+TEST(ClientsManager, isClientRequestInProcessConcurrentlyWithUpdates) {
+  ReplicaConfig::instance().setclientBatchingEnabled(true);
+  ReplicaConfig::instance().setclientBatchingMaxMsgsNbr(4);
+  resetMockReservedPages();
+
+  unique_ptr<ClientsManager> cm(new ClientsManager({1}, {2, 60000}, {}, {}, metrics));
+  const ReqId kLongRunningReqId = 1000000;
+  cm->addPendingRequest(60000, kLongRunningReqId, "correlation ID");
+
+  // Requests come and go while another thread looks them up; more of them than fit in the lock-free slots are pending
+  // at any time.
+  std::atomic_bool done{false};
+  std::thread reader([&]() {
+    while (!done) {
+      EXPECT_TRUE(cm->isClientRequestInProcess(60000, kLongRunningReqId));
+      EXPECT_FALSE(cm->isClientRequestInProcess(60000, kLongRunningReqId + 1));
+    }
+  });
+  const ReqId kInFlight = 6;
+  for (ReqId i = 1; i < 100000; ++i) {
+    cm->addPendingRequest(60000, i, "correlation ID");
+    if (i > kInFlight) cm->removePendingForExecutionRequest(60000, i - kInFlight);
+  }
+  done = true;
+  reader.join();
+
+  for (ReqId i = 1; i < 100000; ++i) {
+    EXPECT_EQ(cm->isClientRequestInProcess(60000, i), i >= 100000 - kInFlight);
+  }
+  cm->clearAllPendingRequests();
+  EXPECT_FALSE(cm->isClientRequestInProcess(60000, kLongRunningReqId));
+  ReplicaConfig::instance().setclientBatchingEnabled(false);
+}
+
 TEST(ClientsManager, canBecomePending) {
   resetMockReservedPages();
 
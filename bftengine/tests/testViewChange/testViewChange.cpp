@@ -407,6 +407,78 @@ TEST(testViewchangeSafetyLogic_test, computeRestrictions_two_prepare_certs_one_i
   delete ppMsg2;
 }
 
+// Prepared certificates verified in advance are shared by the view change messages which carry them, and are used by
+// computeRestrictions.
+TEST(testViewchangeSafetyLogic_test, computeRestrictions_with_prefetched_certificates) {
+  bftEngine::ReservedPagesClientBase::setReservedPages(&res_pages_mock_);
+  bftEngine::impl::SeqNum lastStableSeqNum = 150;
+  const uint32_t kRequestLength = 2;
+  const uint64_t requestBuffer[kRequestLength] = {(uint64_t)200, (uint64_t)12345};
+  ViewNum view = 0;
+  bftEngine::impl::SeqNum assignedSeqNum = lastStableSeqNum + 1;
+
+  auto* clientRequest = new ClientRequestMsg((uint16_t)1,
+                                             bftEngine::ClientMsgFlag::EMPTY_FLAGS_REQ,
+                                             (uint64_t)1234567,
+                                             kRequestLength,
+                                             (const char*)requestBuffer,
+                                             (uint64_t)1000000);
+
+  auto primary = pRepInfo->primaryOfView(view);
+  auto* ppMsg =
+      new PrePrepareMsg(primary, view, assignedSeqNum, bftEngine::impl::CommitPath::SLOW, clientRequest->size());
+  ppMsg->addRequest(clientRequest->body(), clientRequest->size());
+  ppMsg->finishAddingRequests();
+
+  char buff[32]{};
+  PrepareFullMsg* pfMsg = PrepareFullMsg::create(view, assignedSeqNum, primary, buff, sizeof(buff));
+
+  ViewChangeMsg** viewChangeMsgs = new ViewChangeMsg*[N];
+  auto futureView = view + 1;
+
+  viewChangeMsgs[0] = new ViewChangeMsg(0, futureView, lastStableSeqNum);
+  viewChangeMsgs[1] = nullptr;
+  viewChangeMsgs[2] = new ViewChangeMsg(2, futureView, lastStableSeqNum);
+  viewChangeMsgs[3] = new ViewChangeMsg(3, futureView, lastStableSeqNum);
+
+  // The same certificate in two messages
+  for (int i : {2, 3}) {
+    viewChangeMsgs[i]->addElement(assignedSeqNum,
+                                  ppMsg->digestOfRequests(),
+                                  ppMsg->viewNumber(),
+                                  true,
+                                  ppMsg->viewNumber(),
+                                  pfMsg->signatureLen(),
+                                  pfMsg->signatureBody());
+  }
+
+  auto VCS = ViewChangeSafetyLogic(N, F, C, PrePrepareMsg::digestOfNullPrePrepareMsg());
+  for (int i = 0; i < N; i++) {
+    if (viewChangeMsgs[i] != nullptr) VCS.prefetchCertificates(viewChangeMsgs[i]);
+  }
+  ASSERT_EQ(VCS.numOfCachedCertificates(), 1);
+
+  SeqNum min{}, max{};
+  VCS.computeRestrictions(viewChangeMsgs, VCS.calcLBStableForView(viewChangeMsgs), min, max, restrictions);
+
+  ASSERT_FALSE(restrictions[assignedSeqNum - min].isNull);
+  ASSERT_EQ(ppMsg->digestOfRequests().toString(), restrictions[assignedSeqNum - min].digest.toString());
+  ASSERT_EQ(VCS.numOfCachedCertificates(), 1);
+
+  // Once the sequence number is below the stable point, its certificates are dropped
+  VCS.computeRestrictions(viewChangeMsgs, assignedSeqNum, min, max, restrictions);
+  ASSERT_EQ(VCS.numOfCachedCertificates(), 0);
+
+  for (int i = 0; i < N; i++) {
+    delete viewChangeMsgs[i];
+    viewChangeMsgs[i] = nullptr;
+  }
+  delete[] viewChangeMsgs;
+  delete clientRequest;
+  delete pfMsg;
+  delete ppMsg;
+}
+
 TEST(testViewchangeSafetyLogic_test, one_different_new_view_in_VC_msgs) {
   bftEngine::ReservedPagesClientBase::setReservedPages(&res_pages_mock_);
   ViewChangeMsg** viewChangeMsgs = new ViewChangeMsg*[N];
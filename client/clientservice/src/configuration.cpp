@@ -123,6 +123,7 @@ void parseConfigFile(ConcordClientConfig& config, const YAML::Node& yaml) {
   readYamlField(yaml, "enable_multiplex_channel", config.transport.enable_multiplex_channel);
   readYamlField(yaml, "enable_mock_comm", config.transport.enable_mock_comm);
   readYamlField(yaml, "concord-bft_communication_buffer_length", config.transport.buffer_length);
+  readYamlField(yaml, "trc_hedged_data_streams", config.subscribe_config.hedged_data_streams, false);
   concord::client::concordclient::TransportConfig::CommunicationType comm_type;
   std::string comm;
   readYamlField(yaml, "comm_to_use", comm);
@@ -105,6 +105,8 @@ struct SubscribeConfig {
   std::string pem_cert_chain;
   // Buffer with the client's PEM encoded private key
   std::string pem_private_key;
+  // Read updates from two replicas at a time, see ThinReplicaClientConfig::hedged_data_streams
+  bool hedged_data_streams = false;
 };
 
 struct StateSnapshotConfig {
@@ -131,6 +133,12 @@ struct ConcordClientConfig {
 struct StateSnapshotRequest {
   uint64_t snapshot_id;
   std::optional<std::string> last_received_key;
+  // If set, the snapshot is streamed up to and including this key.
+  std::optional<std::string> last_key;
+  // If set, only the key-values of the shard (see getSnapshotShards()) are streamed and verified against its hashes.
+  // `last_received_key` and `last_key` are ignored. If the key-values don't match the hashes, the stream ends with
+  // SnapshotVerificationFailed.
+  std::optional<SnapshotShard> shard;
 };
 
 struct EventGroupRequest {
@@ -174,6 +182,12 @@ class ConcordClient {
   // Key-values are streamed with lexicographic order on keys.
   void getSnapshot(const StateSnapshotRequest& request, std::shared_ptr<SnapshotQueue>& remote_queue);
 
+  // Split a specific state snapshot in at most `max_shards` shards (0 means no limit), in key order. Each shard can be
+  // streamed and verified on its own by getSnapshot(), e.g. in parallel. Together, the shards of a snapshot make up all
+  // of its key-values and the end hash of the last one is the public state hash of the snapshot. The shards are only
+  // returned once f + 1 replicas agree on them, otherwise SnapshotVerificationFailed is thrown.
+  std::vector<SnapshotShard> getSnapshotShards(uint64_t snapshot_id, uint32_t max_shards);
+
   // Get subscription id.
   std::string getSubscriptionId() const { return config_.subscribe_config.id; }
 
@@ -181,6 +195,7 @@ class ConcordClient {
   config_pool::ConcordClientPoolConfig createClientPoolStruct(const ConcordClientConfig& config);
   void createGrpcConnections();
   void checkAndReConnectGrpcConnections();
+  void createStateSnapshotClientIfNeeded();
 
   logging::Logger logger_;
   const ConcordClientConfig& config_;
@@ -53,6 +53,12 @@ class StreamUnavailable : public std::runtime_error {
   StreamUnavailable() : std::runtime_error("Stream is not available"){};
 };
 
+// The streamed key-values of a state snapshot shard don't match the hashes of the shard
+class SnapshotVerificationFailed : public std::runtime_error {
+ public:
+  SnapshotVerificationFailed() : std::runtime_error("state snapshot verification failed"){};
+};
+
 // An internal error may occur due to service unavailability.
 class RequestOverload : public std::runtime_error {
  public:
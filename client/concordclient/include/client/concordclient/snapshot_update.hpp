@@ -13,6 +13,8 @@
 
 #pragma once
 
+#include <cstdint>
+#include <optional>
 #include <string>
 
 #include "client/concordclient/thread_safe_queue.hpp"
@@ -24,6 +26,25 @@ struct SnapshotKVPair {
   std::string val;
 };
 
+// A shard of a state snapshot, i.e. consecutive key-values which can be streamed and verified independently of the
+// other shards of the snapshot. See GetSnapshotShards in replica_state_snapshot.proto.
+struct SnapshotShard {
+  // The last key of the previous shard. Not set for the first shard.
+  std::optional<std::string> after_key;
+  // The last key of the shard. Not set if the shard extends to the end of the snapshot.
+  std::optional<std::string> last_key;
+  uint64_t num_key_values{0};
+  // Chaining the key-values of the shard from start_hash results in end_hash. The end_hash of the last shard is the
+  // public state hash of the snapshot.
+  std::string start_hash;
+  std::string end_hash;
+
+  bool operator==(const SnapshotShard& other) const {
+    return after_key == other.after_key && last_key == other.last_key && num_key_values == other.num_key_values &&
+           start_hash == other.start_hash && end_hash == other.end_hash;
+  }
+};
+
 using SnapshotQueue = IQueue<SnapshotKVPair>;
 using BasicSnapshotQueue = BasicThreadSafeQueue<SnapshotKVPair>;
 
@@ -173,6 +173,7 @@ void ConcordClient::subscribe(const SubscribeRequest& sub_req,
 
   auto trc_config = std::make_unique<ThinReplicaClientConfig>(
       config_.subscribe_config.id, queue, config_.topology.f_val, grpc_connections_);
+  trc_config->hedged_data_streams = config_.subscribe_config.hedged_data_streams;
   trc_ = std::make_unique<ThinReplicaClient>(std::move(trc_config), metrics_);
 
   if (std::holds_alternative<EventGroupRequest>(sub_req.request)) {
@@ -199,19 +200,32 @@ void ConcordClient::unsubscribe() {
 void ConcordClient::getSnapshot(const StateSnapshotRequest& request, std::shared_ptr<SnapshotQueue>& remote_queue) {
   LOG_INFO(logger_, "getSnapshot called.");
   checkAndReConnectGrpcConnections();
-  if (!rss_) {
-    // Lazy initialization, when required for the first time.
-    auto rss_config = std::make_unique<ReplicaStateSnapshotClientConfig>(grpc_connections_,
-                                                                         config_.state_snapshot_config.num_threads);
-    rss_ = std::make_unique<ReplicaStateSnapshotClient>(std::move(rss_config));
-  }
+  createStateSnapshotClientIfNeeded();
 
   ::client::replica_state_snapshot_client::SnapshotRequest rss_request;
   rss_request.snapshot_id = request.snapshot_id;
   if (request.last_received_key.has_value()) {
     rss_request.last_received_key = request.last_received_key.value();
   }
+  rss_request.last_key = request.last_key;
+  rss_request.shard = request.shard;
   rss_->readSnapshotStream(rss_request, remote_queue);
 }
 
+std::vector<SnapshotShard> ConcordClient::getSnapshotShards(uint64_t snapshot_id, uint32_t max_shards) {
+  LOG_INFO(logger_, "getSnapshotShards called.");
+  checkAndReConnectGrpcConnections();
+  createStateSnapshotClientIfNeeded();
+  return rss_->readSnapshotShards(snapshot_id, max_shards);
+}
+
+void ConcordClient::createStateSnapshotClientIfNeeded() {
+  if (!rss_) {
+    // Lazy initialization, when required for the first time.
+    auto rss_config = std::make_unique<ReplicaStateSnapshotClientConfig>(
+        grpc_connections_, config_.state_snapshot_config.num_threads, config_.topology.f_val);
+    rss_ = std::make_unique<ReplicaStateSnapshotClient>(std::move(rss_config));
+  }
+}
+
 }  // namespace concord::client::concordclient
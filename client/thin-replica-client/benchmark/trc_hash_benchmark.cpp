@@ -0,0 +1,136 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the
+// "License").  You may not use this product except in compliance with the
+// Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+// Microbenchmarks of the Thin Replica update hash: hashUpdate() versus the original implementation, which hashes every
+// entry into its own string and orders the entry hashes with an std::map or an std::set.
+//
+// Every benchmark hashes an update of state.range(0) entries with values of state.range(1) bytes per iteration.
+// Compare the items/second of legacy* against batch* for the same arguments.
+
+#include <benchmark/benchmark.h>
+
+#include "client/thin-replica-client/trc_hash.hpp"
+#include "openssl_crypto.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+
+namespace {
+
+using com::vmware::concord::thin_replica::Data;
+using concord::util::openssl_utils::computeSHA256Hash;
+
+std::string randomString(std::mt19937 &gen, std::size_t size) {
+  auto dist = std::uniform_int_distribution<int>{0, 255};
+  auto str = std::string(size, '\0');
+  for (auto &c : str) c = static_cast<char>(dist(gen));
+  return str;
+}
+
+// Keys are 32 bytes, as are most keys of the execution engines.
+Data keyValueUpdate(std::size_t count, std::size_t value_size) {
+  auto gen = std::mt19937{};
+  auto update = Data{};
+  update.mutable_events()->set_block_id(1337);
+  for (std::size_t i = 0; i < count; ++i) {
+    auto kvp = update.mutable_events()->add_data();
+    kvp->set_key(randomString(gen, 32));
+    kvp->set_value(randomString(gen, value_size));
+  }
+  return update;
+}
+
+Data eventGroupUpdate(std::size_t count, std::size_t event_size) {
+  auto gen = std::mt19937{};
+  auto update = Data{};
+  update.mutable_event_group()->set_id(1337);
+  for (std::size_t i = 0; i < count; ++i) {
+    *update.mutable_event_group()->add_events() = randomString(gen, event_size);
+  }
+  return update;
+}
+
+std::string idBytes(std::uint64_t id) { return std::string(reinterpret_cast<const char *>(&id), sizeof(id)); }
+
+std::string legacyHashUpdate(const Data &update) {
+  if (update.has_events()) {
+    std::map<std::string, std::string> entry_hashes;
+    for (const auto &kvp : update.events().data()) {
+      entry_hashes[computeSHA256Hash(kvp.key())] = computeSHA256Hash(kvp.value());
+    }
+    std::string concatenated = idBytes(update.events().block_id());
+    for (const auto &[key_hash, value_hash] : entry_hashes) {
+      concatenated.append(key_hash);
+      concatenated.append(value_hash);
+    }
+    return computeSHA256Hash(concatenated);
+  }
+  std::set<std::string> entry_hashes;
+  for (const auto &event : update.event_group().events()) {
+    entry_hashes.emplace(computeSHA256Hash(event));
+  }
+  std::string concatenated = idBytes(update.event_group().id());
+  for (const auto &hash : entry_hashes) {
+    concatenated.append(hash);
+  }
+  return computeSHA256Hash(concatenated);
+}
+
+void setProcessed(benchmark::State &state) { state.SetItemsProcessed(state.iterations() * state.range(0)); }
+
+template <typename Hash>
+void run(benchmark::State &state, const Data &update, Hash hash) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(hash(update));
+  }
+  setProcessed(state);
+}
+
+void legacyKeyValue(benchmark::State &state) {
+  run(state, keyValueUpdate(state.range(0), state.range(1)), legacyHashUpdate);
+}
+void batchKeyValue(benchmark::State &state) {
+  run(state, keyValueUpdate(state.range(0), state.range(1)), [](const Data &update) {
+    return client::thin_replica_client::hashUpdate(update);
+  });
+}
+void legacyEventGroup(benchmark::State &state) {
+  run(state, eventGroupUpdate(state.range(0), state.range(1)), legacyHashUpdate);
+}
+void batchEventGroup(benchmark::State &state) {
+  run(state, eventGroupUpdate(state.range(0), state.range(1)), [](const Data &update) {
+    return client::thin_replica_client::hashUpdate(update);
+  });
+}
+
+// {number of entries, value size}
+void updateArgs(benchmark::internal::Benchmark *b) {
+  for (auto count : {1, 16, 256, 4096}) {
+    for (auto size : {32, 256, 4096}) {
+      b->Args({count, size});
+    }
+  }
+}
+
+}  // namespace
+
+BENCHMARK(legacyKeyValue)->Apply(updateArgs);
+BENCHMARK(batchKeyValue)->Apply(updateArgs);
+BENCHMARK(legacyEventGroup)->Apply(updateArgs);
+BENCHMARK(batchEventGroup)->Apply(updateArgs);
+
+BENCHMARK_MAIN();
@@ -174,6 +174,11 @@ class GrpcConnection {
   virtual Result readStateSnapshot(RequestId request_id,
                                    vmware::concord::replicastatesnapshot::StreamSnapshotResponse* snapshot_response);
 
+  // Read the shards of a state snapshot (connection has to be established before). Each shard can be streamed on its
+  // own state snapshot stream.
+  virtual Result readStateSnapshotShards(const vmware::concord::replicastatesnapshot::GetSnapshotShardsRequest& request,
+                                         vmware::concord::replicastatesnapshot::GetSnapshotShardsResponse* response);
+
   // Helper to print/log connection details
   friend std::ostream& operator<<(std::ostream& os, const GrpcConnection& trsc) {
     return os << trsc.client_id_ << " (" << trsc.address_ << ")";
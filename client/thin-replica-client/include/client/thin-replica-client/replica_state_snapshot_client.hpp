@@ -21,6 +21,7 @@
 #include <opentracing/span.h>
 #include <condition_variable>
 #include <thread>
+#include <vector>
 
 #include "grpc_connection.hpp"
 #include "thread_pool.hpp"
@@ -40,9 +41,14 @@ struct ReplicaStateSnapshotClientConfig {
   std::vector<std::shared_ptr<client::concordclient::GrpcConnection>>& rss_conns;
 
   uint32_t concurrency_level;
+
+  // max_faulty is the maximum number of simultaneously Byzantine-faulty replicas. The shards of a snapshot are only
+  // accepted once max_faulty + 1 replicas agree on them.
+  uint16_t max_faulty;
   ReplicaStateSnapshotClientConfig(std::vector<std::shared_ptr<client::concordclient::GrpcConnection>>& rss_conns_,
-                                   uint32_t concurrency_level_)
-      : rss_conns(rss_conns_), concurrency_level(concurrency_level_) {}
+                                   uint32_t concurrency_level_,
+                                   uint16_t max_faulty_)
+      : rss_conns(rss_conns_), concurrency_level(concurrency_level_), max_faulty(max_faulty_) {}
 };
 
 // TODO: Add metrics
@@ -51,10 +57,19 @@ struct ReplicaStateSnapshotClientConfig {
 struct SnapshotRequest {
   uint64_t snapshot_id;
   std::optional<std::string> last_received_key;
+  // If set, the stream ends after this key.
+  std::optional<std::string> last_key;
+  // If set, only the key-values of the shard are streamed and `last_received_key` and `last_key` are ignored. The
+  // key-values are verified against the hashes of the shard as they are streamed. If they don't match, the stream ends
+  // with SnapshotVerificationFailed and the key-values received so far must be discarded.
+  std::optional<concord::client::concordclient::SnapshotShard> shard;
 };
 
 class ReplicaStateSnapshotClient {
  public:
+  // Replicas are asked to pack key-values in responses of up to this many bytes.
+  static constexpr uint32_t kMaxResponseSize = 2 * 1024 * 1024;
+
   ReplicaStateSnapshotClient(std::unique_ptr<ReplicaStateSnapshotClientConfig> config)
       : logger_(logging::getLogger("concord.client.replica_stream_snapshot")),
         config_(std::move(config)),
@@ -63,7 +78,16 @@ class ReplicaStateSnapshotClient {
   void readSnapshotStream(const SnapshotRequest& request,
                           std::shared_ptr<concord::client::concordclient::SnapshotQueue> remote_queue);
 
+  // Read the shards of a snapshot, in key order. The replicas may return fewer than `max_shards` (0 means no limit).
+  // A list of shards is only returned once it chains from the empty state to its last shard and max_faulty + 1
+  // replicas returned it. Throws SnapshotVerificationFailed if the replicas don't agree on a valid list and the
+  // exceptions a snapshot stream ends with if they can't be read.
+  std::vector<concord::client::concordclient::SnapshotShard> readSnapshotShards(uint64_t snapshot_id,
+                                                                                uint32_t max_shards);
+
  private:
+  class ShardVerifier;
+
   // Thread function to start subscription_thread_ with snapshot.
   void receiveSnapshot(const SnapshotRequest& request,
                        std::shared_ptr<concord::client::concordclient::SnapshotQueue> remote_queue);
@@ -72,7 +96,8 @@ class ReplicaStateSnapshotClient {
 
   void pushDatumToRemoteQueue(const vmware::concord::replicastatesnapshot::StreamSnapshotResponse& datum,
                               std::shared_ptr<concord::client::concordclient::SnapshotQueue> remote_queue,
-                              std::string& last_key);
+                              std::string& last_key,
+                              ShardVerifier* verifier);
 
   logging::Logger logger_;
   std::unique_ptr<ReplicaStateSnapshotClientConfig> config_;
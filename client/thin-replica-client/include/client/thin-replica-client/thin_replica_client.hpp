@@ -43,9 +43,13 @@
 #include "grpc_connection.hpp"
 #include "assertUtils.hpp"
 #include "Metrics.hpp"
+#include "thread_pool.hpp"
 
 #include <opentracing/span.h>
 #include <condition_variable>
+#include <future>
+#include <mutex>
+#include <optional>
 #include <thread>
 #include "Logger.hpp"
 #include "client/concordclient/event_update.hpp"
@@ -105,6 +109,9 @@ struct ThinReplicaClientConfig {
   // the time duration the TRC waits before printing warning logs when
   // responsive agreeing servers are less than config_->max_faulty + 1
   std::chrono::seconds no_agreement_warn_duration;
+  // If set, updates are read from the data streams of two servers at a time and the first update to arrive is used.
+  // It is still verified against the hashes of the other servers before it gets pushed to the update queue.
+  bool hedged_data_streams{false};
 
   ThinReplicaClientConfig(std::string client_id_,
                           std::shared_ptr<concord::client::concordclient::EventUpdateQueue> update_queue_,
@@ -197,6 +204,33 @@ class ThinReplicaClient final {
   std::unique_ptr<std::thread> subscription_thread_;
   std::atomic_bool stop_subscription_thread_;
 
+  // Reads the hash streams of a round of findBlockHashAgreement() along with the subscription thread, which reads the
+  // first one itself. A round asks at most max_faulty + 1 servers. Not created if max_faulty is 0.
+  std::unique_ptr<concord::util::ThreadPool> hash_read_pool_;
+
+  // With hedged data streams, updates are read from the data streams of data_conn_index_ and hedge_conn_index_ on
+  // data_read_pool_. The server whose update arrives first becomes the data server and the other one the hedge server.
+  // A read that hasn't completed yet is kept for the next update.
+  struct DataStreamRead {
+    client::concordclient::GrpcConnection::Result result;
+    com::vmware::concord::thin_replica::Data data;
+  };
+  struct HedgedDataRead {
+    // The read in flight, if any
+    std::future<void> task;
+    // Set once the read completes, guarded by data_reads_mutex_
+    std::optional<DataStreamRead> read;
+    // The stream is reopened by the next read of the hedge server
+    bool reopen{false};
+  };
+  std::optional<size_t> hedge_conn_index_;
+  // One per server
+  std::vector<HedgedDataRead> data_reads_;
+  std::mutex data_reads_mutex_;
+  std::condition_variable data_read_done_;
+  // Destroyed first: its tasks access the members above. Not created without hedged data streams.
+  std::unique_ptr<concord::util::ThreadPool> data_read_pool_;
+
   // Thread function to start subscription_thread_ with.
   void receiveUpdates();
 
@@ -271,6 +305,12 @@ class ThinReplicaClient final {
                                  std::unique_ptr<LogCid>& cid);
 
   client::concordclient::GrpcConnection::Result resetDataStreamTo(size_t server_idx);
+  // Read the next update from the data streams of the data server and the hedge server, whichever arrives first. The
+  // server it arrived from becomes the data server. Returns the result of the data server if neither read succeeds.
+  client::concordclient::GrpcConnection::Result readHedgedDataStreams(com::vmware::concord::thin_replica::Data& data);
+  void startDataRead(size_t server_index);
+  // Wait for the reads in flight and drop their results
+  void drainDataReads();
   client::concordclient::GrpcConnection::Result startHashStreamWith(size_t server_idx);
   void closeAllHashStreams();
 
@@ -284,8 +324,20 @@ class ThinReplicaClient final {
                            size_t& maximal_agreeing_subset_size,
                            HashRecord& maximally_agreed_on_update);
 
+  // The outcome of opening (if it wasn't open yet) and reading the hash stream of a server. Only touches the
+  // connection to that server, so that the streams of several servers can be read concurrently.
+  struct HashStreamRead {
+    std::optional<client::concordclient::GrpcConnection::Result> open_result;
+    client::concordclient::GrpcConnection::Result read_result{client::concordclient::GrpcConnection::Result::kFailure};
+    com::vmware::concord::thin_replica::Hash hash;
+  };
+  HashStreamRead readHashFromServer(size_t server_index);
+
+  // Records the hash update read from the hash stream of a server, given the result of the read.
   // Returns true if a hash update is received from a hash stream, returns false otherwise
   bool readUpdateHashFromStream(size_t server_index,
+                                client::concordclient::GrpcConnection::Result read_result,
+                                const com::vmware::concord::thin_replica::Hash& hash,
                                 HashRecordMap& server_indexes_by_reported_update,
                                 size_t& maximal_agreeing_subset_size,
                                 HashRecord& maximally_agreed_on_update,
@@ -312,7 +364,14 @@ class ThinReplicaClient final {
         latest_verified_event_group_id_(0),
         is_subscription_successful_(false),
         subscription_thread_(),
-        stop_subscription_thread_(false) {
+        stop_subscription_thread_(false),
+        hash_read_pool_(config_->max_faulty > 0
+                            ? std::make_unique<concord::util::ThreadPool>(config_->max_faulty, "trc_hash_read")
+                            : nullptr),
+        data_reads_(config_->trs_conns.size()),
+        data_read_pool_(config_->hedged_data_streams && config_->trs_conns.size() > 1
+                            ? std::make_unique<concord::util::ThreadPool>(2, "trc_data_read")
+                            : nullptr) {
     metrics_.setAggregator(aggregator);
     if (config_->trs_conns.size() < (3 * (size_t)config_->max_faulty + 1)) {
       size_t num_servers = config_->trs_conns.size();
@@ -536,4 +536,34 @@ GrpcConnection::Result GrpcConnection::readStateSnapshot(
   return Result::kFailure;
 }
 
+GrpcConnection::Result GrpcConnection::readStateSnapshotShards(
+    const vmware::concord::replicastatesnapshot::GetSnapshotShardsRequest& request,
+    vmware::concord::replicastatesnapshot::GetSnapshotShardsResponse* response) {
+  ReadLock read_lock(channel_mutex_);
+  ConcordAssertNE(rss_stub_, nullptr);
+
+  ClientContext context;
+  context.AddMetadata("client_id", client_id_);
+  auto result = async(launch::async, [this, &context, &request, response] {
+    ReadLock read_lock(channel_mutex_);
+    return rss_stub_->GetSnapshotShards(&context, request, response);
+  });
+  auto status = result.wait_for(snapshot_timeout_);
+  if (status == future_status::timeout || status == future_status::deferred) {
+    context.TryCancel();
+    result.wait();
+    return Result::kTimeout;
+  }
+
+  ConcordAssertEQ(status, future_status::ready);
+  Status call_grpc_status = result.get();
+  if (call_grpc_status.ok()) return Result::kSuccess;
+
+  LOG_WARN(logger_,
+           "GetSnapshotShards from " << address_ << " failed with error code: " << call_grpc_status.error_code()
+                                     << ", \"" << call_grpc_status.error_message() << "\".");
+  if (call_grpc_status.error_code() == grpc::StatusCode::NOT_FOUND) return Result::kNotFound;
+  return Result::kFailure;
+}
+
 }  // namespace client::concordclient
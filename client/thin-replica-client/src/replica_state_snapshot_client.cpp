@@ -11,8 +11,11 @@
 // terms and conditions of the subcomponent's license, as noted in the LICENSE
 // file.
 
+#include <algorithm>
+
 #include "client/concordclient/concord_client_exceptions.hpp"
 #include "client/thin-replica-client/replica_state_snapshot_client.hpp"
+#include "sha_hash.hpp"
 
 using client::concordclient::GrpcConnection;
 using concord::client::concordclient::SnapshotKVPair;
@@ -23,10 +26,66 @@ using concord::client::concordclient::EndOfStream;
 using concord::client::concordclient::StreamUnavailable;
 using concord::client::concordclient::RequestOverload;
 using concord::client::concordclient::SnapshotQueue;
+using concord::client::concordclient::SnapshotShard;
+using concord::client::concordclient::SnapshotVerificationFailed;
+using vmware::concord::replicastatesnapshot::GetSnapshotShardsRequest;
+using vmware::concord::replicastatesnapshot::GetSnapshotShardsResponse;
 using vmware::concord::replicastatesnapshot::StreamSnapshotRequest;
 using vmware::concord::replicastatesnapshot::StreamSnapshotResponse;
 
 namespace client::replica_state_snapshot_client {
+
+// Chains the key-values of a shard the way the public state hash is computed:
+//   h = SHA3-256(h || SHA3-256(key) || value)
+class ReplicaStateSnapshotClient::ShardVerifier {
+ public:
+  ShardVerifier(const SnapshotShard& shard) : shard_{shard} {
+    if (shard_.start_hash.size() == hash_.size()) {
+      std::copy(shard_.start_hash.cbegin(), shard_.start_hash.cend(), hash_.begin());
+    }
+  }
+
+  void add(const std::string& key, const std::string& value) {
+    const auto key_hash = hasher_.digest(key.data(), key.size());
+    hasher_.init();
+    hasher_.update(hash_.data(), hash_.size());
+    hasher_.update(key_hash.data(), key_hash.size());
+    hasher_.update(value.data(), value.size());
+    hash_ = hasher_.finish();
+    ++num_key_values_;
+  }
+
+  bool verified() const {
+    return shard_.start_hash.size() == hash_.size() && num_key_values_ == shard_.num_key_values &&
+           shard_.end_hash == std::string(reinterpret_cast<const char*>(hash_.data()), hash_.size());
+  }
+
+ private:
+  const SnapshotShard& shard_;
+  concord::util::SHA3_256 hasher_;
+  concord::util::SHA3_256::Digest hash_{};
+  uint64_t num_key_values_{0};
+};
+
+// A list of shards chains if the first shard starts from the empty state, each shard starts where the previous one
+// ends, both in keys and hashes, and only the last shard extends to the end of the snapshot.
+static bool isChainOfShards(const std::vector<SnapshotShard>& shards) {
+  const auto empty_state_hash = concord::util::SHA3_256{}.digest(nullptr, 0);
+  std::optional<std::string> after_key;
+  auto start_hash = std::string(reinterpret_cast<const char*>(empty_state_hash.data()), empty_state_hash.size());
+  for (size_t i = 0; i < shards.size(); ++i) {
+    const auto& shard = shards[i];
+    const auto is_last = i + 1 == shards.size();
+    if (shard.after_key != after_key || shard.start_hash != start_hash ||
+        shard.end_hash.size() != empty_state_hash.size() || shard.last_key.has_value() == is_last) {
+      return false;
+    }
+    after_key = shard.last_key;
+    start_hash = shard.end_hash;
+  }
+  return !shards.empty();
+}
+
 void ReplicaStateSnapshotClient::readSnapshotStream(const SnapshotRequest& request,
                                                     std::shared_ptr<SnapshotQueue> remote_queue) {
   if (count_of_concurrent_request_.load() > config_->concurrency_level) {
@@ -52,13 +111,21 @@ void ReplicaStateSnapshotClient::receiveSnapshot(const SnapshotRequest& request,
   uint16_t replica_id = 0;
   GrpcConnection::Result result = GrpcConnection::Result::kUnknown;
   std::string last_read_key("");
+  const auto& last_received_key = request.shard ? request.shard->after_key : request.last_received_key;
+  const auto& last_key = request.shard ? request.shard->last_key : request.last_key;
+  // The key-values are chained as they are received, across replicas
+  auto verifier = request.shard ? std::make_unique<ShardVerifier>(*request.shard) : nullptr;
   for (const auto& conn : config_->rss_conns) {
     concordclient::RequestId request_id = 0;
     vmware::concord::replicastatesnapshot::StreamSnapshotRequest stream_snapshot_request;
     stream_snapshot_request.set_snapshot_id(request.snapshot_id);
+    stream_snapshot_request.set_max_response_size(kMaxResponseSize);
+    if (last_key.has_value()) {
+      stream_snapshot_request.set_last_key(last_key.value());
+    }
     if (last_read_key.empty()) {
-      if (request.last_received_key.has_value()) {
-        stream_snapshot_request.set_last_received_key(request.last_received_key.value());
+      if (last_received_key.has_value()) {
+        stream_snapshot_request.set_last_received_key(last_received_key.value());
       }
     } else {
       stream_snapshot_request.set_last_received_key(last_read_key);
@@ -80,7 +147,7 @@ void ReplicaStateSnapshotClient::receiveSnapshot(const SnapshotRequest& request,
         result = GrpcConnection::Result::kFailure;
       }
       if (result == GrpcConnection::Result::kSuccess) {
-        pushDatumToRemoteQueue(stream_snapshot_response, remote_queue, last_read_key);
+        pushDatumToRemoteQueue(stream_snapshot_response, remote_queue, last_read_key, verifier.get());
       } else {
         is_reading = false;
         conn->cancelStateSnapshotStream(request_id);
@@ -91,16 +158,78 @@ void ReplicaStateSnapshotClient::receiveSnapshot(const SnapshotRequest& request,
     }
     replica_id++;
   }
+  if (result == GrpcConnection::Result::kEndOfStream && verifier && !verifier->verified()) {
+    LOG_ERROR(logger_, "Shard of state snapshot " << request.snapshot_id << " doesn't match its hashes");
+    throw SnapshotVerificationFailed();
+  }
   pushFinalStateToRemoteQueue(result);
 }
+
+std::vector<SnapshotShard> ReplicaStateSnapshotClient::readSnapshotShards(uint64_t snapshot_id, uint32_t max_shards) {
+  ConcordAssertGT(config_->rss_conns.size(), 0);
+  GetSnapshotShardsRequest request;
+  request.set_snapshot_id(snapshot_id);
+  request.set_max_shards(max_shards);
+  GrpcConnection::Result result = GrpcConnection::Result::kUnknown;
+  // The valid lists of shards read so far and the number of replicas that returned each of them
+  std::vector<std::pair<std::vector<SnapshotShard>, size_t>> lists;
+  bool read_invalid_list = false;
+  for (const auto& conn : config_->rss_conns) {
+    GetSnapshotShardsResponse response;
+    result = conn->readStateSnapshotShards(request, &response);
+    if (result != GrpcConnection::Result::kSuccess || response.shards().empty()) {
+      LOG_INFO(logger_, "Not able to read the shards of state snapshot " << snapshot_id << " from " << *conn);
+      continue;
+    }
+    std::vector<SnapshotShard> shards;
+    shards.reserve(response.shards_size());
+    for (const auto& s : response.shards()) {
+      auto& shard = shards.emplace_back();
+      if (s.has_after_key()) shard.after_key = s.after_key();
+      if (s.has_last_key()) shard.last_key = s.last_key();
+      shard.num_key_values = s.num_key_values();
+      shard.start_hash = s.start_hash();
+      shard.end_hash = s.end_hash();
+    }
+    if (!isChainOfShards(shards)) {
+      LOG_WARN(logger_, "The shards of state snapshot " << snapshot_id << " from " << *conn << " don't chain");
+      read_invalid_list = true;
+      continue;
+    }
+    auto it = std::find_if(lists.begin(), lists.end(), [&shards](const auto& list) { return list.first == shards; });
+    if (it == lists.end()) {
+      it = lists.emplace(lists.end(), std::move(shards), 0);
+    }
+    if (++it->second == config_->max_faulty + 1u) {
+      return std::move(it->first);
+    }
+  }
+  if (read_invalid_list || !lists.empty()) {
+    LOG_ERROR(logger_,
+              "No " << config_->max_faulty + 1u << " replicas agree on the shards of state snapshot " << snapshot_id);
+    throw SnapshotVerificationFailed();
+  }
+  // Only the errors are mapped to exceptions
+  pushFinalStateToRemoteQueue(result == GrpcConnection::Result::kSuccess ? GrpcConnection::Result::kFailure : result);
+  return {};
+}
+
 void ReplicaStateSnapshotClient::pushDatumToRemoteQueue(const StreamSnapshotResponse& datum,
                                                         std::shared_ptr<SnapshotQueue> remote_queue,
-                                                        std::string& last_key) {
+                                                        std::string& last_key,
+                                                        ShardVerifier* verifier) {
   if (datum.has_key_value()) {
     last_key.assign(datum.key_value().key());
+    if (verifier) verifier->add(last_key, datum.key_value().value());
     auto snapshot_datum = std::unique_ptr<SnapshotKVPair>{new SnapshotKVPair{last_key, datum.key_value().value()}};
     remote_queue->push(std::move(snapshot_datum));
   }
+  for (const auto& kv : datum.key_values()) {
+    last_key.assign(kv.key());
+    if (verifier) verifier->add(last_key, kv.value());
+    auto snapshot_datum = std::unique_ptr<SnapshotKVPair>{new SnapshotKVPair{last_key, kv.value()}};
+    remote_queue->push(std::move(snapshot_datum));
+  }
 }
 
 void ReplicaStateSnapshotClient::pushFinalStateToRemoteQueue(const GrpcConnection::Result& result) {
@@ -16,6 +16,11 @@
 #include <opentracing/propagation.h>
 #include <opentracing/span.h>
 #include <opentracing/tracer.h>
+#include <algorithm>
+#include <array>
+#include <future>
+#include <iterator>
+#include <map>
 #include <memory>
 #include <numeric>
 #include <sstream>
@@ -102,15 +107,15 @@ void ThinReplicaClient::recordCollectedHash(size_t update_source,
 }
 
 bool ThinReplicaClient::readUpdateHashFromStream(size_t server_index,
+                                                 GrpcConnection::Result read_result,
+                                                 const Hash& hash,
                                                  HashRecordMap& server_indexes_by_reported_update,
                                                  size_t& maximal_agreeing_subset_size,
                                                  HashRecord& maximally_agreed_on_update,
                                                  size_t& servers_out_of_range,
                                                  size_t& servers_pruned) {
-  Hash hash;
   LOG_DEBUG(logger_, "Read hash from " << server_index);
 
-  GrpcConnection::Result read_result = config_->trs_conns[server_index]->readHash(&hash);
   if (read_result == GrpcConnection::Result::kTimeout) {
     LOG_DEBUG(logger_, "Hash stream " << server_index << " timed out.");
     metrics_.read_timeouts_per_update++;
@@ -195,7 +200,8 @@ std::pair<GrpcConnection::Result, ThinReplicaClient::SpanPtr> ThinReplicaClient:
     size_t& most_agreeing,
     HashRecord& most_agreed_block,
     unique_ptr<LogCid>& cid) {
-  if (!config_->trs_conns[data_conn_index_]->hasDataStream()) {
+  const bool hedged = hedge_conn_index_.has_value();
+  if (!hedged && !config_->trs_conns[data_conn_index_]->hasDataStream()) {
     // It may be the case that there is no data stream open after the data
     // stream was opened or rotated because the initial SubscribeToUpdates call
     // failed or timed out; in this case the ThinReplicaClient should rotate the
@@ -205,7 +211,8 @@ std::pair<GrpcConnection::Result, ThinReplicaClient::SpanPtr> ThinReplicaClient:
     return {GrpcConnection::Result::kFailure, nullptr};
   }
 
-  GrpcConnection::Result read_result = config_->trs_conns[data_conn_index_]->readData(&update_in);
+  GrpcConnection::Result read_result =
+      hedged ? readHedgedDataStreams(update_in) : config_->trs_conns[data_conn_index_]->readData(&update_in);
   if (read_result == GrpcConnection::Result::kTimeout) {
     LOG_DEBUG(logger_, "Data stream " << data_conn_index_ << " timed out");
     metrics_.read_timeouts_per_update++;
@@ -303,56 +310,88 @@ void ThinReplicaClient::findBlockHashAgreement(std::vector<bool>& servers_tried,
     return config_->trs_conns[a]->hasHashStream() > config_->trs_conns[b]->hasHashStream();
   });
 
-  size_t unsuccessful_hash_stream_subset_size = 0;
+  // The servers are asked in rounds of as many servers as could still complete the agreement. The streams of a round
+  // are opened and read concurrently (on hash_read_pool_ and this thread), so a round costs the slowest server rather
+  // than the sum of them, and the servers asked are the ones the sorted order would ask one at a time. The results are
+  // then processed in that order.
+  std::vector<size_t> untried_servers;
   for (auto server_index : sorted_servers) {
     ConcordAssertNE(config_->trs_conns[server_index], nullptr);
-    if (servers_tried[server_index]) {
-      continue;
+    if (!servers_tried[server_index]) {
+      untried_servers.push_back(server_index);
     }
+  }
+
+  size_t unsuccessful_hash_stream_subset_size = 0;
+  auto next_server = untried_servers.cbegin();
+  while (next_server != untried_servers.cend()) {
     if (stop_subscription_thread_) {
       return;
     }
+    const size_t missing = most_agreeing < (config_->max_faulty + 1u) ? config_->max_faulty + 1u - most_agreeing : 1;
+    const auto round_size = std::min<size_t>(missing, std::distance(next_server, untried_servers.cend()));
+    ConcordAssertLE(round_size, config_->max_faulty + 1u);
+    const auto first_server = next_server++;
+    std::vector<std::future<HashStreamRead>> others;
+    others.reserve(round_size - 1);
+    for (size_t i = 1; i < round_size; ++i, ++next_server) {
+      others.push_back(hash_read_pool_->async([this](size_t server_index) { return readHashFromServer(server_index); },
+                                              *next_server));
+    }
+    std::vector<std::pair<size_t, HashStreamRead>> round;
+    round.reserve(round_size);
+    round.emplace_back(*first_server, readHashFromServer(*first_server));
+    for (size_t i = 0; i < others.size(); ++i) {
+      round.emplace_back(*(first_server + i + 1), others[i].get());
+    }
 
-    if (!config_->trs_conns[server_index]->hasHashStream()) {
-      LOG_DEBUG(logger_, "Additionally asking " << server_index);
-      GrpcConnection::Result stream_open_status = startHashStreamWith(server_index);
-
-      // Assert the possible GrpcConnection::Result values have not changed
-      // without updating the following code.
-      ConcordAssert(stream_open_status == GrpcConnection::Result::kSuccess ||
-                    stream_open_status == GrpcConnection::Result::kTimeout ||
-                    stream_open_status == GrpcConnection::Result::kFailure ||
-                    stream_open_status == GrpcConnection::Result::kOutOfRange ||
-                    stream_open_status == GrpcConnection::Result::kNotFound);
-
-      if (stream_open_status == GrpcConnection::Result::kTimeout) {
-        LOG_DEBUG(logger_, "Opening a hash stream to server " << server_index << " timed out.");
-        metrics_.read_timeouts_per_update++;
-      }
-      if (stream_open_status == GrpcConnection::Result::kFailure) {
-        LOG_DEBUG(logger_, "Opening a hash stream to server " << server_index << " failed.");
-        metrics_.read_failures_per_update++;
-      }
-      if (stream_open_status == GrpcConnection::Result::kOutOfRange) {
-        LOG_DEBUG(logger_, "Opening a hash stream to server " << server_index << " failed, request out of range.");
-        metrics_.read_failures_per_update++;
-        if (!is_subscription_successful_) servers_out_of_range++;
-      }
-      if (stream_open_status == GrpcConnection::Result::kNotFound) {
-        LOG_DEBUG(logger_, "Opening a hash stream to server " << server_index << " failed, requested update pruned.");
-        metrics_.read_failures_per_update++;
-        servers_pruned++;
-      }
-      if (stream_open_status != GrpcConnection::Result::kSuccess) {
-        servers_tried[server_index] = true;
-        continue;
+    for (auto& [server_index, read] : round) {
+      servers_tried[server_index] = true;
+      if (read.open_result) {
+        const auto stream_open_status = *read.open_result;
+
+        // Assert the possible GrpcConnection::Result values have not changed
+        // without updating the following code.
+        ConcordAssert(stream_open_status == GrpcConnection::Result::kSuccess ||
+                      stream_open_status == GrpcConnection::Result::kTimeout ||
+                      stream_open_status == GrpcConnection::Result::kFailure ||
+                      stream_open_status == GrpcConnection::Result::kOutOfRange ||
+                      stream_open_status == GrpcConnection::Result::kNotFound);
+
+        if (stream_open_status == GrpcConnection::Result::kTimeout) {
+          LOG_DEBUG(logger_, "Opening a hash stream to server " << server_index << " timed out.");
+          metrics_.read_timeouts_per_update++;
+        }
+        if (stream_open_status == GrpcConnection::Result::kFailure) {
+          LOG_DEBUG(logger_, "Opening a hash stream to server " << server_index << " failed.");
+          metrics_.read_failures_per_update++;
+        }
+        if (stream_open_status == GrpcConnection::Result::kOutOfRange) {
+          LOG_DEBUG(logger_, "Opening a hash stream to server " << server_index << " failed, request out of range.");
+          metrics_.read_failures_per_update++;
+          if (!is_subscription_successful_) servers_out_of_range++;
+        }
+        if (stream_open_status == GrpcConnection::Result::kNotFound) {
+          LOG_DEBUG(logger_,
+                    "Opening a hash stream to server " << server_index << " failed, requested update pruned.");
+          metrics_.read_failures_per_update++;
+          servers_pruned++;
+        }
+        if (stream_open_status != GrpcConnection::Result::kSuccess) {
+          continue;
+        }
       }
-    }
 
-    bool has_hash = readUpdateHashFromStream(
-        server_index, agreeing_subset_members, most_agreeing, most_agreed_block, servers_out_of_range, servers_pruned);
-    if (!has_hash) unsuccessful_hash_stream_subset_size++;
-    servers_tried[server_index] = true;
+      bool has_hash = readUpdateHashFromStream(server_index,
+                                               read.read_result,
+                                               read.hash,
+                                               agreeing_subset_members,
+                                               most_agreeing,
+                                               most_agreed_block,
+                                               servers_out_of_range,
+                                               servers_pruned);
+      if (!has_hash) unsuccessful_hash_stream_subset_size++;
+    }
 
     if (most_agreeing >= (config_->max_faulty + 1)) {
       return;
@@ -361,8 +400,26 @@ void ThinReplicaClient::findBlockHashAgreement(std::vector<bool>& servers_tried,
   return;
 }
 
+ThinReplicaClient::HashStreamRead ThinReplicaClient::readHashFromServer(size_t server_index) {
+  HashStreamRead read;
+  if (!config_->trs_conns[server_index]->hasHashStream()) {
+    LOG_DEBUG(logger_, "Additionally asking " << server_index);
+    read.open_result = startHashStreamWith(server_index);
+    if (*read.open_result != GrpcConnection::Result::kSuccess) {
+      return read;
+    }
+  }
+  read.read_result = config_->trs_conns[server_index]->readHash(&read.hash);
+  return read;
+}
+
 GrpcConnection::Result ThinReplicaClient::resetDataStreamTo(size_t server_index) {
   ConcordAssertNE(config_->trs_conns[server_index], nullptr);
+  if (hedge_conn_index_) {
+    // No read may be in flight on a stream that gets cancelled. A read that doesn't complete ends with its timeout.
+    drainDataReads();
+    config_->trs_conns[*hedge_conn_index_]->cancelDataStream();
+  }
   config_->trs_conns[server_index]->cancelDataStream();
   config_->trs_conns[server_index]->cancelHashStream();
   config_->trs_conns[data_conn_index_]->cancelDataStream();
@@ -379,9 +436,129 @@ GrpcConnection::Result ThinReplicaClient::resetDataStreamTo(size_t server_index)
   GrpcConnection::Result result = config_->trs_conns[server_index]->openDataStream(request);
 
   data_conn_index_ = server_index;
+  if (data_read_pool_) {
+    // The hedge server doesn't serve hashes, its data stream gets opened by its first read
+    hedge_conn_index_ = (server_index + 1) % config_->trs_conns.size();
+    config_->trs_conns[*hedge_conn_index_]->cancelHashStream();
+    data_reads_[*hedge_conn_index_].reopen = true;
+  }
   return result;
 }
 
+void ThinReplicaClient::startDataRead(size_t server_index) {
+  auto& data_read = data_reads_[server_index];
+  if (data_read.task.valid()) {
+    return;
+  }
+  std::optional<SubscriptionRequest> request;
+  if (server_index == *hedge_conn_index_ && (data_read.reopen || !config_->trs_conns[server_index]->hasDataStream())) {
+    request.emplace();
+    if (is_event_group_request_) {
+      request->mutable_event_groups()->set_event_group_id(latest_verified_event_group_id_ + 1);
+    } else {
+      request->mutable_events()->set_block_id(latest_verified_block_id_ + 1);
+    }
+    data_read.reopen = false;
+  }
+  data_read.task = data_read_pool_->async([this, server_index, request]() {
+    auto& conn = config_->trs_conns[server_index];
+    DataStreamRead read{GrpcConnection::Result::kFailure, {}};
+    if (request) {
+      conn->cancelDataStream();
+      read.result = conn->openDataStream(*request);
+    } else if (conn->hasDataStream()) {
+      read.result = GrpcConnection::Result::kSuccess;
+    }
+    if (read.result == GrpcConnection::Result::kSuccess) {
+      read.result = conn->readData(&read.data);
+    }
+    {
+      std::lock_guard<std::mutex> lock(data_reads_mutex_);
+      data_reads_[server_index].read = std::move(read);
+    }
+    data_read_done_.notify_all();
+  });
+}
+
+GrpcConnection::Result ThinReplicaClient::readHedgedDataStreams(Data& data) {
+  // The losing stream of the previous update reads that update after it was pushed
+  const auto is_stale = [this](const Data& update) {
+    if (!is_subscription_successful_) {
+      return false;
+    }
+    if (update.has_event_group()) {
+      return update.event_group().id() <= latest_verified_event_group_id_;
+    }
+    return update.has_events() && update.events().block_id() <= latest_verified_block_id_;
+  };
+  const auto count_failure = [this](GrpcConnection::Result result) {
+    if (result == GrpcConnection::Result::kTimeout) {
+      metrics_.read_timeouts_per_update++;
+    } else {
+      metrics_.read_failures_per_update++;
+    }
+  };
+
+  // The results of the servers whose read of this update failed
+  std::map<size_t, GrpcConnection::Result> failures;
+  const std::array<size_t, 2> servers{data_conn_index_, *hedge_conn_index_};
+  std::unique_lock<std::mutex> lock(data_reads_mutex_);
+  while (failures.size() < servers.size()) {
+    for (const auto server_index : servers) {
+      if (!failures.count(server_index)) {
+        startDataRead(server_index);
+      }
+    }
+    data_read_done_.wait(lock, [&]() {
+      return std::any_of(servers.cbegin(), servers.cend(), [&](size_t server_index) {
+        return !failures.count(server_index) && data_reads_[server_index].read.has_value();
+      });
+    });
+    // The data server goes first if both reads completed
+    for (const auto server_index : servers) {
+      auto& data_read = data_reads_[server_index];
+      if (failures.count(server_index) || !data_read.read) {
+        continue;
+      }
+      auto read = std::move(*data_read.read);
+      data_read.read.reset();
+      data_read.task = {};
+      if (read.result != GrpcConnection::Result::kSuccess) {
+        LOG_DEBUG(logger_, "Data stream " << server_index << " read failed (hedged)");
+        data_read.reopen = true;
+        failures.emplace(server_index, read.result);
+        continue;
+      }
+      if (is_stale(read.data)) {
+        continue;
+      }
+      for (const auto& [_, result] : failures) {
+        count_failure(result);
+      }
+      if (server_index != data_conn_index_) {
+        LOG_DEBUG(logger_, "Hedge data stream " << server_index << " was read first");
+        std::swap(data_conn_index_, *hedge_conn_index_);
+      }
+      data = std::move(read.data);
+      return GrpcConnection::Result::kSuccess;
+    }
+  }
+  // The failure of the data server is counted by the caller
+  count_failure(failures[*hedge_conn_index_]);
+  return failures[data_conn_index_];
+}
+
+void ThinReplicaClient::drainDataReads() {
+  for (auto& data_read : data_reads_) {
+    if (data_read.task.valid()) {
+      data_read.task.wait();
+      data_read.task = {};
+    }
+    std::lock_guard<std::mutex> lock(data_reads_mutex_);
+    data_read.read.reset();
+  }
+}
+
 void ThinReplicaClient::closeAllHashStreams() {
   for (size_t i = 0; i < config_->trs_conns.size(); ++i) {
     if (i != data_conn_index_) {
@@ -543,6 +720,12 @@ void ThinReplicaClient::receiveUpdates() {
         readBlock(update_in, agreeing_subset_members, most_agreeing, most_agreed_block, update_cid);
     has_data = (read_result != GrpcConnection::Result::kSuccess) ? false : true;
     servers_tried[data_conn_index_] = true;
+    // The hedge server may still be reading its data stream
+    // TODO: Read the hashes of the next updates while an update gets verified (windowed agreement). An update must
+    //       still not be pushed before it is verified.
+    if (hedge_conn_index_) {
+      servers_tried[*hedge_conn_index_] = true;
+    }
 
     if (read_result == GrpcConnection::Result::kOutOfRange && !is_subscription_successful_) {
       servers_out_of_range++;
@@ -1068,6 +1251,8 @@ void ThinReplicaClient::receiveUpdatesWrapper() {
     config_->update_queue->setException(std::current_exception());
     stop_subscription_thread_ = true;
   }
+  // No read is left in flight once the subscription thread ends
+  drainDataReads();
 }
 
 }  // namespace client::thin_replica_client
@@ -13,21 +13,19 @@
 
 #include "client/thin-replica-client/trc_hash.hpp"
 
-#include <map>
-#include <set>
-
-#include "boost/detail/endian.hpp"
 #include "assertUtils.hpp"
+#include "sha256_batch.hpp"
+#include "update_hash_scratch.hpp"
 
 using com::vmware::concord::thin_replica::Data;
 using concord::client::concordclient::EventVariant;
 using concord::client::concordclient::EventGroup;
 using concord::client::concordclient::Update;
+using concord::util::SHA256Batch;
+using concord::util::UpdateHashScratch;
 using concord::util::openssl_utils::computeSHA256Hash;
 using std::invalid_argument;
 using std::list;
-using std::map;
-using std::set;
 using std::string;
 
 namespace client::thin_replica_client {
@@ -35,119 +33,57 @@ namespace client::thin_replica_client {
 // Hash functions in this file may be defined in a way assuming char is an 8 bit
 // type.
 static_assert(CHAR_BIT == 8);
+static_assert(SHA256Batch::SIZE_IN_BYTES == kThinReplicaHashLength);
 
-// Helper function for computing the hash of an update from the hashes of the
-// keys and values it contains (given those hashes in an std::map). This helper
-// factors out logic common to the two overloads of hashUpdate implemented
-// below.
-//
-// Note we store the hashes of the keys and values in an std::map (rather than
-// an std::unordered_map) as an intermediate step in the computation of the
-// update hash so the map can be used for detecting duplicate keys and
-// deterministically ordering the key-value pairs' hashes before they are
-// concatenated for the computation of the update hash. The deterministic
-// ordering is necessary since two updates with the same set of key-value pairs
-// in different orders are considered equivalent so their hashes need to match.
-static string hashUpdateFromEntryHashes(uint64_t block_id, const map<string, string>& entry_hashes) {
-  string concatenated_entry_hashes;
-  concatenated_entry_hashes.reserve(sizeof(block_id) + 2 * entry_hashes.size() * kThinReplicaHashLength);
-
-#ifdef BOOST_LITTLE_ENDIAN
-  concatenated_entry_hashes.append(reinterpret_cast<const char*>(&block_id), sizeof(block_id));
-#else  // BOOST_LITTLE_ENDIAN not defined in this case
-#ifndef BOOST_BIG_ENDIAN
-  static_assert(false,
-                "Cannot determine endianness (needed for Thin Replica "
-                "mechanism hash function).");
-#endif  // BOOST_BIG_ENDIAN defined
-  const char* block_id_as_bytes = reinterpret_cast<const char*>(&block_id);
-  for (size_t i = 1; i <= sizeof(block_id); ++i) {
-    concatenated_entry_hashes.append((block_id_as_bytes + (sizeof(block_id) - i)), 1);
-  }
-#endif  // if BOOST_LITTLE_ENDIAN defined/else
+namespace {
 
-  for (const auto& kvp_hashes : entry_hashes) {
-    concatenated_entry_hashes.append(kvp_hashes.first);
-    concatenated_entry_hashes.append(kvp_hashes.second);
+// Hashes the key-value pairs added to the scratch.
+string hashKeyValueUpdate(UpdateHashScratch& s, uint64_t block_id) {
+  auto hash = s.hashKeyValues(block_id);
+  if (!hash) {
+    throw invalid_argument("hashUpdate called for an update that contains duplicate keys.");
   }
-
-  return computeSHA256Hash(concatenated_entry_hashes);
+  return std::move(*hash);
 }
 
-static string hashUpdateFromEntryHashes(uint64_t id, const set<string>& entry_hashes) {
-  string concatenated_entry_hashes;
-  concatenated_entry_hashes.reserve(sizeof(id) + entry_hashes.size() * kThinReplicaHashLength);
-
-#ifdef BOOST_LITTLE_ENDIAN
-  concatenated_entry_hashes.append(reinterpret_cast<const char*>(&(id)), sizeof(id));
-#else  // BOOST_LITTLE_ENDIAN not defined in this case
-#ifndef BOOST_BIG_ENDIAN
-  static_assert(false,
-                "Cannot determine endianness (needed for Thin Replica "
-                "mechanism hash function).");
-#endif  // BOOST_BIG_ENDIAN defined
-  const char* id_as_bytes = reinterpret_cast<const char*>(&(id));
-  for (size_t i = 1; i <= sizeof(id); ++i) {
-    concatenated_entry_hashes.append((id_as_bytes + (sizeof(id) - i)), 1);
-  }
-#endif  // if BOOST_LITTLE_ENDIAN defined/else
-
-  for (const auto& hash : entry_hashes) {
-    concatenated_entry_hashes.append(hash);
-  }
-
-  return computeSHA256Hash(concatenated_entry_hashes);
-}
+}  // namespace
 
 string hashUpdate(const EventVariant& ev) {
+  auto& s = UpdateHashScratch::get();
+  s.clear();
   if (std::holds_alternative<Update>(ev)) {
     auto& legacy_event = std::get<Update>(ev);
-    map<string, string> entry_hashes;
     for (const auto& kvp : legacy_event.kv_pairs) {
-      string key_hash = computeSHA256Hash(kvp.first);
-      if (entry_hashes.count(key_hash) > 0) {
-        throw invalid_argument("hashUpdate called for an update that contains duplicate keys.");
-      }
-      entry_hashes[key_hash] = computeSHA256Hash(kvp.second);
+      s.add(kvp.first);
+      s.add(kvp.second);
     }
-
-    return hashUpdateFromEntryHashes(legacy_event.block_id, entry_hashes);
+    return hashKeyValueUpdate(s, legacy_event.block_id);
   }
 
   ConcordAssert(std::holds_alternative<EventGroup>(ev));
   auto& event_group = std::get<EventGroup>(ev);
-  set<string> entry_hashes;
   for (const auto& event : event_group.events) {
-    string event_hash = computeSHA256Hash(event);
-    ConcordAssert(entry_hashes.count(event_hash) < 1);
-    entry_hashes.emplace(event_hash);
+    s.add(event);
   }
-
-  return hashUpdateFromEntryHashes(event_group.id, entry_hashes);
+  return s.hashEvents(event_group.id);
 }
 
 string hashUpdate(const Data& update) {
+  auto& s = UpdateHashScratch::get();
+  s.clear();
   if (update.has_events()) {
-    map<string, string> entry_hashes;
     for (const auto& kvp : update.events().data()) {
-      string key_hash = computeSHA256Hash(kvp.key());
-      if (entry_hashes.count(key_hash) > 0) {
-        throw invalid_argument("hashUpdate called for an update that contains duplicate keys.");
-      }
-      entry_hashes[key_hash] = computeSHA256Hash(kvp.value());
+      s.add(kvp.key());
+      s.add(kvp.value());
     }
-
-    return hashUpdateFromEntryHashes(update.events().block_id(), entry_hashes);
+    return hashKeyValueUpdate(s, update.events().block_id());
   }
+
   ConcordAssert(update.has_event_group());
-  set<string> entry_hashes;
   for (const auto& event : update.event_group().events()) {
-    string event_hash = computeSHA256Hash(event);
-    ConcordAssert(entry_hashes.count(event_hash) < 1);
-    entry_hashes.emplace(event_hash);
+    s.add(event);
   }
-
-  return hashUpdateFromEntryHashes(update.event_group().id(), entry_hashes);
+  return s.hashEvents(update.event_group().id());
 }
 
 string hashState(const list<string>& state) {
@@ -11,6 +11,8 @@
 // terms and conditions of the subcomponent's license, as noted in the LICENSE
 // file.
 
+#include <map>
+#include <mutex>
 #include <random>
 #include "client/thin-replica-client/replica_state_snapshot_client.hpp"
 #include "client/thin-replica-client/grpc_connection.hpp"
@@ -18,9 +20,12 @@
 #include "client/concordclient/concord_client_exceptions.hpp"
 #include "thin_replica_mock.grpc.pb.h"
 #include "replica_state_snapshot_mock.grpc.pb.h"
+#include "sha_hash.hpp"
 
 #include "gtest/gtest.h"
 
+using vmware::concord::replicastatesnapshot::GetSnapshotShardsRequest;
+using vmware::concord::replicastatesnapshot::GetSnapshotShardsResponse;
 using vmware::concord::replicastatesnapshot::StreamSnapshotRequest;
 using vmware::concord::replicastatesnapshot::StreamSnapshotResponse;
 using std::make_shared;
@@ -36,6 +41,7 @@ using concord::util::ThreadPool;
 using concord::client::concordclient::SnapshotKVPair;
 using concord::client::concordclient::SnapshotQueue;
 using concord::client::concordclient::BasicSnapshotQueue;
+using concord::client::concordclient::SnapshotShard;
 using client::concordclient::GrpcConnection;
 using client::concordclient::GrpcConnectionConfig;
 using com::vmware::concord::thin_replica::MockThinReplicaStub;
@@ -74,18 +80,109 @@ class FakeReplicaStateSnapshotService : public ReplicaStateSnapshotService::Serv
       ::grpc::ServerWriter<::vmware::concord::replicastatesnapshot::StreamSnapshotResponse>* writer) override {
     auto num_req_to_send = request->snapshot_id();
 
+    // Pack up to 3 key-values per response if the client accepts several
+    const auto max_key_values_per_resp = request->has_max_response_size() ? 3 : 1;
     while (num_req_to_send > 0) {
       auto resp = StreamSnapshotResponse{};
-      auto kv = resp.mutable_key_value();
-      auto resp_key = kv->mutable_key();
-      auto resp_value = kv->mutable_value();
-      *resp_key = getRandomStringOfLength(10);
-      *resp_value = getRandomStringOfLength(50);
+      for (auto i = 0; i < max_key_values_per_resp && num_req_to_send > 0; ++i) {
+        auto kv = request->has_max_response_size() ? resp.add_key_values() : resp.mutable_key_value();
+        auto resp_key = kv->mutable_key();
+        auto resp_value = kv->mutable_value();
+        *resp_key = getRandomStringOfLength(10);
+        *resp_value = getRandomStringOfLength(50);
+        num_req_to_send--;
+      }
+      writer->Write(resp);
+    }
+    return ::grpc::Status::OK;
+  }
+};
+
+// Serves a single snapshot, split in shards of `shard_size` key-values.
+class FakeShardedSnapshotService : public ReplicaStateSnapshotService::Service {
+ public:
+  FakeShardedSnapshotService(size_t num_key_values, size_t shard_size)
+      : FakeShardedSnapshotService(randomKeyValues(num_key_values), shard_size) {}
+
+  FakeShardedSnapshotService(std::map<std::string, std::string> key_values, size_t shard_size)
+      : key_values_(std::move(key_values)) {
+    auto hasher = ::concord::util::SHA3_256{};
+    auto hash = hasher.digest(nullptr, 0);
+    const auto as_string = [](const auto& digest) {
+      return std::string(reinterpret_cast<const char*>(digest.data()), digest.size());
+    };
+    for (const auto& [key, value] : key_values_) {
+      if (shards_.shards().empty() || shards_.shards().rbegin()->num_key_values() == shard_size) {
+        auto shard = shards_.add_shards();
+        if (shards_.shards_size() > 1) {
+          shard->set_after_key(shards_.shards(shards_.shards_size() - 2).last_key());
+          shards_.mutable_shards(shards_.shards_size() - 2)->set_end_hash(as_string(hash));
+        }
+        shard->set_start_hash(as_string(hash));
+      }
+      const auto key_hash = hasher.digest(key.data(), key.size());
+      hasher.init();
+      hasher.update(hash.data(), hash.size());
+      hasher.update(key_hash.data(), key_hash.size());
+      hasher.update(value.data(), value.size());
+      hash = hasher.finish();
+      auto shard = shards_.mutable_shards(shards_.shards_size() - 1);
+      shard->set_last_key(key);
+      shard->set_num_key_values(shard->num_key_values() + 1);
+    }
+    shards_.mutable_shards(shards_.shards_size() - 1)->clear_last_key();
+    shards_.mutable_shards(shards_.shards_size() - 1)->set_end_hash(as_string(hash));
+    state_hash_ = as_string(hash);
+  }
+
+  ::grpc::Status GetSnapshotShards(::grpc::ServerContext* context,
+                                   const GetSnapshotShardsRequest* request,
+                                   GetSnapshotShardsResponse* response) override {
+    *response = shards_;
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status StreamSnapshot(::grpc::ServerContext* context,
+                                const StreamSnapshotRequest* request,
+                                ::grpc::ServerWriter<StreamSnapshotResponse>* writer) override {
+    auto it = request->has_last_received_key() ? key_values_.upper_bound(request->last_received_key())
+                                                : key_values_.begin();
+    for (; it != key_values_.end() && (!request->has_last_key() || it->first <= request->last_key()); ++it) {
+      auto resp = StreamSnapshotResponse{};
+      auto kv = resp.add_key_values();
+      kv->set_key(it->first);
+      std::lock_guard<std::mutex> lock(mutex_);
+      kv->set_value(it->first == tampered_key_ ? "tampered" : it->second);
       writer->Write(resp);
-      num_req_to_send--;
     }
     return ::grpc::Status::OK;
   }
+
+  void tamper(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tampered_key_ = key;
+  }
+
+  const std::map<std::string, std::string>& keyValues() const { return key_values_; }
+  const std::string& stateHash() const { return state_hash_; }
+  // Must not be called while the shards are served
+  GetSnapshotShardsResponse& shards() { return shards_; }
+
+  static std::map<std::string, std::string> randomKeyValues(size_t num_key_values) {
+    std::map<std::string, std::string> key_values;
+    for (size_t i = 0; i < num_key_values; ++i) {
+      auto key = std::to_string(i);
+      key_values.emplace(std::string(4 - key.size(), '0') + key, getRandomStringOfLength(50));
+    }
+    return key_values;
+  }
+
+ private:
+  std::map<std::string, std::string> key_values_;
+  GetSnapshotShardsResponse shards_;
+  std::string state_hash_;
+  std::mutex mutex_;
+  std::string tampered_key_;
 };
 
 }  // namespace replicastatesnapshot
@@ -148,8 +245,10 @@ class FakeGrpcConnection : public GrpcConnection {
   }
 };
 
-void getGrpcConnections(bool full_fake, vector<shared_ptr<GrpcConnection>>& grpc_connections, int num_replicas) {
-  int port = 50001;
+void getGrpcConnections(bool full_fake,
+                        vector<shared_ptr<GrpcConnection>>& grpc_connections,
+                        int num_replicas,
+                        int port = 50001) {
   for (int i = 0; i < num_replicas; i++) {
     auto addr = "127.0.0.1:" + std::to_string(port + i);
     std::shared_ptr<GrpcConnection> grpc_conn =
@@ -165,7 +264,7 @@ TEST(replica_stream_snapshot_client_test, test_destructor_always_successful) {
   getGrpcConnections(true, grpc_connections, 7);
   ThreadPool thread_pool{10};
   auto read_snapshot = [&grpc_connections]() {
-    auto rss_config = std::make_unique<ReplicaStateSnapshotClientConfig>(grpc_connections, 8);
+    auto rss_config = std::make_unique<ReplicaStateSnapshotClientConfig>(grpc_connections, 8, 0);
     auto rss = std::make_unique<ReplicaStateSnapshotClient>(std::move(rss_config));
 
     std::shared_ptr<SnapshotQueue> remote_queue = std::make_shared<BasicSnapshotQueue>();
@@ -224,7 +323,7 @@ TEST(replica_stream_snapshot_client_test, test_real_action) {
   getGrpcConnections(false, grpc_connections, 7);
   ThreadPool thread_pool{10};
   auto read_snapshot = [&grpc_connections](size_t len) {
-    auto rss_config = std::make_unique<ReplicaStateSnapshotClientConfig>(grpc_connections, 8);
+    auto rss_config = std::make_unique<ReplicaStateSnapshotClientConfig>(grpc_connections, 8, 0);
     auto rss = std::make_unique<ReplicaStateSnapshotClient>(std::move(rss_config));
 
     std::shared_ptr<SnapshotQueue> remote_queue = std::make_shared<BasicSnapshotQueue>();
@@ -271,6 +370,131 @@ TEST(replica_stream_snapshot_client_test, test_real_action) {
   }
 }
 
+// Read the key-values of a snapshot stream until it ends and return the exception it ended with
+std::exception_ptr readSnapshotQueue(SnapshotQueue& queue, std::map<string, string>& key_values) {
+  const auto add = [&key_values](std::unique_ptr<SnapshotKVPair> kv) {
+    if (kv) key_values.emplace(std::move(kv->key), std::move(kv->val));
+  };
+  try {
+    while (true) {
+      add(queue.pop());
+    }
+  } catch (...) {
+    // The exception is thrown before the key-values left in the queue
+    while (auto kv = queue.tryPop()) {
+      add(std::move(kv));
+    }
+    return std::current_exception();
+  }
+}
+
+TEST(replica_stream_snapshot_client_test, test_verified_shards) {
+  vmware::concord::replicastatesnapshot::FakeShardedSnapshotService service{100, 30};
+  ::grpc::ServerBuilder builder;
+  builder.AddListeningPort("0.0.0.0:50101", grpc::InsecureServerCredentials());
+  builder.RegisterService(&service);
+  auto server = builder.BuildAndStart();
+
+  vector<shared_ptr<GrpcConnection>> grpc_connections;
+  getGrpcConnections(false, grpc_connections, 1, 50101);
+  auto rss = std::make_unique<ReplicaStateSnapshotClient>(
+      std::make_unique<ReplicaStateSnapshotClientConfig>(grpc_connections, 8, 0));
+
+  const auto shards = rss->readSnapshotShards(1, 0);
+  ASSERT_EQ(shards.size(), 4);
+  ASSERT_FALSE(shards.front().after_key.has_value());
+  ASSERT_FALSE(shards.back().last_key.has_value());
+  ASSERT_EQ(shards.back().end_hash, service.stateHash());
+
+  // Stream the shards in parallel and reassemble the snapshot
+  const auto stream_shard = [&rss](const SnapshotShard& shard) {
+    auto queue = std::make_shared<BasicSnapshotQueue>();
+    ::client::replica_state_snapshot_client::SnapshotRequest request;
+    request.snapshot_id = 1;
+    request.shard = shard;
+    rss->readSnapshotStream(request, queue);
+    return queue;
+  };
+  vector<shared_ptr<BasicSnapshotQueue>> queues;
+  for (const auto& shard : shards) {
+    queues.push_back(stream_shard(shard));
+  }
+  std::map<string, string> key_values;
+  for (size_t i = 0; i < shards.size(); ++i) {
+    std::map<string, string> shard_key_values;
+    auto e = readSnapshotQueue(*queues[i], shard_key_values);
+    EXPECT_THROW(std::rethrow_exception(e), concord::client::concordclient::EndOfStream);
+    EXPECT_EQ(shard_key_values.size(), shards[i].num_key_values);
+    key_values.merge(shard_key_values);
+  }
+  EXPECT_EQ(key_values, service.keyValues());
+
+  // A key-value that doesn't match the hashes fails the verification of its shard only
+  service.tamper(std::next(service.keyValues().cbegin(), 40)->first);
+  for (size_t i = 0; i < shards.size(); ++i) {
+    std::map<string, string> shard_key_values;
+    auto e = readSnapshotQueue(*stream_shard(shards[i]), shard_key_values);
+    if (i == 1) {
+      EXPECT_THROW(std::rethrow_exception(e), concord::client::concordclient::SnapshotVerificationFailed);
+    } else {
+      EXPECT_THROW(std::rethrow_exception(e), concord::client::concordclient::EndOfStream);
+    }
+  }
+
+  server->Shutdown();
+}
+
+
+TEST(replica_stream_snapshot_client_test, test_shards_agreement) {
+  using vmware::concord::replicastatesnapshot::FakeShardedSnapshotService;
+  const auto key_values = FakeShardedSnapshotService::randomKeyValues(100);
+  // Replicas 0 and 1 serve the snapshot, replica 2 serves a list of shards which chains but over other values
+  auto forged_key_values = key_values;
+  forged_key_values.begin()->second = "forged";
+  vector<unique_ptr<FakeShardedSnapshotService>> services;
+  services.push_back(make_unique<FakeShardedSnapshotService>(key_values, 30));
+  services.push_back(make_unique<FakeShardedSnapshotService>(key_values, 30));
+  services.push_back(make_unique<FakeShardedSnapshotService>(forged_key_values, 30));
+  // Replica 3 serves a list of shards which doesn't chain
+  services.push_back(make_unique<FakeShardedSnapshotService>(key_values, 30));
+  services.back()->shards().mutable_shards(2)->set_after_key("0000");
+  vector<unique_ptr<::grpc::Server>> servers;
+  for (size_t i = 0; i < services.size(); ++i) {
+    ::grpc::ServerBuilder builder;
+    builder.AddListeningPort("0.0.0.0:" + to_string(50111 + i), grpc::InsecureServerCredentials());
+    builder.RegisterService(services[i].get());
+    servers.push_back(builder.BuildAndStart());
+  }
+  vector<shared_ptr<GrpcConnection>> grpc_connections;
+  getGrpcConnections(false, grpc_connections, services.size(), 50111);
+  const auto read_shards = [](vector<shared_ptr<GrpcConnection>> conns, uint16_t max_faulty) {
+    auto rss = std::make_unique<ReplicaStateSnapshotClient>(
+        std::make_unique<ReplicaStateSnapshotClientConfig>(conns, 8, max_faulty));
+    return rss->readSnapshotShards(1, 0);
+  };
+  const auto& honest = grpc_connections[0];
+  const auto& other_honest = grpc_connections[1];
+  const auto& forged = grpc_connections[2];
+  const auto& broken = grpc_connections[3];
+
+  // The forged list is valid on its own, so a single replica can't be told apart from an honest one
+  ASSERT_NE(services[2]->stateHash(), services[0]->stateHash());
+  EXPECT_EQ(read_shards({forged}, 0).back().end_hash, services[2]->stateHash());
+
+  // With max_faulty = 1 the forged list is rejected unless another replica returns it
+  EXPECT_THROW(read_shards({forged, honest}, 1), concord::client::concordclient::SnapshotVerificationFailed);
+  EXPECT_EQ(read_shards({forged, honest, other_honest}, 1).back().end_hash, services[0]->stateHash());
+
+  // A list of shards which doesn't chain is rejected even if a single replica is asked
+  EXPECT_THROW(read_shards({broken}, 0), concord::client::concordclient::SnapshotVerificationFailed);
+  EXPECT_EQ(read_shards({broken, honest}, 0).back().end_hash, services[0]->stateHash());
+  EXPECT_THROW(read_shards({broken, honest}, 1), concord::client::concordclient::SnapshotVerificationFailed);
+
+  for (const auto& server : servers) {
+    server->Shutdown();
+  }
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -13,13 +13,19 @@
 
 #include "client/thin-replica-client/thin_replica_client.hpp"
 #include "client/thin-replica-client/grpc_connection.hpp"
+#include "client/thin-replica-client/trc_hash.hpp"
 #include "client/concordclient/event_update.hpp"
 
+#include <optional>
+#include <set>
+
 #include "gtest/gtest.h"
 #include "thin_replica_client_mocks.hpp"
 
 using com::vmware::concord::thin_replica::Data;
+using com::vmware::concord::thin_replica::Hash;
 using com::vmware::concord::thin_replica::KVPair;
+using com::vmware::concord::thin_replica::SubscriptionRequest;
 using std::condition_variable;
 using std::make_shared;
 using std::make_unique;
@@ -39,6 +45,9 @@ using concord::client::concordclient::EventUpdateQueue;
 using concord::client::concordclient::BasicEventUpdateQueue;
 using client::thin_replica_client::ThinReplicaClient;
 using client::thin_replica_client::ThinReplicaClientConfig;
+using client::thin_replica_client::hashUpdate;
+using client::concordclient::GrpcConnection;
+using client::concordclient::GrpcConnectionConfig;
 
 const string kTestingClientID = "mock_client_id";
 const string kTestingJaegerAddress = "127.0.0.1:6831";
@@ -430,6 +439,222 @@ TEST(thin_replica_client_test, test_correct_data_returned_) {
   delay_condition->notify_all();
 }
 
+// The servers whose hash stream of block 1 was opened
+struct HashStreamLog {
+  std::mutex mutex;
+  std::set<size_t> opened;
+};
+
+// Serves block 1 according to its behavior, and nothing after it.
+class ScriptedTrsConnection : public GrpcConnection {
+ public:
+  enum class Behavior { kAgree, kSlow, kTimeout, kFail, kDisagree };
+  static constexpr auto kSlowDuration = 50ms;
+
+  ScriptedTrsConnection(size_t index, Behavior behavior, const Data& update, shared_ptr<HashStreamLog> log)
+      : GrpcConnection("scripted_address", kTestingClientID, 1, 1, 1),
+        index_{index},
+        behavior_{behavior},
+        update_{update},
+        log_{std::move(log)} {}
+
+  void connect(unique_ptr<GrpcConnectionConfig>&) override {}
+  bool isConnected() override { return true; }
+
+  Result openDataStream(const SubscriptionRequest& request) override {
+    next_data_block_ = request.events().block_id();
+    has_data_stream_ = true;
+    return Result::kSuccess;
+  }
+  void cancelDataStream() override { has_data_stream_ = false; }
+  bool hasDataStream() override { return has_data_stream_; }
+  Result readData(Data* data) override {
+    if (next_data_block_ != 1) {
+      sleep_for(kBriefDelayDuration);
+      return Result::kTimeout;
+    }
+    ++next_data_block_;
+    sleep_for(data_delay_);
+    *data = data_.value_or(update_);
+    return Result::kSuccess;
+  }
+  // The data stream serves `data` instead of the update, after `delay`. Must be called before subscribing.
+  void setData(const Data& data, milliseconds delay) {
+    data_ = data;
+    data_delay_ = delay;
+  }
+
+  Result openHashStream(SubscriptionRequest& request) override {
+    next_hash_block_ = request.events().block_id();
+    if (next_hash_block_ == 1) {
+      std::lock_guard<std::mutex> lock(log_->mutex);
+      log_->opened.insert(index_);
+    }
+    if (behavior_ == Behavior::kSlow || behavior_ == Behavior::kTimeout) {
+      sleep_for(kSlowDuration);
+    }
+    if (behavior_ == Behavior::kTimeout) return Result::kTimeout;
+    if (behavior_ == Behavior::kFail) return Result::kFailure;
+    has_hash_stream_ = true;
+    return Result::kSuccess;
+  }
+  void cancelHashStream() override { has_hash_stream_ = false; }
+  bool hasHashStream() override { return has_hash_stream_; }
+  Result readHash(Hash* hash) override {
+    if (next_hash_block_ != 1) {
+      sleep_for(kBriefDelayDuration);
+      return Result::kTimeout;
+    }
+    ++next_hash_block_;
+    hash->mutable_events()->set_block_id(1);
+    hash->mutable_events()->set_hash(behavior_ == Behavior::kDisagree ? string(32, 'x') : hashUpdate(update_));
+    return Result::kSuccess;
+  }
+
+ private:
+  const size_t index_;
+  const Behavior behavior_;
+  const Data update_;
+  shared_ptr<HashStreamLog> log_;
+  std::optional<Data> data_;
+  milliseconds data_delay_{0};
+  std::atomic_bool has_data_stream_{false};
+  std::atomic_bool has_hash_stream_{false};
+  std::atomic_uint64_t next_data_block_{0};
+  std::atomic_uint64_t next_hash_block_{0};
+};
+
+// Server 0 serves the data, the others are asked for hashes in index order. A round of concurrent hash stream reads
+// must ask the same servers and count the same timeouts and failures as asking them one at a time, which stops at the
+// first server that completes max_faulty + 1 agreeing servers.
+void testHashAgreementRounds(uint16_t max_faulty,
+                             const vector<ScriptedTrsConnection::Behavior>& hash_servers,
+                             const std::set<size_t>& expected_opened,
+                             uint64_t expected_timeouts,
+                             uint64_t expected_failures) {
+  Data update;
+  update.mutable_events()->set_block_id(1);
+  KVPair* events_data = update.mutable_events()->add_data();
+  events_data->set_key("key");
+  events_data->set_value("value");
+
+  auto log = make_shared<HashStreamLog>();
+  vector<shared_ptr<GrpcConnection>> servers;
+  servers.push_back(make_shared<ScriptedTrsConnection>(0, ScriptedTrsConnection::Behavior::kAgree, update, log));
+  for (const auto behavior : hash_servers) {
+    servers.push_back(make_shared<ScriptedTrsConnection>(servers.size(), behavior, update, log));
+  }
+  ASSERT_EQ(servers.size(), 3u * max_faulty + 1);
+
+  shared_ptr<EventUpdateQueue> update_queue = make_shared<BasicEventUpdateQueue>();
+  auto aggregator = make_shared<concordMetrics::Aggregator>();
+  auto trc_config = make_unique<ThinReplicaClientConfig>(kTestingClientID, update_queue, max_faulty, servers);
+  auto trc = make_unique<ThinReplicaClient>(std::move(trc_config), aggregator);
+  trc->Subscribe(1);
+  auto update_received = update_queue->pop();
+  ASSERT_TRUE((bool)update_received);
+  EXPECT_EQ(std::get<Update>(*update_received).block_id, 1);
+
+  // The metrics of an update reach the aggregator right after it is pushed
+  const auto gauge = [&aggregator](const string& name) {
+    return aggregator->GetGauge("ThinReplicaClient", name).Get();
+  };
+  while (gauge("last_verified_block_id") != 1) {
+    sleep_for(1ms);
+  }
+  EXPECT_EQ(gauge("read_timeouts_per_update"), expected_timeouts);
+  EXPECT_EQ(gauge("read_failures_per_update"), expected_failures);
+  EXPECT_EQ(gauge("read_ignored_per_update"), 0u);
+  trc.reset();
+  EXPECT_EQ(log->opened, expected_opened);
+}
+
+TEST(thin_replica_client_test, test_hash_agreement_rounds_f2) {
+  using Behavior = ScriptedTrsConnection::Behavior;
+  // One at a time: 1 times out, 2 agrees, 3 fails, 4 disagrees, 5 completes the agreement.
+  // In rounds: {1, 2} as two servers are missing, then {3}, {4} and {5}.
+  testHashAgreementRounds(
+      2,
+      {Behavior::kTimeout, Behavior::kSlow, Behavior::kFail, Behavior::kDisagree, Behavior::kAgree, Behavior::kAgree},
+      {1, 2, 3, 4, 5},
+      1,
+      1);
+}
+
+TEST(thin_replica_client_test, test_hash_agreement_rounds_f3) {
+  using Behavior = ScriptedTrsConnection::Behavior;
+  // One at a time: 1 agrees, 2 times out, 3 fails, 4 agrees, 5 disagrees, 6 times out, 7 completes the agreement.
+  // In rounds: {1, 2, 3}, {4, 5}, {6} and {7}.
+  testHashAgreementRounds(3,
+                          {Behavior::kSlow,
+                           Behavior::kTimeout,
+                           Behavior::kFail,
+                           Behavior::kSlow,
+                           Behavior::kDisagree,
+                           Behavior::kTimeout,
+                           Behavior::kAgree,
+                           Behavior::kAgree,
+                           Behavior::kAgree},
+                          {1, 2, 3, 4, 5, 6, 7},
+                          2,
+                          1);
+}
+
+// Server 0 serves the data slowly and server 1, the hedge server, serves `hedge_update` right away. The others serve
+// the hashes of the update. Returns the hash of the update pushed to the queue.
+string testHedgedDataStreams(const Data& update, const Data& hedge_update, milliseconds& duration) {
+  constexpr auto kSlowDataDuration = 1s;
+  constexpr size_t kMaxFaulty = 1;
+  auto log = make_shared<HashStreamLog>();
+  vector<shared_ptr<GrpcConnection>> servers;
+  for (size_t i = 0; i < 3 * kMaxFaulty + 1; ++i) {
+    auto server = make_shared<ScriptedTrsConnection>(i, ScriptedTrsConnection::Behavior::kAgree, update, log);
+    if (i == 0) server->setData(update, kSlowDataDuration);
+    if (i == 1) server->setData(hedge_update, 0ms);
+    servers.push_back(std::move(server));
+  }
+
+  shared_ptr<EventUpdateQueue> update_queue = make_shared<BasicEventUpdateQueue>();
+  auto trc_config = make_unique<ThinReplicaClientConfig>(kTestingClientID, update_queue, kMaxFaulty, servers);
+  trc_config->hedged_data_streams = true;
+  auto trc = make_unique<ThinReplicaClient>(std::move(trc_config), make_shared<concordMetrics::Aggregator>());
+  const auto start = std::chrono::steady_clock::now();
+  trc->Subscribe(1);
+  auto update_received = update_queue->pop();
+  duration = std::chrono::duration_cast<milliseconds>(std::chrono::steady_clock::now() - start);
+  EXPECT_TRUE((bool)update_received);
+  trc.reset();
+  // The data servers aren't asked for hashes
+  EXPECT_EQ(log->opened.count(0), 0);
+  EXPECT_EQ(log->opened.count(1), 0);
+
+  return update_received ? hashUpdate(*update_received) : string{};
+}
+
+Data makeUpdate(const string& value) {
+  Data update;
+  update.mutable_events()->set_block_id(1);
+  KVPair* events_data = update.mutable_events()->add_data();
+  events_data->set_key("key");
+  events_data->set_value(value);
+  return update;
+}
+
+TEST(thin_replica_client_test, test_hedged_data_streams_use_first_update) {
+  const auto update = makeUpdate("value");
+  milliseconds duration;
+  EXPECT_EQ(testHedgedDataStreams(update, update, duration), hashUpdate(update));
+  // The update of the hedge server is pushed without waiting for the data server
+  EXPECT_LT(duration, 500ms);
+}
+
+TEST(thin_replica_client_test, test_hedged_data_streams_verify_first_update) {
+  const auto update = makeUpdate("value");
+  milliseconds duration;
+  // The forged update arrives first but the other servers don't agree with it
+  EXPECT_EQ(testHedgedDataStreams(update, makeUpdate("forged"), duration), hashUpdate(update));
+}
+
 }  // anonymous namespace
 
 int main(int argc, char** argv) {
@@ -16,12 +16,19 @@
 #include "client/thin-replica-client/trc_hash.hpp"
 #include "client/concordclient/event_update.hpp"
 #include "kvbc_app_filter/kvbc_app_filter.h"
+#include "openssl_crypto.hpp"
+
+#include <map>
+#include <set>
+#include <stdexcept>
 
 using com::vmware::concord::thin_replica::Data;
+using concord::util::openssl_utils::computeSHA256Hash;
 using std::make_pair;
 using std::string;
 using std::to_string;
 using client::thin_replica_client::hashUpdate;
+using concord::client::concordclient::EventGroup;
 using concord::client::concordclient::EventVariant;
 using concord::client::concordclient::Update;
 
@@ -32,6 +39,39 @@ const string kSampleUpdateExpectedHash({'\x02', '\x3D', '\x0D', '\x8B', '\xC6',
 
 namespace {
 
+// The update hashes as originally computed, ordering the entry hashes with an std::map or an std::set.
+string littleEndian(uint64_t id) {
+  string bytes;
+  for (size_t i = 0; i < sizeof(id); ++i) {
+    bytes.push_back(static_cast<char>(id >> (8 * i)));
+  }
+  return bytes;
+}
+
+string referenceHash(const Update& update) {
+  std::map<string, string> entry_hashes;
+  for (const auto& kvp : update.kv_pairs) {
+    entry_hashes[computeSHA256Hash(kvp.first)] = computeSHA256Hash(kvp.second);
+  }
+  string concatenated = littleEndian(update.block_id);
+  for (const auto& [key_hash, value_hash] : entry_hashes) {
+    concatenated += key_hash + value_hash;
+  }
+  return computeSHA256Hash(concatenated);
+}
+
+string referenceHash(const EventGroup& event_group) {
+  std::set<string> entry_hashes;
+  for (const auto& event : event_group.events) {
+    entry_hashes.insert(computeSHA256Hash(event));
+  }
+  string concatenated = littleEndian(event_group.id);
+  for (const auto& hash : entry_hashes) {
+    concatenated += hash;
+  }
+  return computeSHA256Hash(concatenated);
+}
+
 TEST(trc_hash, hash_update) {
   Update legacy_event;
   legacy_event.block_id = 1337;
@@ -90,6 +130,48 @@ TEST(trc_hash, trs_trc_event_group) {
   EXPECT_EQ(concord::kvbc::KvbAppFilter::hashEventGroupUpdate(kvb_update), hashUpdate(data_update));
 }
 
+// Enough entries of various sizes to be hashed in several batches of lanes
+TEST(trc_hash, hash_large_updates) {
+  for (size_t num_entries : {0, 1, 7, 33, 300}) {
+    Update legacy_event;
+    legacy_event.block_id = 0x0102030405060708 + num_entries;
+    concord::kvbc::KvbFilteredUpdate kvb_update;
+    kvb_update.block_id = legacy_event.block_id;
+    EventGroup event_group;
+    event_group.id = legacy_event.block_id;
+    concord::kvbc::KvbFilteredEventGroupUpdate kvb_event_group;
+    kvb_event_group.event_group_id = event_group.id;
+    Data data_update;
+    data_update.mutable_events()->set_block_id(legacy_event.block_id);
+    for (size_t i = 0; i < num_entries; ++i) {
+      auto key = "key" + to_string(num_entries - i);
+      auto value = string((i * 37) % 300, static_cast<char>(i));
+      legacy_event.kv_pairs.push_back(make_pair(key, value));
+      kvb_update.kv_pairs.push_back(make_pair(key, value));
+      event_group.events.push_back(key + value);
+      kvb_event_group.event_group.events.push_back({key + value, {}});
+      auto data = data_update.mutable_events()->add_data();
+      data->set_key(key);
+      data->set_value(value);
+    }
+
+    EXPECT_EQ(hashUpdate(EventVariant{legacy_event}), referenceHash(legacy_event));
+    EXPECT_EQ(hashUpdate(data_update), referenceHash(legacy_event));
+    EXPECT_EQ(hashUpdate(EventVariant{event_group}), referenceHash(event_group));
+    EXPECT_EQ(concord::kvbc::KvbAppFilter::hashUpdate(kvb_update), referenceHash(legacy_event));
+    EXPECT_EQ(concord::kvbc::KvbAppFilter::hashEventGroupUpdate(kvb_event_group), referenceHash(event_group));
+  }
+}
+
+TEST(trc_hash, duplicate_keys) {
+  Update legacy_event;
+  legacy_event.block_id = 1337;
+  legacy_event.kv_pairs.push_back(make_pair("a", "1"));
+  legacy_event.kv_pairs.push_back(make_pair("b", "2"));
+  legacy_event.kv_pairs.push_back(make_pair("a", "3"));
+  EXPECT_THROW(hashUpdate(EventVariant{legacy_event}), std::invalid_argument);
+}
+
 }  // anonymous namespace
 
 int main(int argc, char** argv) {
@@ -0,0 +1,132 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the
+// "License").  You may not use this product except in compliance with the
+// Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+// Microbenchmarks of batch SHA-256 hashing: one buffer at a time versus the multi-lane engines of SHA256Batch.
+//
+// Every benchmark hashes state.range(0) buffers of state.range(1) bytes per iteration. Compare the bytes/second of
+// oneByOne* against batch* for the same arguments.
+
+#include <benchmark/benchmark.h>
+
+#include "Digest.hpp"
+#include "sha256_batch.hpp"
+#include "sha_hash.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using ::concord::util::SHA256Batch;
+using ::concord::util::SHA2_256;
+using ::concord::util::digest::DigestUtil;
+
+struct Buffers {
+  std::vector<std::string> storage;
+  std::vector<const void *> data;
+  std::vector<size_t> sizes;
+  std::vector<SHA256Batch::Digest> out;
+};
+
+Buffers randomBuffers(std::size_t count, std::size_t size) {
+  auto gen = std::mt19937{};
+  auto dist = std::uniform_int_distribution<int>{0, 255};
+  auto buffers = Buffers{};
+  buffers.storage.resize(count);
+  for (auto &buf : buffers.storage) {
+    buf.resize(size);
+    for (auto &c : buf) c = static_cast<char>(dist(gen));
+    buffers.data.push_back(buf.data());
+    buffers.sizes.push_back(buf.size());
+  }
+  buffers.out.resize(count);
+  return buffers;
+}
+
+void setProcessed(benchmark::State &state) {
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * state.range(0) * state.range(1));
+}
+
+// The CryptoPP based DigestUtil, as used by the consensus messages and state transfer.
+void oneByOneDigestUtil(benchmark::State &state) {
+  auto buffers = randomBuffers(state.range(0), state.range(1));
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < buffers.storage.size(); ++i) {
+      DigestUtil::compute(buffers.storage[i].data(),
+                          buffers.storage[i].size(),
+                          reinterpret_cast<char *>(buffers.out[i].data()),
+                          buffers.out[i].size());
+    }
+    benchmark::DoNotOptimize(buffers.out.data());
+  }
+  setProcessed(state);
+}
+
+// The OpenSSL EVP based SHA2_256, as used by kvbc.
+void oneByOneEVP(benchmark::State &state) {
+  auto buffers = randomBuffers(state.range(0), state.range(1));
+  auto hasher = SHA2_256{};
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < buffers.storage.size(); ++i) {
+      buffers.out[i] = hasher.digest(buffers.storage[i].data(), buffers.storage[i].size());
+    }
+    benchmark::DoNotOptimize(buffers.out.data());
+  }
+  setProcessed(state);
+}
+
+void batch(benchmark::State &state, SHA256Batch::Engine engine) {
+  if (!SHA256Batch::isSupported(engine)) {
+    state.SkipWithError("engine not supported by this CPU");
+    return;
+  }
+  auto buffers = randomBuffers(state.range(0), state.range(1));
+  for (auto _ : state) {
+    SHA256Batch::digest(engine, buffers.data.data(), buffers.sizes.data(), buffers.data.size(), buffers.out.data());
+    benchmark::DoNotOptimize(buffers.out.data());
+  }
+  setProcessed(state);
+}
+
+void batchScalar(benchmark::State &state) { batch(state, SHA256Batch::Engine::SCALAR); }
+void batchAvx2(benchmark::State &state) { batch(state, SHA256Batch::Engine::AVX2); }
+void batchAvx512(benchmark::State &state) { batch(state, SHA256Batch::Engine::AVX512); }
+void batchAuto(benchmark::State &state) {
+  state.SetLabel(SHA256Batch::engineName(SHA256Batch::engine()));
+  batch(state, SHA256Batch::engine());
+}
+
+// {number of buffers, buffer size}
+void batchArgs(benchmark::internal::Benchmark *b) {
+  for (auto count : {16, 256}) {
+    for (auto size : {32, 64, 256, 1024, 4096}) {
+      b->Args({count, size});
+    }
+  }
+}
+
+}  // namespace
+
+BENCHMARK(oneByOneDigestUtil)->Apply(batchArgs);
+BENCHMARK(oneByOneEVP)->Apply(batchArgs);
+BENCHMARK(batchScalar)->Apply(batchArgs);
+BENCHMARK(batchAvx2)->Apply(batchArgs);
+BENCHMARK(batchAvx512)->Apply(batchArgs);
+BENCHMARK(batchAuto)->Apply(batchArgs);
+
+BENCHMARK_MAIN();
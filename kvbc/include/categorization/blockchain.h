@@ -141,6 +141,32 @@ class Blockchain {
       return RawBlock::deserialize(raw_block_ser.value());
     }
 
+    // Read the raw blocks [from, until] with a single multiGet. Missing blocks are std::nullopt.
+    std::vector<std::optional<RawBlock>> getRawBlocks(const BlockId from, const BlockId until) const {
+      ConcordAssertLE(from, until);
+      auto keys = std::vector<detail::Buffer>{};
+      keys.reserve(until - from + 1);
+      for (auto id = from; id <= until; ++id) {
+        keys.push_back(Block::generateKey(id));
+      }
+      auto slices = std::vector<::rocksdb::PinnableSlice>{};
+      auto statuses = std::vector<::rocksdb::Status>{};
+      native_client_->multiGet(detail::ST_CHAIN_CF, keys, slices, statuses);
+
+      auto blocks = std::vector<std::optional<RawBlock>>{};
+      blocks.reserve(slices.size());
+      for (auto i = 0ull; i < slices.size(); ++i) {
+        if (statuses[i].ok()) {
+          blocks.push_back(RawBlock::deserialize(slices[i]));
+        } else if (statuses[i].IsNotFound()) {
+          blocks.push_back(std::nullopt);
+        } else {
+          throw std::runtime_error{"State transfer chain multiGet() failure: " + statuses[i].ToString()};
+        }
+      }
+      return blocks;
+    }
+
     std::optional<Hash> parentDigest(BlockId block_id) const {
       const auto raw_block_ser = native_client_->getSlice(detail::ST_CHAIN_CF, Block::generateKey(block_id));
       if (!raw_block_ser) {
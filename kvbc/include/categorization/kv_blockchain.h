@@ -20,6 +20,7 @@
 #include "immutable_kv_category.h"
 #include "block_merkle_category.h"
 #include "versioned_kv_category.h"
+#include "public_state_keys.h"
 #include "kv_types.hpp"
 #include "categorization/types.h"
 #include "thread_pool.hpp"
@@ -150,14 +151,22 @@ class KeyValueBlockchain {
   //  ...
   //  hN = hash(hN-1 || hash(kN) || vN)
   //
+  // The key-values are also split in up to ReplicaConfig::numOfStateSnapshotShards shards of consecutive keys of equal
+  // sizes. The last key, the size and the start hash of each shard are persisted as PublicStateHashShards, so that each
+  // shard can be streamed and verified on its own.
+  //
   // This method is supposed to be called on DB snapshots only and not on the actual blockchain.
   // Precondition: The current KeyValueBlockchain instance points to a DB snapshot.
   void computeAndPersistPublicStateHash(BlockId checkpoint_block_id, const Converter& value_converter = kNoopConverter);
 
   // Returns the public state keys as of the current point in the blockchain's history.
   // Returns std::nullopt if no public keys have been persisted.
+  // Note: loads all the public keys in memory. Prefer getPublicStateKeyStore() for counting, lookups and iteration.
   std::optional<PublicStateKeys> getPublicStateKeys() const;
 
+  // Returns a store for reading and updating the public state keys as of the current point in the blockchain's history.
+  PublicStateKeyStore getPublicStateKeyStore() const;
+
   // Iterate over all public key values, calling the given function multiple times with two parameters:
   // * key
   // * value
@@ -173,17 +182,37 @@ class KeyValueBlockchain {
   bool iteratePublicStateKeyValues(const std::function<void(std::string&&, std::string&&)>& f,
                                    const std::string& after_key) const;
 
+  // Same as above, but starts from the first public key if `after_key` is not given and stops after `last_key`, which
+  // doesn't have to be a public key.
+  bool iteratePublicStateKeyValues(const std::function<void(std::string&&, std::string&&)>& f,
+                                   const std::optional<std::string>& after_key,
+                                   const std::string& last_key) const;
+
   // The key used in the default column family for persisting the current public state hash.
   static std::string publicStateHashKey();
 
+  // The key used in the default column family for persisting the shards of the current public state hash.
+  static std::string publicStateHashShardsKey();
+
+  // Returns hash(prev_hash || hash(key) || value), i.e. the next link of the public state hash chain.
+  static Hash nextPublicStateHash(const Hash& prev_hash, const std::string& key, const std::string& value);
+
  private:
   bool iteratePublicStateKeyValuesImpl(const std::function<void(std::string&&, std::string&&)>& f,
-                                       const std::optional<std::string>& after_key) const;
+                                       const std::optional<std::string>& after_key,
+                                       const std::optional<std::string>& last_key) const;
 
   BlockId addBlock(CategoryInput&& category_updates, concord::storage::rocksdb::NativeWriteBatch& write_batch);
 
   // tries to link the state transfer chain to the main blockchain
   void linkSTChainFrom(BlockId block_id);
+  // Links the blocks [from_block_id, until_block_id] of the state transfer chain in order, up to the first missing one.
+  // While a window of blocks is linked, the next one is read ahead on st_link_prefetch_pool_. Returns (or throws) only
+  // once no read ahead is running.
+  // Returns the number of linked blocks.
+  size_t linkSTChainRange(BlockId from_block_id,
+                          BlockId until_block_id,
+                          const std::function<void(BlockId)>& on_linked = nullptr);
   void writeSTLinkTransaction(const BlockId block_id, RawBlock& block);
 
   // If a block has the genesis ID key, prune up to it. Rationale is that this will preserve the same order of block
@@ -283,18 +312,23 @@ class KeyValueBlockchain {
   util::ThreadPool thread_pool_{1};
   // For concurrent deletion of the categories inside a block.
   util::ThreadPool prunning_thread_pool_{2};
+  // Reads the raw blocks ahead while the state transfer chain is linked.
+  util::ThreadPool st_link_prefetch_pool_{1};
+  static constexpr BlockId kSTLinkPrefetchBlocks = 128;
 
   // metrics
+  // The add/delete counters are sharded, so the aggregator reads them directly and no UpdateAggregator() call is
+  // needed on the block add and prune paths.
   std::shared_ptr<concordMetrics::Aggregator> aggregator_;
   concordMetrics::Component delete_metrics_comp_;
-  concordMetrics::CounterHandle versioned_num_of_deletes_keys_;
-  concordMetrics::CounterHandle immutable_num_of_deleted_keys_;
-  concordMetrics::CounterHandle merkle_num_of_deleted_keys_;
+  concordMetrics::ShardedCounterHandle versioned_num_of_deletes_keys_;
+  concordMetrics::ShardedCounterHandle immutable_num_of_deleted_keys_;
+  concordMetrics::ShardedCounterHandle merkle_num_of_deleted_keys_;
 
   concordMetrics::Component add_metrics_comp_;
-  concordMetrics::CounterHandle versioned_num_of_keys_;
-  concordMetrics::CounterHandle immutable_num_of_keys_;
-  concordMetrics::CounterHandle merkle_num_of_keys_;
+  concordMetrics::ShardedCounterHandle versioned_num_of_keys_;
+  concordMetrics::ShardedCounterHandle immutable_num_of_keys_;
+  concordMetrics::ShardedCounterHandle merkle_num_of_keys_;
 
   std::chrono::seconds dump_delete_metrics_interval_{bftEngine::ReplicaConfig::instance().deleteMetricsDumpInterval};
   std::chrono::seconds last_dump_time_{0};
@@ -0,0 +1,83 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the
+// "License").  You may not use this product except in compliance with the
+// Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#pragma once
+
+#include "base_types.h"
+#include "categorized_kvbc_msgs.cmf.hpp"
+#include "updates.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace concord::kvbc::categorization {
+
+// Reads and updates the set of public state keys, which lives in the concord internal (versioned) category.
+//
+// The keys are stored as sorted chunks of at most kMaxKeysPerChunk keys. Each chunk is a PublicStateKeys message under
+// its own key, and a PublicStateKeysIndex message holds the first key of every chunk. Adding keys rewrites only the
+// chunks they fall into and the index, and iteration loads one chunk at a time, so neither has to load or rewrite the
+// whole set.
+//
+// The set may also be a single PublicStateKeys message under keyTypes::state_public_key_set, as persisted by earlier
+// versions. It is read as is, and converted to chunks the first time keys are added.
+class PublicStateKeyStore {
+ public:
+  // Returns the latest value of a key in the concord internal category
+  using LatestGetter = std::function<std::optional<Value>(const std::string& key)>;
+
+  static constexpr std::size_t kMaxKeysPerChunk = 4096;
+
+  explicit PublicStateKeyStore(LatestGetter get_latest) : get_latest_{std::move(get_latest)} {}
+
+  // Returns true if public keys have been persisted.
+  bool exists() const;
+
+  // The number of public keys. Only loads the index.
+  std::uint64_t size() const;
+
+  bool contains(const std::string& key) const;
+  // Returns whether each of `keys` is public. Loads each chunk at most once.
+  std::vector<bool> contains(const std::vector<std::string>& keys) const;
+
+  // Calls `f` with every public key, in sorted order, starting from the key after `after_key` if given and stopping
+  // after `last_key` if given. `last_key` doesn't have to be a public key.
+  // If `after_key` is not a public key, false is returned and `f` is not called.
+  bool iterate(const std::function<void(std::string&&)>& f,
+               const std::optional<std::string>& after_key = std::nullopt,
+               const std::optional<std::string>& last_key = std::nullopt) const;
+
+  // Returns all the public keys, or std::nullopt if none have been persisted.
+  // Note: loads the whole set in memory.
+  std::optional<PublicStateKeys> getAll() const;
+
+  // Adds to `updates` the updates which make `keys` public. Keys which are already public are ignored.
+  void add(std::vector<std::string> keys, VersionedUpdates& updates) const;
+
+  static std::string chunkKey(std::uint64_t chunk_id);
+
+ private:
+  std::optional<PublicStateKeysIndex> getIndex() const;
+  std::optional<PublicStateKeys> getLegacy() const;
+  PublicStateKeys getChunk(std::uint64_t chunk_id) const;
+  // The position of the chunk `key` falls into, or the number of chunks if the index is empty
+  static std::size_t chunkOf(const PublicStateKeysIndex& index, const std::string& key);
+
+  LatestGetter get_latest_;
+};
+
+}  // namespace concord::kvbc::categorization
@@ -20,6 +20,10 @@
 #include <atomic>
 #include <boost/lockfree/spsc_queue.hpp>
 #include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include "Logger.hpp"
@@ -33,6 +37,8 @@
 #include "event_group_msgs.cmf.hpp"
 #include "endianness.hpp"
 #include "kvbc_key_types.h"
+#include "sha_hash.hpp"
+#include "thread_pool.hpp"
 
 namespace concord {
 namespace kvbc {
@@ -124,10 +130,79 @@ class NoLegacyEvents : public std::exception {
   std::string msg_{"Legacy events requested but event groups found"};
 };
 
+// Saved states of the range hashes computed by KvbAppFilter::readBlockRangeHash() and readEventGroupRangeHash().
+//
+// A range hash is the SHA-256 of the concatenated update hashes in the range. For ranges starting at the first update,
+// as requested by ReadStateHash, the SHA-256 state is saved every `interval` updates per client. A later request
+// resumes from the newest saved state in its range and only reads and filters the updates after it.
+// Updates don't change once written, hence, saved states never have to be invalidated. The cache lives in memory and
+// is shared by all filters which read the same storage. Only the newest `states_per_client` states of a client are
+// kept, as requests are usually for the latest updates, and only the `max_clients` clients used last are kept.
+
+class KvbRangeHashCache {
+ public:
+  enum class Type { BLOCKS, EVENT_GROUPS };
+
+  // Range hash state after hashing the updates [first, id]
+  struct State {
+    uint64_t id;
+    concord::util::SHA2_256 hash;
+  };
+
+  static constexpr uint64_t kDefaultInterval = 1024;
+  static constexpr size_t kDefaultStatesPerClient = 4;
+  static constexpr size_t kDefaultMaxClients = 1024;
+  // Range hashes of ranges starting with this update id are cached
+  static constexpr uint64_t kFirstId = 1;
+
+  explicit KvbRangeHashCache(uint64_t interval = kDefaultInterval,
+                             size_t states_per_client = kDefaultStatesPerClient,
+                             size_t max_clients = kDefaultMaxClients)
+      : interval_(interval), states_per_client_(states_per_client), max_clients_(max_clients) {
+    ConcordAssertGT(interval_, 0);
+    ConcordAssertGT(states_per_client_, 0);
+    ConcordAssertGT(max_clients_, 0);
+  }
+
+  // Return a copy of the newest state of the given client with id <= max_id
+  std::optional<State> find(Type type, const std::string &client_id, uint64_t max_id);
+
+  // Save a copy of the given state if id is a multiple of the interval
+  void save(Type type, const std::string &client_id, uint64_t id, const concord::util::SHA2_256 &hash);
+
+  // Number of saved states (for testing)
+  size_t size() const;
+
+ private:
+  using Key = std::pair<Type, std::string>;
+  struct ClientStates {
+    std::map<uint64_t, concord::util::SHA2_256> states;
+    // Position of the client in lru_
+    std::list<Key>::iterator lru_it;
+  };
+
+  const uint64_t interval_;
+  const size_t states_per_client_;
+  const size_t max_clients_;
+  mutable std::mutex mutex_;
+  std::map<Key, ClientStates> states_;
+  // Clients, the most recently used first
+  std::list<Key> lru_;
+};
+
 class KvbAppFilter {
  public:
-  KvbAppFilter(const concord::kvbc::IReader *rostorage, const std::string &client_id)
-      : logger_(logging::getLogger("concord.storage.KvbAppFilter")), rostorage_(rostorage), client_id_(client_id) {
+  // If a read pool is given then range reads (readBlockRange(), readEventGroups() and the range hashes) read and
+  // filter up to kReadAheadSize updates ahead on it, in parallel. The updates are still processed in order.
+  KvbAppFilter(const concord::kvbc::IReader *rostorage,
+               const std::string &client_id,
+               std::shared_ptr<KvbRangeHashCache> range_hash_cache = nullptr,
+               std::shared_ptr<concord::util::ThreadPool> read_pool = nullptr)
+      : logger_(logging::getLogger("concord.storage.KvbAppFilter")),
+        rostorage_(rostorage),
+        client_id_(client_id),
+        range_hash_cache_(std::move(range_hash_cache)),
+        read_pool_(std::move(read_pool)) {
     ConcordAssertNE(rostorage_, nullptr);
   }
 
@@ -141,6 +216,8 @@ class KvbAppFilter {
   // Compute hash for the given update
   static std::string hashUpdate(const KvbFilteredUpdate &update);
   static std::string hashEventGroupUpdate(const KvbFilteredEventGroupUpdate &update);
+  static std::string hashEventGroupUpdate(kvbc::EventGroupId event_group_id,
+                                          const KvbFilteredEventGroupUpdate::EventGroup &event_group);
 
   // Return all key-value pairs from the KVB in the block range [earliest block
   // available, given block_id] with the following conditions:
@@ -162,6 +239,8 @@ class KvbAppFilter {
 
   // Compute the state hash of all key-value pairs in the range of [earliest
   // block available, given block_id] based on the given KvbAppFilter::AppType.
+  // If a range hash cache is set then ranges starting at the first block resume
+  // from the newest cached state (the same applies to event groups).
   std::string readBlockRangeHash(kvbc::BlockId start, kvbc::BlockId end);
 
   std::string readEventGroupRangeHash(kvbc::EventGroupId event_group_id_start);
@@ -181,6 +260,12 @@ class KvbAppFilter {
 
   TagTableValue getValueFromTagTable(const std::string &tag, uint64_t pvt_eg_id) const;
 
+  // Return the tag-table entries of the given tag in [first_tag_eg_id, last_tag_eg_id], read with a single multi-get.
+  // Throws if any of them doesn't exist.
+  std::vector<TagTableValue> getValuesFromTagTable(const std::string &tag,
+                                                   uint64_t first_tag_eg_id,
+                                                   uint64_t last_tag_eg_id) const;
+
   uint64_t oldestExternalEventGroupId() const;
 
   uint64_t newestExternalEventGroupId() const;
@@ -212,6 +297,8 @@ class KvbAppFilter {
   // Return the pair {last_ext_eg_id_read, last_global_eg_id_read}
   std::pair<uint64_t, uint64_t> getLastEgIdsRead();
 
+  const std::string &getClientId() const { return client_id_; }
+
  public:
   static inline const std::string kGlobalEgIdKeyOldest{"_global_eg_id_oldest"};
   static inline const std::string kGlobalEgIdKeyNewest{"_global_eg_id_newest"};
@@ -223,11 +310,37 @@ class KvbAppFilter {
   // kExecutionEventGroupTagCategory
   static inline const std::string kTagTableKeySeparator{"#"};
 
+  // readEventGroups() reads the tag table ahead of the event groups it filters, in batches which start at the minimum
+  // and double with every batch up to the maximum.
+  static constexpr uint64_t kMinTagTableReadAhead = 4;
+  static constexpr uint64_t kMaxTagTableReadAhead = 256;
+
+  // The number of updates range reads read ahead of the one being processed if a read pool is set
+  static constexpr size_t kReadAheadSize = 64;
+
  private:
+  std::optional<KvbRangeHashCache::State> findRangeHashState(KvbRangeHashCache::Type type,
+                                                             uint64_t start,
+                                                             uint64_t end) const;
+  void saveRangeHashState(KvbRangeHashCache::Type type,
+                          uint64_t start,
+                          uint64_t id,
+                          const concord::util::SHA2_256 &hash) const;
+  // Read and filter the blocks [start, end] and call process_update with each of them in order, until it returns false
+  void readBlocks(kvbc::BlockId start,
+                  kvbc::BlockId end,
+                  const std::function<bool(KvbFilteredUpdate &&)> &process_update);
+  KvbFilteredUpdate readFilteredBlock(kvbc::BlockId block_id);
+  KvbFilteredEventGroupUpdate::EventGroup readFilteredEventGroup(kvbc::EventGroupId global_event_group_id);
+  TagTableValue toTagTableValue(const std::string &key,
+                                const std::optional<concord::kvbc::categorization::Value> &opt) const;
+
   logging::Logger logger_;
   const concord::kvbc::IReader *rostorage_{nullptr};
   const std::string client_id_;
   const std::string cid_key_{kKvbKeyCorrelationId};
+  std::shared_ptr<KvbRangeHashCache> range_hash_cache_;
+  std::shared_ptr<concord::util::ThreadPool> read_pool_;
 
   std::pair<uint64_t, uint64_t> last_ext_and_global_eg_id_read_{0, 0};
 };
@@ -32,6 +32,8 @@ static const char reconfiguration_ts_key = 0x31;
 static const char reconfiguration_rep_main_key = 0x32;
 static const std::string genesis_block_key(1, 0x32);
 static const std::string state_public_key_set(1, 0x33);
+static const std::string state_public_key_index(1, 0x34);
+static const std::string state_public_key_chunk_prefix(1, 0x35);
 
 enum PRUNING_COMMAND_TYPES : uint16_t {
   PRUNING_START = 0x0,
@@ -53,6 +53,63 @@ using concord::storage::DBMetadataStorage;
 
 namespace concord::kvbc {
 
+// Executes the read-only requests of a read-only replica at the last reachable block of its storage, passed in
+// ExecutionRequest::blockId. If the storage is a RocksDB one, the requests are executed over a snapshot of it, so that
+// each of them sees the state at that block even while state transfer keeps linking new ones. The read-only replica may
+// execute several such requests concurrently.
+class KvbcReadOnlyRequestHandler : public bftEngine::RequestHandler {
+ public:
+  using LastBlockIdGetter = std::function<BlockId()>;
+
+  static std::shared_ptr<KvbcReadOnlyRequestHandler> create(
+      const std::shared_ptr<IRequestsHandler> &user_req_handler,
+      const std::shared_ptr<concord::cron::CronTableRegistry> &cron_table_registry,
+      LastBlockIdGetter last_block_id,
+      std::shared_ptr<storage::rocksdb::NativeClient> db,
+      ISystemResourceEntity &resourceEntity) {
+    return std::shared_ptr<KvbcReadOnlyRequestHandler>{new KvbcReadOnlyRequestHandler{
+        user_req_handler, cron_table_registry, std::move(last_block_id), std::move(db), resourceEntity}};
+  }
+
+  void execute(ExecutionRequestsQueue &requests,
+               std::optional<bftEngine::Timestamp> timestamp,
+               const std::string &batchCid,
+               concordUtils::SpanWrapper &parent_span) override {
+    const auto isSnapshotRead = [](const ExecutionRequest &req) {
+      return (req.flags & bftEngine::READ_ONLY_FLAG) && !(req.flags & bftEngine::RECONFIG_FLAG);
+    };
+    if (requests.empty() || !std::all_of(requests.cbegin(), requests.cend(), isSnapshotRead)) {
+      return bftEngine::RequestHandler::execute(requests, timestamp, batchCid, parent_span);
+    }
+    // Blocks are linked atomically, so the snapshot includes at least the last reachable block read before it
+    const auto block_id = last_block_id_();
+    for (auto &req : requests) {
+      req.blockId = block_id;
+    }
+    if (db_) {
+      const auto snapshot = db_->scopedSnapshot();
+      return bftEngine::RequestHandler::execute(requests, timestamp, batchCid, parent_span);
+    }
+    bftEngine::RequestHandler::execute(requests, timestamp, batchCid, parent_span);
+  }
+
+ private:
+  KvbcReadOnlyRequestHandler(const std::shared_ptr<IRequestsHandler> &user_req_handler,
+                             const std::shared_ptr<concord::cron::CronTableRegistry> &cron_table_registry,
+                             LastBlockIdGetter last_block_id,
+                             std::shared_ptr<storage::rocksdb::NativeClient> db,
+                             ISystemResourceEntity &resourceEntity)
+      : bftEngine::RequestHandler(resourceEntity), last_block_id_{std::move(last_block_id)}, db_{std::move(db)} {
+    setUserRequestHandler(user_req_handler);
+    setCronTableRegistry(cron_table_registry);
+  }
+
+ private:
+  const LastBlockIdGetter last_block_id_;
+  // Null if the storage is not a RocksDB one
+  const std::shared_ptr<storage::rocksdb::NativeClient> db_;
+};
+
 Status Replica::initInternals() {
   LOG_INFO(logger, "Replica::initInternals() id = " << replicaConfig_.replicaId);
 
@@ -66,8 +123,21 @@ Status Replica::initInternals() {
 
   if (replicaConfig_.isReadOnly) {
     LOG_INFO(logger, "ReadOnly mode");
-    auto requestHandler =
-        bftEngine::IRequestsHandler::createRequestsHandler(m_cmdHandler, cronTableRegistry_, replicaResources_);
+    // A read-only replica has no blockchain, only the blocks it fetches by state transfer through its DB adapter
+    std::shared_ptr<bftEngine::IRequestsHandler> requestHandler;
+    if (m_bcDbAdapter) {
+      requestHandler = KvbcReadOnlyRequestHandler::create(
+          m_cmdHandler,
+          cronTableRegistry_,
+          [this]() { return m_bcDbAdapter->getLastReachableBlockId(); },
+          std::dynamic_pointer_cast<storage::rocksdb::Client>(m_dbSet.dataDBClient)
+              ? storage::rocksdb::NativeClient::fromIDBClient(m_dbSet.dataDBClient)
+              : nullptr,
+          replicaResources_);
+    } else {
+      requestHandler =
+          bftEngine::IRequestsHandler::createRequestsHandler(m_cmdHandler, cronTableRegistry_, replicaResources_);
+    }
     requestHandler->setReconfigurationHandler(std::make_shared<pruning::ReadOnlyReplicaPruningHandler>(*this));
     m_replicaPtr = bftEngine::IReplica::createNewRoReplica(
         replicaConfig_, requestHandler, m_stateTransfer, m_ptrComm, m_metadataStorage);
@@ -547,7 +617,8 @@ Replica::Replica(ICommunication *comm,
     replicaConfig_.get("concord.bft.st.enableReservedPages", true),
     replicaConfig_.get("concord.bft.st.enableSourceBlocksPreFetch", true),
     replicaConfig_.get("concord.bft.st.enableSourceSelectorPrimaryAwareness", true),
-    replicaConfig_.get("concord.bft.st.enableStoreRvbDataDuringCheckpointing", true)
+    replicaConfig_.get("concord.bft.st.enableStoreRvbDataDuringCheckpointing", true),
+    replicaConfig_.get("concord.bft.st.enableResPagesDigestTree", false)
   };
   if (replicaConfig_.isReadOnly) stConfig.runInSeparateThread = false;
 
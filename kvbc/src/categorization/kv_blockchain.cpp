@@ -25,6 +25,7 @@
 #include "categorization/details.h"
 #include "ReplicaConfig.hpp"
 #include "throughput.hpp"
+#include "scope_exit.hpp"
 
 #include <algorithm>
 #include <iterator>
@@ -54,14 +55,14 @@ KeyValueBlockchain::KeyValueBlockchain(const std::shared_ptr<concord::storage::r
       state_transfer_block_chain_{native_client_},
       delete_metrics_comp_{
           concordMetrics::Component("kv_blockchain_deletes", std::make_shared<concordMetrics::Aggregator>())},
-      versioned_num_of_deletes_keys_{delete_metrics_comp_.RegisterCounter("numOfVersionedKeysDeleted")},
-      immutable_num_of_deleted_keys_{delete_metrics_comp_.RegisterCounter("numOfImmutableKeysDeleted")},
-      merkle_num_of_deleted_keys_{delete_metrics_comp_.RegisterCounter("numOfMerkleKeysDeleted")},
+      versioned_num_of_deletes_keys_{delete_metrics_comp_.RegisterShardedCounter("numOfVersionedKeysDeleted")},
+      immutable_num_of_deleted_keys_{delete_metrics_comp_.RegisterShardedCounter("numOfImmutableKeysDeleted")},
+      merkle_num_of_deleted_keys_{delete_metrics_comp_.RegisterShardedCounter("numOfMerkleKeysDeleted")},
       add_metrics_comp_{
           concordMetrics::Component("kv_blockchain_adds", std::make_shared<concordMetrics::Aggregator>())},
-      versioned_num_of_keys_{add_metrics_comp_.RegisterCounter("numOfVersionedKeys")},
-      immutable_num_of_keys_{add_metrics_comp_.RegisterCounter("numOfImmutableKeys")},
-      merkle_num_of_keys_{add_metrics_comp_.RegisterCounter("numOfMerkleKeys")} {
+      versioned_num_of_keys_{add_metrics_comp_.RegisterShardedCounter("numOfVersionedKeys")},
+      immutable_num_of_keys_{add_metrics_comp_.RegisterShardedCounter("numOfImmutableKeys")},
+      merkle_num_of_keys_{add_metrics_comp_.RegisterShardedCounter("numOfMerkleKeys")} {
   if (detail::createColumnFamilyIfNotExisting(detail::CAT_ID_TYPE_CF, *native_client_.get())) {
     LOG_INFO(CAT_BLOCK_LOG, "Created [" << detail::CAT_ID_TYPE_CF << "] column family for the category types");
   }
@@ -219,7 +220,6 @@ BlockId KeyValueBlockchain::addBlock(CategoryInput&& category_updates,
   block_chain_.addBlock(new_block, write_batch);
   LOG_DEBUG(CAT_BLOCK_LOG, "Writing block [" << new_block.id() << "] to the blocks cf");
   write_batch.put(detail::BLOCKS_CF, Block::generateKey(new_block.id()), Block::serialize(new_block));
-  add_metrics_comp_.UpdateAggregator();
   return new_block.id();
 }
 
@@ -405,62 +405,46 @@ void KeyValueBlockchain::trimBlocksFromSnapshot(BlockId block_id_at_checkpoint)
 static const auto kPublicStateHashKey = concord::storage::v2MerkleTree::detail::serialize(
     concord::storage::v2MerkleTree::detail::EBFTSubtype::PublicStateHashAtDbCheckpoint);
 
+static const auto kPublicStateHashShardsKey = concord::storage::v2MerkleTree::detail::serialize(
+    concord::storage::v2MerkleTree::detail::EBFTSubtype::PublicStateHashShardsAtDbCheckpoint);
+
 std::string KeyValueBlockchain::publicStateHashKey() { return kPublicStateHashKey; }
 
+std::string KeyValueBlockchain::publicStateHashShardsKey() { return kPublicStateHashShardsKey; }
+
+PublicStateKeyStore KeyValueBlockchain::getPublicStateKeyStore() const {
+  return PublicStateKeyStore{[this](const std::string& key) { return getLatest(kConcordInternalCategoryId, key); }};
+}
+
 std::optional<PublicStateKeys> KeyValueBlockchain::getPublicStateKeys() const {
-  const auto opt_val = getLatest(kConcordInternalCategoryId, keyTypes::state_public_key_set);
-  if (!opt_val) {
-    return std::nullopt;
-  }
-  auto public_state = PublicStateKeys{};
-  const auto val = std::get_if<VersionedValue>(&opt_val.value());
-  ConcordAssertNE(val, nullptr);
-  detail::deserialize(val->data, public_state);
-  return std::make_optional(std::move(public_state));
+  return getPublicStateKeyStore().getAll();
 }
 
 void KeyValueBlockchain::iteratePublicStateKeyValues(const std::function<void(std::string&&, std::string&&)>& f) const {
-  const auto ret = iteratePublicStateKeyValuesImpl(f, std::nullopt);
+  const auto ret = iteratePublicStateKeyValuesImpl(f, std::nullopt, std::nullopt);
   ConcordAssert(ret);
 }
 
 bool KeyValueBlockchain::iteratePublicStateKeyValues(const std::function<void(std::string&&, std::string&&)>& f,
                                                      const std::string& after_key) const {
-  return iteratePublicStateKeyValuesImpl(f, after_key);
+  return iteratePublicStateKeyValuesImpl(f, after_key, std::nullopt);
 }
 
-bool KeyValueBlockchain::iteratePublicStateKeyValuesImpl(const std::function<void(std::string&&, std::string&&)>& f,
-                                                         const std::optional<std::string>& after_key) const {
-  const auto public_state = getPublicStateKeys();
-  if (!public_state) {
-    return true;
-  }
-
-  auto idx = 0ull;
-  if (after_key) {
-    auto it = std::lower_bound(public_state->keys.cbegin(), public_state->keys.cend(), *after_key);
-    if (it == public_state->keys.cend() || *it != *after_key) {
-      return false;
-    }
-    // Start from the key after `after_key`.
-    idx = std::distance(public_state->keys.cbegin(), it) + 1;
-  }
+bool KeyValueBlockchain::iteratePublicStateKeyValues(const std::function<void(std::string&&, std::string&&)>& f,
+                                                     const std::optional<std::string>& after_key,
+                                                     const std::string& last_key) const {
+  return iteratePublicStateKeyValuesImpl(f, after_key, last_key);
+}
 
+bool KeyValueBlockchain::iteratePublicStateKeyValuesImpl(const std::function<void(std::string&&, std::string&&)>& f,
+                                                         const std::optional<std::string>& after_key,
+                                                         const std::optional<std::string>& last_key) const {
   const auto batch_size = bftEngine::ReplicaConfig::instance().stateIterationMultiGetBatchSize;
   auto keys_batch = std::vector<std::string>{};
   keys_batch.reserve(batch_size);
   auto opt_values = std::vector<std::optional<Value>>{};
   opt_values.reserve(batch_size);
-  while (idx < public_state->keys.size()) {
-    keys_batch.clear();
-    opt_values.clear();
-    while (keys_batch.size() < batch_size) {
-      if (idx == public_state->keys.size()) {
-        break;
-      }
-      keys_batch.push_back(public_state->keys[idx]);
-      ++idx;
-    }
+  const auto flush = [&]() {
     multiGetLatest(kExecutionProvableCategory, keys_batch, opt_values);
     ConcordAssertEQ(keys_batch.size(), opt_values.size());
     for (auto i = 0ull; i < keys_batch.size(); ++i) {
@@ -470,26 +454,63 @@ bool KeyValueBlockchain::iteratePublicStateKeyValuesImpl(const std::function<voi
       ConcordAssertNE(value, nullptr);
       f(std::move(keys_batch[i]), std::move(value->data));
     }
+    keys_batch.clear();
+    opt_values.clear();
+  };
+
+  // The keys are loaded one chunk at a time.
+  const auto found = getPublicStateKeyStore().iterate(
+      [&](std::string&& key) {
+        keys_batch.push_back(std::move(key));
+        if (keys_batch.size() == batch_size) {
+          flush();
+        }
+      },
+      after_key,
+      last_key);
+  if (!found) {
+    return false;
+  }
+  if (!keys_batch.empty()) {
+    flush();
   }
   return true;
 }
 
 static const auto kInitialHash = detail::hash(std::string{});
 
+Hash KeyValueBlockchain::nextPublicStateHash(const Hash& prev_hash, const std::string& key, const std::string& value) {
+  auto hasher = Hasher{};
+  hasher.init();
+  hasher.update(prev_hash.data(), prev_hash.size());
+  const auto key_hash = detail::hash(key);
+  hasher.update(key_hash.data(), key_hash.size());
+  hasher.update(value.data(), value.size());
+  return hasher.finish();
+}
+
 void KeyValueBlockchain::computeAndPersistPublicStateHash(BlockId checkpoint_block_id,
                                                           const Converter& value_converter) {
+  const auto num_shards = std::max(1u, bftEngine::ReplicaConfig::instance().numOfStateSnapshotShards);
+  const auto num_keys = getPublicStateKeyStore().size();
+  const auto shard_size = std::max<std::uint64_t>(1, (num_keys + num_shards - 1) / num_shards);
+  auto shards = PublicStateHashShards{};
+  shards.block_id = checkpoint_block_id;
   auto hash = kInitialHash;
   iteratePublicStateKeyValues([&](std::string&& key, std::string&& value) {
-    value = value_converter(std::move(value));
-    auto hasher = Hasher{};
-    hasher.init();
-    hasher.update(hash.data(), hash.size());
-    const auto key_hash = detail::hash(key);
-    hasher.update(key_hash.data(), key_hash.size());
-    hasher.update(value.data(), value.size());
-    hash = hasher.finish();
+    if (shards.sizes.empty() || shards.sizes.back() == shard_size) {
+      shards.last_keys.emplace_back();
+      shards.sizes.push_back(0);
+      shards.start_hashes.push_back(hash);
+    }
+    hash = nextPublicStateHash(hash, key, value_converter(std::move(value)));
+    shards.last_keys.back() = std::move(key);
+    ++shards.sizes.back();
   });
-  native_client_->put(kPublicStateHashKey, detail::serialize(StateHash{checkpoint_block_id, hash}));
+  auto batch = native_client_->getBatch();
+  batch.put(kPublicStateHashKey, detail::serialize(StateHash{checkpoint_block_id, hash}));
+  batch.put(kPublicStateHashShardsKey, detail::serialize(shards));
+  native_client_->write(std::move(batch));
 }
 
 /////////////////////// Delete block ///////////////////////
@@ -549,8 +570,6 @@ bool KeyValueBlockchain::deleteBlock(const BlockId& block_id) {
   } else {
     throw std::invalid_argument{"Cannot delete blocks in the middle of the blockchain"};
   }
-  // Lets update the delete metrics component
-  delete_metrics_comp_.UpdateAggregator();
   return true;
 }
 
@@ -903,17 +922,7 @@ size_t KeyValueBlockchain::linkUntilBlockId(BlockId from_block_id, BlockId until
   }
 
   concord::util::DurationTracker<std::chrono::milliseconds> link_duration("link_duration", true);
-  for (auto i = from_block_id; i <= until_block_id; ++i) {
-    auto raw_block = state_transfer_block_chain_.getRawBlock(i);
-    if (!raw_block) {
-      // we didn't find the next block
-      return i - from_block_id;
-    }
-
-    // First prune and then link the block to the chain. Rationale is that this will preserve the same order of block
-    // deletes relative to block adds on source and destination replicas.
-    pruneOnSTLink(*raw_block);
-    writeSTLinkTransaction(i, *raw_block);
+  return linkSTChainRange(from_block_id, until_block_id, [&](BlockId i) {
     if ((++report_counter % report_thresh) == 0) {
       auto elapsed_time_ms = link_duration.totalDuration();
       uint64_t blocks_linked_per_sec{};
@@ -933,8 +942,7 @@ size_t KeyValueBlockchain::linkUntilBlockId(BlockId from_block_id, BlockId until
                                                     blocks_left_to_link,
                                                     estimated_time_left_sec));
     }
-  }
-  return until_block_id - from_block_id + 1;
+  });
 }
 
 // tries to remove blocks form the state transfer chain to the blockchain
@@ -942,15 +950,9 @@ void KeyValueBlockchain::linkSTChainFrom(BlockId block_id) {
   const auto last_block_id = state_transfer_block_chain_.getLastBlockId();
   if (last_block_id == 0) return;
 
-  for (auto i = block_id; i <= last_block_id; ++i) {
-    auto raw_block = state_transfer_block_chain_.getRawBlock(i);
-    if (!raw_block) {
-      return;
-    }
-    // First prune and then link the block to the chain. Rationale is that this will preserve the same order of block
-    // deletes relative to block adds on source and destination replicas.
-    pruneOnSTLink(*raw_block);
-    writeSTLinkTransaction(i, *raw_block);
+  if (block_id <= last_block_id &&
+      linkSTChainRange(block_id, last_block_id) < last_block_id - block_id + 1) {
+    return;
   }
 
   // Linking has fully completed and we should not have any more ST temporary blocks left. Therefore, make sure we don't
@@ -958,6 +960,52 @@ void KeyValueBlockchain::linkSTChainFrom(BlockId block_id) {
   state_transfer_block_chain_.resetChain();
 }
 
+// Every block is still linked in its own write batch: the categories read the state of the previous block while adding
+// a block, so the previous block must have been written. Reading the raw blocks is what can be taken off the linking
+// path.
+size_t KeyValueBlockchain::linkSTChainRange(BlockId from_block_id,
+                                            BlockId until_block_id,
+                                            const std::function<void(BlockId)>& on_linked) {
+  if (from_block_id > until_block_id) return 0;
+  const auto window_end = [until_block_id](BlockId first) {
+    return std::min(until_block_id, first + kSTLinkPrefetchBlocks - 1);
+  };
+  const auto fetch = [this](BlockId first, BlockId last) {
+    return state_transfer_block_chain_.getRawBlocks(first, last);
+  };
+
+  auto next_window = st_link_prefetch_pool_.async(fetch, from_block_id, window_end(from_block_id));
+  // A window read ahead must not outlive the call, e.g. when a block is missing or linking throws: it reads the state
+  // transfer chain, which the caller may reset right after.
+  const auto wait_for_read_ahead = concord::util::ScopeExit{[&next_window]() {
+    if (next_window.valid()) next_window.wait();
+  }};
+  size_t linked = 0;
+  for (auto first = from_block_id; first <= until_block_id;) {
+    auto raw_blocks = next_window.get();
+    const auto last = window_end(first);
+    if (last < until_block_id) {
+      next_window = st_link_prefetch_pool_.async(fetch, last + 1, window_end(last + 1));
+    }
+    for (size_t i = 0; i < raw_blocks.size(); ++i) {
+      const auto& raw_block = raw_blocks[i];
+      if (!raw_block) {
+        // we didn't find the next block
+        return linked;
+      }
+      const BlockId block_id = first + i;
+      // First prune and then link the block to the chain. Rationale is that this will preserve the same order of block
+      // deletes relative to block adds on source and destination replicas.
+      pruneOnSTLink(*raw_block);
+      writeSTLinkTransaction(block_id, *raw_block);
+      ++linked;
+      if (on_linked) on_linked(block_id);
+    }
+    first = last + 1;
+  }
+  return linked;
+}
+
 void KeyValueBlockchain::pruneOnSTLink(const RawBlock& block) {
   auto cat_it = block.data.updates.kv.find(kConcordInternalCategoryId);
   if (cat_it == block.data.updates.kv.cend()) {
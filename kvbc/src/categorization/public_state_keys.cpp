@@ -0,0 +1,272 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the
+// "License").  You may not use this product except in compliance with the
+// Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "categorization/public_state_keys.h"
+
+#include "assertUtils.hpp"
+#include "categorization/details.h"
+#include "endianness.hpp"
+#include "kvbc_key_types.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace concord::kvbc::categorization {
+
+namespace {
+
+template <typename T>
+std::optional<T> deserializeVersioned(const std::optional<Value>& opt_val) {
+  if (!opt_val) {
+    return std::nullopt;
+  }
+  const auto val = std::get_if<VersionedValue>(&opt_val.value());
+  ConcordAssertNE(val, nullptr);
+  auto msg = T{};
+  detail::deserialize(val->data, msg);
+  return msg;
+}
+
+void addUpdate(VersionedUpdates& updates, std::string&& key, const std::vector<std::uint8_t>& value) {
+  updates.addUpdate(std::move(key), std::string{value.cbegin(), value.cend()});
+}
+
+// Calls `f` with the keys after `after_key`, or with all of them if not given, up to `last_key` if given.
+// Returns false if `after_key` isn't in `keys`.
+bool iterateFrom(std::vector<std::string>& keys,
+                 const std::function<void(std::string&&)>& f,
+                 const std::optional<std::string>& after_key,
+                 const std::optional<std::string>& last_key) {
+  auto it = keys.begin();
+  if (after_key) {
+    it = std::lower_bound(keys.begin(), keys.end(), *after_key);
+    if (it == keys.end() || *it != *after_key) {
+      return false;
+    }
+    ++it;
+  }
+  for (; it != keys.end() && (!last_key || *it <= *last_key); ++it) {
+    f(std::move(*it));
+  }
+  return true;
+}
+
+}  // namespace
+
+std::string PublicStateKeyStore::chunkKey(std::uint64_t chunk_id) {
+  return keyTypes::state_public_key_chunk_prefix + concordUtils::toBigEndianStringBuffer(chunk_id);
+}
+
+std::optional<PublicStateKeysIndex> PublicStateKeyStore::getIndex() const {
+  return deserializeVersioned<PublicStateKeysIndex>(get_latest_(keyTypes::state_public_key_index));
+}
+
+std::optional<PublicStateKeys> PublicStateKeyStore::getLegacy() const {
+  return deserializeVersioned<PublicStateKeys>(get_latest_(keyTypes::state_public_key_set));
+}
+
+PublicStateKeys PublicStateKeyStore::getChunk(std::uint64_t chunk_id) const {
+  auto chunk = deserializeVersioned<PublicStateKeys>(get_latest_(chunkKey(chunk_id)));
+  if (!chunk) {
+    throw std::runtime_error{"Missing public state keys chunk " + std::to_string(chunk_id)};
+  }
+  return std::move(*chunk);
+}
+
+std::size_t PublicStateKeyStore::chunkOf(const PublicStateKeysIndex& index, const std::string& key) {
+  if (index.first_keys.empty()) {
+    return 0;
+  }
+  // Keys before the first one of the first chunk go to the first chunk.
+  const auto it = std::upper_bound(index.first_keys.cbegin(), index.first_keys.cend(), key);
+  return it == index.first_keys.cbegin() ? 0 : std::distance(index.first_keys.cbegin(), it) - 1;
+}
+
+bool PublicStateKeyStore::exists() const { return getIndex() || getLegacy(); }
+
+std::uint64_t PublicStateKeyStore::size() const {
+  const auto index = getIndex();
+  if (!index) {
+    const auto legacy = getLegacy();
+    return legacy ? legacy->keys.size() : 0;
+  }
+  auto size = std::uint64_t{0};
+  for (auto chunk_size : index->chunk_sizes) {
+    size += chunk_size;
+  }
+  return size;
+}
+
+bool PublicStateKeyStore::contains(const std::string& key) const {
+  const auto index = getIndex();
+  if (!index) {
+    const auto legacy = getLegacy();
+    return legacy && std::binary_search(legacy->keys.cbegin(), legacy->keys.cend(), key);
+  }
+  if (index->first_keys.empty()) {
+    return false;
+  }
+  const auto chunk = getChunk(index->chunk_ids[chunkOf(*index, key)]);
+  return std::binary_search(chunk.keys.cbegin(), chunk.keys.cend(), key);
+}
+
+std::vector<bool> PublicStateKeyStore::contains(const std::vector<std::string>& keys) const {
+  auto result = std::vector<bool>(keys.size(), false);
+  const auto index = getIndex();
+  if (!index) {
+    const auto legacy = getLegacy();
+    for (auto i = 0ull; legacy && i < keys.size(); ++i) {
+      result[i] = std::binary_search(legacy->keys.cbegin(), legacy->keys.cend(), keys[i]);
+    }
+    return result;
+  }
+  if (index->first_keys.empty()) {
+    return result;
+  }
+  // Look the keys up chunk by chunk
+  auto by_chunk = std::vector<std::pair<std::size_t, std::size_t>>{};
+  by_chunk.reserve(keys.size());
+  for (auto i = 0ull; i < keys.size(); ++i) {
+    by_chunk.emplace_back(chunkOf(*index, keys[i]), i);
+  }
+  std::sort(by_chunk.begin(), by_chunk.end());
+  auto chunk = std::optional<std::pair<std::size_t, PublicStateKeys>>{};
+  for (const auto& [pos, i] : by_chunk) {
+    if (!chunk || chunk->first != pos) {
+      chunk.emplace(pos, getChunk(index->chunk_ids[pos]));
+    }
+    result[i] = std::binary_search(chunk->second.keys.cbegin(), chunk->second.keys.cend(), keys[i]);
+  }
+  return result;
+}
+
+bool PublicStateKeyStore::iterate(const std::function<void(std::string&&)>& f,
+                                  const std::optional<std::string>& after_key,
+                                  const std::optional<std::string>& last_key) const {
+  const auto index = getIndex();
+  if (!index) {
+    auto legacy = getLegacy();
+    if (!legacy) {
+      return !after_key;
+    }
+    return iterateFrom(legacy->keys, f, after_key, last_key);
+  }
+  if (index->first_keys.empty()) {
+    return !after_key;
+  }
+
+  auto pos = after_key ? chunkOf(*index, *after_key) : 0;
+  auto chunk = getChunk(index->chunk_ids[pos]);
+  if (!iterateFrom(chunk.keys, f, after_key, last_key)) {
+    return false;
+  }
+  for (++pos; pos < index->chunk_ids.size() && (!last_key || index->first_keys[pos] <= *last_key); ++pos) {
+    chunk = getChunk(index->chunk_ids[pos]);
+    iterateFrom(chunk.keys, f, std::nullopt, last_key);
+  }
+  return true;
+}
+
+std::optional<PublicStateKeys> PublicStateKeyStore::getAll() const {
+  if (!exists()) {
+    return std::nullopt;
+  }
+  auto all = PublicStateKeys{};
+  all.keys.reserve(size());
+  iterate([&](std::string&& key) { all.keys.push_back(std::move(key)); });
+  return all;
+}
+
+void PublicStateKeyStore::add(std::vector<std::string> keys, VersionedUpdates& updates) const {
+  detail::sortAndRemoveDuplicates(keys);
+  if (keys.empty()) {
+    return;
+  }
+
+  auto old_index = getIndex();
+  if (!old_index) {
+    old_index = PublicStateKeysIndex{};
+    // Start from the keys persisted as a single message, if any. That message gets replaced by chunks.
+    if (const auto legacy = getLegacy()) {
+      auto merged = std::vector<std::string>{};
+      merged.reserve(legacy->keys.size() + keys.size());
+      std::set_union(
+          legacy->keys.cbegin(), legacy->keys.cend(), keys.cbegin(), keys.cend(), std::back_inserter(merged));
+      keys = std::move(merged);
+      updates.addDelete(std::string{keyTypes::state_public_key_set});
+    }
+  }
+
+  auto new_index = PublicStateKeysIndex{};
+  new_index.next_chunk_id = old_index->next_chunk_id;
+  auto changed = false;
+  const auto num_old_chunks = old_index->chunk_ids.size();
+
+  // Writes `chunk_keys` as the chunk `chunk_id`, splitting it into several chunks if it is too big.
+  const auto write = [&](std::uint64_t chunk_id, const std::vector<std::string>& chunk_keys) {
+    const auto num_pieces = (chunk_keys.size() + kMaxKeysPerChunk - 1) / kMaxKeysPerChunk;
+    auto begin = chunk_keys.cbegin();
+    for (auto i = 0ull; i < num_pieces; ++i) {
+      const auto piece_size = (chunk_keys.size() / num_pieces) + (i < chunk_keys.size() % num_pieces ? 1 : 0);
+      auto piece = PublicStateKeys{std::vector<std::string>(begin, begin + piece_size)};
+      begin += piece_size;
+      const auto id = (i == 0) ? chunk_id : new_index.next_chunk_id++;
+      new_index.first_keys.push_back(piece.keys.front());
+      new_index.chunk_ids.push_back(id);
+      new_index.chunk_sizes.push_back(piece.keys.size());
+      addUpdate(updates, chunkKey(id), detail::serialize(piece));
+    }
+    changed = true;
+  };
+
+  const auto keep = [&](std::size_t pos) {
+    new_index.first_keys.push_back(std::move(old_index->first_keys[pos]));
+    new_index.chunk_ids.push_back(old_index->chunk_ids[pos]);
+    new_index.chunk_sizes.push_back(old_index->chunk_sizes[pos]);
+  };
+
+  if (num_old_chunks == 0) {
+    write(new_index.next_chunk_id++, keys);
+  } else {
+    auto it = keys.cbegin();
+    for (auto pos = 0ull; pos < num_old_chunks; ++pos) {
+      // The new keys which fall into this chunk
+      auto end = keys.cend();
+      if (pos + 1 < num_old_chunks) {
+        end = std::lower_bound(it, keys.cend(), old_index->first_keys[pos + 1]);
+      }
+      if (it == end) {
+        keep(pos);
+        continue;
+      }
+      const auto chunk = getChunk(old_index->chunk_ids[pos]);
+      auto merged = std::vector<std::string>{};
+      merged.reserve(chunk.keys.size() + std::distance(it, end));
+      std::set_union(chunk.keys.cbegin(), chunk.keys.cend(), it, end, std::back_inserter(merged));
+      it = end;
+      if (merged.size() == chunk.keys.size()) {
+        // All of them are public already
+        keep(pos);
+        continue;
+      }
+      write(old_index->chunk_ids[pos], merged);
+    }
+  }
+  if (changed) {
+    addUpdate(updates, std::string{keyTypes::state_public_key_index}, detail::serialize(new_index));
+  }
+}
+
+}  // namespace concord::kvbc::categorization
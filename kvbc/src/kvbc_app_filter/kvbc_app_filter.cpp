@@ -15,11 +15,13 @@
 
 #include "kvbc_app_filter/kvbc_app_filter.h"
 
-#include <boost/detail/endian.hpp>
 #include <boost/lockfree/spsc_queue.hpp>
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <deque>
 #include <exception>
+#include <future>
 #include <optional>
 #include <sstream>
 #include "Logger.hpp"
@@ -28,6 +30,7 @@
 #include "kv_types.hpp"
 #include "kvbc_app_filter/kvbc_key_types.h"
 #include "openssl_crypto.hpp"
+#include "update_hash_scratch.hpp"
 
 using namespace std::chrono_literals;
 
@@ -42,12 +45,149 @@ using com::vmware::concord::kvbc::ValueWithTrids;
 using concord::kvbc::BlockId;
 using concord::kvbc::categorization::ImmutableInput;
 using concord::kvbc::InvalidBlockRange;
-using concord::util::openssl_utils::computeSHA256Hash;
-using concord::util::openssl_utils::kExpectedSHA256HashLengthInBytes;
+using concord::util::UpdateHashScratch;
 
 namespace concord {
 namespace kvbc {
 
+namespace {
+
+// Walks the tag-table entries of a tag from a given tag-specific event group id up to the newest one.
+// The entries are read in batches of growing size, so that a long catch-up costs one multi-get per batch rather than
+// one lookup per event group, while reading a single update doesn't read far ahead.
+class TagTableCursor {
+ public:
+  TagTableCursor(const KvbAppFilter &filter,
+                 const std::string &tag,
+                 uint64_t next_tag_eg_id,
+                 uint64_t newest_tag_eg_id)
+      : filter_(filter), tag_(tag), next_tag_eg_id_(next_tag_eg_id), newest_tag_eg_id_(newest_tag_eg_id) {}
+
+  // Return the entry at the cursor or std::nullopt if the cursor is past the newest entry
+  std::optional<TagTableValue> get() {
+    if (pos_ == batch_.size()) {
+      if (next_tag_eg_id_ > newest_tag_eg_id_) return std::nullopt;
+      const auto last_tag_eg_id = std::min(newest_tag_eg_id_, next_tag_eg_id_ + batch_size_ - 1);
+      batch_ = filter_.getValuesFromTagTable(tag_, next_tag_eg_id_, last_tag_eg_id);
+      next_tag_eg_id_ = last_tag_eg_id + 1;
+      pos_ = 0;
+      batch_size_ = std::min(2 * batch_size_, KvbAppFilter::kMaxTagTableReadAhead);
+    }
+    return batch_[pos_];
+  }
+
+  // Precondition: get() returned an entry
+  void next() { ++pos_; }
+
+ private:
+  const KvbAppFilter &filter_;
+  const std::string &tag_;
+  uint64_t next_tag_eg_id_;
+  const uint64_t newest_tag_eg_id_;
+  uint64_t batch_size_{KvbAppFilter::kMinTagTableReadAhead};
+  std::vector<TagTableValue> batch_;
+  size_t pos_{0};
+};
+
+// Run the given read on the pool if there is one. Otherwise, defer it until its result is requested.
+template <typename F>
+auto readAsync(concord::util::ThreadPool *pool, F &&read) {
+  if (pool) {
+    return pool->async(std::forward<F>(read));
+  }
+  return std::async(std::launch::deferred, std::forward<F>(read));
+}
+
+// Wait for the reads which are still running on the pool as they must not outlive the filter.
+// Deferred reads never run.
+template <typename T>
+void waitForRunning(std::deque<std::future<T>> &pending) {
+  for (auto &read : pending) {
+    if (read.valid() && read.wait_for(0s) != std::future_status::deferred) {
+      read.wait();
+    }
+  }
+}
+
+}  // namespace
+
+std::optional<KvbRangeHashCache::State> KvbRangeHashCache::find(Type type,
+                                                                const std::string &client_id,
+                                                                uint64_t max_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto client_states = states_.find(Key{type, client_id});
+  if (client_states == states_.end()) {
+    return std::nullopt;
+  }
+  lru_.splice(lru_.begin(), lru_, client_states->second.lru_it);
+  const auto &states = client_states->second.states;
+  auto it = states.upper_bound(max_id);
+  if (it == states.begin()) {
+    return std::nullopt;
+  }
+  --it;
+  return State{it->first, it->second.clone()};
+}
+
+void KvbRangeHashCache::save(Type type,
+                             const std::string &client_id,
+                             uint64_t id,
+                             const concord::util::SHA2_256 &hash) {
+  if (id % interval_ != 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto key = Key{type, client_id};
+  auto client_states = states_.find(key);
+  if (client_states == states_.end()) {
+    if (states_.size() == max_clients_) {
+      states_.erase(lru_.back());
+      lru_.pop_back();
+    }
+    lru_.push_front(key);
+    client_states = states_.emplace(std::move(key), ClientStates{{}, lru_.begin()}).first;
+  } else {
+    lru_.splice(lru_.begin(), lru_, client_states->second.lru_it);
+  }
+  auto &states = client_states->second.states;
+  // Older states than the ones kept would be dropped right away
+  if (states.find(id) != states.end() || (states.size() == states_per_client_ && id < states.cbegin()->first)) {
+    return;
+  }
+  states.emplace(id, hash.clone());
+  if (states.size() > states_per_client_) {
+    states.erase(states.begin());
+  }
+}
+
+size_t KvbRangeHashCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t size = 0;
+  for (const auto &[_, client_states] : states_) {
+    size += client_states.states.size();
+  }
+  return size;
+}
+
+std::optional<KvbRangeHashCache::State> KvbAppFilter::findRangeHashState(KvbRangeHashCache::Type type,
+                                                                         uint64_t start,
+                                                                         uint64_t end) const {
+  if (!range_hash_cache_ || start != KvbRangeHashCache::kFirstId) {
+    return std::nullopt;
+  }
+  return range_hash_cache_->find(type, client_id_, end);
+}
+
+void KvbAppFilter::saveRangeHashState(KvbRangeHashCache::Type type,
+                                      uint64_t start,
+                                      uint64_t id,
+                                      const concord::util::SHA2_256 &hash) const {
+  if (!range_hash_cache_ || start != KvbRangeHashCache::kFirstId) {
+    return;
+  }
+  range_hash_cache_->save(type, client_id_, id, hash);
+}
+
 uint64_t KvbAppFilter::getOldestGlobalEventGroupId() const { return getValueFromLatestTable(kGlobalEgIdKeyOldest); }
 
 uint64_t KvbAppFilter::getNewestPublicEventGroupId() const { return getValueFromLatestTable(kPublicEgIdKeyNewest); }
@@ -175,87 +315,30 @@ std::optional<KvbFilteredEventGroupUpdate> KvbAppFilter::filterEventGroupUpdate(
 }
 
 string KvbAppFilter::hashUpdate(const KvbFilteredUpdate &update) {
-  // Note we store the hashes of the keys and values in an std::map as an
-  // intermediate step in the computation of the update hash so the map can be
-  // used to deterministically order the key-value pairs' hashes before they are
-  // concatenated for the computation of the update hash. The deterministic
-  // ordering is necessary since two updates with the same set of key-value
-  // pairs in different orders are considered equivalent so their hashes need to
-  // match.
-  map<string, string> entry_hashes;
-  auto &[block_id, _, updates] = update;
-
-  for (const auto &[key, value] : updates) {
-    string key_hash = computeSHA256Hash(key.data(), key.length());
-    ConcordAssertLT(entry_hashes.count(key_hash), 1);
-    entry_hashes[key_hash] = computeSHA256Hash(value.data(), value.length());
-  }
-
-  string concatenated_entry_hashes;
-  concatenated_entry_hashes.reserve(sizeof(BlockId) + 2 * updates.size() * kExpectedSHA256HashLengthInBytes);
-
-#ifdef BOOST_LITTLE_ENDIAN
-  concatenated_entry_hashes.append(reinterpret_cast<const char *>(&(block_id)), sizeof(block_id));
-#else  // BOOST_LITTLE_ENDIAN not defined in this case
-#ifndef BOOST_BIG_ENDIAN
-  static_assert(false,
-                "Cannot determine endianness (needed for Thin Replica "
-                "mechanism hash function).");
-#endif  // BOOST_BIG_ENDIAN defined
-  const char *block_id_as_bytes = reinterpret_cast<cosnt char *>(&(block_id));
-  for (size_t i = 1; i <= sizeof(block_id); ++i) {
-    concatenated_entry_hashes.append((block_id_as_bytes + (sizeof(block_id) - i)), 1);
-  }
-#endif  // if BOOST_LITTLE_ENDIAN defined/else
-
-  for (const auto &kvp_hashes : entry_hashes) {
-    concatenated_entry_hashes.append(kvp_hashes.first);
-    concatenated_entry_hashes.append(kvp_hashes.second);
-  }
-
-  return computeSHA256Hash(concatenated_entry_hashes);
+  // Must match the update hash of the thin replica client (trc_hash.cpp), which uses the same scratch.
+  auto &s = UpdateHashScratch::get();
+  s.clear();
+  for (const auto &[key, value] : update.kv_pairs) {
+    s.add(key);
+    s.add(value);
+  }
+  auto hash = s.hashKeyValues(update.block_id);
+  ConcordAssert(hash.has_value());
+  return std::move(*hash);
 }
 
 string KvbAppFilter::hashEventGroupUpdate(const KvbFilteredEventGroupUpdate &update) {
-  // Note we store the hashes of the events in an std::set as an
-  // intermediate step in the computation of the update hash so the set can be
-  // used to deterministically order the events' hashes before they are
-  // concatenated for the computation of the update hash. The deterministic
-  // ordering is necessary since two updates with the same set of events
-  // in different orders are considered equivalent so their hashes need to
-  // match.
-  std::set<string> entry_hashes;
-  auto &[event_group_id, event_group] = update;
+  return hashEventGroupUpdate(update.event_group_id, update.event_group);
+}
 
+string KvbAppFilter::hashEventGroupUpdate(EventGroupId event_group_id,
+                                          const KvbFilteredEventGroupUpdate::EventGroup &event_group) {
+  auto &s = UpdateHashScratch::get();
+  s.clear();
   for (const auto &event : event_group.events) {
-    string event_hash = computeSHA256Hash(event.data);
-    ConcordAssertLT(entry_hashes.count(event_hash), 1);
-    entry_hashes.emplace(event_hash);
-  }
-
-  string concatenated_entry_hashes;
-  concatenated_entry_hashes.reserve(sizeof(EventGroupId) +
-                                    event_group.events.size() * kExpectedSHA256HashLengthInBytes);
-
-#ifdef BOOST_LITTLE_ENDIAN
-  concatenated_entry_hashes.append(reinterpret_cast<const char *>(&(event_group_id)), sizeof(event_group_id));
-#else  // BOOST_LITTLE_ENDIAN not defined in this case
-#ifndef BOOST_BIG_ENDIAN
-  static_assert(false,
-                "Cannot determine endianness (needed for Thin Replica "
-                "mechanism hash function).");
-#endif  // BOOST_BIG_ENDIAN defined
-  const char *event_group_id_as_bytes = reinterpret_cast<const char *>(&(event_group_id));
-  for (size_t i = 1; i <= sizeof(event_group_id); ++i) {
-    concatenated_entry_hashes.append((event_group_id_as_bytes + (sizeof(event_group_id) - i)), 1);
+    s.add(event.data);
   }
-#endif  // if BOOST_LITTLE_ENDIAN defined/else
-
-  for (const auto &event_hash : entry_hashes) {
-    concatenated_entry_hashes.append(event_hash);
-  }
-
-  return computeSHA256Hash(concatenated_entry_hashes);
+  return s.hashEvents(event_group_id);
 }
 
 void KvbAppFilter::readBlockRange(BlockId block_id_start,
@@ -266,29 +349,53 @@ void KvbAppFilter::readBlockRange(BlockId block_id_start,
     throw InvalidBlockRange(block_id_start, block_id_end);
   }
 
-  BlockId block_id(block_id_start);
-
-  LOG_DEBUG(logger_, "readBlockRange block " << block_id << " to " << block_id_end);
+  LOG_DEBUG(logger_, "readBlockRange block " << block_id_start << " to " << block_id_end);
 
-  for (; block_id <= block_id_end; ++block_id) {
-    std::string cid;
-    auto events = getBlockEvents(block_id, cid);
-    if (!events) {
-      std::stringstream msg;
-      msg << "Couldn't retrieve block events for block id " << block_id;
-      throw KvbReadError(msg.str());
-    }
-    KvbFilteredUpdate update{block_id, cid, filterKeyValuePairs(*events)};
+  readBlocks(block_id_start, block_id_end, [&](KvbFilteredUpdate &&update) {
     while (!stop_execution) {
       if (queue_out.push(update)) {
-        break;
+        return true;
       }
     }
-    if (stop_execution) {
-      LOG_WARN(logger_, "readBlockRange was stopped");
-      break;
+    LOG_WARN(logger_, "readBlockRange was stopped");
+    return false;
+  });
+}
+
+void KvbAppFilter::readBlocks(BlockId start,
+                              BlockId end,
+                              const std::function<bool(KvbFilteredUpdate &&)> &process_update) {
+  const auto read_ahead = read_pool_ ? kReadAheadSize : 1;
+  std::deque<std::future<KvbFilteredUpdate>> pending;
+  auto next_block_id = start;
+  try {
+    while (true) {
+      while (next_block_id <= end && pending.size() < read_ahead) {
+        pending.push_back(
+            readAsync(read_pool_.get(), [this, block_id = next_block_id] { return readFilteredBlock(block_id); }));
+        ++next_block_id;
+      }
+      if (pending.empty()) break;
+      auto update = pending.front().get();
+      pending.pop_front();
+      if (not process_update(std::move(update))) break;
     }
+  } catch (...) {
+    waitForRunning(pending);
+    throw;
+  }
+  waitForRunning(pending);
+}
+
+KvbFilteredUpdate KvbAppFilter::readFilteredBlock(BlockId block_id) {
+  std::string cid;
+  auto events = getBlockEvents(block_id, cid);
+  if (!events) {
+    std::stringstream msg;
+    msg << "Couldn't retrieve block events for block id " << block_id;
+    throw KvbReadError(msg.str());
   }
+  return KvbFilteredUpdate{block_id, cid, filterKeyValuePairs(*events)};
 }
 
 uint64_t KvbAppFilter::getValueFromLatestTable(const std::string &key) const {
@@ -311,6 +418,31 @@ uint64_t KvbAppFilter::getValueFromLatestTable(const std::string &key) const {
 TagTableValue KvbAppFilter::getValueFromTagTable(const std::string &tag, uint64_t pvt_eg_id) const {
   auto key = tag + kTagTableKeySeparator + concordUtils::toBigEndianStringBuffer(pvt_eg_id);
   const auto opt = rostorage_->getLatest(concord::kvbc::categorization::kExecutionEventGroupTagCategory, key);
+  return toTagTableValue(key, opt);
+}
+
+std::vector<TagTableValue> KvbAppFilter::getValuesFromTagTable(const std::string &tag,
+                                                               uint64_t first_tag_eg_id,
+                                                               uint64_t last_tag_eg_id) const {
+  ConcordAssertLE(first_tag_eg_id, last_tag_eg_id);
+  std::vector<std::string> keys;
+  keys.reserve(last_tag_eg_id - first_tag_eg_id + 1);
+  for (auto id = first_tag_eg_id; id <= last_tag_eg_id; ++id) {
+    keys.push_back(tag + kTagTableKeySeparator + concordUtils::toBigEndianStringBuffer(id));
+  }
+  std::vector<std::optional<concord::kvbc::categorization::Value>> opts;
+  rostorage_->multiGetLatest(concord::kvbc::categorization::kExecutionEventGroupTagCategory, keys, opts);
+  ConcordAssertEQ(opts.size(), keys.size());
+  std::vector<TagTableValue> values;
+  values.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    values.push_back(toTagTableValue(keys[i], opts[i]));
+  }
+  return values;
+}
+
+TagTableValue KvbAppFilter::toTagTableValue(const std::string &key,
+                                            const std::optional<concord::kvbc::categorization::Value> &opt) const {
   if (not opt) {
     std::stringstream msg;
     msg << "Failed to get event group id from tag table for key " << key;
@@ -458,78 +590,80 @@ void KvbAppFilter::readEventGroups(EventGroupId external_eg_id_start,
     throw InvalidEventGroupRange(external_eg_id_start, oldest_external_eg_id, newest_external_eg_id);
   }
 
-  auto [global_eg_id, is_previous_public, private_eg_id, public_eg_id] = findGlobalEventGroupId(external_eg_id_start);
-  uint64_t ext_eg_id = external_eg_id_start;
-
-  uint64_t next_pvt_eg_id = private_eg_id + 1;
-  uint64_t next_pub_eg_id = public_eg_id + 1;
-
-  // The next public or private event group might not exist or got pruned
-  // In this case, set to max so that the comparison will be lost later
-  uint64_t pvt_external_id;
-  uint64_t pvt_global_id;
-  try {
-    std::tie(pvt_global_id, pvt_external_id) = getValueFromTagTable(client_id_, next_pvt_eg_id);
-  } catch (const std::exception &e) {
-    pvt_global_id = std::numeric_limits<uint64_t>::max();
-  }
+  const auto start = findGlobalEventGroupId(external_eg_id_start);
 
-  uint64_t pub_global_id;
-  try {
-    std::tie(pub_global_id, std::ignore) = getValueFromTagTable(kPublicEgId, next_pub_eg_id);
-  } catch (const std::exception &e) {
-    pub_global_id = std::numeric_limits<uint64_t>::max();
-  }
+  // The entries of a tag in the tag table are the event groups visible under that tag, in order. Merging the client's
+  // entries with the public ones yields the client's event groups without visiting anybody else's.
+  TagTableCursor private_cursor{*this, client_id_, start.private_id + 1, newest_private_eg_id};
+  TagTableCursor public_cursor{*this, kPublicEgId, start.public_id + 1, newest_public_eg_id};
 
-  while (ext_eg_id <= newest_external_eg_id) {
-    // Get events and filter
-    auto event_group = getEventGroup(global_eg_id);
-    if (event_group.events.empty()) {
-      std::stringstream msg;
-      msg << "EventGroup empty/doesn't exist for global event group " << global_eg_id;
-      throw KvbReadError(msg.str());
+  // The {external, global} ids of the next event group to read, if any
+  std::optional<std::pair<uint64_t, uint64_t>> next{{external_eg_id_start, start.global_id}};
+  const auto advance = [&]() {
+    const auto ext_eg_id = next->first;
+    if (ext_eg_id == newest_external_eg_id) {
+      next.reset();
+      return;
     }
-    KvbFilteredEventGroupUpdate update{ext_eg_id, filterEventsInEventGroup(global_eg_id, event_group)};
-
-    // Process update and stop producing more updates if anything goes wrong
-    if (not process_update(std::move(update))) break;
-    if (ext_eg_id == newest_external_eg_id) break;
-
-    // Update next public or private ids; Only one needs to be udpated
-    if (is_previous_public) {
-      if (next_pub_eg_id > newest_public_eg_id) {
-        pub_global_id = std::numeric_limits<uint64_t>::max();
-      } else {
-        std::tie(pub_global_id, std::ignore) = getValueFromTagTable(kPublicEgId, next_pub_eg_id);
-      }
-    } else {
-      if (next_pvt_eg_id > newest_private_eg_id) {
-        pvt_global_id = std::numeric_limits<uint64_t>::max();
-      } else {
-        std::tie(pvt_global_id, pvt_external_id) = getValueFromTagTable(client_id_, next_pvt_eg_id);
-      }
+    const auto pvt = private_cursor.get();
+    const auto pub = public_cursor.get();
+    // No need to continue if both cursors point into the future
+    if (not pvt && not pub) {
+      next.reset();
+      return;
     }
-
-    // No need to continue if both next counters point into the future
-    if (pvt_global_id == std::numeric_limits<uint64_t>::max() && pub_global_id == std::numeric_limits<uint64_t>::max())
-      break;
-
     // The lesser global event group id is the next update for the client
-    if (pvt_global_id < pub_global_id) {
-      global_eg_id = pvt_global_id;
-      is_previous_public = false;
-      ConcordAssertEQ(ext_eg_id + 1, pvt_external_id);
-      next_pvt_eg_id++;
+    if (pvt && (not pub || pvt->first < pub->first)) {
+      ConcordAssertEQ(ext_eg_id + 1, pvt->second);
+      next.emplace(ext_eg_id + 1, pvt->first);
+      private_cursor.next();
     } else {
-      global_eg_id = pub_global_id;
-      is_previous_public = true;
-      next_pub_eg_id++;
+      next.emplace(ext_eg_id + 1, pub->first);
+      public_cursor.next();
+    }
+  };
+
+  const auto read_ahead = read_pool_ ? kReadAheadSize : 1;
+  std::deque<std::pair<uint64_t, uint64_t>> pending_ids;
+  std::deque<std::future<KvbFilteredEventGroupUpdate::EventGroup>> pending;
+  uint64_t ext_eg_id = external_eg_id_start;
+  uint64_t global_eg_id = start.global_id;
+  try {
+    while (true) {
+      while (next && pending.size() < read_ahead) {
+        pending_ids.push_back(*next);
+        pending.push_back(readAsync(read_pool_.get(), [this, global_id = next->second] {
+          return readFilteredEventGroup(global_id);
+        }));
+        advance();
+      }
+      if (pending.empty()) break;
+      std::tie(ext_eg_id, global_eg_id) = pending_ids.front();
+      KvbFilteredEventGroupUpdate update{ext_eg_id, pending.front().get()};
+      pending_ids.pop_front();
+      pending.pop_front();
+
+      // Process update and stop producing more updates if anything goes wrong
+      if (not process_update(std::move(update))) break;
     }
-    ext_eg_id += 1;
+  } catch (...) {
+    waitForRunning(pending);
+    throw;
   }
+  waitForRunning(pending);
   setLastEgIdsRead(ext_eg_id, global_eg_id);
 }
 
+KvbFilteredEventGroupUpdate::EventGroup KvbAppFilter::readFilteredEventGroup(EventGroupId global_event_group_id) {
+  auto event_group = getEventGroup(global_event_group_id);
+  if (event_group.events.empty()) {
+    std::stringstream msg;
+    msg << "EventGroup empty/doesn't exist for global event group " << global_event_group_id;
+    throw KvbReadError(msg.str());
+  }
+  return filterEventsInEventGroup(global_event_group_id, event_group);
+}
+
 void KvbAppFilter::readEventGroupRange(EventGroupId external_eg_id_start,
                                        spsc_queue<KvbFilteredEventGroupUpdate> &queue_out,
                                        const std::atomic_bool &stop_execution) {
@@ -597,32 +731,74 @@ string KvbAppFilter::readBlockRangeHash(BlockId block_id_start, BlockId block_id
 
   LOG_DEBUG(logger_, "readBlockRangeHash block " << block_id << " to " << block_id_end);
 
-  string concatenated_update_hashes;
-  concatenated_update_hashes.reserve((1 + block_id_end - block_id) * kExpectedSHA256HashLengthInBytes);
-  for (; block_id <= block_id_end; ++block_id) {
+  // The range hash is the hash over the concatenated update hashes. Instead of
+  // concatenating them, we feed them into the hash one by one which allows us
+  // to resume from a saved state.
+  concord::util::SHA2_256 range_hash;
+  auto state = findRangeHashState(KvbRangeHashCache::Type::BLOCKS, block_id_start, block_id_end);
+  if (state) {
+    // The blocks covered by the saved state are not read again. Make sure that
+    // the first one still exists (i.e. hasn't been pruned).
     std::string cid;
-    auto events = getBlockEvents(block_id, cid);
-    if (!events) {
+    if (!getBlockEvents(block_id_start, cid)) {
       std::stringstream msg;
-      msg << "Couldn't retrieve block events for block id " << block_id;
+      msg << "Couldn't retrieve block events for block id " << block_id_start;
       throw KvbReadError(msg.str());
     }
-    KvbFilteredUpdate filtered_update{block_id, cid, filterKeyValuePairs(*events)};
-    concatenated_update_hashes.append(hashUpdate(filtered_update));
-  }
-  return computeSHA256Hash(concatenated_update_hashes);
+    LOG_DEBUG(logger_, "readBlockRangeHash resuming after block " << state->id);
+    range_hash = std::move(state->hash);
+    block_id = state->id + 1;
+  } else {
+    range_hash.init();
+  }
+
+  if (block_id <= block_id_end) {
+    readBlocks(block_id, block_id_end, [&](KvbFilteredUpdate &&filtered_update) {
+      const auto update_hash = hashUpdate(filtered_update);
+      range_hash.update(update_hash.data(), update_hash.size());
+      saveRangeHashState(KvbRangeHashCache::Type::BLOCKS, block_id_start, filtered_update.block_id, range_hash);
+      return true;
+    });
+  }
+  const auto digest = range_hash.finish();
+  return string(digest.begin(), digest.end());
 }
 
 string KvbAppFilter::readEventGroupRangeHash(EventGroupId external_eg_id_start) {
   auto external_eg_id_end = newestExternalEventGroupId();
-  string concatenated_hashes;
-  concatenated_hashes.reserve((1 + external_eg_id_end - external_eg_id_start) * kExpectedSHA256HashLengthInBytes);
+  EventGroupId next_eg_id = external_eg_id_start;
+
+  // See readBlockRangeHash()
+  concord::util::SHA2_256 range_hash;
+  auto state = findRangeHashState(KvbRangeHashCache::Type::EVENT_GROUPS, external_eg_id_start, external_eg_id_end);
+  if (state) {
+    // The event groups covered by the saved state are not read again. Make sure
+    // that the first one still exists (i.e. hasn't been pruned).
+    auto oldest_external_eg_id = oldestExternalEventGroupId();
+    if (external_eg_id_start < oldest_external_eg_id) {
+      throw InvalidEventGroupRange(external_eg_id_start, oldest_external_eg_id, external_eg_id_end);
+    }
+    LOG_DEBUG(logger_, "readEventGroupRangeHash resuming after event group " << state->id);
+    range_hash = std::move(state->hash);
+    next_eg_id = state->id + 1;
+  } else {
+    range_hash.init();
+  }
+
   auto process = [&](KvbFilteredEventGroupUpdate &&update) {
-    concatenated_hashes.append(hashEventGroupUpdate(update));
+    const auto update_hash = hashEventGroupUpdate(update);
+    range_hash.update(update_hash.data(), update_hash.size());
+    saveRangeHashState(
+        KvbRangeHashCache::Type::EVENT_GROUPS, external_eg_id_start, update.event_group_id, range_hash);
     return true;
   };
-  readEventGroups(external_eg_id_start, process);
-  return computeSHA256Hash(concatenated_hashes);
+  // Reading the event groups also validates the range (e.g. that the client has any), unless a saved state already
+  // covers all of it
+  if (!state || next_eg_id <= external_eg_id_end) {
+    readEventGroups(next_eg_id, process);
+  }
+  const auto digest = range_hash.finish();
+  return string(digest.begin(), digest.end());
 }
 
 std::optional<kvbc::categorization::ImmutableInput> KvbAppFilter::getBlockEvents(kvbc::BlockId block_id,
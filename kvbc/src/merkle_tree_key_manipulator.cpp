@@ -205,6 +205,8 @@ EBFTSubtype DBKeyManipulator::getBftSubtype(const Sliver &s) {
       return EBFTSubtype::STTempBlock;
     case toChar(EBFTSubtype::PublicStateHashAtDbCheckpoint):
       return EBFTSubtype::PublicStateHashAtDbCheckpoint;
+    case toChar(EBFTSubtype::PublicStateHashShardsAtDbCheckpoint):
+      return EBFTSubtype::PublicStateHashShardsAtDbCheckpoint;
   }
   ConcordAssert(false);
 
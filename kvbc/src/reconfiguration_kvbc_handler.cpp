@@ -208,12 +208,7 @@ bool StateSnapshotReconfigurationHandler::handle(const concord::messages::StateS
       resp.data->blockchain_height = reader.getLastBlockId();
       resp.data->blockchain_height_type = messages::BlockchainHeightType::BlockId;
     }
-    const auto public_state = kvbc->getPublicStateKeys();
-    if (!public_state) {
-      resp.data->key_value_count_estimate = 0;
-    } else {
-      resp.data->key_value_count_estimate = public_state->keys.size();
-    }
+    resp.data->key_value_count_estimate = kvbc->getPublicStateKeyStore().size();
     resp.data->last_application_transaction_time = last_app_txn_time_cb_(reader);
     LOG_INFO(getLogger(),
              "StateSnapshotRequest(participant ID = " << cmd.participant_id << "): using existing last checkpoint ID: "
@@ -236,16 +231,13 @@ bool StateSnapshotReconfigurationHandler::handle(const concord::messages::StateS
       }
       // If we are creating the snapshot now, return an estimate based on the blockchain and not on the snapshot itself
       // (as it is created asynchronously).
-      const auto opt_val =
-          ro_storage_.getLatest(categorization::kConcordInternalCategoryId, keyTypes::state_public_key_set);
-      if (!opt_val) {
+      const auto public_state = categorization::PublicStateKeyStore{[this](const std::string& key) {
+        return ro_storage_.getLatest(categorization::kConcordInternalCategoryId, key);
+      }};
+      if (!public_state.exists()) {
         resp.data->key_value_count_estimate = 0;
       } else {
-        auto public_state = categorization::PublicStateKeys{};
-        const auto val = std::get_if<categorization::VersionedValue>(&opt_val.value());
-        ConcordAssertNE(val, nullptr);
-        categorization::detail::deserialize(val->data, public_state);
-        resp.data->key_value_count_estimate = public_state.keys.size();
+        resp.data->key_value_count_estimate = public_state.size();
         resp.data->last_application_transaction_time = last_app_txn_time_cb_(ro_storage_);
       }
       LOG_INFO(getLogger(),
@@ -362,13 +354,12 @@ bool StateSnapshotReconfigurationHandler::handle(const concord::messages::StateS
         auto db = NativeClient::newClient(snapshot_path, read_only, NativeClient::DefaultOptions{});
         const auto link_st_chain = false;
         const auto kvbc = KeyValueBlockchain{db, link_st_chain};
-        const auto public_state = kvbc.getPublicStateKeys();
+        const auto is_public = kvbc.getPublicStateKeyStore().contains(req.keys);
         auto values = std::vector<std::optional<categorization::Value>>{};
         kvbc.multiGetLatest(categorization::kExecutionProvableCategory, req.keys, values);
         ConcordAssertEQ(req.keys.size(), values.size());
         for (auto i = 0ull; i < req.keys.size(); ++i) {
           auto& val = values[i];
-          const auto& key = req.keys[i];
           if (!val) {
             resp.values.push_back(std::nullopt);
           } else {
@@ -376,13 +367,8 @@ bool StateSnapshotReconfigurationHandler::handle(const concord::messages::StateS
             ConcordAssertNE(merkle_val, nullptr);
             // Make sure no non-public keys are requested.
             // TODO: This will change when we start streaming non-public keys.
-            if (public_state) {
-              auto it = std::lower_bound(public_state->keys.cbegin(), public_state->keys.cend(), key);
-              if (it == public_state->keys.cend() || *it != key) {
-                resp.values.push_back(std::nullopt);
-              } else {
-                resp.values.push_back(state_value_converter_(std::move(merkle_val->data)));
-              }
+            if (is_public[i]) {
+              resp.values.push_back(state_value_converter_(std::move(merkle_val->data)));
             } else {
               resp.values.push_back(std::nullopt);
             }
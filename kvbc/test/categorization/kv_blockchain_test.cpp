@@ -891,6 +891,56 @@ TEST_F(categorized_kvbc, link_state_transfer_chain) {
   }
 }
 
+TEST_F(categorized_kvbc, link_state_transfer_chain_across_prefetch_windows) {
+  KeyValueBlockchain block_chain{
+      db,
+      true,
+      std::map<std::string, CATEGORY_TYPE>{{"merkle", CATEGORY_TYPE::block_merkle},
+                                           {kConcordInternalCategoryId, CATEGORY_TYPE::versioned_kv}}};
+  const auto raw_block = [](BlockId id) {
+    categorization::RawBlock rb;
+    BlockMerkleInput merkle_updates;
+    merkle_updates.kv["merkle_key" + std::to_string(id)] = "merkle_value" + std::to_string(id);
+    rb.data.updates.kv["merkle"] = merkle_updates;
+    return rb;
+  };
+  {
+    Updates updates;
+    BlockMerkleUpdates merkle_updates;
+    merkle_updates.addUpdate("merkle_key1", "merkle_value1");
+    updates.add("merkle", std::move(merkle_updates));
+    ASSERT_EQ(block_chain.addBlock(std::move(updates)), (BlockId)1);
+  }
+
+  // Several prefetch windows with a gap at block 200
+  const BlockId last_block_id = 300;
+  const BlockId gap_block_id = 200;
+  for (auto id = last_block_id; id > 2; --id) {
+    if (id != gap_block_id) block_chain.addRawBlock(raw_block(id), id);
+  }
+  ASSERT_EQ(block_chain.getLastReachableBlockId(), 1);
+
+  // Linking stops at the gap
+  block_chain.addRawBlock(raw_block(2), 2);
+  ASSERT_EQ(block_chain.getLastReachableBlockId(), gap_block_id - 1);
+  ASSERT_EQ(block_chain.getLastStatetransferBlockId(), last_block_id);
+
+  // and continues from there once the gap is filled
+  block_chain.addRawBlock(raw_block(gap_block_id), gap_block_id);
+  ASSERT_EQ(block_chain.getLastReachableBlockId(), last_block_id);
+  ASSERT_FALSE(block_chain.getLastStatetransferBlockId().has_value());
+
+  KeyValueBlockchain::KeyValueBlockchain_tester tester;
+  const auto& st_blockchain = tester.getStateTransferBlockchain(block_chain);
+  for (auto id = BlockId{2}; id <= last_block_id; ++id) {
+    ASSERT_FALSE(st_blockchain.getRawBlock(id).has_value());
+    const auto value = block_chain.getLatest("merkle", "merkle_key" + std::to_string(id));
+    ASSERT_TRUE(value.has_value());
+    ASSERT_EQ(std::get<MerkleValue>(*value).data, "merkle_value" + std::to_string(id));
+    ASSERT_EQ(std::get<MerkleValue>(*value).block_id, id);
+  }
+}
+
 TEST_F(categorized_kvbc, creation_of_category_type_cf) {
   KeyValueBlockchain block_chain{
       db,
@@ -2591,6 +2641,65 @@ TEST_F(categorized_kvbc, iterate_public_state_key_not_found) {
   ASSERT_TRUE(iterated_key_values.empty());
 }
 
+TEST_F(categorized_kvbc, iterate_public_state_range) {
+  const auto link_st_chain = true;
+  auto kvbc = KeyValueBlockchain{
+      db,
+      link_st_chain,
+      std::map<std::string, CATEGORY_TYPE>{{kExecutionProvableCategory, CATEGORY_TYPE::block_merkle},
+                                           {kConcordInternalCategoryId, CATEGORY_TYPE::versioned_kv}}};
+  addPublicState(kvbc);
+  auto iterated_key_values = std::vector<std::pair<std::string, std::string>>{};
+  const auto iterate = [&](std::string&& key, std::string&& value) {
+    iterated_key_values.push_back(std::make_pair(key, value));
+  };
+  ASSERT_TRUE(kvbc.iteratePublicStateKeyValues(iterate, std::nullopt, "b"));
+  ASSERT_THAT(iterated_key_values,
+              ContainerEq(std::vector<std::pair<std::string, std::string>>{{"a", "va"}, {"b", "vb"}}));
+  iterated_key_values.clear();
+  // The last key doesn't have to be a public key
+  ASSERT_TRUE(kvbc.iteratePublicStateKeyValues(iterate, std::string{"a"}, "cc"));
+  ASSERT_THAT(iterated_key_values,
+              ContainerEq(std::vector<std::pair<std::string, std::string>>{{"b", "vb"}, {"c", "vc"}}));
+  iterated_key_values.clear();
+  ASSERT_TRUE(kvbc.iteratePublicStateKeyValues(iterate, std::string{"b"}, "b"));
+  ASSERT_TRUE(iterated_key_values.empty());
+  ASSERT_FALSE(kvbc.iteratePublicStateKeyValues(iterate, std::string{"NON-EXISTENT"}, "d"));
+  ASSERT_TRUE(iterated_key_values.empty());
+}
+
+TEST_F(categorized_kvbc, compute_and_persist_hash_shards) {
+  const auto link_st_chain = true;
+  auto kvbc = KeyValueBlockchain{
+      db,
+      link_st_chain,
+      std::map<std::string, CATEGORY_TYPE>{{kExecutionProvableCategory, CATEGORY_TYPE::block_merkle},
+                                           {kConcordInternalCategoryId, CATEGORY_TYPE::versioned_kv}}};
+  addPublicState(kvbc);
+  // 4 keys in 3 shards make shards of 2 keys
+  bftEngine::ReplicaConfig::instance().numOfStateSnapshotShards = 3;
+  kvbc.computeAndPersistPublicStateHash(1);
+  bftEngine::ReplicaConfig::instance().numOfStateSnapshotShards = 64;
+  assertPublicStateHash();
+
+  const auto shards_val = db->get(KeyValueBlockchain::publicStateHashShardsKey());
+  ASSERT_TRUE(shards_val.has_value());
+  auto shards = PublicStateHashShards{};
+  detail::deserialize(*shards_val, shards);
+  ASSERT_EQ(shards.block_id, 1);
+  ASSERT_THAT(shards.last_keys, ContainerEq(std::vector<std::string>{"b", "d"}));
+  ASSERT_THAT(shards.sizes, ContainerEq(std::vector<std::uint64_t>{2, 2}));
+  ASSERT_EQ(shards.start_hashes.size(), 2);
+  ASSERT_EQ(shards.start_hashes[0], detail::hash(std::string{}));
+  // Each shard chains up to the start of the next one and the last one up to the public state hash
+  const auto h1 = KeyValueBlockchain::nextPublicStateHash(shards.start_hashes[0], "a", "va");
+  ASSERT_EQ(KeyValueBlockchain::nextPublicStateHash(h1, "b", "vb"), shards.start_hashes[1]);
+  const auto h3 = KeyValueBlockchain::nextPublicStateHash(shards.start_hashes[1], "c", "vc");
+  auto state_hash = StateHash{};
+  detail::deserialize(*db->get(KeyValueBlockchain::publicStateHashKey()), state_hash);
+  ASSERT_EQ(KeyValueBlockchain::nextPublicStateHash(h3, "d", "vd"), state_hash.hash);
+}
+
 }  // end namespace
 
 int main(int argc, char** argv) {
@@ -0,0 +1,165 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the
+// "License").  You may not use this product except in compliance with the
+// Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "gtest/gtest.h"
+#include "categorization/details.h"
+#include "categorization/public_state_keys.h"
+#include "categorization/updates.h"
+#include "kvbc_key_types.hpp"
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace concord::kvbc::categorization;
+using namespace concord::kvbc;
+using namespace ::testing;
+
+namespace {
+
+std::string key(int i) {
+  auto s = std::to_string(i);
+  return std::string(8 - s.size(), '0') + s;
+}
+
+// The latest values of the concord internal category, kept in memory
+class public_state_keys : public Test {
+ protected:
+  PublicStateKeyStore store() {
+    return PublicStateKeyStore{[this](const std::string& k) -> std::optional<Value> {
+      auto it = db.find(k);
+      if (it == db.end()) {
+        return std::nullopt;
+      }
+      return VersionedValue{{1, it->second}};
+    }};
+  }
+
+  // Applies the updates and returns the number of written values
+  std::size_t apply(VersionedUpdates&& updates) {
+    const auto& data = updates.getData();
+    for (const auto& k : data.deletes) {
+      db.erase(k);
+    }
+    for (const auto& [k, v] : data.kv) {
+      db[k] = v.data;
+    }
+    return data.kv.size();
+  }
+
+  std::size_t add(std::vector<std::string> keys) {
+    auto updates = VersionedUpdates{};
+    store().add(std::move(keys), updates);
+    return apply(std::move(updates));
+  }
+
+  std::vector<std::string> iterate(const std::optional<std::string>& after_key = std::nullopt,
+                                   const std::optional<std::string>& last_key = std::nullopt) {
+    auto keys = std::vector<std::string>{};
+    EXPECT_TRUE(store().iterate([&](std::string&& k) { keys.push_back(std::move(k)); }, after_key, last_key));
+    return keys;
+  }
+
+  std::map<std::string, std::string> db;
+};
+
+TEST_F(public_state_keys, empty) {
+  ASSERT_FALSE(store().exists());
+  ASSERT_EQ(store().size(), 0);
+  ASSERT_FALSE(store().getAll());
+  ASSERT_FALSE(store().contains("a"));
+  ASSERT_TRUE(iterate().empty());
+  ASSERT_FALSE(store().iterate([](std::string&&) { FAIL(); }, std::string{"a"}));
+}
+
+TEST_F(public_state_keys, add_and_iterate) {
+  // Index and chunk
+  ASSERT_EQ(add({"c", "a", "e", "a"}), 2);
+  ASSERT_EQ(add({"d", "b"}), 2);
+  ASSERT_EQ(add({"b"}), 0);
+  ASSERT_TRUE(store().exists());
+  ASSERT_EQ(store().size(), 5);
+  ASSERT_EQ(store().getAll()->keys, (std::vector<std::string>{"a", "b", "c", "d", "e"}));
+  ASSERT_EQ(iterate("b"), (std::vector<std::string>{"c", "d", "e"}));
+  ASSERT_TRUE(iterate("e").empty());
+  ASSERT_EQ(iterate("a", "c"), (std::vector<std::string>{"b", "c"}));
+  ASSERT_EQ(iterate(std::nullopt, "bb"), (std::vector<std::string>{"a", "b"}));
+  ASSERT_TRUE(iterate("b", "b").empty());
+  ASSERT_FALSE(store().iterate([](std::string&&) { FAIL(); }, std::string{"bb"}));
+  ASSERT_TRUE(store().contains("d"));
+  ASSERT_FALSE(store().contains("f"));
+  ASSERT_EQ(store().contains({"f", "a", "bb", "e"}), (std::vector<bool>{false, true, false, true}));
+}
+
+TEST_F(public_state_keys, chunks) {
+  const auto max = static_cast<int>(PublicStateKeyStore::kMaxKeysPerChunk);
+  auto expected = std::vector<std::string>{};
+  auto keys = std::vector<std::string>{};
+  for (int i = 0; i < 4 * max; i += 2) {
+    keys.push_back(key(i));
+  }
+  expected = keys;
+  // 2 full chunks + the index
+  ASSERT_EQ(add(keys), 3);
+  ASSERT_EQ(store().size(), 2 * max);
+
+  // A key in the middle of a full chunk splits it
+  ASSERT_EQ(add({key(1)}), 3);
+  expected.insert(expected.begin() + 1, key(1));
+  ASSERT_EQ(store().getAll()->keys, expected);
+
+  // Keys before the first one and after the last one go to the first and last chunks
+  ASSERT_EQ(add({std::string{"0"}}), 2);
+  ASSERT_EQ(add({key(4 * max)}), 3);
+  expected.insert(expected.begin(), "0");
+  expected.push_back(key(4 * max));
+  ASSERT_EQ(store().getAll()->keys, expected);
+  ASSERT_EQ(store().size(), expected.size());
+
+  // Existing keys don't rewrite their chunks
+  ASSERT_EQ(add({key(2), key(3 * max)}), 0);
+
+  // Iteration resumes in any chunk
+  for (auto i : {0, 1, max / 2, max, 2 * max - 1, static_cast<int>(expected.size()) - 1}) {
+    ASSERT_EQ(iterate(expected[i]), std::vector<std::string>(expected.begin() + i + 1, expected.end()));
+  }
+  // And stops in any chunk
+  for (auto i : {0, max / 2, max, 2 * max - 1, static_cast<int>(expected.size()) - 1}) {
+    ASSERT_EQ(iterate(std::nullopt, expected[i]), std::vector<std::string>(expected.begin(), expected.begin() + i + 1));
+  }
+  ASSERT_EQ(store().contains({key(3), key(4), "0", key(4 * max + 2)}), (std::vector<bool>{false, true, true, false}));
+}
+
+TEST_F(public_state_keys, single_message_format) {
+  const auto legacy = detail::serialize(PublicStateKeys{std::vector<std::string>{"a", "c", "e"}});
+  db[keyTypes::state_public_key_set] = std::string{legacy.cbegin(), legacy.cend()};
+  ASSERT_TRUE(store().exists());
+  ASSERT_EQ(store().size(), 3);
+  ASSERT_EQ(iterate("a"), (std::vector<std::string>{"c", "e"}));
+  ASSERT_TRUE(store().contains("c"));
+  ASSERT_FALSE(store().contains("d"));
+
+  // Converted to chunks when keys are added
+  ASSERT_EQ(add({"d", "b"}), 2);
+  ASSERT_EQ(db.count(keyTypes::state_public_key_set), 0);
+  ASSERT_EQ(store().getAll()->keys, (std::vector<std::string>{"a", "b", "c", "d", "e"}));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -43,6 +43,7 @@ using concord::kvbc::InvalidEventGroupRange;
 using concord::kvbc::KvbAppFilter;
 using concord::kvbc::KvbFilteredUpdate;
 using concord::kvbc::KvbFilteredEventGroupUpdate;
+using concord::kvbc::KvbRangeHashCache;
 using concord::kvbc::KvbUpdate;
 using concord::kvbc::NoLegacyEvents;
 using concord::util::openssl_utils::computeSHA256Hash;
@@ -90,6 +91,8 @@ class FakeStorage : public concord::kvbc::IReader {
   std::map<std::string, std::string> latest_table;
   // given trid#<event_group_id> as key, the map returns the global_event_group_id
   std::map<std::string, std::string> tag_table;
+  // number of multiGetLatest() calls on the tag table
+  mutable size_t tag_table_multi_gets_{0};
 
   std::optional<concord::kvbc::categorization::Value> get(const std::string &category_id,
                                                           const std::string &key,
@@ -143,8 +146,14 @@ class FakeStorage : public concord::kvbc::IReader {
   void multiGetLatest(const std::string &category_id,
                       const std::vector<std::string> &keys,
                       std::vector<std::optional<concord::kvbc::categorization::Value>> &values) const override {
-    ADD_FAILURE() << "multiGetLatest() should not be called by this test";
-    values = {};
+    if (category_id != concord::kvbc::categorization::kExecutionEventGroupTagCategory) {
+      ADD_FAILURE() << "multiGetLatest() should only be called for the tag table by this test";
+    }
+    ++tag_table_multi_gets_;
+    values.clear();
+    for (const auto &key : keys) {
+      values.push_back(getLatest(category_id, key));
+    }
   }
 
   std::optional<concord::kvbc::categorization::TaggedVersion> getLatestVersion(const std::string &category_id,
@@ -457,6 +466,46 @@ TEST(kvbc_filter_test, kvbfilter_hash_update_success_eg) {
   EXPECT_EQ(hash_val, computeSHA256Hash(concatenated_entry_hashes));
 }
 
+// The update hashes must not change, as the thin replica clients compare them with their own. Compare them with the
+// SHA-256 of the concatenated entry hashes, for updates of different sizes hashed one after the other on this thread.
+TEST(kvbc_filter_test, kvbfilter_hash_update_matches_concatenated_entry_hashes) {
+  FakeStorage storage;
+  auto kvb_filter = KvbAppFilter(&storage, "1");
+  const BlockId id = 0x0102030405060708;
+
+  for (size_t size : {300, 2, 64, 0, 1, 7}) {
+    KvbFilteredUpdate::OrderedKVPairs kv{};
+    KvbFilteredEventGroupUpdate::EventGroup event_group{};
+    for (size_t i = 0; i < size; ++i) {
+      // Values of varying lengths, including empty ones, and events of varying lengths
+      kv.push_back({"key" + std::to_string(i), std::string(i % 97, static_cast<char>('a' + i % 26))});
+      event_group.events.push_back(
+          convertToEvent(std::to_string(i) + std::string((i * 7) % 131, static_cast<char>(i)), {}));
+    }
+
+    std::string concatenated_entry_hashes = blockIdToByteStringLittleEndian(id);
+    std::map<std::string, std::string> kv_hashes;
+    for (const auto &[key, value] : kv) {
+      kv_hashes[computeSHA256Hash(key)] = computeSHA256Hash(value);
+    }
+    for (const auto &[key_hash, value_hash] : kv_hashes) {
+      concatenated_entry_hashes += key_hash + value_hash;
+    }
+    EXPECT_EQ(kvb_filter.hashUpdate({id, "cid", kv}), computeSHA256Hash(concatenated_entry_hashes)) << size;
+
+    concatenated_entry_hashes = blockIdToByteStringLittleEndian(id);
+    std::set<std::string> event_hashes;
+    for (const auto &event : event_group.events) {
+      event_hashes.emplace(computeSHA256Hash(event.data));
+    }
+    for (const auto &event_hash : event_hashes) {
+      concatenated_entry_hashes += event_hash;
+    }
+    EXPECT_EQ(kvb_filter.hashEventGroupUpdate({id, event_group}), computeSHA256Hash(concatenated_entry_hashes))
+        << size;
+  }
+}
+
 TEST(kvbc_filter_test, kvbfilter_success_get_blocks_in_range) {
   FakeStorage storage;
   size_t client_id = 123;
@@ -713,6 +762,77 @@ TEST(kvbc_filter_test, kvbfilter_success_hash_of_event_groups_in_range_eg) {
   EXPECT_EQ(hash_value, computeSHA256Hash(concatenated_update_hashes));
 }
 
+TEST(kvbc_filter_test, kvbfilter_cached_hash_of_blocks_in_range) {
+  FakeStorage storage;
+  storage.fillWithData(kLastBlockId);
+  const auto client_id = std::string{"1"};
+  auto cache = std::make_shared<KvbRangeHashCache>(16);
+
+  // The first request fills the cache, the following ones resume from it
+  const auto block_id_last = kLastBlockId - 1;
+  for (const BlockId block_id_end : {block_id_last, BlockId{1}, BlockId{15}, BlockId{16}, BlockId{17}, BlockId{100}}) {
+    auto kvb_filter = KvbAppFilter(&storage, client_id);
+    auto cached_kvb_filter = KvbAppFilter(&storage, client_id, cache);
+    EXPECT_EQ(cached_kvb_filter.readBlockRangeHash(1, block_id_end), kvb_filter.readBlockRangeHash(1, block_id_end));
+  }
+  // Only the newest states are kept
+  ASSERT_GT(block_id_last / 16, KvbRangeHashCache::kDefaultStatesPerClient);
+  EXPECT_EQ(cache->size(), KvbRangeHashCache::kDefaultStatesPerClient);
+
+  // Other clients don't share the saved states
+  auto kvb_filter = KvbAppFilter(&storage, "2");
+  auto cached_kvb_filter = KvbAppFilter(&storage, "2", cache);
+  EXPECT_EQ(cached_kvb_filter.readBlockRangeHash(1, 50), kvb_filter.readBlockRangeHash(1, 50));
+  EXPECT_EQ(cache->size(), KvbRangeHashCache::kDefaultStatesPerClient + 50 / 16);
+}
+
+TEST(kvbc_filter_test, kvbfilter_cached_hash_of_event_groups_in_range_eg) {
+  FakeStorage storage;
+  std::string client_id("trid_1");
+  storage.fillWithEventGroupData(55, client_id);
+  auto cache = std::make_shared<KvbRangeHashCache>(8, 8);
+
+  for (int i = 0; i < 2; ++i) {
+    auto kvb_filter = KvbAppFilter(&storage, client_id);
+    auto cached_kvb_filter = KvbAppFilter(&storage, client_id, cache);
+    EXPECT_EQ(cached_kvb_filter.readEventGroupRangeHash(1), kvb_filter.readEventGroupRangeHash(1));
+  }
+  EXPECT_EQ(cache->size(), 55 / 8);
+
+  // New event groups are hashed on top of the saved states
+  storage.fillWithEventGroupData(10, client_id);
+  auto kvb_filter = KvbAppFilter(&storage, client_id);
+  auto cached_kvb_filter = KvbAppFilter(&storage, client_id, cache);
+  EXPECT_EQ(cached_kvb_filter.readEventGroupRangeHash(1), kvb_filter.readEventGroupRangeHash(1));
+  EXPECT_EQ(cache->size(), 65 / 8);
+}
+
+TEST(kvbc_filter_test, kvbfilter_range_hash_cache_bounds) {
+  using Type = KvbRangeHashCache::Type;
+  auto cache = KvbRangeHashCache(1, 2, 2);
+  auto hash = concord::util::SHA2_256{};
+  hash.init();
+
+  // Only the newest states of a client are kept
+  for (uint64_t id = 1; id <= 5; ++id) {
+    cache.save(Type::BLOCKS, "a", id, hash);
+  }
+  cache.save(Type::BLOCKS, "a", 1, hash);
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.find(Type::BLOCKS, "a", 100)->id, 5);
+  EXPECT_EQ(cache.find(Type::BLOCKS, "a", 4)->id, 4);
+  EXPECT_FALSE(cache.find(Type::BLOCKS, "a", 3).has_value());
+
+  // The client used least recently is dropped, the types of range hashes are cached apart
+  cache.save(Type::EVENT_GROUPS, "a", 1, hash);
+  EXPECT_TRUE(cache.find(Type::BLOCKS, "a", 100).has_value());
+  cache.save(Type::BLOCKS, "b", 1, hash);
+  EXPECT_EQ(cache.size(), 3);
+  EXPECT_FALSE(cache.find(Type::EVENT_GROUPS, "a", 100).has_value());
+  EXPECT_TRUE(cache.find(Type::BLOCKS, "a", 100).has_value());
+  EXPECT_TRUE(cache.find(Type::BLOCKS, "b", 100).has_value());
+}
+
 TEST(kvbc_filter_test, read_eg_range_external_id_mixed) {
   FakeStorage storage;
   storage.fillWithEventGroupData(1, "A");
@@ -787,6 +907,105 @@ TEST(kvbc_filter_test, read_eg_range_external_id_mixed) {
   ASSERT_EQ(expected_eg_id, 10);
 }
 
+TEST(kvbc_filter_test, read_eg_range_sparse_client) {
+  FakeStorage storage;
+  storage.fillWithEventGroupData(2, "A");
+  storage.fillWithEventGroupData(500, "B");
+  storage.fillWithEventGroupData(1, kPublicEgIdKey);
+  storage.fillWithEventGroupData(500, "B");
+  storage.fillWithEventGroupData(300, "A");
+
+  auto filter_a = KvbAppFilter(&storage, "A");
+  std::vector<KvbFilteredEventGroupUpdate> updates;
+  filter_a.readEventGroups(1, [&updates](KvbFilteredEventGroupUpdate &&update) {
+    updates.push_back(std::move(update));
+    return true;
+  });
+  ASSERT_EQ(updates.size(), 303);
+  for (uint64_t i = 0; i < updates.size(); ++i) {
+    ASSERT_EQ(updates[i].event_group_id, i + 1);
+  }
+  // The public event group comes after A's first two
+  ASSERT_EQ(updates[1].event_group.events[0].data, "A_val2");
+  ASSERT_TRUE(updates[2].event_group.events.empty());
+  ASSERT_EQ(updates[3].event_group.events[0].data, "A_val1004");
+  ASSERT_EQ(filter_a.getLastEgIdsRead(), std::make_pair(uint64_t{303}, uint64_t{1303}));
+
+  // The tag table is read in growing batches rather than once per event group
+  ASSERT_LE(storage.tag_table_multi_gets_, 8u);
+
+  // Reading a single update doesn't read ahead
+  storage.tag_table_multi_gets_ = 0;
+  filter_a.readEventGroups(303, [](KvbFilteredEventGroupUpdate &&) { return true; });
+  ASSERT_EQ(storage.tag_table_multi_gets_, 0);
+}
+
+TEST(kvbc_filter_test, read_ahead_on_read_pool) {
+  auto read_pool = std::make_shared<concord::util::ThreadPool>(4);
+
+  // Blocks
+  FakeStorage block_storage;
+  block_storage.fillWithData(kLastBlockId);
+  const auto read_blocks = [&](KvbAppFilter &filter) {
+    spsc_queue<KvbFilteredUpdate> queue_out{kLastBlockId};
+    std::atomic_bool stop_exec = false;
+    filter.readBlockRange(0, kLastBlockId - 1, queue_out, stop_exec);
+    std::vector<KvbFilteredUpdate> updates;
+    KvbFilteredUpdate update;
+    while (queue_out.pop(update)) {
+      updates.push_back(update);
+    }
+    return updates;
+  };
+  auto block_filter = KvbAppFilter(&block_storage, "12");
+  auto pooled_block_filter = KvbAppFilter(&block_storage, "12", nullptr, read_pool);
+  const auto blocks = read_blocks(block_filter);
+  const auto pooled_blocks = read_blocks(pooled_block_filter);
+  ASSERT_EQ(pooled_blocks.size(), kLastBlockId);
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    ASSERT_EQ(pooled_blocks[i].block_id, i);
+    ASSERT_EQ(pooled_blocks[i].correlation_id, blocks[i].correlation_id);
+    ASSERT_EQ(pooled_blocks[i].kv_pairs, blocks[i].kv_pairs);
+  }
+  ASSERT_EQ(pooled_blocks[12].kv_pairs.size(), 1);
+  ASSERT_EQ(pooled_block_filter.readBlockRangeHash(0, kLastBlockId - 1),
+            block_filter.readBlockRangeHash(0, kLastBlockId - 1));
+
+  // Event groups
+  FakeStorage eg_storage;
+  eg_storage.fillWithEventGroupData(100, "A");
+  eg_storage.fillWithEventGroupData(50, kPublicEgIdKey);
+  eg_storage.fillWithEventGroupData(100, "B");
+  eg_storage.fillWithEventGroupData(50, "A");
+  const auto read_event_groups = [](KvbAppFilter &filter, size_t max_updates) {
+    std::vector<KvbFilteredEventGroupUpdate> updates;
+    filter.readEventGroups(1, [&](KvbFilteredEventGroupUpdate &&update) {
+      if (updates.size() == max_updates) return false;
+      updates.push_back(std::move(update));
+      return true;
+    });
+    return updates;
+  };
+  auto eg_filter = KvbAppFilter(&eg_storage, "A");
+  auto pooled_eg_filter = KvbAppFilter(&eg_storage, "A", nullptr, read_pool);
+  const auto event_groups = read_event_groups(eg_filter, 200);
+  const auto pooled_event_groups = read_event_groups(pooled_eg_filter, 200);
+  ASSERT_EQ(pooled_event_groups.size(), 200);
+  for (size_t i = 0; i < event_groups.size(); ++i) {
+    ASSERT_EQ(pooled_event_groups[i].event_group_id, i + 1);
+    ASSERT_EQ(pooled_event_groups[i].event_group.events.size(), event_groups[i].event_group.events.size());
+    for (size_t j = 0; j < event_groups[i].event_group.events.size(); ++j) {
+      ASSERT_EQ(pooled_event_groups[i].event_group.events[j].data, event_groups[i].event_group.events[j].data);
+    }
+  }
+  ASSERT_EQ(pooled_eg_filter.getLastEgIdsRead(), eg_filter.getLastEgIdsRead());
+  ASSERT_EQ(pooled_eg_filter.readEventGroupRangeHash(1), eg_filter.readEventGroupRangeHash(1));
+
+  // Stopping in the middle of the read-ahead
+  ASSERT_EQ(read_event_groups(pooled_eg_filter, 10).size(), 10);
+  ASSERT_EQ(pooled_eg_filter.getLastEgIdsRead(), std::make_pair(uint64_t{11}, uint64_t{11}));
+}
+
 TEST(kvbc_filter_test, kvbfilter_success_hash_of_block) {
   FakeStorage storage;
   int client_id = 1;
@@ -858,6 +1077,18 @@ TEST(kvbc_filter_test, kvbfilter_hash_filter_event_group_out_of_range) {
   EXPECT_THROW(kvb_filter.readEventGroupRangeHash(eg_id_start);, InvalidEventGroupRange);
 }
 
+TEST(kvbc_filter_test, kvbfilter_hash_filter_no_event_groups) {
+  FakeStorage storage;
+  auto kvb_filter = KvbAppFilter(&storage, "trid_1");
+  EXPECT_THROW(kvb_filter.readEventGroupRangeHash(1);, std::runtime_error);
+
+  // Event groups of other clients don't count
+  storage.fillWithEventGroupData(10, "trid_2");
+  auto cache = std::make_shared<KvbRangeHashCache>();
+  auto cached_kvb_filter = KvbAppFilter(&storage, "trid_1", cache);
+  EXPECT_THROW(cached_kvb_filter.readEventGroupRangeHash(1);, std::runtime_error);
+}
+
 TEST(kvbc_filter_test, kvbfilter_update_empty_kv_pair) {
   FakeStorage storage;
   int client_id = 1;
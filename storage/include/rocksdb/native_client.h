@@ -135,6 +135,16 @@ class NativeClient : public std::enable_shared_from_this<NativeClient> {
   // match the families input.
   std::vector<NativeIterator> getIterators(const std::vector<std::string> &cFamilies) const;
 
+  // Snapshot interface.
+  //
+  // Pins a consistent view of the database. While the returned object is alive, all reads the calling thread does
+  // through this client (get, getSlice, multiGet and iterators created in that time) see that view, irrespective of
+  // concurrent writes. Other threads are not affected. Snapshots can be nested, in which case the innermost one is
+  // used. The returned object must be destroyed by the thread that created it, after the iterators created during its
+  // lifetime and before this client.
+  class ScopedSnapshot;
+  ScopedSnapshot scopedSnapshot() const;
+
   ::rocksdb::Options options() const;
 
   // Return the DB path.
@@ -186,12 +196,41 @@ class NativeClient : public std::enable_shared_from_this<NativeClient> {
   Client::CfUniquePtr createColumnFamilyHandle(const std::string &cFamily,
                                                const ::rocksdb::ColumnFamilyOptions &options);
 
+  // The read options of the calling thread, which include its snapshot, if any.
+  ::rocksdb::ReadOptions readOptions() const;
+
+  // The snapshot pinned by the calling thread and the DB it belongs to.
+  struct ThreadSnapshot {
+    const ::rocksdb::DB *db{nullptr};
+    const ::rocksdb::Snapshot *snapshot{nullptr};
+  };
+  static ThreadSnapshot &threadSnapshot();
+
  private:
   std::shared_ptr<Client> client_;
   static const bool applyOptimizationsOnDefaultOpts_ = false;
   friend class NativeWriteBatch;
 };
 
+class NativeClient::ScopedSnapshot {
+ public:
+  ~ScopedSnapshot();
+
+  ScopedSnapshot(const ScopedSnapshot &) = delete;
+  ScopedSnapshot(ScopedSnapshot &&) = delete;
+  ScopedSnapshot &operator=(const ScopedSnapshot &) = delete;
+  ScopedSnapshot &operator=(ScopedSnapshot &&) = delete;
+
+ private:
+  explicit ScopedSnapshot(::rocksdb::DB &db);
+
+ private:
+  ::rocksdb::DB &db_;
+  const ::rocksdb::Snapshot *const snapshot_;
+  const ThreadSnapshot previous_;
+  friend class NativeClient;
+};
+
 }  // namespace concord::storage::rocksdb
 
 #include "native_write_batch.ipp"
@@ -91,7 +91,7 @@ template <typename KeySpan>
 std::optional<std::string> NativeClient::get(const std::string &cFamily, const KeySpan &key) const {
   auto value = std::string{};
   auto s =
-      client_->dbInstance_->Get(::rocksdb::ReadOptions{}, columnFamilyHandle(cFamily), detail::toSlice(key), &value);
+      client_->dbInstance_->Get(readOptions(), columnFamilyHandle(cFamily), detail::toSlice(key), &value);
   if (s.IsNotFound()) {
     return std::nullopt;
   }
@@ -103,7 +103,7 @@ template <typename KeySpan>
 std::optional<::rocksdb::PinnableSlice> NativeClient::getSlice(const std::string &cFamily, const KeySpan &key) const {
   auto slice = ::rocksdb::PinnableSlice{};
   auto s =
-      client_->dbInstance_->Get(::rocksdb::ReadOptions{}, columnFamilyHandle(cFamily), detail::toSlice(key), &slice);
+      client_->dbInstance_->Get(readOptions(), columnFamilyHandle(cFamily), detail::toSlice(key), &slice);
   if (s.IsNotFound()) {
     return std::nullopt;
   }
@@ -155,7 +155,7 @@ void NativeClient::multiGet(const std::string &cFamily,
   for (const auto &k : keys) {
     key_slices.emplace_back(detail::toSlice(k));
   }
-  client_->dbInstance_->MultiGet(::rocksdb::ReadOptions{},
+  client_->dbInstance_->MultiGet(readOptions(),
                                  columnFamilyHandle(cFamily),
                                  key_slices.size(),
                                  key_slices.data(),
@@ -166,12 +166,12 @@ void NativeClient::multiGet(const std::string &cFamily,
 inline NativeWriteBatch NativeClient::getBatch() const { return NativeWriteBatch{shared_from_this()}; }
 
 inline NativeIterator NativeClient::getIterator() const {
-  return std::unique_ptr<::rocksdb::Iterator>{client_->dbInstance_->NewIterator(::rocksdb::ReadOptions{})};
+  return std::unique_ptr<::rocksdb::Iterator>{client_->dbInstance_->NewIterator(readOptions())};
 }
 
 inline NativeIterator NativeClient::getIterator(const std::string &cFamily) const {
   return std::unique_ptr<::rocksdb::Iterator>{
-      client_->dbInstance_->NewIterator(::rocksdb::ReadOptions{}, columnFamilyHandle(cFamily))};
+      client_->dbInstance_->NewIterator(readOptions(), columnFamilyHandle(cFamily))};
 }
 
 inline std::vector<NativeIterator> NativeClient::getIterators(const std::vector<std::string> &cFamilies) const {
@@ -181,7 +181,7 @@ inline std::vector<NativeIterator> NativeClient::getIterators(const std::vector<
   }
 
   auto rawPtrIterators = std::vector<::rocksdb::Iterator *>{};
-  auto status = client_->dbInstance_->NewIterators(::rocksdb::ReadOptions{}, cfHandles, &rawPtrIterators);
+  auto status = client_->dbInstance_->NewIterators(readOptions(), cfHandles, &rawPtrIterators);
 
   // Wrap RocksDB iterators in unique pointers so that they are freed, irrespective of the returned status.
   // Note: NewIterators()'s interface is bad and the caller doesn't have enough info by just looking at it. One has to
@@ -195,6 +195,34 @@ inline std::vector<NativeIterator> NativeClient::getIterators(const std::vector<
   return ret;
 }
 
+inline NativeClient::ScopedSnapshot NativeClient::scopedSnapshot() const {
+  return ScopedSnapshot{*client_->dbInstance_};
+}
+
+inline NativeClient::ThreadSnapshot &NativeClient::threadSnapshot() {
+  static thread_local ThreadSnapshot snapshot;
+  return snapshot;
+}
+
+inline ::rocksdb::ReadOptions NativeClient::readOptions() const {
+  auto opts = ::rocksdb::ReadOptions{};
+  const auto &current = threadSnapshot();
+  if (current.db == client_->dbInstance_.get()) {
+    opts.snapshot = current.snapshot;
+  }
+  return opts;
+}
+
+inline NativeClient::ScopedSnapshot::ScopedSnapshot(::rocksdb::DB &db)
+    : db_{db}, snapshot_{db.GetSnapshot()}, previous_{threadSnapshot()} {
+  threadSnapshot() = ThreadSnapshot{&db_, snapshot_};
+}
+
+inline NativeClient::ScopedSnapshot::~ScopedSnapshot() {
+  threadSnapshot() = previous_;
+  db_.ReleaseSnapshot(snapshot_);
+}
+
 inline void NativeClient::write(NativeWriteBatch &&b) {
   auto s = client_->dbInstance_->Write(::rocksdb::WriteOptions{}, &b.batch_);
   detail::throwOnError("write(batch) failed"sv, std::move(s));
@@ -15,8 +15,12 @@
 
 #include <libs3.h>
 #include <cstring>
+#include <deque>
+#include <future>
 #include <mutex>
+#include <optional>
 #include <thread>
+#include <unordered_map>
 #include <mutex>
 #include <functional>
 #include "Logger.hpp"
@@ -24,6 +28,7 @@
 #include "assertUtils.hpp"
 #include "storage/db_interface.h"
 #include "s3_metrics.hpp"
+#include "segment.hpp"
 #include "thread_pool.hpp"
 
 #pragma once
@@ -41,6 +46,16 @@ struct StoreConfig {
   std::string pathPrefix;          // optional path prefix used in the bucket
   std::uint32_t operationTimeout;  // max timeout for an operation in milliseconds
 
+  // Archival tuning, see Client. All of it is disabled by default.
+  std::uint32_t maxTransactionsInFlight = 0;  // committed transactions which may still be uploading
+  std::uint32_t packValuesBelowBytes = 0;     // values shorter than this are packed into segment objects
+  std::uint64_t multipartThresholdBytes = 0;  // values at least this long are uploaded in parts
+  std::uint64_t multipartPartSizeBytes = 8 * 1024 * 1024;
+
+  bool archivalEnabled() const {
+    return maxTransactionsInFlight > 0 || packValuesBelowBytes > 0 || multipartThresholdBytes > 0;
+  }
+
   std::string toURL() const {
     std::ostringstream oss;
     oss << protocol << "://" << url << "/" << bucketName;
@@ -49,15 +64,39 @@ struct StoreConfig {
   friend std::ostream& operator<<(std::ostream&, const StoreConfig&);
 };
 
-/** @brief IDBClient implementation for S3 compatible object store using libs3. */
+/**
+ * @brief IDBClient implementation for S3 compatible object store using libs3.
+ *
+ * A transaction uploads each of its keys as an object, concurrently. Its commit returns once all of them are stored,
+ * unless archival tuning is enabled in StoreConfig:
+ * - maxTransactionsInFlight: commit returns as soon as the uploads are started, and up to that many committed
+ *   transactions keep uploading in the background. Transactions complete in commit order. A failure is reported by
+ *   the commit that completes the failed transaction, and by every later commit and flush(). Reads see the writes
+ *   of the transactions still in flight. A transaction writing an object which an earlier one in flight also writes
+ *   waits for the earlier one, so that the object store ends up with the later value.
+ * - packValuesBelowBytes: the small values of a transaction are packed into a single segment object (see
+ *   segment.hpp) and read back with ranged reads. The index of the packed keys is kept in memory and is rebuilt from
+ *   the segments by init(). A segment is deleted once all of its keys are overwritten or deleted, unless it holds
+ *   tombstones.
+ * - multipartThresholdBytes: large values are split into parts of multipartPartSizeBytes, which are uploaded
+ *   concurrently as objects of their own, followed by a manifest object under the key.
+ */
 class Client : public concord::storage::IDBClient {
  protected:
+  /** Object metadata used by the client. multipartParts is the number of parts of a multipart value, as found on
+   * its manifest object; 0 for other objects. */
+  struct ObjectMetadata {
+    std::uint32_t multipartParts = 0;
+  };
+
   /** Base class for response callback data */
   struct ResponseData {
     S3Status status = S3Status::S3StatusOK;
     std::string errorMessage;
+    ObjectMetadata* metadata = nullptr;  // filled from the response properties if set
   };
 
+  friend S3Status propertiesCallback(const S3ResponseProperties* properties, void* callbackData);
   friend void responseCompleteCallback(S3Status status, const S3ErrorDetails* error, void* callbackData);
 
  public:
@@ -68,6 +107,7 @@ class Client : public concord::storage::IDBClient {
     void commit() override;
     void rollback() override { multiput_.clear(); }
     void put(const concordUtils::Sliver& key, const concordUtils::Sliver& value) override {
+      keys_to_delete_.erase(key);
       multiput_[key.clone()] = value.clone();
     }
     std::string get(const concordUtils::Sliver& key) override { return multiput_[key].toString(); }
@@ -214,6 +254,7 @@ class Client : public concord::storage::IDBClient {
   Client(const StoreConfig& config) : config_{config} { LOG_INFO(logger_, "S3 client created"); }
 
   ~Client() {
+    if (init_) flushOnDestruction();
     /* Destroy LibS3 */
     S3_deinitialize();
     init_ = false;
@@ -222,10 +263,7 @@ class Client : public concord::storage::IDBClient {
 
   void init(bool readOnly) override;
 
-  concordUtils::Status get(const concordUtils::Sliver& key, concordUtils::Sliver& outValue) const override {
-    LOG_DEBUG(logger_, key.toString());
-    return do_with_retry("get_internal", std::bind(&Client::get_internal, this, _1, _2), key, outValue);
-  }
+  concordUtils::Status get(const concordUtils::Sliver& key, concordUtils::Sliver& outValue) const override;
 
   concordUtils::Status get(const concordUtils::Sliver& _key,
                            char*& buf,
@@ -241,7 +279,8 @@ class Client : public concord::storage::IDBClient {
 
   concordUtils::Status put(const concordUtils::Sliver& key, const concordUtils::Sliver& value) override {
     LOG_DEBUG(logger_, key.toString());
-    return do_with_retry("put_internal", std::bind(&Client::put_internal, this, _1, _2), key, value);
+    if (config_.archivalEnabled()) return commitSingle({{key, value}}, {});
+    return putObject(key, value);
   }
 
   concordUtils::Status create_bucket() {
@@ -253,17 +292,17 @@ class Client : public concord::storage::IDBClient {
     return do_with_retry("test_bucket_internal", std::bind(&Client::test_bucket_internal, this));
   }
 
-  concordUtils::Status has(const concordUtils::Sliver& key) const override {
-    using namespace std::placeholders;
-    std::function<ResponseData(const concordUtils::Sliver&)> f = std::bind(&Client::object_exists_internal, this, _1);
-    return do_with_retry("object_exists_internal", f, key);
-  }
+  concordUtils::Status has(const concordUtils::Sliver& key) const override;
 
   concordUtils::Status del(const concordUtils::Sliver& key) override {
     LOG_DEBUG(logger_, key.toString());
-    return do_with_retry("delete_internal", std::bind(&Client::delete_internal, this, _1), key);
+    if (config_.archivalEnabled()) return commitSingle({}, {key});
+    return deleteObject(key);
   }
 
+  // Waits for all committed transactions. Throws if any of them failed.
+  void flush();
+
   concordUtils::Status multiGet(const KeysVector& _keysVec, ValuesVector& _valuesVec) override {
     ConcordAssert(_keysVec.size() == _valuesVec.size());
     for (KeysVector::size_type i = 0; i < _keysVec.size(); ++i)
@@ -377,13 +416,89 @@ class Client : public concord::storage::IDBClient {
     size_t putCount = 0;
   };
 
-  GetObjectResponseData get_internal(const concordUtils::Sliver& _key, concordUtils::Sliver& _outValue) const;
-  PutObjectResponseData put_internal(const concordUtils::Sliver& _key, const concordUtils::Sliver& _value);
-  ResponseData object_exists_internal(const concordUtils::Sliver& key) const;
+  /** Reads byteCount bytes of the object from startByte; the whole object if byteCount is 0. */
+  GetObjectResponseData get_internal(const concordUtils::Sliver& _key,
+                                     concordUtils::Sliver& _outValue,
+                                     std::uint64_t startByte = 0,
+                                     std::uint64_t byteCount = 0,
+                                     ObjectMetadata* metadata = nullptr) const;
+  PutObjectResponseData put_internal(const concordUtils::Sliver& _key,
+                                     const concordUtils::Sliver& _value,
+                                     const ObjectMetadata* metadata = nullptr);
+  ResponseData object_exists_internal(const concordUtils::Sliver& key, ObjectMetadata* metadata = nullptr) const;
   ResponseData delete_internal(const concordUtils::Sliver& key);
   ResponseData create_bucket_internal();
   ResponseData test_bucket_internal();
 
+  /** Object operations, with retries. getObject() and deleteObject() handle multipart values. */
+  Status getObject(const concordUtils::Sliver& key, concordUtils::Sliver& outValue) const;
+  Status putObject(const concordUtils::Sliver& key,
+                   const concordUtils::Sliver& value,
+                   const ObjectMetadata* metadata = nullptr);
+  Status deleteObject(const concordUtils::Sliver& key);
+  Status getMultipart(const concordUtils::Sliver& key,
+                      std::uint32_t parts,
+                      const concordUtils::Sliver& manifest,
+                      concordUtils::Sliver& outValue) const;
+  static concordUtils::Sliver partKey(const concordUtils::Sliver& key, std::uint64_t part);
+
+  /////////////////////////// archival ////////////////////////////
+  // Transactions are numbered in commit order
+  using CommitSeq = std::uint64_t;
+
+  struct PackedLocation {
+    std::shared_ptr<const std::string> segment;
+    std::uint64_t offset = 0;
+    std::uint32_t length = 0;
+  };
+  struct SegmentInfo {
+    std::size_t liveEntries = 0;
+    bool hasTombstones = false;
+  };
+  // The latest write of a key by a transaction in flight
+  struct PendingWrite {
+    CommitSeq seq = 0;
+    std::optional<concordUtils::Sliver> value;  // not set if deleted
+    bool packed = false;
+    // The latest transaction in flight which writes or deletes the object of the key, 0 if none
+    CommitSeq lastObjectWrite = 0;
+  };
+  struct Manifest {
+    concordUtils::Sliver key;
+    concordUtils::Sliver body;
+    ObjectMetadata metadata;
+  };
+  struct InFlightTransaction {
+    CommitSeq seq = 0;
+    std::string idStr;
+    std::vector<std::future<concordUtils::Status>> writes;
+    // Written once all parts of the multipart values are
+    std::vector<Manifest> manifests;
+    // The segment of the packed values and tombstones, if any
+    std::shared_ptr<const std::string> segment;
+    std::vector<segment::Entry> segmentEntries;
+    std::vector<std::string> keys;
+  };
+
+  void commitTransaction(SetOfKeyValuePairs&& puts,
+                         std::set<concordUtils::Sliver>&& dels,
+                         const std::string& idStr);
+  Status commitSingle(SetOfKeyValuePairs&& puts, std::set<concordUtils::Sliver>&& dels);
+  // Waits for the oldest transaction in flight and applies it to the index. Requires commitLock_.
+  void completeOldest();
+  // Requires stateLock_
+  bool isPacked(const std::string& key) const;
+  void markPending(const std::string& key, CommitSeq seq, std::optional<concordUtils::Sliver> value, bool packed);
+  void applySegment(const std::shared_ptr<const std::string>& segment,
+                    const std::vector<segment::Entry>& entries,
+                    std::vector<std::string>& garbage);
+  void releaseLocation(const PackedLocation& location, std::vector<std::string>& garbage);
+  void collectGarbage(const std::vector<std::string>& garbage);
+  std::string nextSegmentName();
+  void loadSegments();
+  void throwOnArchivalError() const;
+  void flushOnDestruction();
+
   StoreConfig config_;
   S3BucketContext context_;
   bool init_ = false;
@@ -392,7 +507,24 @@ class Client : public concord::storage::IDBClient {
   logging::Logger logger_ = logging::getLogger("concord.storage.s3");
   uint16_t initialDelay_ = 100;
   Metrics metrics_;
-  util::ThreadPool thread_pool_{std::thread::hardware_concurrency()};
+  bool readOnly_ = false;
+
+  // Serializes commits and the completion of transactions
+  std::mutex commitLock_;
+  std::deque<InFlightTransaction> inFlight_;
+  CommitSeq lastCommitSeq_ = 0;
+  std::string archivalError_;
+  std::string segmentsPrefix_;
+  std::string segmentNamePrefix_;
+  std::uint64_t nextSegment_ = 0;
+
+  // Guards the state read by get() and has()
+  mutable std::mutex stateLock_;
+  std::unordered_map<std::string, PendingWrite> pending_;
+  std::unordered_map<std::string, PackedLocation> index_;
+  std::unordered_map<std::string, SegmentInfo> segments_;
+
+  mutable util::ThreadPool thread_pool_{std::thread::hardware_concurrency()};
 };
 
 }  // namespace concord::storage::s3
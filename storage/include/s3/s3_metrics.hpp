@@ -13,6 +13,9 @@ class Metrics {
         bytes_transferred{
             metrics_component.RegisterCounter("bytes_transferred"),
         },
+        packed_keys_transferred{metrics_component.RegisterCounter("packed_keys_transferred")},
+        multipart_parts_transferred{metrics_component.RegisterCounter("multipart_parts_transferred")},
+        transactions_in_flight{metrics_component.RegisterGauge("transactions_in_flight", 0)},
         last_saved_block_id_{
             metrics_component.RegisterGauge("last_saved_block_id", 0),
         }
@@ -61,6 +64,10 @@ class Metrics {
 
   concordMetrics::CounterHandle num_keys_transferred;
   concordMetrics::CounterHandle bytes_transferred;
+  // Keys packed into segment objects, and parts of multipart values
+  concordMetrics::CounterHandle packed_keys_transferred;
+  concordMetrics::CounterHandle multipart_parts_transferred;
+  concordMetrics::GaugeHandle transactions_in_flight;
 
  private:
   // This function "guesses" if metadata or block is being updated.
@@ -0,0 +1,119 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the
+// "License").  You may not use this product except in compliance with the
+// Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#pragma once
+
+#include "endianness.hpp"
+#include "sliver.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// A segment is an object packing the small values written by one transaction, so that they don't cost an object each.
+//
+// It starts with a compact index of its entries, followed by their values:
+//   u32 number of entries
+//   per entry: u8 type, u32 key length, u32 value length, key
+//   the values of the entries, in index order
+// Integers are big endian. A tombstone entry has no value; it marks its key as deleted (or written as a regular
+// object) by the transaction of the segment. Segments are named so that their names sort in commit order, and a later
+// entry of a key overrides an earlier one.
+namespace concord::storage::s3::segment {
+
+enum class EntryType : std::uint8_t { VALUE = 0, TOMBSTONE = 1 };
+
+struct Entry {
+  EntryType type;
+  std::string key;
+  // The position of the value within the segment object
+  std::uint64_t valueOffset = 0;
+  std::uint32_t valueLength = 0;
+};
+
+class Builder {
+ public:
+  void add(const concordUtils::Sliver& key, const concordUtils::Sliver& value) {
+    entries_.push_back(Entry{EntryType::VALUE, key.toString(), 0, static_cast<std::uint32_t>(value.length())});
+    values_.push_back(value);
+  }
+  void addTombstone(const concordUtils::Sliver& key) {
+    entries_.push_back(Entry{EntryType::TOMBSTONE, key.toString()});
+  }
+
+  bool empty() const { return entries_.empty(); }
+
+  // Serializes the segment and sets the value offsets of the entries.
+  std::string build() {
+    std::uint64_t indexSize = sizeof(std::uint32_t);
+    std::uint64_t valuesSize = 0;
+    for (const auto& e : entries_) {
+      indexSize += kEntryHeaderSize + e.key.size();
+      valuesSize += e.valueLength;
+    }
+    std::string out;
+    out.reserve(indexSize + valuesSize);
+    out += concordUtils::toBigEndianStringBuffer(static_cast<std::uint32_t>(entries_.size()));
+    auto offset = indexSize;
+    for (auto& e : entries_) {
+      out += static_cast<char>(e.type);
+      out += concordUtils::toBigEndianStringBuffer(static_cast<std::uint32_t>(e.key.size()));
+      out += concordUtils::toBigEndianStringBuffer(e.valueLength);
+      out += e.key;
+      e.valueOffset = offset;
+      offset += e.valueLength;
+    }
+    for (const auto& v : values_) out.append(v.data(), v.length());
+    return out;
+  }
+
+  const std::vector<Entry>& entries() const { return entries_; }
+
+  static constexpr std::size_t kEntryHeaderSize = sizeof(std::uint8_t) + 2 * sizeof(std::uint32_t);
+
+ private:
+  std::vector<Entry> entries_;
+  std::vector<concordUtils::Sliver> values_;
+};
+
+// Parses the index of a segment. Throws std::runtime_error if the segment is malformed.
+inline std::vector<Entry> parseIndex(const char* data, std::size_t size) {
+  const auto need = [size](std::uint64_t pos, std::uint64_t len) {
+    if (pos + len > size) throw std::runtime_error("malformed segment: truncated");
+  };
+  need(0, sizeof(std::uint32_t));
+  const auto count = concordUtils::fromBigEndianBuffer<std::uint32_t>(data);
+  std::uint64_t pos = sizeof(std::uint32_t);
+  std::vector<Entry> entries;
+  entries.reserve(count);
+  for (std::uint32_t i = 0; i < count; ++i) {
+    need(pos, Builder::kEntryHeaderSize);
+    const auto type = static_cast<std::uint8_t>(data[pos]);
+    if (type > static_cast<std::uint8_t>(EntryType::TOMBSTONE)) throw std::runtime_error("malformed segment: type");
+    const auto keyLength = concordUtils::fromBigEndianBuffer<std::uint32_t>(data + pos + 1);
+    const auto valueLength = concordUtils::fromBigEndianBuffer<std::uint32_t>(data + pos + 5);
+    pos += Builder::kEntryHeaderSize;
+    need(pos, keyLength);
+    entries.push_back(Entry{static_cast<EntryType>(type), std::string(data + pos, keyLength), 0, valueLength});
+    pos += keyLength;
+  }
+  for (auto& e : entries) {
+    need(pos, e.valueLength);
+    e.valueOffset = pos;
+    pos += e.valueLength;
+  }
+  return entries;
+}
+
+}  // namespace concord::storage::s3::segment
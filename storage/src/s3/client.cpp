@@ -16,19 +16,34 @@
 #include "s3/client.hpp"
 #include <cstring>
 #include <functional>
+#include <iomanip>
 #include <mutex>
 #include <thread>
 #include <functional>
+#include <strings.h>
 #include "Logger.hpp"
 #include "assertUtils.hpp"
 #include "storage/db_interface.h"
+#include "endianness.hpp"
 
 namespace concord::storage::s3 {
 
 using namespace std;
+using namespace std::chrono;
 using namespace concordUtils;
 
-static S3Status propertiesCallback(const S3ResponseProperties* properties, void* callbackData) {
+namespace {
+// The user metadata marking the manifest object of a multipart value, holding the number of its parts
+const char* kMultipartMetadataName = "concord-multipart-parts";
+}  // namespace
+
+S3Status propertiesCallback(const S3ResponseProperties* properties, void* callbackData) {
+  auto* data = static_cast<Client::ResponseData*>(callbackData);
+  if (!data || !data->metadata) return S3Status::S3StatusOK;
+  for (int i = 0; i < properties->metaDataCount; i++) {
+    if (strcasecmp(properties->metaData[i].name, kMultipartMetadataName) == 0)
+      data->metadata->multipartParts = static_cast<std::uint32_t>(std::strtoul(properties->metaData[i].value, 0, 10));
+  }
   return S3Status::S3StatusOK;
 }
 // This callback does the same thing for every request type: saves the status
@@ -83,8 +98,19 @@ void Client::init(bool readOnly) {
   }
   LOG_INFO(logger_, "libs3 initialized");
   init_ = true;
+  readOnly_ = readOnly;
+  segmentsPrefix_ = (config_.pathPrefix.empty() ? "" : config_.pathPrefix + "/") + "concord-segments/";
+  // Segment names sort in commit order, across restarts too
+  std::ostringstream startup;
+  startup << std::setw(20) << std::setfill('0')
+          << duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count() << '-';
+  segmentNamePrefix_ = segmentsPrefix_ + startup.str();
+
   auto res = test_bucket();
-  if (res.isOK()) return;
+  if (res.isOK()) {
+    loadSegments();
+    return;
+  }
   if (!res.isNotFound()) throw std::runtime_error("s3::Client failed to test bucket: " + res.toString());
 
   res = create_bucket();
@@ -102,12 +128,14 @@ Client::ResponseData Client::delete_internal(const Sliver& key) {
   return rData;
 }
 
-Client::GetObjectResponseData Client::get_internal(const Sliver& key, Sliver& outValue) const {
+Client::GetObjectResponseData Client::get_internal(
+    const Sliver& key, Sliver& outValue, uint64_t startByte, uint64_t byteCount, ObjectMetadata* metadata) const {
   ConcordAssert(init_);
   LOG_DEBUG(logger_, "key: " << key.toString());
-  GetObjectResponseData cbData(kInitialGetBufferSize_);
+  GetObjectResponseData cbData(byteCount ? byteCount : kInitialGetBufferSize_);
+  cbData.metadata = metadata;
   S3GetObjectHandler getObjectHandler;
-  getObjectHandler.responseHandler = {nullptr, &responseCompleteCallback};
+  getObjectHandler.responseHandler = {metadata ? propertiesCallback : nullptr, &responseCompleteCallback};
 
   // libs3 uses multiple calls to this callaback to append chunks of data from the stream
   auto f = [](int buf_len, const char* buf, void* cb) -> S3Status {
@@ -118,14 +146,17 @@ Client::GetObjectResponseData Client::get_internal(const Sliver& key, Sliver& ou
   };
   getObjectHandler.getObjectDataCallback = f;
   LOG_DEBUG(logger_, "calling S3_get_object, key: " << key.toString());
-  S3_get_object(&context_, key.toString().c_str(), nullptr, 0, 0, nullptr, &getObjectHandler, &cbData);
+  S3_get_object(
+      &context_, key.toString().c_str(), nullptr, startByte, byteCount, nullptr, &getObjectHandler, &cbData);
   if (cbData.status == S3Status::S3StatusOK)
     outValue = Sliver::copy(reinterpret_cast<const char*>(cbData.data), cbData.readLength);
 
   return cbData;
 }
 
-Client::PutObjectResponseData Client::put_internal(const Sliver& key, const Sliver& value) {
+Client::PutObjectResponseData Client::put_internal(const Sliver& key,
+                                                   const Sliver& value,
+                                                   const ObjectMetadata* metadata) {
   ConcordAssert(init_);
   PutObjectResponseData cbData(value.data(), value.length());
   S3PutObjectHandler putObjectHandler;
@@ -144,8 +175,23 @@ Client::PutObjectResponseData Client::put_internal(const Sliver& key, const Sliv
     return toSend;
   };
   putObjectHandler.putObjectDataCallback = f;
+  S3PutProperties properties;
+  const S3PutProperties* putProperties = nullptr;
+  std::string parts;
+  S3NameValue multipartMetadata;
+  if (metadata && metadata->multipartParts) {
+    memset(&properties, 0, sizeof(properties));
+    properties.expires = -1;
+    properties.cannedAcl = S3CannedAclPrivate;
+    parts = std::to_string(metadata->multipartParts);
+    multipartMetadata = S3NameValue{kMultipartMetadataName, parts.c_str()};
+    properties.metaDataCount = 1;
+    properties.metaData = &multipartMetadata;
+    putProperties = &properties;
+  }
   LOG_DEBUG(logger_, "calling S3_put_object, key: " << key.toString());
-  S3_put_object(&context_, key.toString().c_str(), value.length(), nullptr, nullptr, &putObjectHandler, &cbData);
+  S3_put_object(
+      &context_, key.toString().c_str(), value.length(), putProperties, nullptr, &putObjectHandler, &cbData);
   if (cbData.status == S3Status::S3StatusOK) {
     metrics_.num_keys_transferred++;
     metrics_.bytes_transferred += (key.length() + value.length());
@@ -154,9 +200,10 @@ Client::PutObjectResponseData Client::put_internal(const Sliver& key, const Sliv
   return cbData;
 }
 
-Client::ResponseData Client::object_exists_internal(const Sliver& key) const {
+Client::ResponseData Client::object_exists_internal(const Sliver& key, ObjectMetadata* metadata) const {
   ConcordAssert(init_);
   ResponseData rData;
+  rData.metadata = metadata;
   S3ResponseHandler rHandler{propertiesCallback, responseCompleteCallback};
   LOG_DEBUG(logger_, "calling S3_head_object, key: " << key.toString());
   S3_head_object(&context_, key.toString().c_str(), nullptr, &rHandler, &rData);
@@ -202,7 +249,15 @@ Client::ResponseData Client::create_bucket_internal() {
 }
 
 std::ostream& operator<<(std::ostream& os, const concord::storage::s3::StoreConfig& c) {
-  os << KVLOG(c.url, c.bucketName, c.pathPrefix, c.protocol, c.operationTimeout);
+  os << KVLOG(c.url,
+              c.bucketName,
+              c.pathPrefix,
+              c.protocol,
+              c.operationTimeout,
+              c.maxTransactionsInFlight,
+              c.packValuesBelowBytes,
+              c.multipartThresholdBytes,
+              c.multipartPartSizeBytes);
   return os;
 }
 
@@ -257,6 +312,11 @@ void Client::Transaction::commit() {
   static logging::Logger logger_ = logging::getLogger("concord.storage.s3");
   try {
     auto client = std::dynamic_pointer_cast<Client>(client_);
+    if (client->config_.archivalEnabled()) {
+      client->commitTransaction(std::move(multiput_), std::move(keys_to_delete_), getIdStr());
+      LOG_DEBUG(logger_, "txn id[" + getIdStr() + std::string("] committed"));
+      return;
+    }
     std::vector<std::future<concordUtils::Status>> futures;
     for (auto& pair : multiput_)
       futures.emplace_back(client->thread_pool_.async([pair, client] { return client->put(pair.first, pair.second); }));
@@ -277,4 +337,348 @@ void Client::Transaction::commit() {
   }
 }
 
+Status Client::get(const Sliver& key, Sliver& outValue) const {
+  LOG_DEBUG(logger_, key.toString());
+  const auto k = key.toString();
+  for (int attempt = 0;; ++attempt) {
+    std::optional<PackedLocation> location;
+    {
+      std::lock_guard<std::mutex> g(stateLock_);
+      if (auto it = pending_.find(k); it != pending_.end()) {
+        if (!it->second.value) return Status::NotFound("Status: deleted by a transaction in flight");
+        outValue = *it->second.value;
+        return Status::OK();
+      }
+      if (auto it = index_.find(k); it != index_.end()) location = it->second;
+    }
+    if (!location) return getObject(key, outValue);
+    if (location->length == 0) {
+      outValue = Sliver();
+      return Status::OK();
+    }
+    const auto segment = Sliver::copy(location->segment->data(), location->segment->size());
+    auto s = do_with_retry(
+        "get_packed", [&] { return get_internal(segment, outValue, location->offset, location->length); });
+    // The segment gets deleted once the key is overwritten, look the key up again
+    if (s.isNotFound() && attempt == 0) continue;
+    return s;
+  }
+}
+
+Status Client::has(const Sliver& key) const {
+  {
+    std::lock_guard<std::mutex> g(stateLock_);
+    if (auto it = pending_.find(key.toString()); it != pending_.end())
+      return it->second.value ? Status::OK() : Status::NotFound("Status: deleted by a transaction in flight");
+    if (index_.count(key.toString())) return Status::OK();
+  }
+  return do_with_retry("object_exists_internal", [&] { return object_exists_internal(key); });
+}
+
+Status Client::getObject(const Sliver& key, Sliver& outValue) const {
+  ObjectMetadata metadata;
+  auto s = do_with_retry("get_internal", [&] { return get_internal(key, outValue, 0, 0, &metadata); });
+  if (!s.isOK() || metadata.multipartParts == 0) return s;
+  const auto manifest = outValue;
+  return getMultipart(key, metadata.multipartParts, manifest, outValue);
+}
+
+Status Client::putObject(const Sliver& key, const Sliver& value, const ObjectMetadata* metadata) {
+  return do_with_retry("put_internal", [&] { return put_internal(key, value, metadata); });
+}
+
+Status Client::deleteObject(const Sliver& key) {
+  ObjectMetadata metadata;
+  if (config_.multipartThresholdBytes > 0) {
+    auto s = do_with_retry("object_exists_internal", [&] { return object_exists_internal(key, &metadata); });
+    if (s.isNotFound()) return Status::OK();
+    if (!s.isOK()) return s;
+  }
+  // The manifest goes first, so that a failure leaves unreachable parts behind rather than a broken value
+  auto s = do_with_retry("delete_internal", [&] { return delete_internal(key); });
+  for (std::uint32_t i = 0; s.isOK() && i < metadata.multipartParts; ++i) {
+    const auto part = partKey(key, i);
+    s = do_with_retry("delete_internal", [&] { return delete_internal(part); });
+    if (s.isNotFound()) s = Status::OK();
+  }
+  return s;
+}
+
+Sliver Client::partKey(const Sliver& key, std::uint64_t part) {
+  return Sliver(key.toString() + "/__part_" + std::to_string(part));
+}
+
+// The manifest of a multipart value holds its length and the size of its parts
+Status Client::getMultipart(const Sliver& key,
+                            std::uint32_t parts,
+                            const Sliver& manifest,
+                            Sliver& outValue) const {
+  if (manifest.length() != 2 * sizeof(std::uint64_t))
+    return Status::GeneralError("Status: malformed multipart manifest of " + key.toString());
+  const auto length = fromBigEndianBuffer<std::uint64_t>(manifest.data());
+  const auto partSize = fromBigEndianBuffer<std::uint64_t>(manifest.data() + sizeof(std::uint64_t));
+  if (partSize == 0 || (length + partSize - 1) / partSize != parts)
+    return Status::GeneralError("Status: malformed multipart manifest of " + key.toString());
+
+  std::string value(length, '\0');
+  std::vector<std::future<Status>> reads;
+  for (std::uint32_t i = 0; i < parts; ++i) {
+    reads.push_back(thread_pool_.async([this, &key, &value, i, partSize] {
+      Sliver part;
+      const auto k = partKey(key, i);
+      auto s = do_with_retry("get_internal", [&] { return get_internal(k, part); });
+      if (!s.isOK()) return s;
+      const auto offset = i * partSize;
+      if (part.length() != std::min(partSize, value.size() - offset))
+        return Status::GeneralError("Status: unexpected length of " + k.toString());
+      memcpy(value.data() + offset, part.data(), part.length());
+      return Status::OK();
+    }));
+  }
+  auto status = Status::OK();
+  for (auto& r : reads) {
+    auto s = r.get();
+    if (status.isOK() && !s.isOK()) status = s;
+  }
+  if (status.isOK()) outValue = Sliver(std::move(value));
+  return status;
+}
+
+Status Client::commitSingle(SetOfKeyValuePairs&& puts, std::set<Sliver>&& dels) {
+  try {
+    commitTransaction(std::move(puts), std::move(dels), "single");
+  } catch (const std::exception& e) {
+    return Status::GeneralError(e.what());
+  }
+  return Status::OK();
+}
+
+void Client::commitTransaction(SetOfKeyValuePairs&& puts, std::set<Sliver>&& dels, const std::string& idStr) {
+  std::lock_guard<std::mutex> guard(commitLock_);
+  throwOnArchivalError();
+  const auto isPackable = [this](const Sliver& value) { return value.length() < config_.packValuesBelowBytes; };
+
+  // Writes of an object must not race with the ones of earlier transactions, wait for them
+  CommitSeq barrier = 0;
+  {
+    std::lock_guard<std::mutex> g(stateLock_);
+    const auto lastObjectWrite = [this](const Sliver& key) {
+      auto it = pending_.find(key.toString());
+      return it == pending_.end() ? 0 : it->second.lastObjectWrite;
+    };
+    for (const auto& [key, value] : puts)
+      if (!isPackable(value)) barrier = std::max(barrier, lastObjectWrite(key));
+    for (const auto& key : dels) barrier = std::max(barrier, lastObjectWrite(key));
+  }
+  while (!inFlight_.empty() && inFlight_.front().seq <= barrier) completeOldest();
+
+  InFlightTransaction txn;
+  txn.seq = ++lastCommitSeq_;
+  txn.idStr = idStr;
+  const auto write = [this, &txn](const Sliver& key, const Sliver& value) {
+    txn.writes.push_back(thread_pool_.async([this, key, value] { return putObject(key, value); }));
+  };
+  segment::Builder packed;
+  {
+    std::lock_guard<std::mutex> g(stateLock_);
+    for (const auto& [key, value] : puts) {
+      const auto k = key.toString();
+      if (isPackable(value)) {
+        packed.add(key, value);
+        metrics_.packed_keys_transferred++;
+      } else {
+        if (isPacked(k)) packed.addTombstone(key);
+        if (config_.multipartThresholdBytes > 0 && value.length() >= config_.multipartThresholdBytes) {
+          const auto partSize = config_.multipartPartSizeBytes;
+          const auto parts = (value.length() + partSize - 1) / partSize;
+          for (std::uint64_t i = 0; i < parts; ++i)
+            write(partKey(key, i), Sliver(value, i * partSize, std::min(partSize, value.length() - i * partSize)));
+          metrics_.multipart_parts_transferred += parts;
+          auto manifest = toBigEndianStringBuffer<std::uint64_t>(value.length());
+          manifest += toBigEndianStringBuffer<std::uint64_t>(partSize);
+          txn.manifests.push_back(
+              Manifest{key, Sliver(std::move(manifest)), ObjectMetadata{static_cast<std::uint32_t>(parts)}});
+        } else {
+          write(key, value);
+        }
+      }
+      markPending(k, txn.seq, value, isPackable(value));
+      txn.keys.push_back(k);
+    }
+    for (const auto& key : dels) {
+      const auto k = key.toString();
+      if (isPacked(k)) packed.addTombstone(key);
+      txn.writes.push_back(thread_pool_.async([this, key] { return deleteObject(key); }));
+      markPending(k, txn.seq, std::nullopt, false);
+      txn.keys.push_back(k);
+    }
+  }
+  if (!packed.empty()) {
+    auto body = packed.build();
+    txn.segment = std::make_shared<const std::string>(nextSegmentName());
+    txn.segmentEntries = packed.entries();
+    write(Sliver::copy(txn.segment->data(), txn.segment->size()), Sliver(std::move(body)));
+  }
+  inFlight_.push_back(std::move(txn));
+  while (inFlight_.size() > config_.maxTransactionsInFlight) completeOldest();
+  metrics_.transactions_in_flight.Get().Set(inFlight_.size());
+  metrics_.metrics_component.UpdateAggregator();
+}
+
+void Client::completeOldest() {
+  auto txn = std::move(inFlight_.front());
+  inFlight_.pop_front();
+  const auto wait = [](std::vector<std::future<Status>>& writes) {
+    auto status = Status::OK();
+    for (auto& w : writes) {
+      auto s = w.get();
+      if (status.isOK() && !s.isOK()) status = s;
+    }
+    writes.clear();
+    return status;
+  };
+  auto status = wait(txn.writes);
+  if (status.isOK() && !txn.manifests.empty()) {
+    for (const auto& m : txn.manifests)
+      txn.writes.push_back(thread_pool_.async([this, &m] { return putObject(m.key, m.body, &m.metadata); }));
+    status = wait(txn.writes);
+  }
+
+  std::vector<std::string> garbage;
+  {
+    std::lock_guard<std::mutex> g(stateLock_);
+    if (status.isOK() && txn.segment) applySegment(txn.segment, txn.segmentEntries, garbage);
+    for (const auto& k : txn.keys) {
+      if (auto it = pending_.find(k); it != pending_.end() && it->second.seq == txn.seq) pending_.erase(it);
+    }
+  }
+  if (!status.isOK()) {
+    archivalError_ = "txn id[" + txn.idStr + "] failed, status: " + status.toString();
+    LOG_ERROR(logger_, archivalError_);
+    throw std::runtime_error(archivalError_);
+  }
+  collectGarbage(garbage);
+}
+
+void Client::flush() {
+  std::lock_guard<std::mutex> guard(commitLock_);
+  while (!inFlight_.empty()) completeOldest();
+  metrics_.transactions_in_flight.Get().Set(0);
+  throwOnArchivalError();
+}
+
+void Client::flushOnDestruction() {
+  std::lock_guard<std::mutex> guard(commitLock_);
+  while (!inFlight_.empty()) {
+    try {
+      completeOldest();
+    } catch (const std::exception& e) {
+      LOG_ERROR(logger_, "archival failed on destruction: " << e.what());
+    }
+  }
+}
+
+void Client::throwOnArchivalError() const {
+  if (!archivalError_.empty()) throw std::runtime_error("s3::Client archival failed: " + archivalError_);
+}
+
+bool Client::isPacked(const std::string& key) const {
+  if (auto it = pending_.find(key); it != pending_.end()) return it->second.packed;
+  return index_.count(key) > 0;
+}
+
+void Client::markPending(const std::string& key, CommitSeq seq, std::optional<Sliver> value, bool packed) {
+  auto& p = pending_[key];
+  p.seq = seq;
+  p.value = std::move(value);
+  p.packed = packed;
+  if (!packed) p.lastObjectWrite = seq;
+}
+
+void Client::applySegment(const std::shared_ptr<const std::string>& segment,
+                          const std::vector<segment::Entry>& entries,
+                          std::vector<std::string>& garbage) {
+  auto& info = segments_[*segment];
+  for (const auto& e : entries) {
+    if (e.type == segment::EntryType::TOMBSTONE) info.hasTombstones = true;
+  }
+  for (const auto& e : entries) {
+    auto it = index_.find(e.key);
+    if (it != index_.end()) {
+      releaseLocation(it->second, garbage);
+      if (e.type == segment::EntryType::TOMBSTONE) index_.erase(it);
+    }
+    if (e.type == segment::EntryType::VALUE) {
+      index_[e.key] = PackedLocation{segment, e.valueOffset, e.valueLength};
+      info.liveEntries++;
+    }
+  }
+  if (info.liveEntries == 0 && !info.hasTombstones) garbage.push_back(*segment);
+}
+
+void Client::releaseLocation(const PackedLocation& location, std::vector<std::string>& garbage) {
+  auto it = segments_.find(*location.segment);
+  ConcordAssert(it != segments_.end());
+  ConcordAssertGT(it->second.liveEntries, 0);
+  if (--it->second.liveEntries == 0 && !it->second.hasTombstones) garbage.push_back(it->first);
+}
+
+void Client::collectGarbage(const std::vector<std::string>& garbage) {
+  for (const auto& name : garbage) {
+    {
+      std::lock_guard<std::mutex> g(stateLock_);
+      segments_.erase(name);
+    }
+    if (readOnly_) continue;
+    const auto key = Sliver::copy(name.data(), name.size());
+    if (auto s = do_with_retry("delete_internal", [&] { return delete_internal(key); }); !s.isOK())
+      LOG_WARN(logger_, "failed to delete segment " << name << ": " << s.toString());
+  }
+}
+
+std::string Client::nextSegmentName() {
+  std::ostringstream oss;
+  oss << segmentNamePrefix_ << std::setw(20) << std::setfill('0') << nextSegment_++;
+  return oss.str();
+}
+
+void Client::loadSegments() {
+  std::unique_ptr<Iterator> it{getIterator<SortByKeyAscIterator>()};
+  std::vector<std::string> names;
+  for (auto kv = it->seekAtLeast(Sliver::copy(segmentsPrefix_.data(), segmentsPrefix_.size())); !it->isEnd();
+       kv = it->next())
+    names.push_back(kv.first.toString());
+  if (const auto& listing = static_cast<Iterator&>(*it).cb_data_; listing.status != S3StatusOK)
+    throw std::runtime_error("s3::Client failed to list segments: " + listing.errorMessage);
+
+  using Parsed = std::pair<Status, std::vector<segment::Entry>>;
+  std::vector<std::future<Parsed>> reads;
+  for (const auto& name : names) {
+    reads.push_back(thread_pool_.async([this, &name] {
+      Sliver body;
+      const auto key = Sliver::copy(name.data(), name.size());
+      auto s = do_with_retry("get_internal", [&] { return get_internal(key, body); });
+      if (!s.isOK()) return Parsed{s, {}};
+      try {
+        return Parsed{s, segment::parseIndex(body.data(), body.length())};
+      } catch (const std::exception& e) {
+        return Parsed{Status::GeneralError(e.what()), {}};
+      }
+    }));
+  }
+  std::vector<Parsed> segments;
+  for (auto& r : reads) segments.push_back(r.get());
+
+  std::vector<std::string> garbage;
+  for (size_t i = 0; i < names.size(); ++i) {
+    const auto& [status, entries] = segments[i];
+    if (!status.isOK())
+      throw std::runtime_error("s3::Client failed to read segment " + names[i] + ": " + status.toString());
+    std::lock_guard<std::mutex> g(stateLock_);
+    applySegment(std::make_shared<const std::string>(names[i]), entries, garbage);
+  }
+  collectGarbage(garbage);
+  LOG_INFO(logger_, "loaded segments" << KVLOG(names.size(), index_.size(), segments_.size()));
+}
+
 }  // namespace concord::storage::s3
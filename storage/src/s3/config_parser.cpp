@@ -32,6 +32,11 @@ concord::storage::s3::StoreConfig ConfigFileParser::parse() {
   config.secretKey = get_value<string>("s3-secret-key");
   config.pathPrefix = get_optional_value<string>("s3-path-prefix", "");
   config.operationTimeout = get_optional_value<std::uint32_t>("s3-operation-timeout", 60000);
+  config.maxTransactionsInFlight = get_optional_value<std::uint32_t>("s3-max-transactions-in-flight", 0);
+  config.packValuesBelowBytes = get_optional_value<std::uint32_t>("s3-pack-values-below-bytes", 0);
+  config.multipartThresholdBytes = get_optional_value<std::uint64_t>("s3-multipart-threshold-bytes", 0);
+  config.multipartPartSizeBytes =
+      get_optional_value<std::uint64_t>("s3-multipart-part-size-bytes", config.multipartPartSizeBytes);
   LOG_INFO(logger_, config);
   return config;
 }
@@ -21,6 +21,7 @@
 #include "storage/test/storage_test_common.h"
 
 #include <string_view>
+#include <thread>
 #include <utility>
 
 namespace {
@@ -918,6 +919,39 @@ TEST_F(native_rocksdb_test, multiget_resize_values_and_statuses) {
   ASSERT_EQ(value2, *values[2].GetSelf());
 }
 
+TEST_F(native_rocksdb_test, reads_in_a_scoped_snapshot_ignore_later_writes) {
+  const auto cf = "cf"s;
+  db->createColumnFamily(cf);
+  db->put(cf, key1, value1);
+  {
+    const auto snapshot = db->scopedSnapshot();
+    db->put(cf, key1, value2);
+    db->put(cf, key2, value2);
+
+    ASSERT_EQ(value1, *db->get(cf, key1));
+    ASSERT_FALSE(db->getSlice(cf, key2));
+    std::vector<std::string> keys = {key1, key2};
+    std::vector<::rocksdb::PinnableSlice> values;
+    std::vector<::rocksdb::Status> statuses;
+    db->multiGet(cf, keys, values, statuses);
+    ASSERT_EQ(value1, *values[0].GetSelf());
+    ASSERT_TRUE(statuses[1].IsNotFound());
+    {
+      auto it = db->getIterator(cf);
+      it.first();
+      ASSERT_TRUE(it);
+      ASSERT_EQ(it.keyView(), key1);
+      it.next();
+      ASSERT_FALSE(it);
+    }
+
+    // Other threads read the latest state
+    std::thread{[&] { ASSERT_EQ(value2, *db->get(cf, key1)); }}.join();
+  }
+  ASSERT_EQ(value2, *db->get(cf, key1));
+  ASSERT_EQ(value2, *db->get(cf, key2));
+}
+
 TEST_F(native_rocksdb_test, create_rocksdb_checkpoint) {
   auto checkPointDirPath = db->path() + "_checkpoint";
   db->setCheckpointDirNative(checkPointDirPath);
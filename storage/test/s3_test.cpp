@@ -8,6 +8,8 @@
 
 namespace concord::storage::s3::test {
 
+using namespace std::string_literals;
+
 /** @brief put and get regular string object */
 TEST_F(S3Test, PutGetStringObject) {
   Sliver key("unit_test_key");
@@ -167,4 +169,113 @@ TEST_F(S3Test, Iterator) {
     res = it->next();
   }
 }
+
+std::shared_ptr<Client> archivalClient(StoreConfig config,
+                                       const std::string &pathPrefix,
+                                       const std::function<void(StoreConfig &)> &tune) {
+  config.pathPrefix = pathPrefix;
+  tune(config);
+  auto client = std::make_shared<Client>(config);
+  client->init(false);
+  return client;
+}
+
+/** @brief Transactions in flight are visible to reads, and complete in commit order */
+TEST_F(S3Test, PipelinedTransactions) {
+  auto client = archivalClient(state.config, "pipelined", [](StoreConfig &c) { c.maxTransactionsInFlight = 4; });
+  for (int i = 0; i < 10; ++i) {
+    SetOfKeyValuePairs pairs;
+    pairs["pipelined/key" + std::to_string(i)] = "value" + std::to_string(i);
+    // Every transaction overwrites the same key
+    pairs["pipelined/last"s] = "value" + std::to_string(i);
+    ASSERT_EQ(client->multiPut(pairs), Status::OK());
+    Sliver value;
+    ASSERT_EQ(client->get("pipelined/key" + std::to_string(i), value), Status::OK());
+    ASSERT_EQ(value, Sliver("value" + std::to_string(i)));
+  }
+  ASSERT_EQ(client->del("pipelined/key0"s), Status::OK());
+  ASSERT_TRUE(client->has("pipelined/key0"s).isNotFound());
+  client->flush();
+
+  Sliver value;
+  ASSERT_TRUE(state.client->get("pipelined/key0"s, value).isNotFound());
+  for (int i = 1; i < 10; ++i) {
+    ASSERT_EQ(state.client->get("pipelined/key" + std::to_string(i), value), Status::OK());
+    ASSERT_EQ(value, Sliver("value" + std::to_string(i)));
+  }
+  ASSERT_EQ(state.client->get("pipelined/last"s, value), Status::OK());
+  ASSERT_EQ(value, Sliver("value9"s));
+}
+
+/** @brief Small values are packed into segments, which are indexed again by a new client */
+TEST_F(S3Test, PackedValues) {
+  const auto tune = [](StoreConfig &c) {
+    c.maxTransactionsInFlight = 2;
+    c.packValuesBelowBytes = 64;
+  };
+  const Sliver big(std::string(100, 'b'));
+  {
+    auto client = archivalClient(state.config, "packed", tune);
+    SetOfKeyValuePairs pairs;
+    for (int i = 0; i < 10; ++i) pairs["packed/key" + std::to_string(i)] = "value" + std::to_string(i);
+    pairs["packed/big"s] = big;
+    ASSERT_EQ(client->multiPut(pairs), Status::OK());
+    ASSERT_EQ(client->put("packed/key1"s, "overwritten"s), Status::OK());
+    ASSERT_EQ(client->put("packed/key2"s, big), Status::OK());
+    ASSERT_EQ(client->del("packed/key3"s), Status::OK());
+    client->flush();
+
+    // Packed values are not stored as objects of their own
+    ASSERT_TRUE(state.client->has("packed/key0"s).isNotFound());
+    ASSERT_EQ(state.client->has("packed/big"s), Status::OK());
+    ASSERT_EQ(client->has("packed/key0"s), Status::OK());
+  }
+  auto client = archivalClient(state.config, "packed", tune);
+  Sliver value;
+  ASSERT_EQ(client->get("packed/key0"s, value), Status::OK());
+  ASSERT_EQ(value, Sliver("value0"s));
+  ASSERT_EQ(client->get("packed/key1"s, value), Status::OK());
+  ASSERT_EQ(value, Sliver("overwritten"s));
+  ASSERT_EQ(client->get("packed/key2"s, value), Status::OK());
+  ASSERT_EQ(value, big);
+  ASSERT_TRUE(client->get("packed/key3"s, value).isNotFound());
+  ASSERT_TRUE(client->has("packed/key3"s).isNotFound());
+  ASSERT_EQ(client->get("packed/big"s, value), Status::OK());
+  ASSERT_EQ(value, big);
+  for (int i = 4; i < 10; ++i) {
+    ASSERT_EQ(client->get("packed/key" + std::to_string(i), value), Status::OK());
+    ASSERT_EQ(value, Sliver("value" + std::to_string(i)));
+  }
+}
+
+/** @brief Large values are uploaded in parts */
+TEST_F(S3Test, MultipartValues) {
+  const auto tune = [](StoreConfig &c) {
+    c.maxTransactionsInFlight = 2;
+    c.multipartThresholdBytes = 1000;
+    c.multipartPartSizeBytes = 300;
+  };
+  std::string bytes(2500, '\0');
+  for (size_t i = 0; i < bytes.size(); ++i) bytes[i] = static_cast<char>(i % 251);
+  const Sliver big(std::move(bytes));
+  {
+    auto client = archivalClient(state.config, "multipart", tune);
+    ASSERT_EQ(client->put("multipart/big"s, big), Status::OK());
+    ASSERT_EQ(client->put("multipart/small"s, "small"s), Status::OK());
+  }
+  ASSERT_EQ(state.client->has("multipart/big/__part_8"s), Status::OK());
+  ASSERT_TRUE(state.client->has("multipart/big/__part_9"s).isNotFound());
+
+  auto client = archivalClient(state.config, "multipart", tune);
+  Sliver value;
+  ASSERT_EQ(client->get("multipart/big"s, value), Status::OK());
+  ASSERT_EQ(value, big);
+  ASSERT_EQ(client->get("multipart/small"s, value), Status::OK());
+  ASSERT_EQ(value, Sliver("small"s));
+
+  ASSERT_EQ(client->del("multipart/big"s), Status::OK());
+  client->flush();
+  ASSERT_TRUE(client->get("multipart/big"s, value).isNotFound());
+  ASSERT_TRUE(state.client->has("multipart/big/__part_0"s).isNotFound());
+}
 }  // namespace concord::storage::s3::test
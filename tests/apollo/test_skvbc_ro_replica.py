@@ -40,6 +40,15 @@ def start_replica_cmd(builddir, replica_id, config):
     """
     return start_replica_cmd_prefix(builddir, replica_id, config)
 
+def start_replica_cmd_with_read_threads(builddir, replica_id, config):
+    """
+    Same as start_replica_cmd, with a pool of threads serving read-only requests on the read-only replica.
+    """
+    cmd = start_replica_cmd_prefix(builddir, replica_id, config)
+    if replica_id >= config.n:
+        cmd.extend(["--ro-replica-read-threads", "2"])
+    return cmd
+
 class SkvbcReadOnlyReplicaTest(ApolloTest):
     """
     ReadOnlyReplicaTest has got two modes of operation:
@@ -258,6 +267,30 @@ class SkvbcReadOnlyReplicaTest(ApolloTest):
 
         await self._wait_for_st(bft_network, ro_replica_id, 150)
 
+    @with_trio
+    @with_bft_network(start_replica_cmd=start_replica_cmd_with_read_threads, num_ro_replicas=1,
+                      selected_configs=lambda n, f, c: n == 7)
+    async def test_ro_replica_with_read_threads(self, bft_network):
+        """
+        Start up N of N regular replicas.
+        Start a read-only replica serving read-only requests from a pool of threads.
+        Send client commands until checkpoint 1 is reached.
+        Wait for State Transfer in ReadOnlyReplica to complete.
+        """
+        bft_network.start_all_replicas()
+        ro_replica_id = bft_network.config.n
+        bft_network.start_replica(ro_replica_id)
+        skvbc = kvbc.SimpleKVBCProtocol(bft_network)
+
+        await skvbc.fill_and_wait_for_checkpoint(
+            initial_nodes=bft_network.all_replicas(),
+            num_of_checkpoints_to_add=1,
+            verify_checkpoint_persistency=False,
+            assert_state_transfer_not_started=False
+        )
+
+        await self._wait_for_st(bft_network, ro_replica_id, 150)
+
     @with_trio
     @with_bft_network(start_replica_cmd=start_replica_cmd_prefix, num_ro_replicas=1, selected_configs=lambda n, f, c: n == 7)
     async def test_ro_replica_state_fetch(self, bft_network):
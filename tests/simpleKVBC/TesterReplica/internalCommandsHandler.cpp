@@ -347,25 +347,15 @@ void InternalCommandsHandler::addBlock(VersionedUpdates &verUpdates, BlockMerkle
   // Add all key-values in the block merkle category as public ones.
   if (m_addAllKeysAsPublic) {
     ConcordAssertNE(m_kvbc, nullptr);
-    auto public_state = m_kvbc->getPublicStateKeys();
-    if (!public_state) {
-      public_state = PublicStateKeys{};
-    }
+    auto keys = std::vector<std::string>{};
+    keys.reserve(merkleUpdates.getData().kv.size());
     for (const auto &[k, _] : merkleUpdates.getData().kv) {
       (void)_;
-      // We don't allow duplicates.
-      auto it = std::lower_bound(public_state->keys.cbegin(), public_state->keys.cend(), k);
-      if (it != public_state->keys.cend() && *it == k) {
-        continue;
-      }
-      // We always persist public state keys in sorted order.
-      public_state->keys.push_back(k);
-      std::sort(public_state->keys.begin(), public_state->keys.end());
+      keys.push_back(k);
     }
-    const auto public_state_ser = detail::serialize(*public_state);
+    // Only the chunks of public keys the new keys fall into get rewritten.
     auto public_state_updates = VersionedUpdates{};
-    public_state_updates.addUpdate(std::string{concord::kvbc::keyTypes::state_public_key_set},
-                                   std::string{public_state_ser.cbegin(), public_state_ser.cend()});
+    m_kvbc->getPublicStateKeyStore().add(std::move(keys), public_state_updates);
     updates.add(kConcordInternalCategoryId, std::move(public_state_updates));
   }
 
@@ -138,6 +138,7 @@ std::unique_ptr<TestSetup> TestSetup::ParseArgs(int argc, char** argv) {
         {"publish-master-key-on-startup", no_argument, (int*)&replicaConfig.publishReplicasMasterKeyOnStartup, 1},
         {"add-all-keys-as-public", no_argument, &addAllKeysAsPublic, 1},
         {"diagnostics-port", required_argument, 0, 2},
+        {"ro-replica-read-threads", required_argument, 0, 2},
         {0, 0, 0, 0}};
     int o = 0;
     int optionIndex = 0;
@@ -172,6 +173,9 @@ std::unique_ptr<TestSetup> TestSetup::ParseArgs(int argc, char** argv) {
                     "a valid available port number"};
               }
             } break;
+            case 30: {
+              replicaConfig.numOfReadOnlyReplicaReadThreads = concord::util::to<std::uint32_t>(std::string(optarg));
+            } break;
             default: {
               std::ostringstream ss;
               ss << "invalid option:" << KVLOG(o, optionIndex);
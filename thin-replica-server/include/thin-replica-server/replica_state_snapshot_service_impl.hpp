@@ -18,7 +18,13 @@
 #include "bftengine/DbCheckpointManager.hpp"
 #include "categorization/kv_blockchain.h"
 #include "kvbc_app_filter/value_from_kvbc_proto.h"
+#include "Metrics.hpp"
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 
@@ -27,9 +33,19 @@ namespace concord::thin_replica {
 // A service that streams state snapshot key-values. By default, `kvbc` values are assumed to be in a
 // `com::vmware::concord::kvbc::ValueWithTrids` format and the value is extracted from it. Users can specify different
 // convertors, if needed.
+//
+// Key-values are read from the snapshot and converted on a separate thread, which runs ahead of the gRPC writer by up
+// to kMaxQueuedResponses responses. That way, reading from RocksDB and writing to the client overlap.
 class ReplicaStateSnapshotServiceImpl
     : public vmware::concord::replicastatesnapshot::ReplicaStateSnapshotService::Service {
  public:
+  // The biggest `max_response_size` the service honours.
+  static constexpr std::uint32_t kMaxResponseSize = 2 * 1024 * 1024;
+  // The number of responses that are read ahead of the gRPC writer.
+  static constexpr std::size_t kMaxQueuedResponses = 16;
+
+  ReplicaStateSnapshotServiceImpl();
+
   // Streams the state snapshot requested in `request` in the form of a finite stream of key-values.
   // See `replica_state_snapshot.proto` for the possible return values and the data structures.
   ::grpc::Status StreamSnapshot(
@@ -37,11 +53,22 @@ class ReplicaStateSnapshotServiceImpl
       const ::vmware::concord::replicastatesnapshot::StreamSnapshotRequest* request,
       ::grpc::ServerWriter< ::vmware::concord::replicastatesnapshot::StreamSnapshotResponse>* writer) override;
 
+  // Splits the state snapshot requested in `request` in shards that can be streamed and verified independently.
+  // The shards are the ones persisted along with the public state hash of the snapshot, merged if more than
+  // `max_shards` are persisted.
+  // See `replica_state_snapshot.proto` for the possible return values and the data structures.
+  ::grpc::Status GetSnapshotShards(
+      ::grpc::ServerContext* context,
+      const ::vmware::concord::replicastatesnapshot::GetSnapshotShardsRequest* request,
+      ::vmware::concord::replicastatesnapshot::GetSnapshotShardsResponse* response) override;
+
   // Allows users to convert state values to any format that is appropriate.
   void setStateValueConverter(const kvbc::categorization::KeyValueBlockchain::Converter& c) {
     state_value_converter_ = c;
   }
 
+  void setAggregator(const std::shared_ptr<concordMetrics::Aggregator>& aggregator);
+
   // Following methods are used for testing only. Please do not use in production.
   void overrideCheckpointPathForTest(const std::string& path) { overriden_path_for_test_ = path; }
   void overrideCheckpointStateForTest(bftEngine::impl::DbCheckpointManager::CheckpointState state) {
@@ -49,6 +76,15 @@ class ReplicaStateSnapshotServiceImpl
   }
   void throwExceptionForTest() { throw_exception_for_test_ = true; }
 
+ private:
+  // Returns an error status if the snapshot doesn't exist or is not ready yet.
+  std::optional<::grpc::Status> checkSnapshot(std::uint64_t snapshot_id) const;
+  std::string snapshotPath(std::uint64_t snapshot_id) const;
+
+  // Updates the throughput of the current stream, which started at `start` and has streamed `key_values` key-values
+  // and `bytes` bytes so far.
+  void updateThroughput(std::chrono::steady_clock::time_point start, std::uint64_t key_values, std::uint64_t bytes);
+
  private:
   std::optional<std::string> overriden_path_for_test_;
   std::optional<bftEngine::impl::DbCheckpointManager::CheckpointState> overriden_checkpoint_state_for_test_;
@@ -56,6 +92,15 @@ class ReplicaStateSnapshotServiceImpl
   // Allows users to convert state values to any format that is appropriate.
   // The default converter extracts the value from the ValueWithTrids protobuf type.
   kvbc::categorization::KeyValueBlockchain::Converter state_value_converter_{kvbc::valueFromKvbcProto};
+
+  concordMetrics::Component metrics_component_;
+  // Totals over all the streams
+  concordMetrics::ShardedCounterHandle streamed_key_values_;
+  concordMetrics::ShardedCounterHandle streamed_bytes_;
+  // The throughput of the latest stream, updated about every second while streaming
+  concordMetrics::AtomicGaugeHandle key_values_per_sec_;
+  concordMetrics::AtomicGaugeHandle bytes_per_sec_;
+  std::mutex metrics_mutex_;
 };
 
 }  // namespace concord::thin_replica
@@ -19,13 +19,19 @@
 #include <chrono>
 #include <condition_variable>
 #include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
 #include <tuple>
+#include <unordered_map>
 #include <unordered_set>
 #include "Logger.hpp"
 #include "assertUtils.hpp"
 #include "block_update/block_update.hpp"
 #include "block_update/event_group_update.hpp"
 #include "kv_types.hpp"
+#include "kvbc_app_filter/kvbc_app_filter.h"
 
 namespace concord {
 namespace thin_replica {
@@ -38,11 +44,75 @@ class ConsumerTooSlow : public std::runtime_error {
 typedef kvbc::BlockUpdate SubUpdate;
 typedef kvbc::EventGroupUpdate SubEventGroupUpdate;
 
+// An update as it is handed out to the subscribers. It is created once per
+// update and shared by all subscriber buffers, hence, it is immutable.
+// Subscriptions of the same client filter (and hash) an update the same way.
+// Therefore, these results are memoized per client id and computed by the
+// first subscription of that client only.
+template <typename UpdateT, typename FilteredT>
+class SharedUpdate {
+ public:
+  explicit SharedUpdate(const UpdateT& update) : update_(update) {}
+  explicit SharedUpdate(UpdateT&& update) : update_(std::move(update)) {}
+
+  SharedUpdate(const SharedUpdate&) = delete;
+  SharedUpdate& operator=(const SharedUpdate&) = delete;
+
+  const UpdateT& get() const { return update_; }
+
+  // Return the result of filter(get()) for the given client. The result stays
+  // valid as long as this update is alive.
+  template <typename FilterFn>
+  const FilteredT& filtered(const std::string& client_id, FilterFn&& filter) const {
+    auto& entry = entryFor(client_id);
+    std::call_once(entry.filtered_once, [&] { entry.filtered.emplace(filter(update_)); });
+    return *entry.filtered;
+  }
+
+  // Return the result of hash(filtered) for the given client whereby filtered
+  // is the memoized result of filtered().
+  template <typename FilterFn, typename HashFn>
+  const std::string& hash(const std::string& client_id, FilterFn&& filter, HashFn&& hash_fn) const {
+    const auto& filtered_update = filtered(client_id, std::forward<FilterFn>(filter));
+    auto& entry = entryFor(client_id);
+    std::call_once(entry.hash_once, [&] { entry.hash = hash_fn(filtered_update); });
+    return entry.hash;
+  }
+
+ private:
+  struct ClientEntry {
+    std::once_flag filtered_once;
+    std::optional<FilteredT> filtered;
+    std::once_flag hash_once;
+    std::string hash;
+  };
+
+  ClientEntry& entryFor(const std::string& client_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = per_client_[client_id];
+    if (!entry) {
+      entry = std::make_unique<ClientEntry>();
+    }
+    return *entry;
+  }
+
+  const UpdateT update_;
+  mutable std::mutex mutex_;
+  mutable std::unordered_map<std::string, std::unique_ptr<ClientEntry>> per_client_;
+};
+
+typedef SharedUpdate<SubUpdate, kvbc::KvbFilteredUpdate> SharedSubUpdate;
+typedef SharedUpdate<SubEventGroupUpdate, std::optional<kvbc::KvbFilteredEventGroupUpdate>> SharedSubEventGroupUpdate;
+typedef std::shared_ptr<const SharedSubUpdate> SubUpdatePtr;
+typedef std::shared_ptr<const SharedSubEventGroupUpdate> SubEventGroupUpdatePtr;
+
 // Each subscriber creates its own spsc queue and puts it into the shared list
 // of subscriber buffers. This is a thread-safe implementation around boost's
 // spsc queue in order to use an additional wake-up mechanism. We expect a
 // single producer (the commands handler) and a single consumer (the subscriber
 // thread in the thin replica gRPC service).
+// The queues hold references to shared updates. The subscriber's position in
+// the stream of updates is its read position in the queue.
 class SubUpdateBuffer {
  public:
   explicit SubUpdateBuffer(size_t size)
@@ -59,7 +129,8 @@ class SubUpdateBuffer {
   SubUpdateBuffer& operator=(const SubUpdateBuffer&) = delete;
 
   // Add an update to the queue and notify waiting subscribers
-  void Push(const SubUpdate& update) {
+  void Push(const SubUpdatePtr& update) {
+    ConcordAssertNE(update, nullptr);
     {
       std::unique_lock<std::mutex> lock(mutex_);
       if (!too_slow_ && !queue_.push(update)) {
@@ -70,14 +141,17 @@ class SubUpdateBuffer {
         too_slow_ = true;
         LOG_WARN(logger_, "Failed to add update. Consumer too slow.");
       } else {
-        newest_block_id_ = update.block_id;
+        newest_block_id_ = update->get().block_id;
       }
     }
     cv_.notify_one();
   }
 
+  void Push(const SubUpdate& update) { Push(std::make_shared<const SharedSubUpdate>(update)); }
+
   // Add an update to the queue and notify waiting subscribers
-  void PushEventGroup(const SubEventGroupUpdate& update) {
+  void PushEventGroup(const SubEventGroupUpdatePtr& update) {
+    ConcordAssertNE(update, nullptr);
     {
       std::unique_lock<std::mutex> lock(eg_mutex_);
       if (!eg_too_slow_ && !eg_queue_.push(update)) {
@@ -88,14 +162,18 @@ class SubUpdateBuffer {
         eg_too_slow_ = true;
         LOG_WARN(logger_, "Failed to add update. Consumer too slow.");
       } else {
-        newest_event_group_id_ = update.event_group_id;
+        newest_event_group_id_ = update->get().event_group_id;
       }
     }
     eg_cv_.notify_one();
   }
 
+  void PushEventGroup(const SubEventGroupUpdate& update) {
+    PushEventGroup(std::make_shared<const SharedSubEventGroupUpdate>(update));
+  }
+
   // Return the oldest update (block if queue is empty)
-  void Pop(SubUpdate& out) {
+  void Pop(SubUpdatePtr& out) {
     std::unique_lock<std::mutex> lock(mutex_);
     // Boost's spsc queue is wait-free but we want to block here
     cv_.wait(lock, [this] { return too_slow_ || queue_.read_available(); });
@@ -109,8 +187,14 @@ class SubUpdateBuffer {
     ConcordAssert(queue_.pop(out));
   }
 
+  void Pop(SubUpdate& out) {
+    SubUpdatePtr update;
+    Pop(update);
+    out = update->get();
+  }
+
   template <typename RepT, typename PeriodT>
-  bool TryPop(SubUpdate& out, const std::chrono::duration<RepT, PeriodT>& timeout) {
+  bool TryPop(SubUpdatePtr& out, const std::chrono::duration<RepT, PeriodT>& timeout) {
     std::unique_lock<std::mutex> lock(mutex_);
     // Boost's spsc queue is wait-free but we want to block here
     cv_.wait_for(lock, timeout, [this] { return too_slow_ || queue_.read_available(); });
@@ -128,8 +212,18 @@ class SubUpdateBuffer {
     return false;
   }
 
+  template <typename RepT, typename PeriodT>
+  bool TryPop(SubUpdate& out, const std::chrono::duration<RepT, PeriodT>& timeout) {
+    SubUpdatePtr update;
+    if (!TryPop(update, timeout)) {
+      return false;
+    }
+    out = update->get();
+    return true;
+  }
+
   // Return the oldest update (event group if queue is empty)
-  void PopEventGroup(SubEventGroupUpdate& out) {
+  void PopEventGroup(SubEventGroupUpdatePtr& out) {
     std::unique_lock<std::mutex> lock(eg_mutex_);
     // Boost's spsc queue is wait-free but we want to block here
     eg_cv_.wait(lock, [this] { return eg_too_slow_ || eg_queue_.read_available(); });
@@ -143,8 +237,14 @@ class SubUpdateBuffer {
     ConcordAssert(eg_queue_.pop(out));
   }
 
+  void PopEventGroup(SubEventGroupUpdate& out) {
+    SubEventGroupUpdatePtr update;
+    PopEventGroup(update);
+    out = update->get();
+  }
+
   template <typename RepT, typename PeriodT>
-  bool TryPopEventGroup(SubEventGroupUpdate& out, const std::chrono::duration<RepT, PeriodT>& timeout) {
+  bool TryPopEventGroup(SubEventGroupUpdatePtr& out, const std::chrono::duration<RepT, PeriodT>& timeout) {
     std::unique_lock<std::mutex> lock(eg_mutex_);
     // Boost's spsc queue is wait-free but we want to block here
     eg_cv_.wait_for(lock, timeout, [this] { return eg_too_slow_ || eg_queue_.read_available(); });
@@ -162,6 +262,16 @@ class SubUpdateBuffer {
     return false;
   }
 
+  template <typename RepT, typename PeriodT>
+  bool TryPopEventGroup(SubEventGroupUpdate& out, const std::chrono::duration<RepT, PeriodT>& timeout) {
+    SubEventGroupUpdatePtr update;
+    if (!TryPopEventGroup(update, timeout)) {
+      return false;
+    }
+    out = update->get();
+    return true;
+  }
+
   void waitUntilNonEmpty() {
     std::unique_lock<std::mutex> lock(mutex_);
     cv_.wait(lock, [this] { return queue_.read_available(); });
@@ -223,7 +333,7 @@ class SubUpdateBuffer {
     std::unique_lock<std::mutex> lock(mutex_);
     // Undefined behavior if the queue is empty
     ConcordAssertGT(queue_.read_available(), 0);
-    return queue_.front().block_id;
+    return queue_.front()->get().block_id;
   }
 
   // The caller needs to make sure that the queue is not empty when calling
@@ -231,11 +341,11 @@ class SubUpdateBuffer {
     std::unique_lock<std::mutex> lock(eg_mutex_);
     // Undefined behavior if the queue is empty
     ConcordAssertGT(eg_queue_.read_available(), 0);
-    return eg_queue_.front().event_group_id;
+    return eg_queue_.front()->get().event_group_id;
   }
 
   // The caller needs to make sure that the queue is not empty when calling
-  SubEventGroupUpdate oldestEventGroup() {
+  SubEventGroupUpdatePtr oldestEventGroup() {
     std::unique_lock<std::mutex> lock(eg_mutex_);
     // Undefined behavior if the queue is empty
     ConcordAssertGT(eg_queue_.read_available(), 0);
@@ -276,8 +386,8 @@ class SubUpdateBuffer {
 
  private:
   logging::Logger logger_;
-  boost::lockfree::spsc_queue<SubUpdate> queue_;
-  boost::lockfree::spsc_queue<SubEventGroupUpdate> eg_queue_;
+  boost::lockfree::spsc_queue<SubUpdatePtr> queue_;
+  boost::lockfree::spsc_queue<SubEventGroupUpdatePtr> eg_queue_;
   // lock used for updating the queue as well as the variables below
   std::mutex mutex_;
   std::condition_variable cv_;
@@ -318,10 +428,23 @@ class SubBufferList {
   }
 
   // Populate updates to all subscribers
-  // Note: This is potentially expensive depending on the update size and the
-  // number of subscribers. If TRC/TRS stays then we might want to think about
-  // an optimization.
+  // Note: Each update is copied (or moved) once into an immutable shared update
+  // which is then referenced by all subscriber buffers.
   virtual void updateSubBuffers(SubUpdate& update) {
+    if (Size() == 0) {
+      return;
+    }
+    updateSubBuffers(std::make_shared<const SharedSubUpdate>(update));
+  }
+
+  virtual void updateSubBuffers(SubUpdate&& update) {
+    if (Size() == 0) {
+      return;
+    }
+    updateSubBuffers(std::make_shared<const SharedSubUpdate>(std::move(update)));
+  }
+
+  virtual void updateSubBuffers(const SubUpdatePtr& update) {
     std::lock_guard<std::mutex> lock(mutex_);
     for (const auto& it : subscriber_) {
       it->Push(update);
@@ -329,6 +452,20 @@ class SubBufferList {
   }
 
   virtual void updateEventGroupSubBuffers(SubEventGroupUpdate& update) {
+    if (Size() == 0) {
+      return;
+    }
+    updateEventGroupSubBuffers(std::make_shared<const SharedSubEventGroupUpdate>(update));
+  }
+
+  virtual void updateEventGroupSubBuffers(SubEventGroupUpdate&& update) {
+    if (Size() == 0) {
+      return;
+    }
+    updateEventGroupSubBuffers(std::make_shared<const SharedSubEventGroupUpdate>(std::move(update)));
+  }
+
+  virtual void updateEventGroupSubBuffers(const SubEventGroupUpdatePtr& update) {
     std::lock_guard<std::mutex> lock(mutex_);
     for (const auto& it : subscriber_) {
       it->PushEventGroup(update);
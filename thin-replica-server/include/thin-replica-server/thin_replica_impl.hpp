@@ -30,6 +30,7 @@
 #include <string>
 #include "Logger.hpp"
 #include "Metrics.hpp"
+#include "thread_pool.hpp"
 
 #include "db_interfaces.h"
 #include "kv_types.hpp"
@@ -70,6 +71,10 @@ struct ThinReplicaServerConfig {
   // the time duration the TRS waits before printing warning logs when
   // subscription status for live updates is not ok
   std::chrono::seconds no_live_subscription_warn_duration;
+  // the number of threads which read and filter historical updates ahead of
+  // the subscriptions catching up, shared by all subscriptions (0 to read and
+  // filter on the subscription's reader thread only)
+  const uint32_t catch_up_read_threads;
 
   ThinReplicaServerConfig(const bool is_insecure_trs_,
                           const std::string& tls_trs_cert_path_,
@@ -77,17 +82,20 @@ struct ThinReplicaServerConfig {
                           SubBufferList& subscriber_list_,
                           std::unordered_set<std::string>& client_id_set_,
                           const uint16_t update_metrics_aggregator_thresh_ = 100,
-                          std::chrono::seconds no_live_subscription_warn_duration_ = kNoLiveSubscriptionWarnDuration)
+                          std::chrono::seconds no_live_subscription_warn_duration_ = kNoLiveSubscriptionWarnDuration,
+                          const uint32_t catch_up_read_threads_ = kDefaultCatchUpReadThreads)
       : is_insecure_trs(is_insecure_trs_),
         tls_trs_cert_path(tls_trs_cert_path_),
         rostorage(rostorage_),
         subscriber_list(subscriber_list_),
         client_id_set(client_id_set_),
         update_metrics_aggregator_thresh(update_metrics_aggregator_thresh_),
-        no_live_subscription_warn_duration(no_live_subscription_warn_duration_) {}
+        no_live_subscription_warn_duration(no_live_subscription_warn_duration_),
+        catch_up_read_threads(catch_up_read_threads_) {}
 
  private:
   static constexpr std::chrono::seconds kNoLiveSubscriptionWarnDuration = 60s;
+  static constexpr uint32_t kDefaultCatchUpReadThreads = 4;
 };
 
 class ThinReplicaImpl {
@@ -108,6 +116,8 @@ class ThinReplicaImpl {
 
   using KvbAppFilterPtr = std::shared_ptr<kvbc::KvbAppFilter>;
   static constexpr size_t kSubUpdateBufferSize{1000u};
+  // Filtered historical updates queued for the gRPC writer
+  static constexpr size_t kCatchUpQueueSize{kvbc::KvbAppFilter::kReadAheadSize};
   const std::chrono::milliseconds kWaitForUpdateTimeout{100};
   const std::string kCorrelationIdTag = "cid";
   // last timestamp when subscription status for live updates was not ok
@@ -116,7 +126,14 @@ class ThinReplicaImpl {
  public:
   ThinReplicaImpl(std::unique_ptr<ThinReplicaServerConfig> config,
                   std::shared_ptr<concordMetrics::Aggregator> aggregator)
-      : logger_(logging::getLogger("concord.thin_replica")), config_(std::move(config)), aggregator_(aggregator) {}
+      : logger_(logging::getLogger("concord.thin_replica")), config_(std::move(config)), aggregator_(aggregator) {
+    if (config_->catch_up_read_threads > 0) {
+      read_pool_ = std::make_shared<concord::util::ThreadPool>(config_->catch_up_read_threads, "trs_catch_up_read");
+      if (aggregator_) {
+        read_pool_->setAggregator(aggregator_);
+      }
+    }
+  }
 
   ThinReplicaImpl(const ThinReplicaImpl&) = delete;
   ThinReplicaImpl(ThinReplicaImpl&&) = delete;
@@ -355,10 +372,10 @@ class ThinReplicaImpl {
           }
           is_update_available = live_updates->waitUntilNonEmpty(kWaitForUpdateTimeout);
           if (is_update_available && live_updates->oldestBlockId() < last_block_id + 1) {
-            SubUpdate update;
+            SubUpdatePtr update;
             live_updates->Pop(update);
             LOG_DEBUG(logger_,
-                      "Dropping block ID: " << update.block_id << " from live_updates, requested block ID: "
+                      "Dropping block ID: " << update->get().block_id << " from live_updates, requested block ID: "
                                             << request->events().block_id());
             is_update_available = false;
           }
@@ -391,7 +408,10 @@ class ThinReplicaImpl {
         return grpc::Status(grpc::StatusCode::UNKNOWN, msg.str());
       }
       // Read, filter, and send live updates
-      SubUpdate update;
+      // Live updates are shared with the other subscriptions. Filtering (and
+      // hashing) results are memoized per client in the shared update.
+      SubUpdatePtr update;
+      const auto filter_update = [&kvb_filter](const SubUpdate& u) { return kvb_filter->filterUpdate(u); };
       try {
         while (!context->IsCancelled() && !is_event_group_transition) {
           metrics_.queue_size.Get().Set(live_updates->Size());
@@ -400,14 +420,13 @@ class ThinReplicaImpl {
           if (not is_update_available) {
             continue;
           }
-          auto kvb_update =
-              kvbc::KvbUpdate{update.block_id, update.correlation_id, std::move(update.immutable_kv_pairs)};
-          const auto& filtered_update = kvb_filter->filterUpdate(kvb_update);
+          const auto& block_update = update->get();
           if constexpr (std::is_same<DataT, com::vmware::concord::thin_replica::Data>()) {
             LOG_DEBUG(logger_, "Live updates send data");
+            const auto& filtered_update = update->filtered(kvb_filter->getClientId(), filter_update);
             auto correlation_id = filtered_update.correlation_id;
-            if (update.parent_span) {
-              sendData(stream, filtered_update, {*update.parent_span});
+            if (block_update.parent_span) {
+              sendData(stream, filtered_update, {*block_update.parent_span});
             } else {
               std::string propagated_span_context;
 #ifdef USE_OPENTRACING
@@ -422,9 +441,11 @@ class ThinReplicaImpl {
             }
           } else if constexpr (std::is_same<DataT, com::vmware::concord::thin_replica::Hash>()) {
             LOG_DEBUG(logger_, "Live updates send hash");
-            sendHash(stream, update.block_id, kvb_filter->hashUpdate(filtered_update));
+            sendHash(stream,
+                     block_update.block_id,
+                     update->hash(kvb_filter->getClientId(), filter_update, &kvbc::KvbAppFilter::hashUpdate));
           }
-          metrics_.last_sent_block_id.Get().Set(update.block_id);
+          metrics_.last_sent_block_id.Get().Set(block_update.block_id);
           if (++update_aggregator_counter == config_->update_metrics_aggregator_thresh) {
             metrics_.updateAggregator();
             update_aggregator_counter = 0;
@@ -484,7 +505,10 @@ class ThinReplicaImpl {
     }
 
     // Read, filter, and send live updates
-    SubEventGroupUpdate sub_eg_update;
+    SubEventGroupUpdatePtr sub_eg_update;
+    const auto filter_eg_update = [&kvb_filter](const SubEventGroupUpdate& u) {
+      return kvb_filter->filterEventGroupUpdate(u);
+    };
     try {
       while (not context->IsCancelled()) {
         metrics_.queue_size.Get().Set(live_updates->SizeEventGroupQueue());
@@ -496,33 +520,30 @@ class ThinReplicaImpl {
         const auto& [last_ext_eg_id_read, last_global_eg_id_read] = kvb_filter->getLastEgIdsRead();
         // Event group read from live update queue should always be greater than last global event group ID read and
         // sent
-        ConcordAssertGT(sub_eg_update.event_group_id, last_global_eg_id_read);
-
-        auto eg_update = kvbc::EgUpdate{sub_eg_update.event_group_id, std::move(sub_eg_update.event_group)};
+        const auto& eg_update = sub_eg_update->get();
+        ConcordAssertGT(eg_update.event_group_id, last_global_eg_id_read);
 
         auto next_ext_eg_id = last_ext_eg_id_read + 1;
-        // TODO (Shruti):
-        // We read and filter the first event group for the client from the live update queue twice.
-        // Once in syncAndSendEventGroups() and once here. Do this only once.
-        auto filtered_eg_update = kvb_filter->filterEventGroupUpdate(eg_update);
+        // The filtering result is memoized in the shared update. Hence, the first event group that was filtered in
+        // syncAndSendEventGroups() already is not filtered again.
+        const auto& filtered_eg_update = sub_eg_update->filtered(kvb_filter->getClientId(), filter_eg_update);
         if (!filtered_eg_update) {
           continue;
         }
-        // Overwrite event group ID in the filtered update to external event group ID
+        // Send the filtered update with the external event group ID
         // We don't want to expose the global event group ID to the client
-        filtered_eg_update.value().event_group_id = next_ext_eg_id;
+        const auto& filtered_event_group = filtered_eg_update.value().event_group;
 
         if constexpr (std::is_same<DataT, com::vmware::concord::thin_replica::Data>()) {
-          sendEventGroupData(stream, filtered_eg_update.value(), sub_eg_update.parent_span);
+          sendEventGroupData(stream, next_ext_eg_id, filtered_event_group, eg_update.parent_span);
         } else if constexpr (std::is_same<DataT, com::vmware::concord::thin_replica::Hash>()) {
-          sendEventGroupHash(stream,
-                             filtered_eg_update.value().event_group_id,
-                             kvb_filter->hashEventGroupUpdate(filtered_eg_update.value()));
+          sendEventGroupHash(
+              stream, next_ext_eg_id, kvb_filter->hashEventGroupUpdate(next_ext_eg_id, filtered_event_group));
         }
 
-        kvb_filter->setLastEgIdsRead(next_ext_eg_id, sub_eg_update.event_group_id);
+        kvb_filter->setLastEgIdsRead(next_ext_eg_id, eg_update.event_group_id);
 
-        metrics_.last_sent_event_group_id.Get().Set(filtered_eg_update.value().event_group_id);
+        metrics_.last_sent_event_group_id.Get().Set(next_ext_eg_id);
         if (++update_aggregator_counter == config_->update_metrics_aggregator_thresh) {
           metrics_.updateAggregator();
           update_aggregator_counter = 0;
@@ -699,7 +720,7 @@ class ThinReplicaImpl {
                               kvbc::BlockId start,
                               kvbc::BlockId end,
                               std::shared_ptr<kvbc::KvbAppFilter> kvb_filter) {
-    boost::lockfree::spsc_queue<kvbc::KvbFilteredUpdate> queue{10};
+    boost::lockfree::spsc_queue<kvbc::KvbFilteredUpdate> queue{kCatchUpQueueSize};
     std::atomic_bool close_stream = false;
 
     auto kvb_reader = std::async(std::launch::async,
@@ -746,7 +767,7 @@ class ThinReplicaImpl {
                                          ServerWriterT* stream,
                                          kvbc::EventGroupId start,
                                          std::shared_ptr<kvbc::KvbAppFilter> kvb_filter) {
-    boost::lockfree::spsc_queue<kvbc::KvbFilteredEventGroupUpdate> queue{10};
+    boost::lockfree::spsc_queue<kvbc::KvbFilteredEventGroupUpdate> queue{kCatchUpQueueSize};
     std::atomic_bool close_stream = false;
 
     auto kvb_reader = std::async(std::launch::async,
@@ -917,11 +938,11 @@ class ThinReplicaImpl {
     // If we read updates from KVB that were added to the live updates already
     // then we just need to drop the overlap and return
     ConcordAssertLE(live_updates->oldestBlockId(), end);
-    SubUpdate update;
+    SubUpdatePtr update;
     do {
       live_updates->Pop(update);
-      LOG_DEBUG(logger_, "Sync dropping " << update.block_id);
-    } while (update.block_id < end);
+      LOG_DEBUG(logger_, "Sync dropping " << update->get().block_id);
+    } while (update->get().block_id < end);
   }
 
   // Read from KVB until we are in sync with the live updates. This function
@@ -971,9 +992,9 @@ class ThinReplicaImpl {
       // Drop all live updates with global_eg_id < next_global_eg_id_to_read, because TRS has already read and sent
       // these updates from storage
       if (live_updates->oldestEventGroupId() < next_global_eg_id_to_read) {
-        SubEventGroupUpdate sub_eg_update;
+        SubEventGroupUpdatePtr sub_eg_update;
         live_updates->PopEventGroup(sub_eg_update);
-        LOG_DEBUG(logger_, "Sync dropping " << sub_eg_update.event_group_id);
+        LOG_DEBUG(logger_, "Sync dropping " << sub_eg_update->get().event_group_id);
         is_update_available = false;
         continue;
       }
@@ -984,11 +1005,14 @@ class ThinReplicaImpl {
       // If the oldest live update is not for the requesting client, keep reading from the live update queue
       // until the first relevant live update is reached. Drop all non-relevant live updates read along the way.
       if (live_updates->oldestEventGroupId() == next_global_eg_id_to_read) {
-        auto filtered_eg_update = kvb_filter->filterEventGroupUpdate(live_updates->oldestEventGroup());
+        const auto oldest_eg_update = live_updates->oldestEventGroup();
+        const auto& filtered_eg_update = oldest_eg_update->filtered(
+            kvb_filter->getClientId(),
+            [&kvb_filter](const SubEventGroupUpdate& u) { return kvb_filter->filterEventGroupUpdate(u); });
         if (!filtered_eg_update) {
-          SubEventGroupUpdate sub_eg_update;
+          SubEventGroupUpdatePtr sub_eg_update;
           live_updates->PopEventGroup(sub_eg_update);
-          LOG_DEBUG(logger_, "Sync dropping upon filtering " << sub_eg_update.event_group_id);
+          LOG_DEBUG(logger_, "Sync dropping upon filtering " << sub_eg_update->get().event_group_id);
           num_updates_filtered_out++;
           is_update_available = false;
           next_global_eg_id_to_read += 1;
@@ -1066,16 +1090,24 @@ class ThinReplicaImpl {
   void sendEventGroupData(ServerWriterT* stream,
                           const kvbc::KvbFilteredEventGroupUpdate& eg_update,
                           const std::optional<std::string>& span = std::nullopt) {
+    sendEventGroupData(stream, eg_update.event_group_id, eg_update.event_group, span);
+  }
+
+  template <typename ServerWriterT>
+  void sendEventGroupData(ServerWriterT* stream,
+                          kvbc::EventGroupId event_group_id,
+                          const kvbc::KvbFilteredEventGroupUpdate::EventGroup& event_group,
+                          const std::optional<std::string>& span = std::nullopt) {
     com::vmware::concord::thin_replica::Data data;
-    LOG_DEBUG(logger_, "sendEventGroupData for id " << eg_update.event_group_id);
-    data.mutable_event_group()->set_id(eg_update.event_group_id);
+    LOG_DEBUG(logger_, "sendEventGroupData for id " << event_group_id);
+    data.mutable_event_group()->set_id(event_group_id);
 
-    for (const auto& event : eg_update.event_group.events) {
-      // TODO: Move don't copy.
+    for (const auto& event : event_group.events) {
+      // Live updates are shared by all subscriptions, hence, we cannot move.
       data.mutable_event_group()->add_events(event.data);
     }
     google::protobuf::Timestamp* timestamp = new google::protobuf::Timestamp();
-    TimeUtil::FromString(eg_update.event_group.record_time, timestamp);
+    TimeUtil::FromString(event_group.record_time, timestamp);
     data.mutable_event_group()->set_allocated_record_time(timestamp);
     if (span) {
       data.mutable_event_group()->set_trace_context(*span);
@@ -1148,7 +1180,8 @@ class ThinReplicaImpl {
   std::tuple<grpc::Status, KvbAppFilterPtr> createKvbFilter(ServerContextT* context, const RequestT* request) {
     KvbAppFilterPtr kvb_filter;
     try {
-      kvb_filter = std::make_shared<kvbc::KvbAppFilter>(config_->rostorage, getClientId(context));
+      kvb_filter =
+          std::make_shared<kvbc::KvbAppFilter>(config_->rostorage, getClientId(context), range_hash_cache_, read_pool_);
     } catch (std::exception& error) {
       std::stringstream msg;
       msg << "Failed to set up filter: " << error.what();
@@ -1176,6 +1209,10 @@ class ThinReplicaImpl {
   logging::Logger logger_;
   std::unique_ptr<ThinReplicaServerConfig> config_;
   std::shared_ptr<concordMetrics::Aggregator> aggregator_;
+  // Saved range hash states used by ReadStateHash, shared by all filters
+  std::shared_ptr<kvbc::KvbRangeHashCache> range_hash_cache_{std::make_shared<kvbc::KvbRangeHashCache>()};
+  // Reads and filters historical updates ahead of the subscriptions catching up, shared by all filters
+  std::shared_ptr<concord::util::ThreadPool> read_pool_;
 };
 }  // namespace thin_replica
 }  // namespace concord
@@ -13,84 +13,248 @@
 
 #include "thin-replica-server/replica_state_snapshot_service_impl.hpp"
 
+#include "categorization/details.h"
 #include "Logger.hpp"
 #include "rocksdb/native_client.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <future>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 namespace concord::thin_replica {
 
+using vmware::concord::replicastatesnapshot::GetSnapshotShardsRequest;
+using vmware::concord::replicastatesnapshot::GetSnapshotShardsResponse;
 using vmware::concord::replicastatesnapshot::StreamSnapshotRequest;
 using vmware::concord::replicastatesnapshot::StreamSnapshotResponse;
 
 using bftEngine::impl::DbCheckpointManager;
 using kvbc::categorization::KeyValueBlockchain;
+using kvbc::categorization::PublicStateHashShards;
+using kvbc::categorization::StateHash;
+using kvbc::categorization::detail::deserialize;
 using storage::rocksdb::NativeClient;
 
+namespace {
+
+// A bounded queue of responses, filled by the thread reading the snapshot and drained by the gRPC writer.
+class ResponseQueue {
+ public:
+  explicit ResponseQueue(std::size_t capacity) : capacity_{capacity} {}
+
+  // Blocks while the queue is full. Returns false if the queue has been closed.
+  bool push(StreamSnapshotResponse&& resp) {
+    auto lock = std::unique_lock{mutex_};
+    not_full_.wait(lock, [this]() { return closed_ || queue_.size() < capacity_; });
+    if (closed_) {
+      return false;
+    }
+    queue_.push_back(std::move(resp));
+    not_empty_.notify_one();
+    return true;
+  }
+
+  // Blocks while the queue is empty. Returns std::nullopt if the queue has been closed and there is nothing left in it.
+  std::optional<StreamSnapshotResponse> pop() {
+    auto lock = std::unique_lock{mutex_};
+    not_empty_.wait(lock, [this]() { return closed_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return std::nullopt;
+    }
+    auto resp = std::move(queue_.front());
+    queue_.pop_front();
+    not_full_.notify_one();
+    return resp;
+  }
+
+  // Called by the reader when done and by the writer on failure. Pending responses can still be popped.
+  void close() {
+    auto lock = std::lock_guard{mutex_};
+    closed_ = true;
+    not_full_.notify_all();
+    not_empty_.notify_all();
+  }
+
+ private:
+  const std::size_t capacity_;
+  std::deque<StreamSnapshotResponse> queue_;
+  bool closed_{false};
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+};
+
+}  // namespace
+
+ReplicaStateSnapshotServiceImpl::ReplicaStateSnapshotServiceImpl()
+    : metrics_component_{"ReplicaStateSnapshotService", std::make_shared<concordMetrics::Aggregator>()},
+      streamed_key_values_{metrics_component_.RegisterShardedCounter("streamed_key_values")},
+      streamed_bytes_{metrics_component_.RegisterShardedCounter("streamed_bytes")},
+      key_values_per_sec_{metrics_component_.RegisterAtomicGauge("key_values_per_sec", 0)},
+      bytes_per_sec_{metrics_component_.RegisterAtomicGauge("bytes_per_sec", 0)} {
+  metrics_component_.Register();
+}
+
+void ReplicaStateSnapshotServiceImpl::setAggregator(const std::shared_ptr<concordMetrics::Aggregator>& aggregator) {
+  auto lock = std::lock_guard{metrics_mutex_};
+  metrics_component_.SetAggregator(aggregator);
+}
+
+void ReplicaStateSnapshotServiceImpl::updateThroughput(std::chrono::steady_clock::time_point start,
+                                                       std::uint64_t key_values,
+                                                       std::uint64_t bytes) {
+  const auto elapsed_ms = std::max<std::uint64_t>(
+      1, std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+  auto lock = std::lock_guard{metrics_mutex_};
+  key_values_per_sec_.Get().Set(key_values * 1000 / elapsed_ms);
+  bytes_per_sec_.Get().Set(bytes * 1000 / elapsed_ms);
+  metrics_component_.UpdateAggregator();
+}
+
+std::optional<grpc::Status> ReplicaStateSnapshotServiceImpl::checkSnapshot(std::uint64_t snapshot_id) const {
+  if (overriden_path_for_test_.has_value()) {
+    return std::nullopt;
+  }
+  const auto snapshot_id_str = std::to_string(snapshot_id);
+  const auto checkpoint_state = overriden_checkpoint_state_for_test_.has_value()
+                                    ? *overriden_checkpoint_state_for_test_
+                                    : DbCheckpointManager::instance().getCheckpointState(snapshot_id);
+  switch (checkpoint_state) {
+    case DbCheckpointManager::CheckpointState::kNonExistent: {
+      const auto msg = "State Snapshot ID = " + snapshot_id_str + " doesn't exist";
+      LOG_INFO(STATE_SNAPSHOT, msg);
+      return grpc::Status{grpc::StatusCode::NOT_FOUND, msg};
+    }
+    case DbCheckpointManager::CheckpointState::kPending: {
+      const auto msg = "State Snapshot ID = " + snapshot_id_str + " is pending creation";
+      LOG_INFO(STATE_SNAPSHOT, msg);
+      return grpc::Status{grpc::StatusCode::UNAVAILABLE, msg};
+    }
+    case DbCheckpointManager::CheckpointState::kCreated:
+      break;
+  }
+  return std::nullopt;
+}
+
+std::string ReplicaStateSnapshotServiceImpl::snapshotPath(std::uint64_t snapshot_id) const {
+  return overriden_path_for_test_.has_value() ? *overriden_path_for_test_
+                                              : DbCheckpointManager::instance().getPathForCheckpoint(snapshot_id);
+}
+
 grpc::Status ReplicaStateSnapshotServiceImpl::StreamSnapshot(grpc::ServerContext* context,
                                                              const StreamSnapshotRequest* request,
                                                              grpc::ServerWriter<StreamSnapshotResponse>* writer) {
   const auto snapshot_id_str = std::to_string(request->snapshot_id());
-  if (!overriden_path_for_test_.has_value()) {
-    const auto checkpoint_state = overriden_checkpoint_state_for_test_.has_value()
-                                      ? *overriden_checkpoint_state_for_test_
-                                      : DbCheckpointManager::instance().getCheckpointState(request->snapshot_id());
-    switch (checkpoint_state) {
-      case DbCheckpointManager::CheckpointState::kNonExistent: {
-        const auto msg = "State Snapshot ID = " + snapshot_id_str + " doesn't exist";
-        LOG_INFO(STATE_SNAPSHOT, msg);
-        return grpc::Status{grpc::StatusCode::NOT_FOUND, msg};
-      }
-      case DbCheckpointManager::CheckpointState::kPending: {
-        const auto msg = "State Snapshot ID = " + snapshot_id_str + " is pending creation";
-        LOG_INFO(STATE_SNAPSHOT, msg);
-        return grpc::Status{grpc::StatusCode::UNAVAILABLE, msg};
-      }
-      case DbCheckpointManager::CheckpointState::kCreated:
-        LOG_INFO(STATE_SNAPSHOT, "Starting streaming of State Snapshot ID = " + snapshot_id_str);
-        break;
-    }
+  if (auto status = checkSnapshot(request->snapshot_id())) {
+    return *status;
   }
+  LOG_INFO(STATE_SNAPSHOT, "Starting streaming of State Snapshot ID = " + snapshot_id_str);
 
   try {
     if (throw_exception_for_test_) {
       throw std::runtime_error{"test exception - only thrown in tests"};
     }
 
-    const auto snapshot_path = overriden_path_for_test_.has_value()
-                                   ? *overriden_path_for_test_
-                                   : DbCheckpointManager::instance().getPathForCheckpoint(request->snapshot_id());
     const auto link_st_chain = false;
     const auto read_only = true;
-    auto db = NativeClient::newClient(snapshot_path, read_only, NativeClient::DefaultOptions{});
+    auto db = NativeClient::newClient(snapshotPath(request->snapshot_id()), read_only, NativeClient::DefaultOptions{});
     const auto kvbc = KeyValueBlockchain{db, link_st_chain};
 
-    const auto iterate = [&](std::string&& key, std::string&& value) {
+    const auto batched = request->has_max_response_size();
+    const auto max_response_size = std::min(request->max_response_size(), kMaxResponseSize);
+
+    // Read and convert the key-values on a separate thread, while this one writes them to the client.
+    auto queue = ResponseQueue{kMaxQueuedResponses};
+    auto reader = std::async(std::launch::async, [&]() {
       auto resp = StreamSnapshotResponse{};
-      auto kv = resp.mutable_key_value();
-      auto resp_key = kv->mutable_key();
-      auto resp_value = kv->mutable_value();
-      *resp_key = std::move(key);
-      *resp_value = state_value_converter_(std::move(value));
-      if (!writer->Write(resp)) {
+      auto resp_size = std::size_t{0};
+      const auto push = [&]() {
+        if (!queue.push(std::move(resp))) {
+          throw std::runtime_error{"the gRPC writer stopped"};
+        }
+        resp = StreamSnapshotResponse{};
+        resp_size = 0;
+      };
+
+      const auto iterate = [&](std::string&& key, std::string&& value) {
+        auto converted = state_value_converter_(std::move(value));
+        const auto kv_size = key.size() + converted.size();
+        if (resp.key_values_size() > 0 && resp_size + kv_size > max_response_size) {
+          push();
+        }
+        auto kv = batched ? resp.add_key_values() : resp.mutable_key_value();
+        *kv->mutable_key() = std::move(key);
+        *kv->mutable_value() = std::move(converted);
+        resp_size += kv_size;
+        if (!batched) {
+          push();
+        }
+      };
+
+      try {
+        auto found = true;
+        if (request->has_last_key()) {
+          const auto after_key = request->has_last_received_key()
+                                     ? std::make_optional(request->last_received_key())
+                                     : std::optional<std::string>{};
+          found = kvbc.iteratePublicStateKeyValues(iterate, after_key, request->last_key());
+        } else if (request->has_last_received_key()) {
+          found = kvbc.iteratePublicStateKeyValues(iterate, request->last_received_key());
+        } else {
+          kvbc.iteratePublicStateKeyValues(iterate);
+        }
+        if (resp.key_values_size() > 0) {
+          push();
+        }
+        queue.close();
+        return found;
+      } catch (...) {
+        queue.close();
+        throw;
+      }
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    auto last_update = start;
+    auto key_values = std::uint64_t{0};
+    auto bytes = std::uint64_t{0};
+    while (auto resp = queue.pop()) {
+      if (!writer->Write(*resp)) {
+        queue.close();
+        reader.wait();
         const auto err =
             "Streaming of State Snapshot ID = " + snapshot_id_str + " failed, reason = gRPC:Write() failure";
         LOG_ERROR(STATE_SNAPSHOT, err);
         throw std::runtime_error{err};
       }
-    };
-
-    if (request->has_last_received_key()) {
-      if (!kvbc.iteratePublicStateKeyValues(iterate, request->last_received_key())) {
-        const auto msg =
-            "Streaming of State Snapshot ID = " + snapshot_id_str + " failed, reason = last_received_key not found";
-        LOG_INFO(STATE_SNAPSHOT, msg);
-        return grpc::Status{grpc::StatusCode::INVALID_ARGUMENT, msg};
+      const auto resp_key_values = batched ? resp->key_values_size() : 1;
+      const auto resp_bytes = resp->ByteSizeLong();
+      key_values += resp_key_values;
+      bytes += resp_bytes;
+      streamed_key_values_ += resp_key_values;
+      streamed_bytes_ += resp_bytes;
+      const auto now = std::chrono::steady_clock::now();
+      if (now - last_update >= std::chrono::seconds{1}) {
+        updateThroughput(start, key_values, bytes);
+        last_update = now;
       }
-    } else {
-      kvbc.iteratePublicStateKeyValues(iterate);
     }
+
+    // Rethrows the exception of the reader, if any.
+    if (!reader.get()) {
+      const auto msg =
+          "Streaming of State Snapshot ID = " + snapshot_id_str + " failed, reason = last_received_key not found";
+      LOG_INFO(STATE_SNAPSHOT, msg);
+      return grpc::Status{grpc::StatusCode::INVALID_ARGUMENT, msg};
+    }
+    updateThroughput(start, key_values, bytes);
+    LOG_INFO(STATE_SNAPSHOT,
+             "Streamed " << key_values << " key-values (" << bytes << " bytes) of State Snapshot ID = "
+                         << snapshot_id_str);
   } catch (const std::exception& e) {
     const auto err = "Streaming of State Snapshot ID = " + snapshot_id_str + " failed, reason = " + e.what();
     LOG_ERROR(STATE_SNAPSHOT, err);
@@ -102,4 +266,75 @@ grpc::Status ReplicaStateSnapshotServiceImpl::StreamSnapshot(grpc::ServerContext
   return grpc::Status{grpc::StatusCode::OK, success_msg};
 }
 
+grpc::Status ReplicaStateSnapshotServiceImpl::GetSnapshotShards(grpc::ServerContext* context,
+                                                                const GetSnapshotShardsRequest* request,
+                                                                GetSnapshotShardsResponse* response) {
+  const auto snapshot_id_str = std::to_string(request->snapshot_id());
+  if (auto status = checkSnapshot(request->snapshot_id())) {
+    return *status;
+  }
+
+  try {
+    if (throw_exception_for_test_) {
+      throw std::runtime_error{"test exception - only thrown in tests"};
+    }
+
+    const auto read_only = true;
+    auto db = NativeClient::newClient(snapshotPath(request->snapshot_id()), read_only, NativeClient::DefaultOptions{});
+    const auto ser_state_hash = db->get(KeyValueBlockchain::publicStateHashKey());
+    if (!ser_state_hash) {
+      const auto msg = "State Snapshot ID = " + snapshot_id_str + " has no public state hash yet";
+      LOG_INFO(STATE_SNAPSHOT, msg);
+      return grpc::Status{grpc::StatusCode::UNAVAILABLE, msg};
+    }
+    auto state_hash = StateHash{};
+    deserialize(*ser_state_hash, state_hash);
+    auto shards = PublicStateHashShards{};
+    if (const auto ser_shards = db->get(KeyValueBlockchain::publicStateHashShardsKey())) {
+      deserialize(*ser_shards, shards);
+    }
+
+    const auto num_shards = shards.sizes.size();
+    if (num_shards == 0 || shards.block_id != state_hash.block_id) {
+      // Either there are no public keys or the snapshot was created without shards - serve it as a single shard.
+      const auto link_st_chain = false;
+      const auto blockchain = KeyValueBlockchain{db, link_st_chain};
+      const auto initial_hash = kvbc::categorization::detail::hash(std::string{});
+      auto shard = response->add_shards();
+      shard->set_num_key_values(blockchain.getPublicStateKeyStore().size());
+      shard->set_start_hash(initial_hash.data(), initial_hash.size());
+      shard->set_end_hash(state_hash.hash.data(), state_hash.hash.size());
+    } else {
+      // Merge consecutive shards if there are too many
+      const auto max_shards = request->max_shards() == 0 ? num_shards : request->max_shards();
+      const auto group_size = (num_shards + max_shards - 1) / max_shards;
+      for (auto first = std::size_t{0}; first < num_shards; first += group_size) {
+        const auto last = std::min(first + group_size, num_shards) - 1;
+        auto shard = response->add_shards();
+        if (first > 0) {
+          shard->set_after_key(shards.last_keys[first - 1]);
+        }
+        shard->set_last_key(shards.last_keys[last]);
+        auto num_key_values = std::uint64_t{0};
+        for (auto i = first; i <= last; ++i) {
+          num_key_values += shards.sizes[i];
+        }
+        shard->set_num_key_values(num_key_values);
+        const auto& start_hash = shards.start_hashes[first];
+        const auto& end_hash = (last + 1 < num_shards) ? shards.start_hashes[last + 1] : state_hash.hash;
+        shard->set_start_hash(start_hash.data(), start_hash.size());
+        shard->set_end_hash(end_hash.data(), end_hash.size());
+      }
+    }
+  } catch (const std::exception& e) {
+    const auto err = "Getting the shards of State Snapshot ID = " + snapshot_id_str + " failed, reason = " + e.what();
+    LOG_ERROR(STATE_SNAPSHOT, err);
+    return grpc::Status{grpc::StatusCode::UNKNOWN, err};
+  }
+
+  LOG_INFO(STATE_SNAPSHOT,
+           "Returning " << response->shards_size() << " shards of State Snapshot ID = " << snapshot_id_str);
+  return grpc::Status::OK;
+}
+
 }  // namespace concord::thin_replica
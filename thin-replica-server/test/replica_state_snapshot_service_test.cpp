@@ -17,6 +17,7 @@
 #include "categorization/db_categories.h"
 #include "categorization/kv_blockchain.h"
 #include "kvbc_key_types.hpp"
+#include "ReplicaConfig.hpp"
 #include "storage/test/storage_test_common.h"
 #include "thin-replica-server/replica_state_snapshot_service_impl.hpp"
 
@@ -46,7 +47,10 @@ using grpc::CreateChannel;
 using grpc::Server;
 using grpc::ServerBuilder;
 using grpc::StatusCode;
+using vmware::concord::replicastatesnapshot::GetSnapshotShardsRequest;
+using vmware::concord::replicastatesnapshot::GetSnapshotShardsResponse;
 using vmware::concord::replicastatesnapshot::ReplicaStateSnapshotService;
+using vmware::concord::replicastatesnapshot::SnapshotShard;
 using vmware::concord::replicastatesnapshot::StreamSnapshotRequest;
 using vmware::concord::replicastatesnapshot::StreamSnapshotResponse;
 
@@ -103,6 +107,33 @@ class replica_state_snapshot_service_test : public Test {
     ASSERT_EQ(kvbc_->addBlock(std::move(updates)), 1);
   }
 
+  // Streams the key-values of a shard and returns them if their hash chain matches the hashes of the shard.
+  std::vector<std::pair<std::string, std::string>> streamShard(const SnapshotShard& shard) {
+    auto context = ClientContext{};
+    auto request = StreamSnapshotRequest{};
+    request.set_snapshot_id(42);
+    if (shard.has_after_key()) {
+      request.set_last_received_key(shard.after_key());
+    }
+    if (shard.has_last_key()) {
+      request.set_last_key(shard.last_key());
+    }
+    auto response = StreamSnapshotResponse{};
+    auto reader = std::unique_ptr<ClientReader<StreamSnapshotResponse>>{stub_->StreamSnapshot(&context, request)};
+    auto kvs = std::vector<std::pair<std::string, std::string>>{};
+    auto hash = Hash{};
+    EXPECT_EQ(shard.start_hash().size(), hash.size());
+    std::copy(shard.start_hash().cbegin(), shard.start_hash().cend(), hash.begin());
+    while (reader->Read(&response)) {
+      kvs.push_back(std::make_pair(response.key_value().key(), response.key_value().value()));
+      hash = KeyValueBlockchain::nextPublicStateHash(hash, kvs.back().first, kvs.back().second);
+    }
+    EXPECT_EQ(reader->Finish().error_code(), StatusCode::OK);
+    EXPECT_EQ(kvs.size(), shard.num_key_values());
+    EXPECT_EQ(std::string(hash.cbegin(), hash.cend()), shard.end_hash());
+    return kvs;
+  }
+
  protected:
   const std::string grpc_uri_{"127.0.0.1:50051"};
   std::shared_ptr<NativeClient> db_;
@@ -207,6 +238,94 @@ TEST_F(replica_state_snapshot_service_test, invalid_last_received_key) {
   ASSERT_TRUE(kvs.empty());
 }
 
+TEST_F(replica_state_snapshot_service_test, batched_key_values) {
+  addPublicState();
+  auto aggregator = std::make_shared<concordMetrics::Aggregator>();
+  service_.setAggregator(aggregator);
+  service_.overrideCheckpointPathForTest(db_->path());
+  startServer();
+  auto context = ClientContext{};
+  auto request = StreamSnapshotRequest{};
+  request.set_snapshot_id(42);  // ignored, because we override the DB path and, hence, the DbCheckpointManager
+  request.set_last_received_key("a");
+  // Room for 2 key-values of 3 bytes each
+  request.set_max_response_size(7);
+  auto response = StreamSnapshotResponse{};
+  auto reader = std::unique_ptr<ClientReader<StreamSnapshotResponse>>{stub_->StreamSnapshot(&context, request)};
+  auto batches = std::vector<std::vector<std::pair<std::string, std::string>>>{};
+  while (reader->Read(&response)) {
+    ASSERT_FALSE(response.has_key_value());
+    auto& batch = batches.emplace_back();
+    for (const auto& kv : response.key_values()) {
+      batch.push_back(std::make_pair(kv.key(), kv.value()));
+    }
+  }
+  const auto status = reader->Finish();
+  ASSERT_EQ(status.error_code(), StatusCode::OK);
+  ASSERT_THAT(batches,
+              ContainerEq(std::vector<std::vector<std::pair<std::string, std::string>>>{{{"b", "vb"}, {"c", "vc"}},
+                                                                                         {{"d", "vd"}}}));
+  ASSERT_EQ(aggregator->GetCounter("ReplicaStateSnapshotService", "streamed_key_values").Get(), 3);
+  ASSERT_GT(aggregator->GetCounter("ReplicaStateSnapshotService", "streamed_bytes").Get(), 9);
+}
+
+TEST_F(replica_state_snapshot_service_test, stream_shards) {
+  addPublicState();
+  // A shard per key
+  bftEngine::ReplicaConfig::instance().numOfStateSnapshotShards = 4;
+  kvbc_->computeAndPersistPublicStateHash(1, KeyValueBlockchain::kNoopConverter);
+  bftEngine::ReplicaConfig::instance().numOfStateSnapshotShards = 64;
+  service_.overrideCheckpointPathForTest(db_->path());
+  startServer();
+  auto context = ClientContext{};
+  auto request = GetSnapshotShardsRequest{};
+  request.set_snapshot_id(42);  // ignored, because we override the DB path and, hence, the DbCheckpointManager
+  request.set_max_shards(3);
+  auto response = GetSnapshotShardsResponse{};
+  ASSERT_TRUE(stub_->GetSnapshotShards(&context, request, &response).ok());
+  // Merged in pairs
+  ASSERT_EQ(response.shards_size(), 2);
+  ASSERT_FALSE(response.shards(0).has_after_key());
+  ASSERT_EQ(response.shards(0).last_key(), "b");
+  ASSERT_EQ(response.shards(1).after_key(), "b");
+  ASSERT_EQ(response.shards(1).last_key(), "d");
+  ASSERT_EQ(response.shards(0).end_hash(), response.shards(1).start_hash());
+  ASSERT_THAT(streamShard(response.shards(0)),
+              ContainerEq(std::vector<std::pair<std::string, std::string>>{{"a", "va"}, {"b", "vb"}}));
+  ASSERT_THAT(streamShard(response.shards(1)),
+              ContainerEq(std::vector<std::pair<std::string, std::string>>{{"c", "vc"}, {"d", "vd"}}));
+}
+
+TEST_F(replica_state_snapshot_service_test, snapshot_without_shards) {
+  addPublicState();
+  kvbc_->computeAndPersistPublicStateHash(1, KeyValueBlockchain::kNoopConverter);
+  db_->del(KeyValueBlockchain::publicStateHashShardsKey());
+  service_.overrideCheckpointPathForTest(db_->path());
+  startServer();
+  auto context = ClientContext{};
+  auto request = GetSnapshotShardsRequest{};
+  request.set_snapshot_id(42);  // ignored, because we override the DB path and, hence, the DbCheckpointManager
+  auto response = GetSnapshotShardsResponse{};
+  ASSERT_TRUE(stub_->GetSnapshotShards(&context, request, &response).ok());
+  ASSERT_EQ(response.shards_size(), 1);
+  ASSERT_FALSE(response.shards(0).has_after_key());
+  ASSERT_FALSE(response.shards(0).has_last_key());
+  ASSERT_THAT(streamShard(response.shards(0)),
+              ContainerEq(std::vector<std::pair<std::string, std::string>>{
+                  {"a", "va"}, {"b", "vb"}, {"c", "vc"}, {"d", "vd"}}));
+}
+
+TEST_F(replica_state_snapshot_service_test, shards_without_public_state_hash) {
+  addPublicState();
+  service_.overrideCheckpointPathForTest(db_->path());
+  startServer();
+  auto context = ClientContext{};
+  auto request = GetSnapshotShardsRequest{};
+  request.set_snapshot_id(42);  // ignored, because we override the DB path and, hence, the DbCheckpointManager
+  auto response = GetSnapshotShardsResponse{};
+  ASSERT_EQ(stub_->GetSnapshotShards(&context, request, &response).error_code(), StatusCode::UNAVAILABLE);
+}
+
 TEST_F(replica_state_snapshot_service_test, pending_checkpoint_creation) {
   addPublicState();
   service_.overrideCheckpointStateForTest(DbCheckpointManager::CheckpointState::kPending);
@@ -233,8 +233,13 @@ class FakeStorage : public concord::kvbc::IReader {
   void multiGetLatest(const std::string& category_id,
                       const std::vector<std::string>& keys,
                       std::vector<std::optional<concord::kvbc::categorization::Value>>& values) const override {
-    ADD_FAILURE() << "multiGetLatest() should not be called by this test";
-    values = {};
+    if (category_id != concord::kvbc::categorization::kExecutionEventGroupTagCategory) {
+      ADD_FAILURE() << "multiGetLatest() should only be called for the tag table by this test";
+    }
+    values.clear();
+    for (const auto& key : keys) {
+      values.push_back(getLatest(category_id, key));
+    }
   }
 
   std::optional<concord::kvbc::categorization::TaggedVersion> getLatestVersion(const std::string& category_id,
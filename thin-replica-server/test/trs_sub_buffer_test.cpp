@@ -33,6 +33,8 @@ using concord::thin_replica::SubBufferList;
 using concord::thin_replica::SubUpdate;
 using concord::thin_replica::SubEventGroupUpdate;
 using concord::thin_replica::SubUpdateBuffer;
+using concord::thin_replica::SubUpdatePtr;
+using concord::thin_replica::SubEventGroupUpdatePtr;
 
 // A producer should be able to "add" updates whether there are consumers or
 // not. Meaning, the producer does not get interrupted/disturbed if no
@@ -284,6 +286,79 @@ TEST(trs_sub_buffer_test, waiting_for_updates) {
   sub_list.updateEventGroupSubBuffers(update_eg);
 }
 
+// All subscribers reference the same update instead of getting their own copy.
+TEST(trs_sub_buffer_test, consumers_share_update) {
+  SubBufferList sub_list;
+  ImmutableInput input;
+  ImmutableValueUpdate val;
+  val.data = "value";
+  input.kv = {{"key", val}};
+  auto updates1 = std::make_shared<SubUpdateBuffer>(10);
+  auto updates2 = std::make_shared<SubUpdateBuffer>(10);
+  sub_list.addBuffer(updates1);
+  sub_list.addBuffer(updates2);
+
+  sub_list.updateSubBuffers(SubUpdate{1337, "CID", input});
+  EventGroup event_group;
+  Event event;
+  event.data = "value";
+  event_group.events.emplace_back(event);
+  sub_list.updateEventGroupSubBuffers(SubEventGroupUpdate{1338, event_group});
+
+  SubUpdatePtr out1, out2;
+  updates1->Pop(out1);
+  updates2->Pop(out2);
+  ASSERT_EQ(out1, out2);
+  ASSERT_EQ(out1->get().block_id, 1337);
+  ASSERT_EQ(out1->get().immutable_kv_pairs.kv.at("key").data, "value");
+
+  SubEventGroupUpdatePtr out_eg1, out_eg2;
+  updates1->PopEventGroup(out_eg1);
+  updates2->PopEventGroup(out_eg2);
+  ASSERT_EQ(out_eg1, out_eg2);
+  ASSERT_EQ(out_eg1->get().event_group_id, 1338);
+}
+
+// Filtering and hashing results are computed once per client id.
+TEST(trs_sub_buffer_test, memoized_per_client) {
+  SubBufferList sub_list;
+  std::list<std::shared_ptr<SubUpdateBuffer>> sub_buffers;
+  for (int i = 0; i < 8; ++i) {
+    sub_buffers.push_back(std::make_shared<SubUpdateBuffer>(10));
+    sub_list.addBuffer(sub_buffers.back());
+  }
+  sub_list.updateSubBuffers(SubUpdate{1337, "CID", ImmutableInput{}});
+
+  std::atomic_int num_filtered{0};
+  std::atomic_int num_hashed{0};
+  auto filter = [&](const SubUpdate& update) {
+    ++num_filtered;
+    return concord::kvbc::KvbFilteredUpdate{update.block_id, update.correlation_id, {}};
+  };
+  auto hash = [&](const concord::kvbc::KvbFilteredUpdate& update) {
+    ++num_hashed;
+    return std::to_string(update.block_id);
+  };
+
+  std::list<std::future<void>> readers;
+  int i = 0;
+  for (auto& buffer : sub_buffers) {
+    // Two client ids across all subscribers
+    const auto client_id = std::string{"client"} + std::to_string(i++ % 2);
+    readers.push_back(std::async(std::launch::async, [&, buffer, client_id] {
+      SubUpdatePtr update;
+      buffer->Pop(update);
+      ASSERT_EQ(update->filtered(client_id, filter).block_id, 1337);
+      ASSERT_EQ(update->hash(client_id, filter, hash), "1337");
+    }));
+  }
+  for (auto& reader : readers) {
+    reader.get();
+  }
+  ASSERT_EQ(num_filtered, 2);
+  ASSERT_EQ(num_hashed, 2);
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -85,6 +85,20 @@ class ThresholdAccumulatorBase : public IThresholdAccumulator {
    */
   virtual bool verifyShare(ShareID id, const NumType& sigShare) = 0;
 
+  /**
+   * Called by verifyPendingShares() to verify a batch of pending shares. Returns the IDs of the invalid ones.
+   *
+   * By default, verifies the shares one by one via verifyShare(). BLS accumulators override this to verify the
+   * whole batch at once.
+   */
+  virtual std::vector<ShareID> findInvalidPendingShares(const std::vector<ShareID>& ids) {
+    std::vector<ShareID> invalid;
+    for (auto id : ids) {
+      if (!verifyShare(id, pendingShares[static_cast<size_t>(id)])) invalid.push_back(id);
+    }
+    return invalid;
+  }
+
   /**
    * Called after the share is verified succesfully if share verification is enabled, or called after the unverified
    * share is added otherwise.
@@ -87,6 +87,13 @@ class BlsAccumulatorBase : public ThresholdAccumulatorBase<BlsPublicKey, G1T, Bl
    */
   virtual bool verifyShare(ShareID id, const G1T& sigShare);
 
+  /**
+   * Verifies the shares with a single pairing check over their randomly weighted aggregate (see BlsBatchVerifier).
+   * If that fails, bisects the batch to locate the invalid shares, which takes O(b log n) pairings for b invalid
+   * shares out of n, rather than the n pairing checks of verifying the shares one by one.
+   */
+  std::vector<ShareID> findInvalidPendingShares(const std::vector<ShareID>& ids) override;
+
   /**
    * Simply maps the message/digest to the group G1, storing it in 'hash.'
    * Automagically called when setExpectedDigest() is called on the accumulator.
@@ -57,6 +57,9 @@ class BlsThresholdAccumulator : public BlsAccumulatorBase {
   // Used internally, by benchmarks and by subclasses
  public:
   /**
+   * Fetches the Lagrange coefficients of the current set of signers from a process-wide cache of recently used signer
+   * sets, computing them on a miss.
+   *
    * NOTE: Must be virtual because BlsAlmostMultisigAccumulator overrides this to fetch precomputed Lagrange coeffs.
    */
   virtual void computeLagrangeCoeff();
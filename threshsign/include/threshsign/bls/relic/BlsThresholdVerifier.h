@@ -51,7 +51,7 @@ class BlsThresholdVerifier : public IThresholdVerifier {
    */
   NumSharesType getNumRequiredShares() const { return reqSigners_; }
   NumSharesType getNumTotalShares() const { return numSigners_; }
-  std::vector<BlsPublicKey> getPublicKeysVector() const { return publicKeysVector_; }
+  const std::vector<BlsPublicKey> &getPublicKeysVector() const { return publicKeysVector_; }
   const BlsPublicParameters &getParams() const { return params_; }
   const BlsPublicKey getKey() const { return publicKey_; }
   /**
@@ -1,6 +1,7 @@
 
 #include "threshsign/ThresholdAccumulatorBase.h"
 
+#include <algorithm>
 #include <utility>
 #include <cstring>
 
@@ -64,22 +65,31 @@ void ThresholdAccumulatorBase<VerificationKey, NumType, SigShareParserFunc>::ver
   assertTrue(hasExpectedDigest());
   assertEqual(validSharesBits.count(), 0);
 
-  for (ShareID id = pendingSharesBits.first(); pendingSharesBits.isEnd(id) == false; id = pendingSharesBits.next(id)) {
-    // We have to stop if we reach required threshold number of signers
-    if (validSharesBits.count() == reqSigners) break;
+  // We verify just as many shares as still needed to reach the required threshold number of signers, all at once.
+  // The invalid ones get replaced by the next batch of pending shares.
+  ShareID id = pendingSharesBits.first();
+  while (validSharesBits.count() < reqSigners && pendingSharesBits.isEnd(id) == false) {
+    std::vector<ShareID> batch;
+    const auto needed = static_cast<size_t>(reqSigners - validSharesBits.count());
+    for (; batch.size() < needed && pendingSharesBits.isEnd(id) == false; id = pendingSharesBits.next(id)) {
+      batch.push_back(id);
+    }
+    const std::vector<ShareID> invalid = findInvalidPendingShares(batch);
 
-    // Get the share pending for this signer
-    size_t idx = static_cast<size_t>(id);
-    NumType& sigShare = pendingShares[idx];
+    for (ShareID batchId : batch) {
+      // Get the share pending for this signer
+      size_t idx = static_cast<size_t>(batchId);
+      NumType& sigShare = pendingShares[idx];
 
-    // Is it a valid share? If so mark it as valid.
-    if (verifyShare(id, sigShare)) {
-      validShares[idx] = sigShare;
-      validSharesBits.add(id);  // If already added, not a problem.
-      LOG_TRACE(THRESHSIGN_LOG, "Moved validated share by signer " << id);
-    } else {
-      invalidShares.insert(id);
-      LOG_WARN(THRESHSIGN_LOG, "Invalid share by signer " << id << " detected: " << sigShare);
+      // Is it a valid share? If so mark it as valid.
+      if (std::find(invalid.begin(), invalid.end(), batchId) == invalid.end()) {
+        validShares[idx] = sigShare;
+        validSharesBits.add(batchId);  // If already added, not a problem.
+        LOG_TRACE(THRESHSIGN_LOG, "Moved validated share by signer " << batchId);
+      } else {
+        invalidShares.insert(batchId);
+        LOG_WARN(THRESHSIGN_LOG, "Invalid share by signer " << batchId << " detected: " << sigShare);
+      }
     }
   }
   pendingShares.clear();
@@ -19,6 +19,7 @@
 #include "threshsign/bls/relic/FastMultExp.h"
 
 #include "BlsAlmostMultisigCoefficients.h"
+#include "BlsBatchVerifier.h"
 #include "LagrangeInterpolation.h"
 
 #include <vector>
@@ -83,5 +84,27 @@ bool BlsAccumulatorBase::verifyShare(ShareID id, const G1T& sigShare) {
   }
 }
 
+std::vector<ShareID> BlsAccumulatorBase::findInvalidPendingShares(const std::vector<ShareID>& ids) {
+  assertTrue(hasExpectedDigest());
+  // A single share is verified as fast on its own
+  if (ids.size() < 2) return ThresholdAccumulatorBase::findInvalidPendingShares(ids);
+
+  // Small random weights are enough to prevent invalid shares from cancelling each other out, and are much cheaper
+  // to exponentiate by than full-size ones
+  constexpr int kWeightBits = 64;
+  BlsBatchVerifier batch(vks, gen2, static_cast<int>(ids.size()));
+  BNT weight;
+  for (ShareID id : ids) {
+    assertInclusiveRange(1, id, totalSigners);
+    do {
+      weight.Random(kWeightBits);
+    } while (weight == BNT(0));
+    batch.addWeightedShare(id, pendingShares[static_cast<size_t>(id)], weight);
+  }
+  std::vector<ShareID> invalid;
+  batch.batchVerify(hash, true, invalid, true);
+  return invalid;
+}
+
 } /* namespace Relic */
 } /* namespace BLS */
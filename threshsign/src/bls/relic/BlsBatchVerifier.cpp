@@ -22,15 +22,23 @@ namespace BLS {
 namespace Relic {
 
 BlsBatchVerifier::BlsBatchVerifier(const BlsThresholdVerifier& ver, int maxShares)
-    : ver(ver),
-      fieldOrder(ver.getParams().getGroupOrder()),
+    : BlsBatchVerifier(ver.getPublicKeysVector(), ver.getParams().getGenerator2(), maxShares) {}
+
+BlsBatchVerifier::BlsBatchVerifier(const std::vector<BlsPublicKey>& vks, const G2T& gen2, int maxShares)
+    : vks(vks),
+      gen2(gen2),
       aggTree(maxShares),  // the max # of leafs in the aggregation tree
       isAggregated(false) {}
 
 BlsBatchVerifier::~BlsBatchVerifier() {}
 
+void BlsBatchVerifier::addWeightedShare(ShareID id, const G1T& sigShare, const BNT& weight) {
+  const G2T& vk = vks.at(static_cast<size_t>(id)).getPoint();
+  aggTree.appendLeaf(Share(id, G1T::Times(sigShare, weight), G2T::Times(vk, weight)));
+}
+
 void BlsBatchVerifier::addShare(ShareID id, const G1T& sigShare) {
-  const G2T& vk = checked_ref_cast<const BlsPublicKey&>(ver.getShareVerificationKey(id)).getPoint();
+  const G2T& vk = vks.at(static_cast<size_t>(id)).getPoint();
 
   // MAYDO: We could start aggregating incrementally after a leaf is appended
   // (powers of two + finish it off in batchVerify()). Make sure aggregate() still works incrementally.
@@ -45,7 +53,7 @@ bool BlsBatchVerifier::batchVerify(const G1T& msg, bool wantBadShares, std::vect
   // WARNING: If we ever multi-thread this, then 'shares' needs to be thread-safe. Right now is not, cause we
   // push_back().
   assertEqual(shares.size(), 0);
-  assertLessThanOrEqual(aggTree.getNumLeaves(), ver.getNumTotalShares());
+  assertLessThanOrEqual(static_cast<size_t>(aggTree.getNumLeaves()), vks.size() - 1);
 
   // TODO: use trick of not checking right root if left root is valid but their parent is invalid
   this->msg = msg;
@@ -84,7 +92,7 @@ bool BlsBatchVerifier::batchVerify(const G1T& msg, bool wantBadShares, std::vect
 bool BlsBatchVerifier::batchVerifyRecursive(int node, bool wantBadShares, std::vector<ShareID>& shares) {
   const Share& share = aggTree.getNode(node);
   assertProperty(node, share.isAggregated);
-  bool verified = ver.verify(msg, share.sig, share.vk);
+  bool verified = verify(share.sig, share.vk);
 
   if (verified) {
     LOG_TRACE(BLS_LOG, "Successfully verified node " << node);
@@ -133,5 +141,13 @@ bool BlsBatchVerifier::batchVerifyRecursive(int node, bool wantBadShares, std::v
   }
 }
 
+bool BlsBatchVerifier::verify(const G1T& sig, const G2T& vk) const {
+  // FIXME: RELIC: pc_map should take const arguments
+  GTT e1, e2;
+  pc_map(e1, const_cast<G1T&>(msg), const_cast<G2T&>(vk));
+  pc_map(e2, const_cast<G1T&>(sig), const_cast<G2T&>(gen2));
+  return gt_cmp(e1, e2) == CMP_EQ;
+}
+
 } /* namespace Relic */
 } /* namespace BLS */
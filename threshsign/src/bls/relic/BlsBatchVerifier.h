@@ -15,6 +15,7 @@
 #include "threshsign/ThresholdSignaturesTypes.h"
 
 #include "threshsign/bls/relic/BlsNumTypes.h"
+#include "threshsign/bls/relic/BlsPublicKey.h"
 
 #include "Utils.h"
 #include "Logger.hpp"
@@ -286,9 +287,10 @@ class BlsBatchVerifier {
   };
 
  protected:
-  const BlsThresholdVerifier& ver;
+  // The share verification keys, indexed by signer ID, and the generator of G2 they are relative to
+  const std::vector<BlsPublicKey>& vks;
+  G2T gen2;
   G1T msg;
-  const BNT& fieldOrder;
 
   AlmostCompleteBinaryTree<Share, ShareAgg> aggTree;
 
@@ -299,11 +301,22 @@ class BlsBatchVerifier {
    * @param	ver 	the BlsThresholdVerifier object needed for verifying shares
    */
   BlsBatchVerifier(const BlsThresholdVerifier& ver, int maxShares);
+  /**
+   * @param   vks     the share verification keys, indexed by signer ID (vks[0] is unused)
+   * @param   gen2    the generator of G2
+   */
+  BlsBatchVerifier(const std::vector<BlsPublicKey>& vks, const G2T& gen2, int maxShares);
   virtual ~BlsBatchVerifier();
 
  public:
   void addShare(ShareID id, const G1T& sigShare);
 
+  /**
+   * Adds the share and its verification key raised to a random weight. Since a forger can't predict the weights,
+   * invalid shares can't cancel each other out when aggregated, which they otherwise can.
+   */
+  void addWeightedShare(ShareID id, const G1T& sigShare, const BNT& weight);
+
   int getNumShares() const { return aggTree.getNumLeaves(); }
 
   bool empty() const { return aggTree.getNumLeaves() == 0; }
@@ -327,6 +340,10 @@ class BlsBatchVerifier {
   bool batchVerify(const G1T& msg, bool wantBadShares, std::vector<ShareID>& shares, bool checkRoot);
 
   bool batchVerifyRecursive(int node, bool wantBadShares, std::vector<ShareID>& shares);
+
+ protected:
+  // e(msg, vk) == e(sig, gen2)
+  bool verify(const G1T& sig, const G2T& vk) const;
 };
 
 } /* namespace Relic */
@@ -0,0 +1,95 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the
+// LICENSE file.
+
+#ifdef ERROR  // TODO(GG): should be fixed by encapsulating relic (or windows) definitions in cpp files
+#undef ERROR
+#endif
+
+#include "BlsLagrangeCoefficientsCache.h"
+#include "LagrangeInterpolation.h"
+
+#include "threshsign/bls/relic/Library.h"
+
+#include "XAssert.h"
+#include "Logger.hpp"
+
+namespace BLS {
+namespace Relic {
+
+BlsLagrangeCoefficientsCache BlsLagrangeCoefficientsCache::_instance;
+
+void BlsLagrangeCoefficientsCache::getCoeffs(const VectorOfShares& signers, std::vector<BNT>& coeffs) {
+  assertStrictlyPositive(signers.count());
+  assertStrictlyLessThan(static_cast<size_t>(signers.last()), coeffs.size());
+
+  std::string key(static_cast<size_t>(VectorOfShares::getByteCount()), '\0');
+  signers.toBytes(reinterpret_cast<unsigned char*>(&key[0]), static_cast<int>(key.size()));
+
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+      lru.splice(lru.begin(), lru, it->second.lruPos);
+      for (ShareID id = signers.first(); signers.isEnd(id) == false; id = signers.next(id)) {
+        size_t i = static_cast<size_t>(id);
+        coeffs[i] = it->second.coeffs[i];
+      }
+      hits++;
+      return;
+    }
+    misses++;
+  }
+
+  // Compute outside of the lock; concurrent misses on the same set just compute it twice
+  std::vector<BNT> computed(static_cast<size_t>(signers.last() + 1));
+  lagrangeCoeffAccumReduced(signers, computed, Library::Get().getG2Order());
+  for (ShareID id = signers.first(); signers.isEnd(id) == false; id = signers.next(id)) {
+    size_t i = static_cast<size_t>(id);
+    coeffs[i] = computed[i];
+  }
+
+  std::lock_guard<std::mutex> guard(lock);
+  if (entries.count(key) > 0) return;
+  if (entries.size() >= maxSignerSets) {
+    LOG_TRACE(BLS_LOG, "Evicting the Lagrange coefficients of the least recently used signer set");
+    entries.erase(lru.back());
+    lru.pop_back();
+  }
+  lru.push_front(key);
+  entries.emplace(std::move(key), Entry{std::move(computed), lru.begin()});
+}
+
+size_t BlsLagrangeCoefficientsCache::size() const {
+  std::lock_guard<std::mutex> guard(lock);
+  return entries.size();
+}
+
+size_t BlsLagrangeCoefficientsCache::getHits() const {
+  std::lock_guard<std::mutex> guard(lock);
+  return hits;
+}
+
+size_t BlsLagrangeCoefficientsCache::getMisses() const {
+  std::lock_guard<std::mutex> guard(lock);
+  return misses;
+}
+
+void BlsLagrangeCoefficientsCache::clear() {
+  std::lock_guard<std::mutex> guard(lock);
+  entries.clear();
+  lru.clear();
+  hits = 0;
+  misses = 0;
+}
+
+} /* namespace Relic */
+} /* namespace BLS */
@@ -0,0 +1,78 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the
+// LICENSE file.
+
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "threshsign/ThresholdSignaturesTypes.h"
+#include "threshsign/VectorOfShares.h"
+#include "threshsign/bls/relic/BlsNumTypes.h"
+
+namespace BLS {
+namespace Relic {
+
+/**
+ * Caches the Lagrange coefficients of the most recently combined signer sets.
+ *
+ * The signers whose shares get combined are usually one of a few recurring subsets of the replicas (e.g., the fastest
+ * ones), so computing the coefficients from scratch for every threshold signature is mostly wasted work. Sets are
+ * keyed by their bitmap and evicted in LRU order. Thread-safe.
+ */
+class BlsLagrangeCoefficientsCache {
+ public:
+  static constexpr size_t kMaxSignerSets = 64;
+
+ private:
+  static BlsLagrangeCoefficientsCache _instance;
+
+  struct Entry {
+    // Indexed by signer ID, like the coefficients of the accumulators
+    std::vector<BNT> coeffs;
+    std::list<std::string>::iterator lruPos;
+  };
+
+  const size_t maxSignerSets;
+  mutable std::mutex lock;
+  std::unordered_map<std::string, Entry> entries;
+  // Most recently used first
+  std::list<std::string> lru;
+  size_t hits = 0;
+  size_t misses = 0;
+
+ public:
+  static BlsLagrangeCoefficientsCache& Get() { return _instance; }
+
+  explicit BlsLagrangeCoefficientsCache(size_t maxSignerSets = kMaxSignerSets) : maxSignerSets(maxSignerSets) {}
+
+ public:
+  /**
+   * Sets coeffs[i] to the Lagrange coefficient \ell_i^{S(0)} of every signer i in S = signers. Computes them with
+   * lagrangeCoeffAccumReduced() if the set is not cached yet.
+   *
+   * @param   signers     the set S of signers
+   * @param   coeffs      the output vector, which must have room for signers.last()
+   */
+  void getCoeffs(const VectorOfShares& signers, std::vector<BNT>& coeffs);
+
+  size_t size() const;
+  size_t getHits() const;
+  size_t getMisses() const;
+  void clear();
+};
+
+} /* namespace Relic */
+} /* namespace BLS */
@@ -19,6 +19,7 @@
 #include "threshsign/bls/relic/FastMultExp.h"
 
 #include "BlsAlmostMultisigCoefficients.h"
+#include "BlsLagrangeCoefficientsCache.h"
 #include "LagrangeInterpolation.h"
 
 #include <vector>
@@ -40,7 +41,7 @@ BlsThresholdAccumulator::BlsThresholdAccumulator(const std::vector<BlsPublicKey>
 }
 
 void BlsThresholdAccumulator::computeLagrangeCoeff() {
-  lagrangeCoeffAccumReduced(validSharesBits, coeffs, BLS::Relic::Library::Get().getG2Order());
+  BlsLagrangeCoefficientsCache::Get().getCoeffs(validSharesBits, coeffs);
 }
 
 void BlsThresholdAccumulator::exponentiateLagrangeCoeff() {
@@ -38,20 +38,26 @@ GT fastMultExp(const VectorOfShares& s,
   GT r;
   assertEqual(r, GT::Identity());
 
+  // Walk the bitset once rather than once per bit of the exponents
+  std::vector<size_t> indices;
+  indices.reserve(static_cast<size_t>(count));
+  ShareID i = first;
+  for (int c = 0; c < count; c++) {
+    assertFalse(s.isEnd(i));
+
+    size_t idx = static_cast<size_t>(i);
+    assertLessThanOrEqual(e[idx].getBits(), maxBits);
+    indices.push_back(idx);
+
+    // Next share
+    i = s.next(i);
+  }
+
   for (int j = maxBits - 1; j >= 0; j--) {
     r.Double();
 
-    ShareID i = first;
-    for (int c = 0; c < count; c++) {
-      assertFalse(s.isEnd(i));
-
-      size_t idx = static_cast<size_t>(i);
-      assertLessThanOrEqual(e[idx].getBits(), maxBits);
-
+    for (size_t idx : indices) {
       if (e[idx].getBit(j)) r.Add(a[idx]);
-
-      // Next share
-      i = s.next(i);
     }
   }
 
@@ -148,6 +148,55 @@ void batchVerifyHelper(BlsBatchVerifier& ver,
 #endif
 }
 
+// Adds the shares of all n signers to an accumulator with share verification, some of them signing the wrong message,
+// and checks that the accumulator isolates the bad shares it needed to look at and combines the good ones.
+void runAccumulatorTest(int k, int n, int numBadShares) {
+  BlsPublicParameters params = PublicParametersFactory::getWhatever();
+  BlsThresholdFactory factory(params);
+  std::vector<IThresholdSigner*> signers;
+  IThresholdVerifier* verifier;
+  std::tie(signers, verifier) = factory.newRandomSigners(k, n);
+
+  VectorOfShares badSubset;
+  VectorOfShares::randomSubset(badSubset, n, numBadShares);
+
+  const char* msg = "some message";
+  const char* otherMsg = "some other message";
+  int msgLen = static_cast<int>(strlen(msg));
+
+  std::unique_ptr<IThresholdAccumulator> acc(verifier->newAccumulator(true));
+  for (ShareID id = 1; id <= n; id++) {
+    IThresholdSigner* signer = signers[static_cast<size_t>(id)];
+    const char* signedMsg = badSubset.contains(id) ? otherMsg : msg;
+    std::vector<char> share(static_cast<size_t>(signer->requiredLengthForSignedData()));
+    signer->signData(signedMsg, static_cast<int>(strlen(signedMsg)), share.data(), static_cast<int>(share.size()));
+    acc->add(share.data(), static_cast<int>(share.size()));
+  }
+  acc->setExpectedDigest(reinterpret_cast<const unsigned char*>(msg), msgLen);
+
+  // The accumulator verifies the shares in ID order, until it has k valid ones
+  std::set<ShareID> expectedBad;
+  int numGood = 0;
+  for (ShareID id = 1; id <= n && numGood < k; id++) {
+    if (badSubset.contains(id)) {
+      expectedBad.insert(id);
+    } else {
+      numGood++;
+    }
+  }
+  testAssertTrue(acc->getInvalidShareIds() == expectedBad);
+  testAssertEqual(acc->getNumValidShares(), numGood);
+
+  if (numGood == k) {
+    std::vector<char> sig(static_cast<size_t>(verifier->requiredLengthForSignedData()));
+    acc->getFullSignedData(sig.data(), static_cast<int>(sig.size()));
+    testAssertTrue(verifier->verify(msg, msgLen, sig.data(), static_cast<int>(sig.size())));
+  }
+
+  for (IThresholdSigner* signer : signers) delete signer;
+  delete verifier;
+}
+
 int RelicAppMain(const Library& lib, const std::vector<std::string>& args) {
   (void)args;
   (void)lib;
@@ -163,5 +212,14 @@ int RelicAppMain(const Library& lib, const std::vector<std::string>& args) {
     }
   }
 
+  // n = k + 1 would get the 'almost multisig' accumulator, which does not verify shares
+  for (int k = 1; k < 8; k++) {
+    int n = 2 * k + 2;
+    LOG_DEBUG(THRESHSIGN_LOG, "Testing the BLS accumulator share verification with k = " << k << " and n = " << n);
+    for (int bad = 0; bad <= n; bad++) {
+      runAccumulatorTest(k, n, bad);
+    }
+  }
+
   return 0;
 }
@@ -31,6 +31,7 @@
 #include "threshsign/bls/relic/PublicParametersFactory.h"
 
 #include "bls/relic/LagrangeInterpolation.h"
+#include "bls/relic/BlsLagrangeCoefficientsCache.h"
 
 using namespace std;
 using namespace BLS::Relic;
@@ -127,6 +128,30 @@ int RelicAppMain(const Library& lib, const std::vector<std::string>& args) {
       LOG_ERROR(THRESHSIGN_LOG, "  lagrCoeffs[" << pos << "] = " << *result.second);
       throw std::runtime_error("Bad coeffs");
     }
+
+    // The cached coefficients must match too, whether computed on a miss or fetched on a hit
+    BlsLagrangeCoefficientsCache cache(2);
+    for (int i = 0; i < 2; i++) {
+      std::vector<BNT> cachedCoeffs(static_cast<size_t>(numSigners + 1), BNT(0));
+      cache.getCoeffs(signers, cachedCoeffs);
+      testAssertTrue(cachedCoeffs == lagrCoeffs);
+    }
+    testAssertEqual(cache.getMisses(), 1);
+    testAssertEqual(cache.getHits(), 1);
+  }
+
+  // The least recently used signer sets get evicted
+  BlsLagrangeCoefficientsCache cache(2);
+  std::vector<BNT> coeffs(4);
+  VectorOfShares sets[3];
+  for (ShareID id = 1; id <= 3; id++) {
+    sets[id - 1].add(id);
+    cache.getCoeffs(sets[id - 1], coeffs);
   }
+  testAssertEqual(cache.size(), 2);
+  cache.getCoeffs(sets[2], coeffs);
+  testAssertEqual(cache.getHits(), 1);
+  cache.getCoeffs(sets[0], coeffs);
+  testAssertEqual(cache.getMisses(), 4);
   return 0;
 }
@@ -110,6 +110,8 @@ class DigestUtil {
  public:
   static size_t digestLength();
   static bool compute(const char* input, size_t inputLength, char* outBufferForDigest, size_t lengthOfBufferForDigest);
+  // Compute the digests of count independent inputs at once, using the multi-lane engine of SHA256Batch.
+  static void computeBatch(const char* const* inputs, const size_t* inputLengths, size_t count, Digest* outDigests);
 
   class Context {
    public:
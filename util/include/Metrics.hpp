@@ -70,6 +70,7 @@ class Aggregator {
  private:
   const bool metricsEnabled_ = true;
   void RegisterComponent(Component& component);
+  void ReplaceComponent(const Component& previous, Component& component);
   void UpdateValues(const std::string& name, Values&& values);
 
   std::map<std::string, Component> components_;
@@ -128,6 +129,75 @@ class BasicCounter {
   T val_;
 };
 
+/******************************** Class ShardedCounter ********************************/
+
+// A ShardedCounter spreads its value over a fixed number of cache line sized slots. Each thread is assigned a slot on
+// first use and increments it with a relaxed atomic add, so updating the counter never takes a lock and never bounces
+// a cache line between cores.
+//
+// The slots are shared by all copies of the counter, including the copy the Aggregator keeps. The Aggregator sums
+// them lazily whenever the metric is collected, so a component that only holds sharded counters never has to call
+// UpdateAggregator().
+class ShardedCounter {
+ public:
+  typedef uint64_t type;
+  static constexpr size_t kNumShards = 64;
+
+  explicit ShardedCounter(const uint64_t val) : shards_(std::make_shared<Shards>()) {
+    shards_->slots[0].val.store(val, std::memory_order_relaxed);
+  }
+
+  ShardedCounter& operator+=(const uint64_t rhs) {
+    shards_->slots[ThreadShard()].val.fetch_add(rhs, std::memory_order_relaxed);
+    return *this;
+  }
+
+  // Sum of all slots. Concurrent increments may or may not be reflected.
+  uint64_t Get() const {
+    uint64_t sum = 0;
+    for (const auto& slot : shards_->slots) sum += slot.val.load(std::memory_order_relaxed);
+    return sum;
+  }
+
+ private:
+  struct alignas(64) Slot {
+    std::atomic_uint64_t val{0};
+  };
+  struct Shards {
+    Slot slots[kNumShards];
+  };
+
+  static size_t ThreadShard() {
+    static std::atomic_size_t next_shard{0};
+    thread_local const size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % kNumShards;
+    return shard;
+  }
+
+  std::shared_ptr<Shards> shards_;
+};
+
+// The handle of a sharded counter keeps its own reference to the shared slots. Unlike Component::Handle it may be
+// used from any thread, and an increment is a single relaxed atomic add on the calling thread's slot.
+class ShardedCounterHandle {
+ public:
+  ShardedCounterHandle(const ShardedCounter& counter, bool metricsEnabled)
+      : counter_(counter), metricsEnabled_(metricsEnabled) {}
+  ShardedCounter& Get() { return counter_; }
+  // postfix
+  void operator++(int) {
+    if (!metricsEnabled_) return;
+    counter_ += 1;
+  }
+  ShardedCounter& operator+=(const uint64_t rhs) {
+    if (!metricsEnabled_) return counter_;
+    return counter_ += rhs;
+  }
+
+ private:
+  ShardedCounter counter_;
+  const bool metricsEnabled_;
+};
+
 /******************************** Class BasicStatus ********************************/
 
 // Status is a text based representation of a value. It's used for things that
@@ -165,6 +235,7 @@ class Values {
   std::vector<Counter> counters_;
   std::vector<AtomicCounter> atomic_counters_;
   std::vector<AtomicGauge> atomic_gauges_;
+  std::vector<ShardedCounter> sharded_counters_;
 
   friend class Component;
   friend class Aggregator;
@@ -183,6 +254,7 @@ class Names {
   std::vector<std::string> counter_names_;
   std::vector<std::string> atomic_counter_names_;
   std::vector<std::string> atomic_gauge_names_;
+  std::vector<std::string> sharded_counter_names_;
 
   friend class Component;
   friend class Aggregator;
@@ -251,7 +323,7 @@ class Component {
   };
 
   Component(const std::string& name, std::shared_ptr<Aggregator> aggregator)
-      : aggregator_(aggregator), name_(name), metricsEnabled_(aggregator->metricsEnabled_) {}
+      : aggregator_(aggregator), name_(name), metricsEnabled_(aggregator->metricsEnabled_), id_(NextId()) {}
   std::string Name() { return name_; }
 
   // Create a Gauge, add it to the component and return a reference to the
@@ -266,6 +338,8 @@ class Component {
   Handle<AtomicCounter> RegisterAtomicCounter(const std::string& name, const uint64_t val);
   Handle<AtomicCounter> RegisterAtomicCounter(const std::string& name) { return RegisterAtomicCounter(name, 0); }
   Handle<AtomicGauge> RegisterAtomicGauge(const std::string& name, const uint64_t val);
+  ShardedCounterHandle RegisterShardedCounter(const std::string& name, const uint64_t val);
+  ShardedCounterHandle RegisterShardedCounter(const std::string& name) { return RegisterShardedCounter(name, 0); }
 
   std::list<Metric> CollectGauges();
   std::list<Metric> CollectCounters();
@@ -281,6 +355,15 @@ class Component {
     }
   }
 
+  // Register the component in place of `previous`, e.g. the component of a restarted thread pool, if `previous` is
+  // the component registered under its name. Otherwise, the component is registered as by Register(). `previous`
+  // must not be updated anymore.
+  void ReplaceRegistration(const Component& previous) {
+    if (auto aggregator = aggregator_.lock()) {
+      aggregator->ReplaceComponent(previous, *this);
+    }
+  }
+
   // Update the values in the aggregator
   void UpdateAggregator();
 
@@ -299,10 +382,13 @@ class Component {
   friend class Aggregator;
 
   void SetValues(Values&& values) { values_ = values; }
+  static uint64_t NextId();
 
   std::weak_ptr<Aggregator> aggregator_;
   std::string name_;
   const bool metricsEnabled_;
+  // Identifies the component and its copies, e.g. the one registered with the aggregator
+  const uint64_t id_;
 
   Names names_;
   Tags tags_;
@@ -11,19 +11,19 @@
 
 #pragma once
 
-#include <queue>
-#include <vector>
-#include <thread>
+#include "WorkStealingExecutor.hpp"
+
+#include <memory>
 #include <mutex>
-#include <atomic>
-#include <condition_variable>
+#include <string>
 
 namespace concord::util {
 
+// A pool of threads executing Jobs, on top of a WorkStealingExecutor
 class SimpleThreadPool {
-  typedef std::lock_guard<std::mutex> guard;
-
  public:
+  using Priority = WorkStealingExecutor::Priority;
+
   // TODO change to managed object
   class Job {
    public:
@@ -33,7 +33,10 @@ class SimpleThreadPool {
     ~Job(){};  // should not be deleted directly - use  release()
   };
 
-  SimpleThreadPool() : stopped_(true) {}
+  /**
+   * @param name - the name the pool reports its metrics under
+   */
+  explicit SimpleThreadPool(const std::string& name = "SimpleThreadPool") : name_(name) {}
 
   /**
    * starts the thread pool with desired number of threads
@@ -47,36 +50,38 @@ class SimpleThreadPool {
   /**
    * add a job for execution
    * @param j - subclass of Job for execution
+   * @param priority - jobs of a higher priority get executed first
    */
-  void add(Job* j);
+  void add(Job* j, Priority priority = Priority::NORMAL);
   /**
    * get the number of currently allocated threads in pool
    */
   size_t getNumOfThreads() {
-    guard g(queue_lock_);
-    return threads_.size();
+    auto executor = std::atomic_load(&executor_);
+    return executor ? executor->numOfThreads() : 0;
   }
   /**
    * get the number of jobs in queue
    */
   size_t getNumOfJobs() {
-    guard g(queue_lock_);
-    return job_queue_.size();
+    auto executor = std::atomic_load(&executor_);
+    return executor ? executor->numOfPendingTasks() : 0;
   }
+  /**
+   * report the metrics of the pool to the given aggregator
+   */
+  void setAggregator(const std::shared_ptr<concordMetrics::Aggregator>& aggregator);
 
  protected:
-  bool load(Job*& outJob);
-  void execute(Job*);
+  static void execute(Job*);
 
- protected:
-  std::queue<SimpleThreadPool::Job*> job_queue_;
-  std::mutex queue_lock_;
-  std::condition_variable queue_cond_;
-  bool stopped_;
-  int num_of_free_threads_ = 0;
-  std::mutex threads_startup_lock_;
-  std::condition_variable threads_startup_cond_;
-  std::vector<std::thread> threads_;
+ private:
+  const std::string name_;
+  std::mutex lock_;
+  std::shared_ptr<concordMetrics::Aggregator> aggregator_;
+  // The executor of the last start(), accessed atomically. It is kept after stop() so that jobs added later get
+  // released, and replaced by the next start(). A replaced executor is destroyed once no concurrent add() uses it.
+  std::shared_ptr<WorkStealingExecutor> executor_;
 };
 
 }  // namespace concord::util
@@ -15,13 +15,21 @@
 #include <functional>
 #include <cstdint>
 #include <chrono>
+#include <array>
 #include <vector>
+#include <list>
+#include <unordered_map>
 #include <algorithm>
 #include <mutex>
 #include "Logger.hpp"
 namespace concordUtil {
 
-// A collection of timers backed by a vector.
+// A collection of timers backed by a hierarchical timing wheel.
+//
+// Time is measured in ticks of one millisecond. The wheel has kLevels levels of kSlots slots each; level L holds timers
+// expiring within kSlots^(L+1) ticks, and its slots are cascaded into the lower levels as time advances. add(), reset()
+// and cancel() are O(1), and evaluate() only touches the slots of the ticks that elapsed since the previous call and
+// the timers that expire in them.
 class Timers {
  public:
   class Handle {
@@ -49,9 +57,6 @@ class Timers {
     };
 
    private:
-    Timer(std::chrono::milliseconds duration, Type t, const std::function<void(Handle)>& callback)
-        : Timer(duration, t, callback, std::chrono::steady_clock::now()) {}
-
     Timer(std::chrono::milliseconds d,
           Type t,
           std::function<void(Handle)> cb,
@@ -83,6 +88,12 @@ class Timers {
     uint64_t id_ = 0;
     std::function<void(Handle)> callback_;
 
+    // Position in the wheel. A timer is unlinked while its slot is being evaluated.
+    bool linked_ = false;
+    size_t level_ = 0;
+    size_t slot_ = 0;
+    std::list<uint64_t>::iterator slot_it_;
+
     friend class Timers;
   };
 
@@ -102,10 +113,12 @@ class Timers {
              const std::function<void(Handle)>& cb,
              std::chrono::steady_clock::time_point now) {
     std::unique_lock<std::recursive_mutex> mlock(lock_);
-    timers_.emplace_back(Timer(d, t, cb, now));
+    syncClock(now);
     id_counter_ += 1;
     Handle h{id_counter_};
-    timers_.back().id_ = h.id_;
+    auto& timer = timers_.emplace(h.id_, Timer(d, t, cb, now)).first->second;
+    timer.id_ = h.id_;
+    link(timer);
     return h;
   }
 
@@ -113,16 +126,19 @@ class Timers {
 
   void reset(const Handle& handle, std::chrono::milliseconds d, std::chrono::steady_clock::time_point now) {
     std::unique_lock<std::recursive_mutex> mlock(lock_);
-    auto it = find(handle);
+    auto it = timers_.find(handle.id_);
     if (it != timers_.end()) {
-      it->reset(now, d);
+      it->second.reset(now, d);
+      unlink(it->second);
+      link(it->second);
     }
   }
 
   void cancel(const Handle& handle) {
     std::unique_lock<std::recursive_mutex> mlock(lock_);
-    auto it = find(handle);
+    auto it = timers_.find(handle.id_);
     if (it != timers_.end()) {
+      unlink(it->second);
       timers_.erase(it);
     }
   }
@@ -134,32 +150,136 @@ class Timers {
     std::unique_lock<std::recursive_mutex> mlock(lock_);
     if (timers_.empty()) return;
 
-    // Expired ids must be stored separately since erasing causes iterator invalidation.
-    std::vector<Handle> to_cancel;
-    for (auto& timer : timers_) {
-      if (timer.expired(now)) {
-        timer.run_callback(Handle(timer.id_));
-        if (timer.recurring()) {
-          timer.reset(now);
+    // Timers in the slot of the current tick may not have expired yet, since a tick is coarser than the clock. That
+    // slot is therefore evaluated again on the next call and current_tick_ only advances up to the previous tick.
+    const auto target = toTick(now);
+    // Recurring timers are re-linked once all ticks are evaluated, so that each fires at most once per call.
+    std::vector<uint64_t> rescheduled;
+    while (current_tick_ < target && !timers_.empty()) {
+      const auto tick = std::min(nextEventTick(), target);
+      cascade(tick);
+      std::list<uint64_t> due;
+      due.swap(wheel_[0][tick & kSlotMask]);
+      occupied_[(tick & kSlotMask) / 64] &= ~(uint64_t{1} << (tick & 63));
+      for (auto id : due) timers_.at(id).linked_ = false;
+      // Timers (re)linked while running the callbacks below must not land in the slot that is being evaluated, unless it
+      // is the slot of the current tick, which is evaluated again on the next call.
+      current_tick_ = (tick == target) ? tick - 1 : tick;
+      for (auto id : due) {
+        auto it = timers_.find(id);
+        // Cancelled or reset by the callback of an earlier timer in this slot.
+        if (it == timers_.end() || it->second.linked_) continue;
+        if (!it->second.expired(now)) {
+          link(it->second);
+          continue;
+        }
+        it->second.run_callback(Handle(id));
+        // The callback may have cancelled or reset its own timer.
+        it = timers_.find(id);
+        if (it == timers_.end()) continue;
+        unlink(it->second);
+        if (it->second.recurring()) {
+          it->second.reset(now);
+          rescheduled.push_back(id);
         } else {
-          to_cancel.push_back(Handle(timer.id_));
+          timers_.erase(it);
         }
       }
+      if (tick == target) break;
     }
-
-    for (auto& handle : to_cancel) {
-      cancel(handle);
+    if (current_tick_ < target) current_tick_ = target - 1;
+    for (auto id : rescheduled) {
+      auto it = timers_.find(id);
+      if (it != timers_.end() && !it->second.linked_) link(it->second);
     }
   }
 
  private:
-  std::vector<Timer>::iterator find(const Handle& handle) {
-    std::unique_lock<std::recursive_mutex> mlock(lock_);
-    return std::find_if(timers_.begin(), timers_.end(), [&handle](const Timer& t) { return t.id_ == handle.id_; });
+  static constexpr size_t kLevels = 4;
+  static constexpr size_t kSlotBits = 8;
+  static constexpr size_t kSlots = 1 << kSlotBits;
+  static constexpr uint64_t kSlotMask = kSlots - 1;
+  // Timers further away than the wheel's span wait in the last slot of the top level and are re-linked on cascade.
+  static constexpr uint64_t kMaxDelta = (uint64_t{1} << (kSlotBits * kLevels)) - 1;
+
+  static uint64_t toTick(std::chrono::steady_clock::time_point t) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(t.time_since_epoch()).count());
+  }
+
+  // While the wheel is empty its clock can jump forward, so that a later evaluate() doesn't walk the idle period.
+  void syncClock(std::chrono::steady_clock::time_point now) {
+    if (!clock_initialized_) {
+      current_tick_ = toTick(now) - 1;
+      clock_initialized_ = true;
+    } else if (timers_.empty()) {
+      current_tick_ = std::max(current_tick_, toTick(now) - 1);
+    }
+  }
+
+  // The first tick after current_tick_ that either has level 0 timers or requires a cascade.
+  uint64_t nextEventTick() const {
+    const auto first = current_tick_ + 1;
+    const auto index = first & kSlotMask;
+    if (index == 0) return first;
+    for (auto word = index / 64; word < occupied_.size(); ++word) {
+      auto bits = occupied_[word];
+      if (word == index / 64) bits &= ~uint64_t{0} << (index % 64);
+      if (bits) return first - index + word * 64 + __builtin_ctzll(bits);
+    }
+    return first - index + kSlots;
+  }
+
+  // Place the timer in the slot matching its expiry, relative to the next tick to be evaluated.
+  void link(Timer& timer) {
+    const auto base = current_tick_ + 1;
+    auto expiry = std::max(toTick(timer.expires_at_), base);
+    auto delta = expiry - base;
+    if (delta > kMaxDelta) {
+      delta = kMaxDelta;
+      expiry = base + kMaxDelta;
+    }
+    size_t level = 0;
+    while (level + 1 < kLevels && delta >= (uint64_t{1} << (kSlotBits * (level + 1)))) ++level;
+    const auto index = (expiry >> (kSlotBits * level)) & kSlotMask;
+    auto& slot = wheel_[level][index];
+    if (level == 0) occupied_[index / 64] |= uint64_t{1} << (index % 64);
+    timer.slot_it_ = slot.insert(slot.end(), timer.id_);
+    timer.level_ = level;
+    timer.slot_ = index;
+    timer.linked_ = true;
+  }
+
+  void unlink(Timer& timer) {
+    if (!timer.linked_) return;
+    auto& slot = wheel_[timer.level_][timer.slot_];
+    slot.erase(timer.slot_it_);
+    if (timer.level_ == 0 && slot.empty()) occupied_[timer.slot_ / 64] &= ~(uint64_t{1} << (timer.slot_ % 64));
+    timer.linked_ = false;
+  }
+
+  // When the lower bits of a tick wrap around, move the timers of the matching upper-level slot one level down.
+  void cascade(uint64_t tick) {
+    for (size_t level = kLevels - 1; level > 0; --level) {
+      if ((tick & ((uint64_t{1} << (kSlotBits * level)) - 1)) != 0) continue;
+      std::list<uint64_t> slot;
+      slot.swap(wheel_[level][(tick >> (kSlotBits * level)) & kSlotMask]);
+      current_tick_ = tick - 1;
+      for (auto id : slot) {
+        auto& timer = timers_.at(id);
+        timer.linked_ = false;
+        link(timer);
+      }
+    }
   }
 
   std::recursive_mutex lock_;
-  std::vector<Timer> timers_;
+  std::unordered_map<uint64_t, Timer> timers_;
+  std::array<std::array<std::list<uint64_t>, kSlots>, kLevels> wheel_;
+  // Non-empty slots of level 0, so that evaluate() skips empty ticks.
+  std::array<uint64_t, kSlots / 64> occupied_{};
+  uint64_t current_tick_ = 0;
+  bool clock_initialized_ = false;
   uint64_t id_counter_;
 };
 
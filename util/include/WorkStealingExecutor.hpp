@@ -0,0 +1,156 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").  You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#pragma once
+
+#include "Metrics.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace concord::util {
+
+// A fixed-size pool of worker threads, each with its own task queues.
+//
+// A task submitted by a worker of the executor is queued on that worker; other tasks are spread over the workers
+// round-robin. A worker runs the tasks of its own queues first and steals from the other workers when it runs out, so
+// submitters and workers never contend on a single queue. Workers which have nothing to do sleep until a task arrives.
+//
+// Tasks of a higher priority are picked before tasks of a lower one. Within a priority, each queue is FIFO.
+//
+// Workers may be pinned to CPUs. A pinned worker steals from the workers on its own NUMA node first.
+//
+// The executor reports the following metrics under its name: submittedTasks, executedTasks, stolenTasks, and the sums
+// taskQueueWaitMicros and taskExecutionMicros. The queue depth is submittedTasks - executedTasks; the average task
+// latency is the sum of the latter two divided by executedTasks.
+class WorkStealingExecutor {
+ public:
+  enum class Priority : uint8_t { HIGH, NORMAL, LOW };
+  static constexpr size_t kNumOfPriorities = 3;
+
+  struct Config {
+    // The name of the metrics component
+    std::string name = "WorkStealingExecutor";
+    uint32_t numOfThreads = 1;
+    // Worker i is pinned to cpus[i % cpus.size()]. Workers are not pinned if empty.
+    std::vector<uint32_t> cpus;
+  };
+
+  // A move-only callable taking no arguments
+  class Task {
+   public:
+    Task() = default;
+    template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+    Task(F&& f) : impl_{std::make_unique<Impl<std::decay_t<F>>>(std::forward<F>(f))} {}
+
+    void operator()() { impl_->run(); }
+    explicit operator bool() const { return impl_ != nullptr; }
+
+   private:
+    struct Base {
+      virtual ~Base() = default;
+      virtual void run() = 0;
+    };
+    template <typename F>
+    struct Impl : Base {
+      template <typename G>
+      explicit Impl(G&& g) : f_{std::forward<G>(g)} {}
+      void run() override { f_(); }
+      F f_;
+    };
+    std::unique_ptr<Base> impl_;
+  };
+
+  // Starts the workers and waits until all of them are running.
+  explicit WorkStealingExecutor(const Config& config);
+  // Stops the workers, discarding the pending tasks.
+  ~WorkStealingExecutor();
+
+  WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+  WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+
+  // Queues a task for execution. Returns false and destroys the task if the executor is stopped.
+  bool submit(Task task, Priority priority = Priority::NORMAL);
+
+  // Stops the workers and waits for the running tasks. If drain is set, the pending tasks get executed before the
+  // call returns; otherwise they get destroyed without being executed. Later calls do nothing.
+  void stop(bool drain = false);
+
+  // The number of running workers, 0 once stopped
+  size_t numOfThreads() const;
+  // The number of tasks waiting for execution
+  size_t numOfPendingTasks() const { return static_cast<size_t>(pending_.load()); }
+
+  void setAggregator(const std::shared_ptr<concordMetrics::Aggregator>& aggregator) {
+    metricsComponent_.SetAggregator(aggregator);
+  }
+  // Report the metrics in place of the given executor, e.g. the one of a restarted pool, if it is the registered one
+  void replaceMetricsOf(const WorkStealingExecutor& previous) {
+    metricsComponent_.ReplaceRegistration(previous.metricsComponent_);
+  }
+
+ private:
+  struct QueuedTask {
+    Task task;
+    std::chrono::steady_clock::time_point queuedAt;
+  };
+
+  struct alignas(64) Worker {
+    std::mutex lock;
+    std::array<std::deque<QueuedTask>, kNumOfPriorities> queues;
+    // The other workers, in the order this one steals from them
+    std::vector<size_t> victims;
+    std::thread thread;
+  };
+
+  void loop(size_t id);
+  bool take(size_t id, QueuedTask& out);
+  bool popFrom(Worker& worker, size_t priority, QueuedTask& out);
+  void run(QueuedTask& queuedTask);
+  void pin(size_t id);
+  void initVictims();
+
+  const Config config_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic_size_t nextWorker_{0};
+
+  // Queued tasks, in total and per priority
+  std::atomic_int64_t pending_{0};
+  std::array<std::atomic_int64_t, kNumOfPriorities> pendingPerPriority_{};
+
+  std::mutex idleLock_;
+  std::condition_variable idleCond_;
+  std::atomic_size_t idleWorkers_{0};
+  std::atomic_bool stopped_{false};
+  std::atomic_bool drain_{false};
+  std::mutex stopLock_;
+  bool joined_ = false;
+
+  concordMetrics::Component metricsComponent_;
+  concordMetrics::ShardedCounterHandle submittedTasks_;
+  concordMetrics::ShardedCounterHandle executedTasks_;
+  concordMetrics::ShardedCounterHandle stolenTasks_;
+  concordMetrics::ShardedCounterHandle taskQueueWaitMicros_;
+  concordMetrics::ShardedCounterHandle taskExecutionMicros_;
+};
+
+}  // namespace concord::util
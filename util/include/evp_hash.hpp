@@ -47,7 +47,8 @@ class EVPHash {
   };
 
   EVPHash& operator=(EVPHash&& other) noexcept {
-    *this = EVPHash{std::move(other)};
+    std::swap(ctx_, other.ctx_);
+    std::swap(updating_, other.updating_);
     return *this;
   }
 
@@ -90,6 +91,16 @@ class EVPHash {
     ConcordAssert(EVP_DigestUpdate(ctx_, buf, size) == 1);
   }
 
+  // Return a hash that continues from the current state of this one, i.e. both
+  // hashes have seen the same data so far.
+  EVPHash clone() const noexcept {
+    ConcordAssert(updating_);
+    EVPHash copy;
+    ConcordAssert(EVP_MD_CTX_copy_ex(copy.ctx_, ctx_) == 1);
+    copy.updating_ = true;
+    return copy;
+  }
+
   Digest finish() noexcept {
     Digest digest;
     unsigned int _digest_len;
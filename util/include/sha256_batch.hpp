@@ -0,0 +1,51 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").  You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace concord::util {
+
+// Computes the SHA-256 digests of many independent buffers at once.
+//
+// Buffers are grouped by length and hashed in parallel SIMD lanes: 16 lanes with AVX-512, 8 lanes with AVX2. The engine
+// is selected once at runtime from the CPU features. Without either, buffers are hashed one by one with the scalar
+// implementation, which uses the SHA extensions (SHA-NI) where available. Since a single SHA-NI stream outruns the lanes
+// on long buffers, digest() also falls back to the scalar path for batches of long buffers on such CPUs.
+//
+// The result for each buffer is identical to a plain SHA-256 of it.
+class SHA256Batch {
+ public:
+  static constexpr size_t SIZE_IN_BYTES = 32;
+  typedef std::array<uint8_t, SIZE_IN_BYTES> Digest;
+
+  enum class Engine { SCALAR, AVX2, AVX512 };
+
+  // The engine used by digest() on this CPU.
+  static Engine engine();
+  static bool isSupported(Engine engine);
+  static const char* engineName(Engine engine);
+
+  // out[i] = SHA-256(data[i], sizes[i]) for every i < count.
+  static void digest(const void* const* data, const size_t* sizes, size_t count, Digest* out);
+  static void digest(const std::vector<std::string_view>& buffers, Digest* out);
+  static std::vector<Digest> digest(const std::vector<std::string_view>& buffers);
+
+  // Same as above with an explicit engine. The engine must be supported by the CPU.
+  static void digest(Engine engine, const void* const* data, const size_t* sizes, size_t count, Digest* out);
+};
+
+}  // namespace concord::util
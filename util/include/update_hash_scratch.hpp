@@ -0,0 +1,105 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").  You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "assertUtils.hpp"
+#include "sha256_batch.hpp"
+#include "sha_hash.hpp"
+
+namespace concord::util {
+
+// Computes the hash of a thin replica update, shared by the server (KvbAppFilter) and the thin replica client so that
+// both get the same hash. The entries of an update are added with add() and hashed in a single SHA256Batch call.
+//
+// The update hash is the SHA-256 of the id (little endian) followed by the hashes of the entries, sorted so that two
+// updates with the same entries in different orders get the same hash. For key-value updates, the hash of each key is
+// followed by the hash of its value, and the entries are sorted by the hash of their key.
+//
+// The buffers are reused by the updates hashed on a thread, so that hashing an update doesn't allocate once they have
+// grown to the size of the largest update seen.
+class UpdateHashScratch {
+ public:
+  // The scratch of the calling thread.
+  static UpdateHashScratch& get() {
+    thread_local UpdateHashScratch scratch;
+    return scratch;
+  }
+
+  void clear() {
+    data_.clear();
+    sizes_.clear();
+  }
+  // The buffer must outlive the next hash.
+  void add(const std::string& buf) {
+    data_.push_back(buf.data());
+    sizes_.push_back(buf.size());
+  }
+
+  // Hashes the key-value pairs added since clear(), each key followed by its value.
+  // Returns std::nullopt if two of the keys are the same.
+  std::optional<std::string> hashKeyValues(uint64_t block_id) {
+    ConcordAssertEQ(data_.size() % 2, 0);
+    kv_digests_.resize(data_.size() / 2);
+    SHA256Batch::digest(
+        data_.data(), sizes_.data(), data_.size(), reinterpret_cast<SHA256Batch::Digest*>(kv_digests_.data()));
+    // Key hashes are unique, so this sorts by key hash.
+    std::sort(kv_digests_.begin(), kv_digests_.end());
+    const auto duplicate = std::adjacent_find(
+        kv_digests_.cbegin(), kv_digests_.cend(), [](auto& lhs, auto& rhs) { return lhs[0] == rhs[0]; });
+    if (duplicate != kv_digests_.cend()) {
+      return std::nullopt;
+    }
+    return hashFromEntryHashes(block_id, kv_digests_.data(), kv_digests_.size() * sizeof(KeyValueDigests));
+  }
+
+  // Hashes the events added since clear(), which must be unique.
+  std::string hashEvents(uint64_t event_group_id) {
+    event_digests_.resize(data_.size());
+    SHA256Batch::digest(data_.data(), sizes_.data(), data_.size(), event_digests_.data());
+    std::sort(event_digests_.begin(), event_digests_.end());
+    ConcordAssert(std::adjacent_find(event_digests_.cbegin(), event_digests_.cend()) == event_digests_.cend());
+    return hashFromEntryHashes(
+        event_group_id, event_digests_.data(), event_digests_.size() * sizeof(SHA256Batch::Digest));
+  }
+
+ private:
+  using KeyValueDigests = std::array<SHA256Batch::Digest, 2>;
+  static_assert(sizeof(KeyValueDigests) == 2 * sizeof(SHA256Batch::Digest));
+
+  std::string hashFromEntryHashes(uint64_t id, const void* entry_hashes, size_t size) {
+    uint8_t id_bytes[sizeof(id)];
+    for (size_t i = 0; i < sizeof(id); ++i) {
+      id_bytes[i] = static_cast<uint8_t>(id >> (8 * i));
+    }
+    hasher_.init();
+    hasher_.update(id_bytes, sizeof(id_bytes));
+    hasher_.update(entry_hashes, size);
+    const auto digest = hasher_.finish();
+    return std::string(digest.cbegin(), digest.cend());
+  }
+
+  std::vector<const void*> data_;
+  std::vector<size_t> sizes_;
+  std::vector<KeyValueDigests> kv_digests_;
+  std::vector<SHA256Batch::Digest> event_digests_;
+  SHA2_256 hasher_;
+};
+
+}  // namespace concord::util
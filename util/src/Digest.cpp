@@ -11,6 +11,7 @@
 
 #include "Digest.hpp"
 #include "hex_tools.h"
+#include "sha256_batch.hpp"
 
 #include <string.h>
 #include <stdio.h>
@@ -62,6 +63,23 @@ bool DigestUtil::compute(const char* input,
   return true;
 }
 
+void DigestUtil::computeBatch(const char* const* inputs,
+                              const size_t* inputLengths,
+                              size_t count,
+                              Digest* outDigests) {
+#if defined SHA256_DIGEST
+  static_assert(sizeof(Digest) == sizeof(concord::util::SHA256Batch::Digest));
+  concord::util::SHA256Batch::digest(reinterpret_cast<const void* const*>(inputs),
+                                     inputLengths,
+                                     count,
+                                     reinterpret_cast<concord::util::SHA256Batch::Digest*>(outDigests));
+#else
+  for (size_t i = 0; i < count; ++i) {
+    compute(inputs[i], inputLengths[i], outDigests[i].getForUpdate(), sizeof(Digest));
+  }
+#endif
+}
+
 DigestUtil::Context::Context() {
   DigestType* p = new DigestType();
   internalState = p;
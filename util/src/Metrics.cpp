@@ -39,6 +39,11 @@ T FindValue(const char* const val_type, const string& val_name, const vector<str
 
 /******************************** Class Component ********************************/
 
+uint64_t Component::NextId() {
+  static std::atomic_uint64_t next_id{0};
+  return next_id++;
+}
+
 Component::Handle<Gauge> Component::RegisterGauge(const string& name, const uint64_t val) {
   names_.gauge_names_.emplace_back(name);
   values_.gauges_.emplace_back(Gauge(val));
@@ -79,6 +84,12 @@ Component::Handle<AtomicGauge> Component::RegisterAtomicGauge(const std::string&
   return Component::Handle<AtomicGauge>(values_.atomic_gauges_, values_.atomic_gauges_.size() - 1, metricsEnabled_);
 }
 
+ShardedCounterHandle Component::RegisterShardedCounter(const std::string& name, const uint64_t val) {
+  names_.sharded_counter_names_.emplace_back(name);
+  values_.sharded_counters_.emplace_back(ShardedCounter(val));
+  return ShardedCounterHandle(values_.sharded_counters_.back(), metricsEnabled_);
+}
+
 std::list<Metric> Component::CollectGauges() {
   if (!metricsEnabled_) return list<Metric>();
   std::list<Metric> ret;
@@ -104,6 +115,9 @@ std::list<Metric> Component::CollectCounters() {
   for (std::size_t i = 0; i < names_.atomic_counter_names_.size(); i++) {
     ret.emplace_back(Metric{name_, names_.atomic_counter_names_[i], Counter(values_.atomic_counters_[i].Get())});
   }
+  for (std::size_t i = 0; i < names_.sharded_counter_names_.size(); i++) {
+    ret.emplace_back(Metric{name_, names_.sharded_counter_names_[i], Counter(values_.sharded_counters_[i].Get())});
+  }
   return ret;
 }
 
@@ -174,6 +188,13 @@ std::string Component::ToJson() {
     oss << "\"" << names_.atomic_counter_names_[i] << "\":" << values_.atomic_counters_[i].Get() << "";
   }
 
+  for (size_t i = 0; i < names_.sharded_counter_names_.size(); i++) {
+    if (i != 0 || names_.counter_names_.size() > 0 || names_.atomic_counter_names_.size() > 0) {
+      oss << ",";
+    }
+    oss << "\"" << names_.sharded_counter_names_[i] << "\":" << values_.sharded_counters_[i].Get() << "";
+  }
+
   // End counters
   oss << "}";
 
@@ -190,6 +211,15 @@ void Aggregator::RegisterComponent(Component& component) {
   components_.insert(make_pair(component.Name(), component));
 }
 
+void Aggregator::ReplaceComponent(const Component& previous, Component& component) {
+  std::lock_guard<std::mutex> lock(lock_);
+  auto it = components_.find(previous.name_);
+  if (it != components_.end() && it->second.id_ == previous.id_) {
+    components_.erase(it);
+  }
+  components_.insert(make_pair(component.Name(), component));
+}
+
 // Throws if the component doesn't exist.
 // This is only called from the component itself, so it will never actually throw.
 void Aggregator::UpdateValues(const string& name, Values&& values) {
@@ -236,9 +266,15 @@ Counter Aggregator::GetCounter(const string& component_name, const string& val_n
     if (std::find(counters.begin(), counters.end(), val_name) != counters.end()) {
       return FindValue(kCounterName, val_name, component.names_.counter_names_, component.values_.counters_);
     }
-    auto atomic_counter =
-        FindValue(kCounterName, val_name, component.names_.atomic_counter_names_, component.values_.atomic_counters_);
-    return Counter(atomic_counter.Get());
+    auto& atomic_counters = component.names_.atomic_counter_names_;
+    if (std::find(atomic_counters.begin(), atomic_counters.end(), val_name) != atomic_counters.end()) {
+      auto atomic_counter =
+          FindValue(kCounterName, val_name, component.names_.atomic_counter_names_, component.values_.atomic_counters_);
+      return Counter(atomic_counter.Get());
+    }
+    auto sharded_counter =
+        FindValue(kCounterName, val_name, component.names_.sharded_counter_names_, component.values_.sharded_counters_);
+    return Counter(sharded_counter.Get());
   } catch (const std::out_of_range& e) {
     throw std::out_of_range("components_.at() failed for component_name = " + component_name);
   }
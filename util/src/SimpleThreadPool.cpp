@@ -18,69 +18,64 @@
 logging::Logger SP = logging::getLogger("thread-pool");
 namespace concord::util {
 
-void SimpleThreadPool::start(uint8_t num_of_threads) {
-  stopped_ = false;
-  guard g(queue_lock_);
-  for (auto i = 0; i < num_of_threads; ++i) {
-    threads_.emplace_back(std::thread([this, num_of_threads] {
-      LOG_DEBUG(SP, "thread start " << std::this_thread::get_id());
-      {
-        std::unique_lock<std::mutex> ul(threads_startup_lock_);
-        num_of_free_threads_++;
-        if (num_of_free_threads_ == num_of_threads) threads_startup_cond_.notify_one();
-      }
-      SimpleThreadPool::Job* j = nullptr;
-      while (load(j)) {
-        execute(j);
-        j->release();
-        j = nullptr;
-      }
-    }));
+namespace {
+
+// Owns a job: releases it once the task gets executed or discarded
+class JobTask {
+ public:
+  explicit JobTask(SimpleThreadPool::Job* j) : job_(j) {}
+  JobTask(JobTask&& other) : job_(other.job_) { other.job_ = nullptr; }
+  JobTask(const JobTask&) = delete;
+  JobTask& operator=(const JobTask&) = delete;
+  ~JobTask() {
+    if (job_) job_->release();
   }
-  std::unique_lock<std::mutex> ul(threads_startup_lock_);
-  threads_startup_cond_.wait(ul, [this, num_of_threads] { return (num_of_free_threads_ == num_of_threads); });
-}
+  SimpleThreadPool::Job* get() const { return job_; }
 
-void SimpleThreadPool::stop(bool executeAllJobs) {
-  {
-    std::unique_lock<std::mutex> l{queue_lock_};
-    stopped_ = true;
+ private:
+  SimpleThreadPool::Job* job_;
+};
+
+}  // namespace
+
+void SimpleThreadPool::start(uint8_t num_of_threads) {
+  std::lock_guard<std::mutex> guard(lock_);
+  if (!num_of_threads) {
+    LOG_WARN(SP, "not starting " << name_ << " with no threads");
+    return;
   }
-  queue_cond_.notify_all();
-  for (auto&& t : threads_) {
-    auto tid = t.get_id();
-    t.join();
-    LOG_DEBUG(SP, "thread joined " << tid);
+  auto executor = std::make_shared<WorkStealingExecutor>(WorkStealingExecutor::Config{name_, num_of_threads});
+  auto previous = std::atomic_load(&executor_);
+  if (aggregator_) {
+    executor->setAggregator(aggregator_);
+    // Other pools may have the same name: only the metrics of this pool's previous executor are replaced
+    if (previous) executor->replaceMetricsOf(*previous);
   }
-  threads_.clear();
-  // no more concurrent threads, can cleanup without locking
-  LOG_DEBUG(SP, "will " << (executeAllJobs ? "execute " : "discard ") << job_queue_.size() << " jobs in queue");
-  while (!job_queue_.empty()) {
-    Job* j = job_queue_.front();
-    job_queue_.pop();
-    if (executeAllJobs) execute(j);
+  std::atomic_store(&executor_, std::move(executor));
+  // The pool was started again without being stopped: the jobs queued so far still get executed
+  if (previous) previous->stop(true);
+  LOG_DEBUG(SP, "started " << name_ << " with " << (int)num_of_threads << " threads");
+}
 
-    j->release();
-  }
+void SimpleThreadPool::stop(bool executeAllJobs) {
+  std::lock_guard<std::mutex> guard(lock_);
+  auto executor = std::atomic_load(&executor_);
+  if (!executor) return;
+  LOG_DEBUG(SP,
+            "will " << (executeAllJobs ? "execute " : "discard ") << executor->numOfPendingTasks() << " jobs in queue");
+  executor->stop(executeAllJobs);
 }
 
-void SimpleThreadPool::add(Job* j) {
-  {
-    guard g(queue_lock_);
-    if (stopped_) return;
-    job_queue_.push(j);
-  }
-  queue_cond_.notify_one();
+void SimpleThreadPool::add(Job* j, Priority priority) {
+  auto executor = std::atomic_load(&executor_);
+  if (!executor) return;
+  executor->submit([task = JobTask{j}]() { execute(task.get()); }, priority);
 }
 
-bool SimpleThreadPool::load(Job*& outJob) {
-  std::unique_lock<std::mutex> ul(queue_lock_);
-  queue_cond_.wait(ul, [this] { return !(job_queue_.empty() && !stopped_); });
-  if (!stopped_) {
-    outJob = job_queue_.front();
-    job_queue_.pop();
-  }
-  return !stopped_;
+void SimpleThreadPool::setAggregator(const std::shared_ptr<concordMetrics::Aggregator>& aggregator) {
+  std::lock_guard<std::mutex> guard(lock_);
+  aggregator_ = aggregator;
+  if (auto executor = std::atomic_load(&executor_)) executor->setAggregator(aggregator);
 }
 
 void SimpleThreadPool::execute(Job* j) {
@@ -0,0 +1,222 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").  You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "WorkStealingExecutor.hpp"
+#include "Logger.hpp"
+#include "assertUtils.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+
+namespace concord::util {
+
+using namespace std::chrono;
+
+namespace {
+
+logging::Logger& logger() {
+  static logging::Logger logger_ = logging::getLogger("concord.util.thread-pool");
+  return logger_;
+}
+
+// The executor and the worker the current thread belongs to, if any
+thread_local const WorkStealingExecutor* currentExecutor = nullptr;
+thread_local size_t currentWorker = 0;
+
+// The NUMA node of a CPU, as exposed by sysfs; 0 if unknown
+int numaNodeOf(uint32_t cpu) {
+  const auto dirName = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+  auto* dir = opendir(dirName.c_str());
+  if (!dir) return 0;
+  int node = 0;
+  while (const auto* entry = readdir(dir)) {
+    if (strncmp(entry->d_name, "node", 4) == 0 && isdigit(entry->d_name[4])) {
+      node = atoi(entry->d_name + 4);
+      break;
+    }
+  }
+  closedir(dir);
+  return node;
+}
+
+}  // namespace
+
+WorkStealingExecutor::WorkStealingExecutor(const Config& config)
+    : config_{config},
+      metricsComponent_{config.name, std::make_shared<concordMetrics::Aggregator>()},
+      submittedTasks_{metricsComponent_.RegisterShardedCounter("submittedTasks")},
+      executedTasks_{metricsComponent_.RegisterShardedCounter("executedTasks")},
+      stolenTasks_{metricsComponent_.RegisterShardedCounter("stolenTasks")},
+      taskQueueWaitMicros_{metricsComponent_.RegisterShardedCounter("taskQueueWaitMicros")},
+      taskExecutionMicros_{metricsComponent_.RegisterShardedCounter("taskExecutionMicros")} {
+  ConcordAssertGT(config_.numOfThreads, 0);
+  metricsComponent_.Register();
+  for (uint32_t i = 0; i < config_.numOfThreads; ++i) workers_.push_back(std::make_unique<Worker>());
+  initVictims();
+
+  std::mutex startupLock;
+  std::condition_variable startupCond;
+  size_t numOfStarted = 0;
+  for (size_t id = 0; id < workers_.size(); ++id) {
+    workers_[id]->thread = std::thread([this, id, &startupLock, &startupCond, &numOfStarted] {
+      if (!config_.cpus.empty()) pin(id);
+      currentExecutor = this;
+      currentWorker = id;
+      {
+        std::lock_guard<std::mutex> guard(startupLock);
+        if (++numOfStarted == workers_.size()) startupCond.notify_one();
+      }
+      loop(id);
+    });
+  }
+  std::unique_lock<std::mutex> lock(startupLock);
+  startupCond.wait(lock, [this, &numOfStarted] { return numOfStarted == workers_.size(); });
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() { stop(false); }
+
+void WorkStealingExecutor::initVictims() {
+  std::vector<int> nodes(workers_.size(), 0);
+  if (!config_.cpus.empty()) {
+    for (size_t id = 0; id < workers_.size(); ++id) nodes[id] = numaNodeOf(config_.cpus[id % config_.cpus.size()]);
+  }
+  for (size_t id = 0; id < workers_.size(); ++id) {
+    auto& victims = workers_[id]->victims;
+    // Start right after this worker, so that the workers don't all steal from the same victim
+    for (size_t i = 1; i < workers_.size(); ++i) victims.push_back((id + i) % workers_.size());
+    std::stable_sort(victims.begin(), victims.end(), [&nodes, id](size_t a, size_t b) {
+      return (nodes[a] == nodes[id]) > (nodes[b] == nodes[id]);
+    });
+  }
+}
+
+void WorkStealingExecutor::pin(size_t id) {
+  const auto cpu = config_.cpus[id % config_.cpus.size()];
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(cpu, &cpuSet);
+  if (const auto err = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet)) {
+    LOG_WARN(logger(), "Failed to pin a worker to a CPU" << KVLOG(config_.name, id, cpu, err));
+  }
+}
+
+bool WorkStealingExecutor::submit(Task task, Priority priority) {
+  if (stopped_) return false;
+  const auto p = static_cast<size_t>(priority);
+  const auto id = (currentExecutor == this) ? currentWorker : nextWorker_.fetch_add(1) % workers_.size();
+  {
+    auto& worker = *workers_[id];
+    std::lock_guard<std::mutex> guard(worker.lock);
+    worker.queues[p].push_back(QueuedTask{std::move(task), steady_clock::now()});
+    pendingPerPriority_[p]++;
+    pending_++;
+  }
+  submittedTasks_++;
+  // A worker publishes itself as idle before it checks pending_ for the last time, so either it sees the new task or
+  // we see it idle
+  if (idleWorkers_ > 0) {
+    { std::lock_guard<std::mutex> guard(idleLock_); }
+    idleCond_.notify_one();
+  }
+  return true;
+}
+
+bool WorkStealingExecutor::popFrom(Worker& worker, size_t priority, QueuedTask& out) {
+  std::lock_guard<std::mutex> guard(worker.lock);
+  auto& queue = worker.queues[priority];
+  if (queue.empty()) return false;
+  out = std::move(queue.front());
+  queue.pop_front();
+  pendingPerPriority_[priority]--;
+  pending_--;
+  return true;
+}
+
+bool WorkStealingExecutor::take(size_t id, QueuedTask& out) {
+  auto& self = *workers_[id];
+  for (size_t p = 0; p < kNumOfPriorities; ++p) {
+    if (pendingPerPriority_[p] == 0) continue;
+    if (popFrom(self, p, out)) return true;
+    for (const auto victim : self.victims) {
+      if (popFrom(*workers_[victim], p, out)) {
+        stolenTasks_++;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void WorkStealingExecutor::run(QueuedTask& queuedTask) {
+  const auto start = steady_clock::now();
+  taskQueueWaitMicros_ += duration_cast<microseconds>(start - queuedTask.queuedAt).count();
+  try {
+    queuedTask.task();
+  } catch (const std::exception& e) {
+    LOG_ERROR(logger(), "Exception in a task of " << config_.name << ": " << e.what());
+  } catch (...) {
+    LOG_ERROR(logger(), "Unknown exception in a task of " << config_.name);
+  }
+  // Release whatever the task holds before picking the next one
+  queuedTask.task = Task{};
+  executedTasks_++;
+  taskExecutionMicros_ += duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+void WorkStealingExecutor::loop(size_t id) {
+  QueuedTask queuedTask;
+  while (!stopped_ || drain_) {
+    if (take(id, queuedTask)) {
+      run(queuedTask);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(idleLock_);
+    if (stopped_ && pending_ == 0) break;
+    idleWorkers_++;
+    idleCond_.wait(lock, [this] { return pending_ > 0 || stopped_; });
+    idleWorkers_--;
+  }
+}
+
+void WorkStealingExecutor::stop(bool drain) {
+  std::lock_guard<std::mutex> stopGuard(stopLock_);
+  if (joined_) return;
+  drain_ = drain;
+  {
+    std::lock_guard<std::mutex> guard(idleLock_);
+    stopped_ = true;
+  }
+  idleCond_.notify_all();
+  for (auto& worker : workers_) worker->thread.join();
+  joined_ = true;
+
+  // Tasks submitted while the workers were stopping
+  QueuedTask queuedTask;
+  for (size_t p = 0; p < kNumOfPriorities; ++p) {
+    for (auto& worker : workers_) {
+      while (popFrom(*worker, p, queuedTask)) {
+        if (drain) run(queuedTask);
+        queuedTask.task = Task{};
+      }
+    }
+  }
+}
+
+size_t WorkStealingExecutor::numOfThreads() const { return stopped_ ? 0 : workers_.size(); }
+
+}  // namespace concord::util
@@ -0,0 +1,229 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").  You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "sha256_batch.hpp"
+#include "sha256_lanes.hpp"
+#include "assertUtils.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <cryptopp/sha.h>
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#endif
+
+namespace concord::util {
+
+namespace {
+
+constexpr size_t kBlockSize = 64;
+constexpr uint32_t kInitialState[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+// Below this many buffers the lanes would mostly be idle.
+constexpr size_t kMinBuffersForLanes = 4;
+// From this average buffer size on, a single SHA-NI stream outruns the lanes.
+constexpr size_t kMinAverageSizeForShaNi = 2048;
+
+bool detectShaExtensions() {
+#if defined(__x86_64__)
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+  if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return false;
+  return (ebx & (1u << 29)) != 0;
+#else
+  return false;
+#endif
+}
+
+bool cpuHasShaExtensions() {
+  static const bool has_sha = detectShaExtensions();
+  return has_sha;
+}
+
+SHA256Batch::Engine detectEngine() {
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return SHA256Batch::Engine::AVX512;
+  if (__builtin_cpu_supports("avx2")) return SHA256Batch::Engine::AVX2;
+#endif
+  return SHA256Batch::Engine::SCALAR;
+}
+
+void digestScalar(const void* const* data, const size_t* sizes, size_t count, SHA256Batch::Digest* out) {
+  CryptoPP::SHA256 sha;
+  for (size_t i = 0; i < count; ++i) {
+    sha.CalculateDigest(out[i].data(), static_cast<const CryptoPP::byte*>(data[i]), sizes[i]);
+  }
+}
+
+// One buffer being hashed in a lane: its full blocks are read in place and the padded remainder from tail.
+struct LaneJob {
+  const uint8_t* data = nullptr;
+  size_t full_blocks = 0;
+  size_t total_blocks = 0;
+  uint8_t tail[2 * kBlockSize];
+  SHA256Batch::Digest* out = nullptr;
+
+  void init(const void* buf, size_t size, SHA256Batch::Digest* digest) {
+    data = static_cast<const uint8_t*>(buf);
+    full_blocks = size / kBlockSize;
+    const auto rem = size % kBlockSize;
+    const auto tail_blocks = (rem + 1 + sizeof(uint64_t) <= kBlockSize) ? 1 : 2;
+    total_blocks = full_blocks + tail_blocks;
+    memset(tail, 0, sizeof(tail));
+    if (rem) memcpy(tail, data + full_blocks * kBlockSize, rem);
+    tail[rem] = 0x80;
+    const uint64_t bits = static_cast<uint64_t>(size) * 8;
+    for (size_t i = 0; i < sizeof(bits); ++i) {
+      tail[tail_blocks * kBlockSize - 1 - i] = static_cast<uint8_t>(bits >> (8 * i));
+    }
+    out = digest;
+  }
+
+  const uint8_t* block(size_t i) const {
+    return i < full_blocks ? data + i * kBlockSize : tail + (i - full_blocks) * kBlockSize;
+  }
+};
+
+size_t blockCount(size_t size) { return (size + 1 + sizeof(uint64_t) + kBlockSize - 1) / kBlockSize; }
+
+// Hash the buffers kLanes at a time. Buffers are sorted by their number of blocks, so that the lanes of a group finish
+// at about the same time.
+template <size_t kLanes>
+void digestLanes(void (*compress)(uint32_t*, const uint8_t* const*),
+                 const void* const* data,
+                 const size_t* sizes,
+                 size_t count,
+                 SHA256Batch::Digest* out) {
+  std::vector<size_t> order(count);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [sizes](size_t lhs, size_t rhs) {
+    return blockCount(sizes[lhs]) < blockCount(sizes[rhs]);
+  });
+
+  static const uint8_t kIdleBlock[kBlockSize] = {};
+  std::vector<LaneJob> jobs(kLanes);
+  uint32_t state[8 * kLanes];
+  const uint8_t* blocks[kLanes];
+
+  for (size_t group = 0; group < count; group += kLanes) {
+    const auto lanes = std::min(kLanes, count - group);
+    size_t max_blocks = 0;
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+      for (size_t word = 0; word < 8; ++word) state[word * kLanes + lane] = kInitialState[word];
+      if (lane < lanes) {
+        const auto i = order[group + lane];
+        jobs[lane].init(data[i], sizes[i], &out[i]);
+        max_blocks = std::max(max_blocks, jobs[lane].total_blocks);
+      } else {
+        jobs[lane].total_blocks = 0;
+      }
+    }
+
+    for (size_t b = 0; b < max_blocks; ++b) {
+      for (size_t lane = 0; lane < kLanes; ++lane) {
+        blocks[lane] = b < jobs[lane].total_blocks ? jobs[lane].block(b) : kIdleBlock;
+      }
+      compress(state, blocks);
+      for (size_t lane = 0; lane < lanes; ++lane) {
+        if (b + 1 != jobs[lane].total_blocks) continue;
+        auto& digest = *jobs[lane].out;
+        for (size_t word = 0; word < 8; ++word) {
+          const auto v = state[word * kLanes + lane];
+          digest[4 * word + 0] = static_cast<uint8_t>(v >> 24);
+          digest[4 * word + 1] = static_cast<uint8_t>(v >> 16);
+          digest[4 * word + 2] = static_cast<uint8_t>(v >> 8);
+          digest[4 * word + 3] = static_cast<uint8_t>(v);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+SHA256Batch::Engine SHA256Batch::engine() {
+  static const Engine engine = detectEngine();
+  return engine;
+}
+
+bool SHA256Batch::isSupported(Engine engine) {
+  switch (engine) {
+    case Engine::SCALAR:
+      return true;
+#if defined(__x86_64__)
+    case Engine::AVX2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2");
+    case Engine::AVX512:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+      return false;
+  }
+}
+
+const char* SHA256Batch::engineName(Engine engine) {
+  switch (engine) {
+    case Engine::SCALAR:
+      return "scalar";
+    case Engine::AVX2:
+      return "avx2";
+    case Engine::AVX512:
+      return "avx512";
+  }
+  return "unknown";
+}
+
+void SHA256Batch::digest(const void* const* data, const size_t* sizes, size_t count, Digest* out) {
+  auto selected = engine();
+  if (selected != Engine::SCALAR && cpuHasShaExtensions()) {
+    const auto total = std::accumulate(sizes, sizes + count, size_t{0});
+    if (count && total / count >= kMinAverageSizeForShaNi) selected = Engine::SCALAR;
+  }
+  digest(selected, data, sizes, count, out);
+}
+
+void SHA256Batch::digest(const std::vector<std::string_view>& buffers, Digest* out) {
+  std::vector<const void*> data;
+  std::vector<size_t> sizes;
+  data.reserve(buffers.size());
+  sizes.reserve(buffers.size());
+  for (const auto& buf : buffers) {
+    data.push_back(buf.data());
+    sizes.push_back(buf.size());
+  }
+  digest(data.data(), sizes.data(), buffers.size(), out);
+}
+
+std::vector<SHA256Batch::Digest> SHA256Batch::digest(const std::vector<std::string_view>& buffers) {
+  std::vector<Digest> out(buffers.size());
+  digest(buffers, out.data());
+  return out;
+}
+
+void SHA256Batch::digest(Engine engine, const void* const* data, const size_t* sizes, size_t count, Digest* out) {
+  ConcordAssert(isSupported(engine));
+  if (count < kMinBuffersForLanes) engine = Engine::SCALAR;
+  switch (engine) {
+#if defined(__x86_64__)
+    case Engine::AVX2:
+      return digestLanes<8>(detail::sha256CompressX8Avx2, data, sizes, count, out);
+    case Engine::AVX512:
+      return digestLanes<16>(detail::sha256CompressX16Avx512, data, sizes, count, out);
+#endif
+    default:
+      return digestScalar(data, sizes, count, out);
+  }
+}
+
+}  // namespace concord::util
@@ -0,0 +1,60 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").  You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+// Compiled with -mavx2. Only called after a runtime check of the CPU features.
+
+#include "sha256_lanes.hpp"
+
+#include <immintrin.h>
+
+namespace concord::util::detail {
+namespace {
+
+struct Avx2Ops {
+  typedef __m256i V;
+  static constexpr int kLanes = 8;
+
+  static V add(V a, V b) { return _mm256_add_epi32(a, b); }
+  static V and2(V a, V b) { return _mm256_and_si256(a, b); }
+  static V or2(V a, V b) { return _mm256_or_si256(a, b); }
+  static V xor2(V a, V b) { return _mm256_xor_si256(a, b); }
+  static V xor3(V a, V b, V c) { return _mm256_xor_si256(_mm256_xor_si256(a, b), c); }
+  // ~a & b
+  static V andnot(V a, V b) { return _mm256_andnot_si256(a, b); }
+  template <int N>
+  static V ror(V x) {
+    return _mm256_or_si256(_mm256_srli_epi32(x, N), _mm256_slli_epi32(x, 32 - N));
+  }
+  template <int N>
+  static V shr(V x) {
+    return _mm256_srli_epi32(x, N);
+  }
+  static V set1(uint32_t v) { return _mm256_set1_epi32(static_cast<int>(v)); }
+  static V load(const uint32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const V*>(p)); }
+  static void store(uint32_t* p, V v) { _mm256_storeu_si256(reinterpret_cast<V*>(p), v); }
+  static V loadWord(const uint8_t* const* blocks, int i) {
+    const auto o = 4 * i;
+    return _mm256_setr_epi32(static_cast<int>(loadBigEndian32(blocks[0] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[1] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[2] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[3] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[4] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[5] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[6] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[7] + o)));
+  }
+};
+
+}  // namespace
+
+void sha256CompressX8Avx2(uint32_t* state, const uint8_t* const* blocks) { compressLanes<Avx2Ops>(state, blocks); }
+
+}  // namespace concord::util::detail
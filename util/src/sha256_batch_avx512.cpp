@@ -0,0 +1,80 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").  You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+// Compiled with -mavx512f. Only called after a runtime check of the CPU features.
+
+#include "sha256_lanes.hpp"
+
+#include <immintrin.h>
+
+// Some GCC versions flag the intentionally undefined pass-through operand of the unmasked AVX-512 intrinsics.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#if !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace concord::util::detail {
+namespace {
+
+struct Avx512Ops {
+  typedef __m512i V;
+  static constexpr int kLanes = 16;
+
+  static V add(V a, V b) { return _mm512_add_epi32(a, b); }
+  static V and2(V a, V b) { return _mm512_and_si512(a, b); }
+  static V or2(V a, V b) { return _mm512_or_si512(a, b); }
+  static V xor2(V a, V b) { return _mm512_xor_si512(a, b); }
+  // A single vpternlogd computes the three-way XOR.
+  static V xor3(V a, V b, V c) { return _mm512_ternarylogic_epi32(a, b, c, 0x96); }
+  // ~a & b
+  static V andnot(V a, V b) { return _mm512_andnot_si512(a, b); }
+  template <int N>
+  static V ror(V x) {
+    return _mm512_ror_epi32(x, N);
+  }
+  template <int N>
+  static V shr(V x) {
+    return _mm512_srli_epi32(x, N);
+  }
+  static V set1(uint32_t v) { return _mm512_set1_epi32(static_cast<int>(v)); }
+  static V load(const uint32_t* p) { return _mm512_loadu_si512(p); }
+  static void store(uint32_t* p, V v) { _mm512_storeu_si512(p, v); }
+  static V loadWord(const uint8_t* const* blocks, int i) {
+    const auto o = 4 * i;
+    return _mm512_setr_epi32(static_cast<int>(loadBigEndian32(blocks[0] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[1] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[2] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[3] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[4] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[5] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[6] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[7] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[8] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[9] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[10] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[11] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[12] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[13] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[14] + o)),
+                             static_cast<int>(loadBigEndian32(blocks[15] + o)));
+  }
+};
+
+}  // namespace
+
+void sha256CompressX16Avx512(uint32_t* state, const uint8_t* const* blocks) {
+  compressLanes<Avx512Ops>(state, blocks);
+}
+
+}  // namespace concord::util::detail
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,98 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").  You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+// Lane-parallel SHA-256 compression function, shared by the SIMD kernels of SHA256Batch.
+//
+// This header is private to util. The kernel translation units that include it are compiled with their own instruction
+// set flags, so the helpers below have internal linkage: code generated for one instruction set can never be picked by
+// the linker for another translation unit.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace concord::util::detail {
+
+// Compress one 64-byte block per lane. Defined in the kernel translation units; see compressLanes() for the layout.
+void sha256CompressX8Avx2(uint32_t* state, const uint8_t* const* blocks);
+void sha256CompressX16Avx512(uint32_t* state, const uint8_t* const* blocks);
+
+namespace {
+
+constexpr uint32_t kSha256RoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+inline uint32_t loadBigEndian32(const uint8_t* p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return __builtin_bswap32(v);
+}
+
+// Ops provides the vector type V holding one 32-bit word per lane, kLanes, and the primitive operations below.
+//
+// state holds the 8 working words of every lane, word-major: state[word * kLanes + lane].
+// blocks holds one 64-byte message block per lane.
+template <typename Ops>
+inline void compressLanes(uint32_t* state, const uint8_t* const* blocks) {
+  using V = typename Ops::V;
+  constexpr auto N = Ops::kLanes;
+
+  V w[16];
+  for (int i = 0; i < 16; ++i) w[i] = Ops::loadWord(blocks, i);
+
+  V a = Ops::load(state + 0 * N), b = Ops::load(state + 1 * N), c = Ops::load(state + 2 * N),
+    d = Ops::load(state + 3 * N), e = Ops::load(state + 4 * N), f = Ops::load(state + 5 * N),
+    g = Ops::load(state + 6 * N), h = Ops::load(state + 7 * N);
+
+  for (int t = 0; t < 64; ++t) {
+    if (t >= 16) {
+      const V w15 = w[(t - 15) & 15];
+      const V w2 = w[(t - 2) & 15];
+      const V s0 = Ops::xor3(Ops::template ror<7>(w15), Ops::template ror<18>(w15), Ops::template shr<3>(w15));
+      const V s1 = Ops::xor3(Ops::template ror<17>(w2), Ops::template ror<19>(w2), Ops::template shr<10>(w2));
+      w[t & 15] = Ops::add(Ops::add(w[t & 15], s0), Ops::add(w[(t - 7) & 15], s1));
+    }
+    const V S1 = Ops::xor3(Ops::template ror<6>(e), Ops::template ror<11>(e), Ops::template ror<25>(e));
+    const V ch = Ops::xor2(Ops::and2(e, f), Ops::andnot(e, g));
+    const V t1 = Ops::add(Ops::add(Ops::add(h, S1), Ops::add(ch, w[t & 15])), Ops::set1(kSha256RoundConstants[t]));
+    const V S0 = Ops::xor3(Ops::template ror<2>(a), Ops::template ror<13>(a), Ops::template ror<22>(a));
+    const V maj = Ops::or2(Ops::and2(a, b), Ops::and2(c, Ops::or2(a, b)));
+    const V t2 = Ops::add(S0, maj);
+    h = g;
+    g = f;
+    f = e;
+    e = Ops::add(d, t1);
+    d = c;
+    c = b;
+    b = a;
+    a = Ops::add(t1, t2);
+  }
+
+  Ops::store(state + 0 * N, Ops::add(a, Ops::load(state + 0 * N)));
+  Ops::store(state + 1 * N, Ops::add(b, Ops::load(state + 1 * N)));
+  Ops::store(state + 2 * N, Ops::add(c, Ops::load(state + 2 * N)));
+  Ops::store(state + 3 * N, Ops::add(d, Ops::load(state + 3 * N)));
+  Ops::store(state + 4 * N, Ops::add(e, Ops::load(state + 4 * N)));
+  Ops::store(state + 5 * N, Ops::add(f, Ops::load(state + 5 * N)));
+  Ops::store(state + 6 * N, Ops::add(g, Ops::load(state + 6 * N)));
+  Ops::store(state + 7 * N, Ops::add(h, Ops::load(state + 7 * N)));
+}
+
+}  // namespace
+}  // namespace concord::util::detail
@@ -16,6 +16,7 @@
 #include "gtest/gtest.h"
 #include "Metrics.hpp"
 #include <cmath>
+#include <thread>
 
 using namespace std;
 
@@ -200,4 +201,68 @@ TEST(MetricTest, CollectStatuses) {
   ASSERT_EQ(numOfGaugesInStateTransfer, 1);
 }
 
+TEST(MetricTest, ShardedCounterVisibleWithoutUpdate) {
+  auto aggregator = std::make_shared<Aggregator>();
+  Component c("replica", aggregator);
+  auto h_counter = c.RegisterShardedCounter("messages_sent", 3);
+  c.Register();
+
+  ASSERT_EQ(3, aggregator->GetCounter(c.Name(), "messages_sent").Get());
+  h_counter++;
+  h_counter += 5;
+  // Sharded counters share their slots with the aggregator, so no UpdateAggregator() is needed
+  ASSERT_EQ(9, h_counter.Get().Get());
+  ASSERT_EQ(9, aggregator->GetCounter(c.Name(), "messages_sent").Get());
+
+  auto counters = aggregator->CollectCounters();
+  ASSERT_EQ(1, counters.size());
+  ASSERT_EQ(9, std::get<Counter>(counters.front().value).Get());
+}
+
+TEST(MetricTest, ShardedCounterConcurrentIncrements) {
+  auto aggregator = std::make_shared<Aggregator>();
+  Component c("replica", aggregator);
+  auto h_counter = c.RegisterShardedCounter("messages_sent");
+  c.Register();
+
+  const size_t num_threads = 8;
+  const size_t increments = 100000;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; i++) {
+    threads.emplace_back([&h_counter, increments]() {
+      for (size_t j = 0; j < increments; j++) h_counter++;
+    });
+  }
+  for (auto& t : threads) t.join();
+  ASSERT_EQ(num_threads * increments, aggregator->GetCounter(c.Name(), "messages_sent").Get());
+}
+
+TEST(MetricTest, ReplaceRegistration) {
+  auto aggregator = std::make_shared<Aggregator>();
+  auto previous = std::make_unique<Component>("pool", aggregator);
+  auto h_previous_counter = previous->RegisterShardedCounter("executedTasks", 3);
+  previous->RegisterGauge("threads", 1);
+  previous->Register();
+
+  // Only the registered component can be replaced
+  Component other("pool", aggregator);
+  Component next("pool", aggregator);
+  auto h_next_counter = next.RegisterShardedCounter("executedTasks");
+  next.ReplaceRegistration(other);
+  ASSERT_EQ(3, aggregator->GetCounter("pool", "executedTasks").Get());
+  next.ReplaceRegistration(*previous);
+  previous.reset();
+  h_next_counter++;
+  ASSERT_EQ(1, aggregator->GetCounter("pool", "executedTasks").Get());
+  ASSERT_THROW(aggregator->GetGauge("pool", "threads"), invalid_argument);
+  ASSERT_EQ(1, aggregator->CollectCounters().size());
+
+  // Without a registered component, the component is registered
+  Component unregistered("queue", aggregator);
+  Component replacement("queue", aggregator);
+  auto h_replacement_counter = replacement.RegisterShardedCounter("executedTasks", 2);
+  replacement.ReplaceRegistration(unregistered);
+  ASSERT_EQ(2, aggregator->GetCounter("queue", "executedTasks").Get());
+}
+
 }  // namespace concordMetrics
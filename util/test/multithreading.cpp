@@ -87,6 +87,34 @@ TEST_F(SimpleThreadPoolFixture, ThreadPoolMultipleProducers) {
   EXPECT_EQ(result, 1000);
 }
 
+TEST_F(SimpleThreadPoolFixture, ThreadPoolRestart) {
+  auto aggregator = std::make_shared<concordMetrics::Aggregator>();
+  pool_.setAggregator(aggregator);
+  for (int i = 0; i < 10; ++i) pool_.add(new TestJob(this, 1));
+  pool_.stop(true);
+  EXPECT_EQ(result, 10);
+
+  pool_.start(2);
+  EXPECT_EQ(pool_.getNumOfThreads(), 2);
+  for (int i = 0; i < 5; ++i) pool_.add(new TestJob(this, 1));
+  pool_.stop(true);
+  EXPECT_EQ(result, 15);
+  // The aggregator reports the executor of the last start()
+  EXPECT_EQ(aggregator->GetCounter("SimpleThreadPool", "executedTasks").Get(), 5);
+  // Released without being executed
+  pool_.add(new TestJob(this, 1));
+  EXPECT_EQ(result, 15);
+  // Restarting another pool of the same name doesn't replace the metrics of this one
+  concord::util::SimpleThreadPool other_pool;
+  other_pool.setAggregator(aggregator);
+  other_pool.start(1);
+  other_pool.start(1);
+  other_pool.add(new TestJob(this, 1));
+  other_pool.stop(true);
+  EXPECT_EQ(result, 16);
+  EXPECT_EQ(aggregator->GetCounter("SimpleThreadPool", "executedTasks").Get(), 5);
+}
+
 /**
  * Fixture for testing Handoff
  */
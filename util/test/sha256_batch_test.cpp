@@ -0,0 +1,95 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the
+// LICENSE file.
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sha256_batch.hpp"
+#include "sha_hash.hpp"
+
+using namespace concord::util;
+
+namespace {
+
+// Lengths around the padding boundaries, where the last one or two blocks differ.
+const std::vector<size_t> kEdgeLengths{0, 1, 31, 32, 55, 56, 63, 64, 65, 119, 120, 127, 128, 129, 1000, 4096};
+
+std::vector<std::string> randomBuffers(const std::vector<size_t>& lengths, unsigned seed) {
+  auto gen = std::mt19937{seed};
+  std::vector<std::string> buffers;
+  for (auto len : lengths) {
+    std::string buf(len, '\0');
+    for (auto& c : buf) c = static_cast<char>(gen());
+    buffers.push_back(std::move(buf));
+  }
+  return buffers;
+}
+
+void checkEngine(SHA256Batch::Engine engine, const std::vector<std::string>& buffers) {
+  std::vector<const void*> data;
+  std::vector<size_t> sizes;
+  for (const auto& buf : buffers) {
+    data.push_back(buf.data());
+    sizes.push_back(buf.size());
+  }
+  std::vector<SHA256Batch::Digest> out(buffers.size());
+  SHA256Batch::digest(engine, data.data(), sizes.data(), buffers.size(), out.data());
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    ASSERT_EQ(SHA2_256{}.digest(buffers[i].data(), buffers[i].size()), out[i])
+        << SHA256Batch::engineName(engine) << " buffer of " << buffers[i].size() << " bytes";
+  }
+}
+
+class SHA256BatchTest : public ::testing::TestWithParam<SHA256Batch::Engine> {
+ protected:
+  void SetUp() override {
+    if (!SHA256Batch::isSupported(GetParam())) GTEST_SKIP() << "engine not supported by this CPU";
+  }
+};
+
+TEST_P(SHA256BatchTest, EdgeLengths) {
+  // Repeat the lengths so that every one of them lands in a lane next to the others
+  std::vector<size_t> lengths;
+  for (int i = 0; i < 3; ++i) lengths.insert(lengths.end(), kEdgeLengths.begin(), kEdgeLengths.end());
+  checkEngine(GetParam(), randomBuffers(lengths, 1));
+}
+
+TEST_P(SHA256BatchTest, RandomLengths) {
+  auto gen = std::mt19937{2};
+  for (size_t count : {1, 3, 4, 7, 8, 9, 15, 16, 17, 100}) {
+    std::vector<size_t> lengths;
+    for (size_t i = 0; i < count; ++i) lengths.push_back(gen() % 600);
+    checkEngine(GetParam(), randomBuffers(lengths, count));
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(Engines,
+                        SHA256BatchTest,
+                        ::testing::Values(SHA256Batch::Engine::SCALAR,
+                                          SHA256Batch::Engine::AVX2,
+                                          SHA256Batch::Engine::AVX512),
+                        [](const auto& info) { return std::string{SHA256Batch::engineName(info.param)}; });
+
+TEST(SHA256BatchSelectionTest, SelectedEngine) {
+  const auto buffers = randomBuffers(kEdgeLengths, 3);
+  std::vector<std::string_view> views(buffers.begin(), buffers.end());
+  const auto out = SHA256Batch::digest(views);
+  ASSERT_EQ(buffers.size(), out.size());
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    ASSERT_EQ(SHA2_256{}.digest(buffers[i].data(), buffers[i].size()), out[i]);
+  }
+}
+
+}  // namespace
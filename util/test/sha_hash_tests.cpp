@@ -135,6 +135,30 @@ TYPED_TEST(SHATest, update) {
   ASSERT_EQ(expected, sha.finish());
 }
 
+TYPED_TEST(SHATest, clone) {
+  using Test = typename TestFixture::Type;
+  using Hash = typename Test::Hash;
+
+  auto sha = Hash{};
+  sha.init();
+  sha.update("art", 3);
+  auto copy = sha.clone();
+  sha.update("ist", 3);
+  copy.update("ist", 3);
+
+  auto expected = string_to_array<Hash>(Test::ARTIST_DIGEST);
+  ASSERT_EQ(expected, sha.finish());
+  ASSERT_EQ(expected, copy.finish());
+
+  // A moved-to hash continues from the state of the moved-from one
+  auto moved = Hash{};
+  sha.init();
+  sha.update("R", 1);
+  moved = std::move(sha);
+  moved.update("EM", 2);
+  ASSERT_EQ(string_to_array<Hash>(Test::REM_DIGEST), moved.finish());
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
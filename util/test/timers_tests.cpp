@@ -106,4 +106,93 @@ TEST(TimersTest, Basic) {
   ASSERT_TRUE(third_timer_fired);
 }
 
+TEST(TimersTest, ManyTimersAcrossWheelLevels) {
+  auto timers = Timers();
+  steady_clock::time_point now = steady_clock::now();
+
+  // Durations spanning the first three levels of the wheel
+  std::vector<milliseconds> durations{
+      milliseconds(1), milliseconds(255), milliseconds(256), milliseconds(1000), milliseconds(70000)};
+  std::vector<int> fired(durations.size(), 0);
+  for (size_t i = 0; i < durations.size(); ++i) {
+    timers.add(
+        durations[i], Timers::Timer::ONESHOT, [&fired, i](Handle) { ++fired[i]; }, now);
+  }
+
+  auto start = now;
+  for (size_t i = 0; i < durations.size(); ++i) {
+    // Just before the expiry, the timer must not fire
+    now = start + durations[i] - microseconds(1);
+    timers.evaluate(now);
+    ASSERT_EQ(0, fired[i]);
+    now = start + durations[i];
+    timers.evaluate(now);
+    ASSERT_EQ(1, fired[i]);
+  }
+  ASSERT_EQ(std::vector<int>(durations.size(), 1), fired);
+}
+
+TEST(TimersTest, CancelAndResetFromCallback) {
+  milliseconds duration(10);
+  auto timers = Timers();
+  steady_clock::time_point now = steady_clock::now();
+
+  int first_counter = 0;
+  int second_counter = 0;
+  Handle second;
+  // The first timer cancels the second one, which expires at the same time
+  timers.add(
+      duration,
+      Timers::Timer::ONESHOT,
+      [&](Handle) {
+        ++first_counter;
+        timers.cancel(second);
+      },
+      now);
+  second = timers.add(
+      duration, Timers::Timer::ONESHOT, [&second_counter](Handle) { ++second_counter; }, now);
+
+  // A recurring timer that changes its own period, as the replica's slow path timer does
+  int recurring_counter = 0;
+  timers.add(
+      duration,
+      Timers::Timer::RECURRING,
+      [&](Handle h) {
+        ++recurring_counter;
+        timers.reset(h, duration * 3);
+      },
+      now);
+
+  now += duration;
+  timers.evaluate(now);
+  ASSERT_EQ(1, first_counter);
+  ASSERT_EQ(0, second_counter);
+  ASSERT_EQ(1, recurring_counter);
+
+  now += duration * 2;
+  timers.evaluate(now);
+  ASSERT_EQ(1, recurring_counter);
+  now += duration;
+  timers.evaluate(now);
+  ASSERT_EQ(2, recurring_counter);
+}
+
+TEST(TimersTest, LongGapBetweenEvaluations) {
+  milliseconds duration(100);
+  auto timers = Timers();
+  steady_clock::time_point now = steady_clock::now();
+
+  int counter = 0;
+  timers.add(
+      duration, Timers::Timer::RECURRING, [&counter](Handle) { ++counter; }, now);
+
+  // A recurring timer fires once per evaluation, even if several periods elapsed in between
+  now += hours(2);
+  timers.evaluate(now);
+  ASSERT_EQ(1, counter);
+  now += duration;
+  timers.evaluate(now);
+  ASSERT_EQ(2, counter);
+}
+
 }  // namespace concordUtil
@@ -0,0 +1,159 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").  You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "gtest/gtest.h"
+
+#include "WorkStealingExecutor.hpp"
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sched.h>
+
+namespace {
+
+using namespace concord::util;
+using Priority = WorkStealingExecutor::Priority;
+
+WorkStealingExecutor::Config config(uint32_t numOfThreads) {
+  return WorkStealingExecutor::Config{"test_executor", numOfThreads};
+}
+
+// Blocks a worker of the executor until release() is called
+class Blocker {
+ public:
+  void block(WorkStealingExecutor& executor) {
+    executor.submit([this] {
+      started_.set_value();
+      released_.get_future().wait();
+    });
+    started_.get_future().wait();
+  }
+  void release() { released_.set_value(); }
+
+ private:
+  std::promise<void> started_;
+  std::promise<void> released_;
+};
+
+TEST(work_stealing_executor, executes_tasks_of_many_producers) {
+  WorkStealingExecutor executor{config(4)};
+  ASSERT_EQ(executor.numOfThreads(), 4);
+  std::atomic_int executed{0};
+  std::vector<std::thread> producers;
+  for (int i = 0; i < 8; ++i) {
+    producers.emplace_back([&] {
+      for (int j = 0; j < 1000; ++j) ASSERT_TRUE(executor.submit([&executed] { executed++; }));
+    });
+  }
+  for (auto& p : producers) p.join();
+  executor.stop(true);
+  ASSERT_EQ(executed, 8000);
+  ASSERT_EQ(executor.numOfPendingTasks(), 0);
+  ASSERT_EQ(executor.numOfThreads(), 0);
+}
+
+TEST(work_stealing_executor, higher_priority_first) {
+  WorkStealingExecutor executor{config(1)};
+  Blocker blocker;
+  blocker.block(executor);
+  std::mutex lock;
+  std::vector<int> order;
+  auto record = [&](int i) {
+    return [&, i] {
+      std::lock_guard<std::mutex> guard(lock);
+      order.push_back(i);
+    };
+  };
+  executor.submit(record(3), Priority::LOW);
+  executor.submit(record(2), Priority::NORMAL);
+  executor.submit(record(1), Priority::HIGH);
+  executor.submit(record(4), Priority::LOW);
+  executor.submit(record(0), Priority::HIGH);
+  blocker.release();
+  executor.stop(true);
+  ASSERT_EQ(order, (std::vector<int>{1, 0, 2, 3, 4}));
+}
+
+TEST(work_stealing_executor, idle_workers_steal_tasks_of_a_busy_one) {
+  auto aggregator = std::make_shared<concordMetrics::Aggregator>();
+  WorkStealingExecutor executor{config(2)};
+  executor.setAggregator(aggregator);
+  const int numOfTasks = 100;
+  std::promise<void> allDone;
+  std::atomic_int executed{0};
+  std::promise<void> released;
+  auto releasedFuture = released.get_future().share();
+  // Tasks submitted by a worker are queued on that worker, which is blocked until all of them are done
+  executor.submit([&] {
+    for (int i = 0; i < numOfTasks; ++i) {
+      executor.submit([&] {
+        if (++executed == numOfTasks) allDone.set_value();
+      });
+    }
+    releasedFuture.wait();
+  });
+  ASSERT_EQ(allDone.get_future().wait_for(std::chrono::seconds(10)), std::future_status::ready);
+  released.set_value();
+  executor.stop(true);
+  ASSERT_EQ(aggregator->GetCounter("test_executor", "stolenTasks").Get(), numOfTasks);
+  ASSERT_EQ(aggregator->GetCounter("test_executor", "submittedTasks").Get(), numOfTasks + 1);
+  ASSERT_EQ(aggregator->GetCounter("test_executor", "executedTasks").Get(), numOfTasks + 1);
+}
+
+TEST(work_stealing_executor, stop_discards_pending_tasks) {
+  WorkStealingExecutor executor{config(1)};
+  Blocker blocker;
+  blocker.block(executor);
+  std::atomic_int executed{0};
+  auto token = std::make_shared<int>(0);
+  for (int i = 0; i < 10; ++i) executor.submit([&executed, token] { executed++; });
+  ASSERT_EQ(executor.numOfPendingTasks(), 10);
+  std::thread stopper([&] { executor.stop(false); });
+  // Let stop() start waiting for the running task
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  blocker.release();
+  stopper.join();
+  ASSERT_EQ(executed, 0);
+  // The discarded tasks were destroyed
+  ASSERT_EQ(token.use_count(), 1);
+  ASSERT_EQ(executor.numOfPendingTasks(), 0);
+  ASSERT_FALSE(executor.submit([&executed] { executed++; }));
+  ASSERT_EQ(executed, 0);
+}
+
+TEST(work_stealing_executor, exceptions_do_not_stop_the_worker) {
+  WorkStealingExecutor executor{config(1)};
+  executor.submit([] { throw std::runtime_error{"error"}; });
+  std::promise<void> done;
+  executor.submit([&done] { done.set_value(); });
+  ASSERT_EQ(done.get_future().wait_for(std::chrono::seconds(10)), std::future_status::ready);
+}
+
+TEST(work_stealing_executor, pinned_workers) {
+  auto c = config(2);
+  c.cpus = {0};
+  WorkStealingExecutor executor{c};
+  std::promise<int> cpu;
+  executor.submit([&cpu] { cpu.set_value(sched_getcpu()); });
+  ASSERT_EQ(cpu.get_future().get(), 0);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}